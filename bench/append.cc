@@ -0,0 +1,155 @@
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "sstr.h"
+
+// old policy: grow by CAP_ADD_DELTA bytes each time.
+static const sstr_growth_t linear_growth = {1.0, CAP_ADD_DELTA, 0};
+
+static const char chunk[] =
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+
+static void append_until(benchmark::State& state,
+                         const sstr_growth_t* growth) {
+    size_t total = (size_t)state.range(0);
+    for (auto _ : state) {
+        sstr_t s = sstr_new();
+        sstr_set_growth(s, growth);
+        while (sstr_length(s) < total) {
+            sstr_append_of(s, chunk, sizeof(chunk) - 1);
+        }
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * total);
+}
+
+static void BM_append_of_geometric(benchmark::State& state) {
+    append_until(state, NULL);
+}
+BENCHMARK(BM_append_of_geometric)->RangeMultiplier(10)->Range(1 << 10,
+                                                                100 << 20);
+
+static void BM_append_of_linear(benchmark::State& state) {
+    append_until(state, &linear_growth);
+}
+BENCHMARK(BM_append_of_linear)->RangeMultiplier(10)->Range(1 << 10, 100 << 20);
+
+static void BM_append_std_string(benchmark::State& state) {
+    size_t total = (size_t)state.range(0);
+    for (auto _ : state) {
+        std::string s;
+        while (s.size() < total) {
+            s.append(chunk, sizeof(chunk) - 1);
+        }
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * total);
+}
+BENCHMARK(BM_append_std_string)->RangeMultiplier(10)->Range(1 << 10, 100 << 20);
+
+// 64 KB built from pieces of state.range(0) bytes: small pieces measure the
+// per-call cost, large ones the copy.
+#define PIECE_TOTAL (64 << 10)
+#define PIECE_ARGS ->Arg(1)->Arg(8)->Arg(64)->Arg(1024)
+
+static void BM_append_piece_sstr(benchmark::State& state) {
+    std::string piece(state.range(0), 'x');
+    for (auto _ : state) {
+        sstr_t s = sstr_new();
+        while (sstr_length(s) < PIECE_TOTAL) {
+            sstr_append_of(s, piece.data(), piece.size());
+        }
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * PIECE_TOTAL);
+}
+BENCHMARK(BM_append_piece_sstr) PIECE_ARGS;
+
+static void BM_append_piece_std_string(benchmark::State& state) {
+    std::string piece(state.range(0), 'x');
+    for (auto _ : state) {
+        std::string s;
+        while (s.size() < PIECE_TOTAL) {
+            s.append(piece.data(), piece.size());
+        }
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * PIECE_TOTAL);
+}
+BENCHMARK(BM_append_piece_std_string) PIECE_ARGS;
+
+// plain char*: realloc to double the capacity, memcpy, keep a '\0'.
+static void BM_append_piece_char_ptr(benchmark::State& state) {
+    std::string piece(state.range(0), 'x');
+    for (auto _ : state) {
+        size_t len = 0, cap = 16;
+        char* s = (char*)malloc(cap);
+        while (len < PIECE_TOTAL) {
+            if (len + piece.size() + 1 > cap) {
+                while (len + piece.size() + 1 > cap) {
+                    cap *= 2;
+                }
+                s = (char*)realloc(s, cap);
+            }
+            memcpy(s + len, piece.data(), piece.size());
+            len += piece.size();
+            s[len] = '\0';
+        }
+        benchmark::DoNotOptimize(s);
+        free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * PIECE_TOTAL);
+}
+BENCHMARK(BM_append_piece_char_ptr) PIECE_ARGS;
+
+// a scratch string rebuilt to state.range(0) bytes each round: freed by
+// sstr_clear(), kept by sstr_clear_keep_capacity(), reserved up front.
+static void BM_append_scratch_clear(benchmark::State& state) {
+    size_t total = (size_t)state.range(0);
+    sstr_t s = sstr_new();
+    for (auto _ : state) {
+        sstr_clear(s);
+        while (sstr_length(s) < total) {
+            sstr_append_of(s, chunk, sizeof(chunk) - 1);
+        }
+        benchmark::DoNotOptimize(sstr_cstr(s));
+    }
+    state.SetBytesProcessed(state.iterations() * total);
+    sstr_free(s);
+}
+BENCHMARK(BM_append_scratch_clear)->Arg(1 << 10)->Arg(64 << 10);
+
+static void BM_append_scratch_keep_capacity(benchmark::State& state) {
+    size_t total = (size_t)state.range(0);
+    sstr_t s = sstr_new();
+    for (auto _ : state) {
+        sstr_clear_keep_capacity(s);
+        while (sstr_length(s) < total) {
+            sstr_append_of(s, chunk, sizeof(chunk) - 1);
+        }
+        benchmark::DoNotOptimize(sstr_cstr(s));
+    }
+    state.SetBytesProcessed(state.iterations() * total);
+    sstr_free(s);
+}
+BENCHMARK(BM_append_scratch_keep_capacity)->Arg(1 << 10)->Arg(64 << 10);
+
+static void BM_append_reserved(benchmark::State& state) {
+    size_t total = (size_t)state.range(0);
+    for (auto _ : state) {
+        sstr_t s = sstr_new();
+        sstr_reserve(s, total + sizeof(chunk));
+        while (sstr_length(s) < total) {
+            sstr_append_of(s, chunk, sizeof(chunk) - 1);
+        }
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * total);
+}
+BENCHMARK(BM_append_reserved)->Arg(1 << 10)->Arg(64 << 10);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "sstr.h"
+
+// an HTTP response: a status line, a few headers and a body of the given
+// size, written to /dev/null.
+static void response_headers_append(sstr_t out, size_t length) {
+    sstr_append_cstr(out, "HTTP/1.1 200 OK\r\n");
+    sstr_printf_append(out, "Content-Length: %z\r\n", length);
+    sstr_append_cstr(out, "Content-Type: application/octet-stream\r\n");
+    sstr_append_cstr(out, "Cache-Control: no-cache\r\n");
+    sstr_printf_append(out, "X-Request-Id: %d\r\n\r\n", 123456);
+}
+
+static void BM_response_append(benchmark::State& state) {
+    sstr_t body = sstr_of(std::string(state.range(0), 'b').data(),
+                          state.range(0));
+    int fd = open("/dev/null", O_WRONLY);
+    for (auto _ : state) {
+        sstr_t out = sstr_new();
+        response_headers_append(out, sstr_length(body));
+        sstr_append(out, body);
+        benchmark::DoNotOptimize(write(fd, sstr_cstr(out), sstr_length(out)));
+        sstr_free(out);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    close(fd);
+    sstr_free(body);
+}
+BENCHMARK(BM_response_append)->Arg(1 << 10)->Arg(64 << 10)->Arg(1 << 20);
+
+// the same response as segments: the headers are copied into the builder,
+// the body is shared, and writev() sends both.
+static void BM_response_builder(benchmark::State& state) {
+    sstr_t body = sstr_of(std::string(state.range(0), 'b').data(),
+                          state.range(0));
+    int fd = open("/dev/null", O_WRONLY);
+    sstr_builder_t* b = sstr_builder_create();
+    for (auto _ : state) {
+        sstr_builder_append_of(b, "HTTP/1.1 200 OK\r\n", 17);
+        sstr_builder_printf(b, "Content-Length: %z\r\n", sstr_length(body));
+        sstr_builder_append_of(
+            b, "Content-Type: application/octet-stream\r\n", 40);
+        sstr_builder_append_of(b, "Cache-Control: no-cache\r\n", 25);
+        sstr_builder_printf(b, "X-Request-Id: %d\r\n\r\n", 123456);
+        sstr_builder_append(b, body);
+        size_t n;
+        const struct iovec* iov = sstr_builder_iovec(b, &n);
+        benchmark::DoNotOptimize(writev(fd, iov, n));
+        sstr_builder_clear(b);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    sstr_builder_destroy(b);
+    close(fd);
+    sstr_free(body);
+}
+BENCHMARK(BM_response_builder)->Arg(1 << 10)->Arg(64 << 10)->Arg(1 << 20);
@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+#include <ctype.h>
+#include <strings.h>
+
+#include <string>
+
+#include "sstr.h"
+
+// header-name sized and page sized mixed case text.
+static std::string case_text(size_t len) {
+    static const char words[] = "Content-Type X-Forwarded-For Accept ";
+    std::string s;
+    while (s.size() < len) {
+        s += words[s.size() % (sizeof(words) - 1)];
+    }
+    return s;
+}
+
+#define CASE_ARGS ->Arg(14)->Arg(4096)
+
+static void BM_tolower(benchmark::State& state) {
+    std::string in = case_text(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        sstr_tolower(s);
+        sstr_toupper(s);
+        benchmark::DoNotOptimize(sstr_cstr(s));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size() * 2);
+    sstr_free(s);
+}
+BENCHMARK(BM_tolower) CASE_ARGS;
+
+// the byte loop over sstr_cstr() sstr_tolower() replaces.
+static void BM_tolower_loop(benchmark::State& state) {
+    std::string in = case_text(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        char* p = sstr_cstr(s);
+        for (size_t i = 0; i < sstr_length(s); ++i) {
+            p[i] = (char)tolower((unsigned char)p[i]);
+        }
+        for (size_t i = 0; i < sstr_length(s); ++i) {
+            p[i] = (char)toupper((unsigned char)p[i]);
+        }
+        benchmark::DoNotOptimize(p);
+    }
+    state.SetBytesProcessed(state.iterations() * in.size() * 2);
+    sstr_free(s);
+}
+BENCHMARK(BM_tolower_loop) CASE_ARGS;
+
+static void BM_tolower_copy(benchmark::State& state) {
+    std::string in = case_text(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        sstr_t lower = sstr_tolower_copy(s);
+        benchmark::DoNotOptimize(sstr_cstr(lower));
+        sstr_free(lower);
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_tolower_copy) CASE_ARGS;
+
+static void BM_compare_nocase(benchmark::State& state) {
+    std::string in = case_text(state.range(0));
+    sstr_t a = sstr_of(in.data(), in.size());
+    sstr_t b = sstr_toupper_copy(a);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_compare_nocase(a, b));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(a);
+    sstr_free(b);
+}
+BENCHMARK(BM_compare_nocase) CASE_ARGS;
+
+static void BM_compare_nocase_strcasecmp(benchmark::State& state) {
+    std::string in = case_text(state.range(0));
+    sstr_t a = sstr_of(in.data(), in.size());
+    sstr_t b = sstr_toupper_copy(a);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(strcasecmp(sstr_cstr(a), sstr_cstr(b)));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(a);
+    sstr_free(b);
+}
+BENCHMARK(BM_compare_nocase_strcasecmp) CASE_ARGS;
+
+// a needle that is at the end, after many near misses on 'x'.
+static void BM_find_nocase(benchmark::State& state) {
+    std::string in = case_text(state.range(0)) + "X-REQUEST-ID";
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_find_nocase_of(s, "x-request-id", 12, 0));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_find_nocase) CASE_ARGS;
+
+// the lowered copy and sstr_find_of() sstr_find_nocase() replaces.
+static void BM_find_nocase_lowered_copy(benchmark::State& state) {
+    std::string in = case_text(state.range(0)) + "X-REQUEST-ID";
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        sstr_t lower = sstr_of(sstr_cstr(s), sstr_length(s));
+        char* p = sstr_cstr(lower);
+        for (size_t i = 0; i < sstr_length(lower); ++i) {
+            p[i] = (char)tolower((unsigned char)p[i]);
+        }
+        benchmark::DoNotOptimize(sstr_find_of(lower, "x-request-id", 12, 0));
+        sstr_free(lower);
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_find_nocase_lowered_copy) CASE_ARGS;
+
+static void BM_is_ascii(benchmark::State& state) {
+    std::string in = case_text(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_is_ascii(s));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_is_ascii) CASE_ARGS;
+
+static void BM_is_ascii_loop(benchmark::State& state) {
+    std::string in = case_text(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        const char* p = sstr_cstr(s);
+        int ascii = 1;
+        for (size_t i = 0; i < sstr_length(s); ++i) {
+            ascii &= (unsigned char)p[i] < 0x80;
+        }
+        benchmark::DoNotOptimize(ascii);
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_is_ascii_loop) CASE_ARGS;
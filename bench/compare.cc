@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include <string>
+
+#include "sstr.h"
+
+// equal strings, the worst case: every byte is looked at.
+#define COMPARE_ARGS ->Arg(8)->Arg(32)->Arg(4096)->Arg(64 << 10)
+
+static void BM_compare_sstr(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    sstr_t a = sstr_of(data.data(), data.size());
+    sstr_t b = sstr_of(data.data(), data.size());
+    for (auto _ : state) {
+        int r = sstr_compare(a, b);
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    sstr_free(a);
+    sstr_free(b);
+}
+BENCHMARK(BM_compare_sstr) COMPARE_ARGS;
+
+static void BM_compare_sstr_c(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    sstr_t a = sstr_of(data.data(), data.size());
+    for (auto _ : state) {
+        int r = sstr_compare_c(a, data.c_str());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    sstr_free(a);
+}
+BENCHMARK(BM_compare_sstr_c) COMPARE_ARGS;
+
+static void BM_compare_std_string(benchmark::State& state) {
+    std::string a(state.range(0), 'x');
+    std::string b(state.range(0), 'x');
+    for (auto _ : state) {
+        int r = a.compare(b);
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_compare_std_string) COMPARE_ARGS;
+
+static void BM_compare_strcmp(benchmark::State& state) {
+    std::string a(state.range(0), 'x');
+    std::string b(state.range(0), 'x');
+    for (auto _ : state) {
+        int r = strcmp(a.c_str(), b.c_str());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_compare_strcmp) COMPARE_ARGS;
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "sstr.h"
+
+// lengths to create: 8 and 28 fit the short buffer, 32 is just above it, a
+// page, 64 KB
+#define CREATE_ARGS ->Arg(8)->Arg(28)->Arg(32)->Arg(4096)->Arg(64 << 10)
+
+static void BM_create_sstr_of(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    for (auto _ : state) {
+        sstr_t s = sstr_of(data.data(), data.size());
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_create_sstr_of) CREATE_ARGS;
+
+static void BM_create_std_string(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    for (auto _ : state) {
+        std::string s(data.data(), data.size());
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_create_std_string) CREATE_ARGS;
+
+// plain char*: malloc, memcpy and a terminating '\0'.
+static void BM_create_char_ptr(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    for (auto _ : state) {
+        char* s = (char*)malloc(data.size() + 1);
+        memcpy(s, data.data(), data.size());
+        s[data.size()] = '\0';
+        benchmark::DoNotOptimize(s);
+        free(s);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_create_char_ptr) CREATE_ARGS;
+
+static void BM_create_sstr_new(benchmark::State& state) {
+    for (auto _ : state) {
+        sstr_t s = sstr_new();
+        benchmark::DoNotOptimize(s);
+        sstr_free(s);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_create_sstr_new);
+
+static void BM_create_sstr_cstr(benchmark::State& state) {
+    for (auto _ : state) {
+        sstr_t s = sstr("content-type");
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_create_sstr_cstr);
+
+static void BM_create_sstr_ref(benchmark::State& state) {
+    std::string data(4096, 'x');
+    for (auto _ : state) {
+        sstr_t s = sstr_ref(data.data(), data.size());
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_create_sstr_ref);
+
+// a stack sstr: sstr_init()/sstr_deinit() skip the struct allocation.
+static void BM_create_sstr_init(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    for (auto _ : state) {
+        struct sstr_s s;
+        sstr_init(&s);
+        sstr_append_of(&s, data.data(), data.size());
+        benchmark::DoNotOptimize(sstr_cstr(&s));
+        sstr_deinit(&s);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_create_sstr_init) CREATE_ARGS;
@@ -0,0 +1,165 @@
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "sstr.h"
+
+#define DUP_ARGS ->Arg(8)->Arg(32)->Arg(4096)->Arg(64 << 10)->Arg(1 << 20)
+
+static void BM_dup_sstr(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    sstr_t in = sstr_of(data.data(), data.size());
+    for (auto _ : state) {
+        sstr_t s = sstr_dup(in);
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    sstr_free(in);
+}
+BENCHMARK(BM_dup_sstr) DUP_ARGS;
+
+// a write to the duplicate pays for the copy sstr_dup() saved.
+static void BM_dup_sstr_then_write(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    sstr_t in = sstr_of(data.data(), data.size());
+    for (auto _ : state) {
+        sstr_t s = sstr_dup(in);
+        sstr_append_of(s, "!", 1);
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    sstr_free(in);
+}
+BENCHMARK(BM_dup_sstr_then_write) DUP_ARGS;
+
+static void BM_dup_std_string(benchmark::State& state) {
+    std::string in(state.range(0), 'x');
+    for (auto _ : state) {
+        std::string s(in);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_dup_std_string) DUP_ARGS;
+
+static void BM_dup_strdup(benchmark::State& state) {
+    std::string in(state.range(0), 'x');
+    for (auto _ : state) {
+        char* s = strdup(in.c_str());
+        benchmark::DoNotOptimize(s);
+        free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_dup_strdup) DUP_ARGS;
+
+// the middle half of the input.
+static void BM_substr_sstr(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    sstr_t in = sstr_of(data.data(), data.size());
+    size_t len = data.size() / 2;
+    for (auto _ : state) {
+        sstr_t s = sstr_substr(in, len / 2, len);
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * len);
+    sstr_free(in);
+}
+BENCHMARK(BM_substr_sstr) DUP_ARGS;
+
+static void BM_substr_std_string(benchmark::State& state) {
+    std::string in(state.range(0), 'x');
+    size_t len = in.size() / 2;
+    for (auto _ : state) {
+        std::string s = in.substr(len / 2, len);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * len);
+}
+BENCHMARK(BM_substr_std_string) DUP_ARGS;
+
+static void BM_substr_char_ptr(benchmark::State& state) {
+    std::string in(state.range(0), 'x');
+    size_t len = in.size() / 2;
+    for (auto _ : state) {
+        char* s = (char*)malloc(len + 1);
+        memcpy(s, in.data() + len / 2, len);
+        s[len] = '\0';
+        benchmark::DoNotOptimize(s);
+        free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * len);
+}
+BENCHMARK(BM_substr_char_ptr) DUP_ARGS;
+
+// an HTTP message with a 1 MB body, cut into head and body.
+static const std::string& http_message() {
+    static std::string s;
+    if (s.empty()) {
+        s = "POST /upload HTTP/1.1\r\nHost: example.com\r\n"
+            "Content-Type: application/octet-stream\r\n\r\n";
+        s.append(1 << 20, 'x');
+    }
+    return s;
+}
+
+static void BM_slice_sstr_substr(benchmark::State& state) {
+    sstr_t msg = sstr_of(http_message().data(), http_message().size());
+    for (auto _ : state) {
+        size_t end = sstr_find_of(msg, "\r\n\r\n", 4, 0);
+        sstr_t head = sstr_substr(msg, 0, end);
+        sstr_t body = sstr_substr(msg, end + 4, SSTR_NPOS);
+        benchmark::DoNotOptimize(sstr_cstr(head));
+        benchmark::DoNotOptimize(sstr_cstr(body));
+        sstr_free(head);
+        sstr_free(body);
+    }
+    sstr_free(msg);
+}
+BENCHMARK(BM_slice_sstr_substr);
+
+static void BM_slice_sstr_substr_ref(benchmark::State& state) {
+    sstr_t msg = sstr_of(http_message().data(), http_message().size());
+    for (auto _ : state) {
+        size_t end = sstr_find_of(msg, "\r\n\r\n", 4, 0);
+        sstr_t head = sstr_substr_ref(msg, 0, end);
+        sstr_t body = sstr_substr_ref(msg, end + 4, SSTR_NPOS);
+        benchmark::DoNotOptimize(sstr_cstr(head));
+        benchmark::DoNotOptimize(sstr_cstr(body));
+        sstr_free(head);
+        sstr_free(body);
+    }
+    sstr_free(msg);
+}
+BENCHMARK(BM_slice_sstr_substr_ref);
+
+static void BM_slice_sstr_view(benchmark::State& state) {
+    sstr_t msg = sstr_of(http_message().data(), http_message().size());
+    for (auto _ : state) {
+        struct sstr_s head, body;
+        size_t end = sstr_find_of(msg, "\r\n\r\n", 4, 0);
+        sstr_substr_ref_init(&head, msg, 0, end);
+        sstr_substr_ref_init(&body, msg, end + 4, SSTR_NPOS);
+        benchmark::DoNotOptimize(sstr_cstr(&head));
+        benchmark::DoNotOptimize(sstr_cstr(&body));
+    }
+    sstr_free(msg);
+}
+BENCHMARK(BM_slice_sstr_view);
+
+static void BM_slice_std_string(benchmark::State& state) {
+    const std::string& msg = http_message();
+    for (auto _ : state) {
+        size_t end = msg.find("\r\n\r\n");
+        std::string head = msg.substr(0, end);
+        std::string body = msg.substr(end + 4);
+        benchmark::DoNotOptimize(head.data());
+        benchmark::DoNotOptimize(body.data());
+    }
+}
+BENCHMARK(BM_slice_std_string);
@@ -0,0 +1,145 @@
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include <random>
+#include <string>
+
+#include "sstr.h"
+
+// one 1 MB log line of key=value pairs, the needle sits at the very end.
+static const std::string& log_line() {
+    static std::string s;
+    if (s.empty()) {
+        std::mt19937 rng(12);
+        while (s.size() < (1 << 20)) {
+            s += "ts=1679652000 level=info req_id=";
+            s += std::to_string(rng());
+            s += " path=/api/v1/items latency_ms=";
+            s += std::to_string(rng() % 1000);
+            s += ' ';
+        }
+        s += "error=timeout";
+    }
+    return s;
+}
+
+#define NEEDLE "error=timeout"
+
+static void BM_find_sstr(benchmark::State& state) {
+    const std::string& line = log_line();
+    sstr_t s = sstr_of(line.data(), line.size());
+    sstr_t needle = sstr(NEEDLE);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_find(s, needle, 0));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+    sstr_free(s);
+    sstr_free(needle);
+}
+BENCHMARK(BM_find_sstr);
+
+static void BM_find_std_string(benchmark::State& state) {
+    const std::string& line = log_line();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(line.find(NEEDLE));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_find_std_string);
+
+static void BM_find_strstr(benchmark::State& state) {
+    const std::string& line = log_line();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(strstr(line.c_str(), NEEDLE));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_find_strstr);
+
+static void BM_rfind_sstr(benchmark::State& state) {
+    const std::string& line = log_line();
+    sstr_t s = sstr_of(line.data(), line.size());
+    for (auto _ : state) {
+        // the first pair of the line
+        benchmark::DoNotOptimize(sstr_rfind_of(s, "ts=", 3, 1000));
+        benchmark::DoNotOptimize(
+            sstr_rfind_of(s, "level=debug", 11, SSTR_NPOS));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_rfind_sstr);
+
+static void BM_rfind_std_string(benchmark::State& state) {
+    const std::string& line = log_line();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(line.rfind("ts=", 1000));
+        benchmark::DoNotOptimize(line.rfind("level=debug"));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_rfind_std_string);
+
+static void BM_find_char_sstr(benchmark::State& state) {
+    const std::string& line = log_line();
+    sstr_t s = sstr_of(line.data(), line.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_find_char(s, '\n', 0));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_find_char_sstr);
+
+static void BM_rfind_char_sstr(benchmark::State& state) {
+    const std::string& line = log_line();
+    sstr_t s = sstr_of(line.data(), line.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_rfind_char(s, '\n', SSTR_NPOS));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_rfind_char_sstr);
+
+static void BM_rfind_char_std_string(benchmark::State& state) {
+    const std::string& line = log_line();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(line.rfind('\n'));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_rfind_char_std_string);
+
+// none of the bytes occurs in the line.
+#define ANY_OF "\r\n\"\\{}<>"
+
+static void BM_find_any_of_sstr(benchmark::State& state) {
+    const std::string& line = log_line();
+    sstr_t s = sstr_of(line.data(), line.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            sstr_find_any_of(s, ANY_OF, sizeof(ANY_OF) - 1, 0));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_find_any_of_sstr);
+
+static void BM_find_any_of_std_string(benchmark::State& state) {
+    const std::string& line = log_line();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(line.find_first_of(ANY_OF));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_find_any_of_std_string);
+
+static void BM_find_any_of_strpbrk(benchmark::State& state) {
+    const std::string& line = log_line();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(strpbrk(line.c_str(), ANY_OF));
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_find_any_of_strpbrk);
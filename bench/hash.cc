@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+
+#include "sstr.h"
+
+static std::string hash_input(size_t len) {
+    std::string in;
+    for (size_t i = 0; i < len; ++i) {
+        in += (char)(i * 131);
+    }
+    return in;
+}
+
+#define HASH_ARGS \
+    ->Arg(8)->Arg(32)->Arg(256)->Arg(4096)->Arg(64 << 10)
+
+static void BM_hash_of(benchmark::State& state) {
+    std::string in = hash_input(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_hash_of(in.data(), in.size(), 0));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_hash_of) HASH_ARGS;
+
+static void BM_hash_std(benchmark::State& state) {
+    std::string in = hash_input(state.range(0));
+    std::hash<std::string_view> h;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(h(std::string_view(in)));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_hash_std) HASH_ARGS;
+
+// rehashing an unchanged string hits the cache in its buffer.
+static void BM_hash_cached(benchmark::State& state) {
+    std::string in = hash_input(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_hash(s));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_hash_cached) HASH_ARGS;
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "sstr.h"
+
+// tag keys and values as found in metric labels and headers.
+static std::vector<std::string> tag_inputs(size_t n) {
+    std::vector<std::string> v;
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back("service.request.latency." + std::to_string(i % 997) +
+                    ".host-" + std::to_string(i));
+    }
+    return v;
+}
+
+// lookups of strings already interned: 1000 tags stay in cache, 100000 do
+// not.
+static void BM_intern_hit(benchmark::State& state) {
+    std::vector<std::string> in = tag_inputs(state.range(0));
+    sstr_intern_t* pool = sstr_intern_create(0);
+    for (const auto& k : in) {
+        sstr_intern_of(pool, k.data(), k.size());
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        const std::string& k = in[i++ % in.size()];
+        benchmark::DoNotOptimize(sstr_intern_of(pool, k.data(), k.size()));
+    }
+    state.SetItemsProcessed(state.iterations());
+    sstr_intern_destroy(pool);
+}
+BENCHMARK(BM_intern_hit)->Arg(1000)->Arg(100000);
+
+static void BM_intern_hit_unordered_set(benchmark::State& state) {
+    std::vector<std::string> in = tag_inputs(state.range(0));
+    std::unordered_set<std::string> set(in.begin(), in.end());
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(set.find(in[i++ % in.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_intern_hit_unordered_set)->Arg(1000)->Arg(100000);
+
+// the same lookups from several threads sharing one pool.
+static void BM_intern_hit_shared(benchmark::State& state) {
+    static std::vector<std::string> in = tag_inputs(1000);
+    static sstr_intern_t* pool = NULL;
+    if (state.thread_index() == 0 && pool == NULL) {
+        pool = sstr_intern_create(0);
+        for (const auto& k : in) {
+            sstr_intern_of(pool, k.data(), k.size());
+        }
+    }
+    size_t i = state.thread_index() * 7919;
+    for (auto _ : state) {
+        const std::string& k = in[i++ % in.size()];
+        benchmark::DoNotOptimize(sstr_intern_of(pool, k.data(), k.size()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_intern_hit_shared)->Threads(1)->Threads(4);
+
+// interning every string of a fresh pool.
+static void BM_intern_insert(benchmark::State& state) {
+    std::vector<std::string> in = tag_inputs(100000);
+    for (auto _ : state) {
+        sstr_intern_t* pool = sstr_intern_create(0);
+        for (const auto& k : in) {
+            sstr_intern_of(pool, k.data(), k.size());
+        }
+        sstr_intern_destroy(pool);
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_intern_insert);
+
+// equality of two equal tags: interned pointers against sstr_compare().
+static void BM_equal_interned(benchmark::State& state) {
+    std::string k = tag_inputs(1)[0];
+    sstr_intern_t* pool = sstr_intern_create(0);
+    sstr_t a = sstr_intern_of(pool, k.data(), k.size());
+    sstr_t b = sstr_intern_of(pool, k.data(), k.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(a == b);
+    }
+    sstr_intern_destroy(pool);
+}
+BENCHMARK(BM_equal_interned);
+
+static void BM_equal_sstr_compare(benchmark::State& state) {
+    std::string k = tag_inputs(1)[0];
+    sstr_t a = sstr_of(k.data(), k.size());
+    sstr_t b = sstr_of(k.data(), k.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(sstr_compare(a, b) == 0);
+    }
+    sstr_free(a);
+    sstr_free(b);
+}
+BENCHMARK(BM_equal_sstr_compare);
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+
+#include <random>
+#include <string>
+
+#include "sstr.h"
+
+// sstr_json_escape_string_append() of 1.1.1, byte by byte.
+static int legacy_json_escape_string_append(sstr_t out, sstr_t in) {
+    size_t i = 0;
+    unsigned char* data = (unsigned char*)sstr_cstr(in);
+    size_t in_len = sstr_length(in);
+    for (i = 0; i < in_len; ++i) {
+        if (data[i] <= 31 || data[i] == '\"' || data[i] == '\\') {
+            sstr_append_of(out, "\\", 1);
+            switch (data[i]) {
+                case '\\':
+                    sstr_append_of(out, "\\", 1);
+                    break;
+                case '\"':
+                    sstr_append_of(out, "\"", 1);
+                    break;
+                case '\b':
+                    sstr_append_of(out, "b", 1);
+                    break;
+                case '\f':
+                    sstr_append_of(out, "f", 1);
+                    break;
+                case '\n':
+                    sstr_append_of(out, "n", 1);
+                    break;
+                case '\r':
+                    sstr_append_of(out, "r", 1);
+                    break;
+                case '\t':
+                    sstr_append_of(out, "t", 1);
+                    break;
+                default: {
+                    char tmp[7] = {0};
+                    snprintf(tmp, sizeof(tmp), "u%04x", *(data + i));
+                    sstr_append_cstr(out, tmp);
+                }
+            }
+        } else {
+            size_t j;
+            for (j = i + 1; j < in_len; ++j) {
+                if (data[j] <= 31 || data[j] == '\"' || data[j] == '\\') {
+                    break;
+                }
+            }
+            sstr_append_of(out, data + i, j - i);
+            i += j - i - 1;
+        }
+    }
+    return 0;
+}
+
+// printable text with one escapable byte per `every` bytes on average.
+static sstr_t json_payload(size_t size, int every) {
+    std::mt19937 rng(9);
+    std::string s;
+    for (size_t i = 0; i < size; ++i) {
+        if (every && rng() % every == 0) {
+            s += "\"\\\n\t\x01"[rng() % 5];
+        } else {
+            s += (char)(' ' + 1 + rng() % 90);
+        }
+    }
+    return sstr_of(s.data(), s.size());
+}
+
+template <int (*Escape)(sstr_t, sstr_t)>
+static void run_escape(benchmark::State& state) {
+    sstr_t in = json_payload(state.range(0), state.range(1));
+    for (auto _ : state) {
+        sstr_t out = sstr_new();
+        Escape(out, in);
+        benchmark::DoNotOptimize(sstr_cstr(out));
+        sstr_free(out);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    sstr_free(in);
+}
+
+// 1 MB payloads: almost clean, an escape every 100 bytes, every 8 bytes
+#define JSON_ARGS \
+    ->Args({1 << 20, 0})->Args({1 << 20, 100})->Args({1 << 20, 8})
+
+static void BM_json_escape(benchmark::State& state) {
+    run_escape<sstr_json_escape_string_append>(state);
+}
+BENCHMARK(BM_json_escape) JSON_ARGS;
+
+static void BM_json_escape_legacy(benchmark::State& state) {
+    run_escape<legacy_json_escape_string_append>(state);
+}
+BENCHMARK(BM_json_escape_legacy) JSON_ARGS;
+
+static void BM_json_unescape(benchmark::State& state) {
+    sstr_t raw = json_payload(state.range(0), state.range(1));
+    sstr_t in = sstr_new();
+    sstr_json_escape_string_append(in, raw);
+    for (auto _ : state) {
+        sstr_t out = sstr_new();
+        sstr_json_unescape_string_append(out, in);
+        benchmark::DoNotOptimize(sstr_cstr(out));
+        sstr_free(out);
+    }
+    state.SetBytesProcessed(state.iterations() * sstr_length(in));
+    sstr_free(raw);
+    sstr_free(in);
+}
+BENCHMARK(BM_json_unescape) JSON_ARGS;
@@ -0,0 +1,380 @@
+/**
+ * @file legacy_printf.c
+ * @brief sstr_vslprintf_append() as of sstr 1.1.1, appending once per literal
+ * run and per formatted value. Kept as a baseline for the printf benchmarks.
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "sstr.h"
+
+#define SSTR_INT64_LEN (sizeof("-9223372036854775808") - 1)
+#define SSTR_MAX_UINT32_VALUE (uint32_t)0xffffffff
+
+sstr_t legacy_vslprintf_append(sstr_t buf, const char* fmt, va_list args);
+
+static void legacy_char_to_hex(unsigned char c, unsigned char* buf, int cap) {
+    static unsigned char hex[] = "0123456789abcdef";
+    static unsigned char HEX[] = "0123456789ABCDEF";
+
+    if (cap) {
+        buf[0] = HEX[((c >> 4) & 0x0f)];
+        buf[1] = HEX[(c & 0x0f)];
+    } else {
+        buf[0] = hex[((c >> 4) & 0x0f)];
+        buf[1] = hex[(c & 0x0f)];
+    }
+}
+
+static unsigned char* legacy_sprintf_num(unsigned char* buf,
+                                         unsigned char* last, uint64_t ui64,
+                                         unsigned char zero,
+                                         unsigned int hexadecimal,
+                                         unsigned width) {
+    unsigned char *p, temp[SSTR_INT64_LEN + 1];
+    size_t len;
+    uint32_t ui32;
+    static unsigned char hex[] = "0123456789abcdef";
+    static unsigned char HEX[] = "0123456789ABCDEF";
+
+    p = temp + SSTR_INT64_LEN;
+
+    if (hexadecimal == 0) {
+        if (ui64 <= (uint64_t)SSTR_MAX_UINT32_VALUE) {
+            ui32 = (uint32_t)ui64;
+
+            do {
+                *--p = (unsigned char)(ui32 % 10 + '0');
+            } while (ui32 /= 10);
+
+        } else {
+            do {
+                *--p = (unsigned char)(ui64 % 10 + '0');
+            } while (ui64 /= 10);
+        }
+
+    } else if (hexadecimal == 1) {
+        do {
+            *--p = hex[(uint32_t)(ui64 & 0xf)];
+        } while (ui64 >>= 4);
+
+    } else { /* hexadecimal == 2 */
+
+        do {
+            *--p = HEX[(uint32_t)(ui64 & 0xf)];
+        } while (ui64 >>= 4);
+    }
+
+    /* zero or space padding */
+
+    len = (temp + SSTR_INT64_LEN) - p;
+
+    while (len++ < width && buf < last) {
+        *buf++ = zero;
+    }
+
+    /* number safe copy */
+
+    len = (temp + SSTR_INT64_LEN) - p;
+
+    if (buf + len > last) {
+        len = last - buf;
+    }
+
+    memcpy(buf, p, len);
+    buf += len;
+    return buf;
+}
+
+sstr_t legacy_vslprintf_append(sstr_t buf, const char* fmt, va_list args) {
+    unsigned char *p, zero;
+    int d;
+    double f;
+    size_t slen;
+    size_t i;
+    int64_t i64;
+    uint64_t ui64, frac, scale;
+    unsigned int width, sign, hex, frac_width, frac_width_set, n;
+    sstr_t S;
+    /* a default d after %..x/u  */
+    int df_d;
+    unsigned char tmp[100];
+    unsigned char* ptmp;
+
+    while (*fmt) {
+        if (*fmt == '%') {
+            i64 = 0;
+            ui64 = 0;
+
+            zero = (unsigned char)((*++fmt == '0') ? '0' : ' ');
+            width = 0;
+            sign = 1;
+            hex = 0;
+            frac_width = 6;
+            frac_width_set = 0;
+            slen = (size_t)-1;
+
+            while (*fmt >= '0' && *fmt <= '9') {
+                width = width * 10 + (*fmt++ - '0');
+            }
+
+            df_d = 0;
+            for (;;) {
+                switch (*fmt) {
+                    case 'u':
+                        sign = 0;
+                        fmt++;
+                        df_d = 1;
+                        continue;
+
+                    case 'X':
+                        hex = 2;
+                        sign = 0;
+                        fmt++;
+                        df_d = 1;
+                        continue;
+
+                    case 'x':
+                        hex = 1;
+                        sign = 0;
+                        fmt++;
+                        df_d = 1;
+                        continue;
+
+                    case '.':
+                        fmt++;
+                        frac_width = 0;
+                        while (*fmt >= '0' && *fmt <= '9') {
+                            frac_width = frac_width * 10 + (*fmt++ - '0');
+                            frac_width_set = 1;
+                        }
+
+                        break;
+
+                    case '*':
+                        slen = va_arg(args, size_t);
+                        fmt++;
+                        continue;
+
+                    default:
+                        break;
+                }
+
+                break;
+            }
+
+            switch (*fmt) {
+                case 'S':
+                    S = va_arg(args, sstr_t);
+                    if (S == NULL) {
+                        p = (unsigned char*)"NULL";
+                        sstr_append_of(buf, p, 4);
+                    } else if (hex == 0) {
+                        sstr_append(buf, S);
+                    } else if (hex) {
+                        p = (unsigned char*)sstr_cstr(S);
+                        slen = sstr_length(S);
+                        for (i = 0; i < slen; ++i) {
+                            legacy_char_to_hex(p[i], tmp, hex == 2);
+                            sstr_append_of(buf, tmp, 2);
+                        }
+                    }
+
+                    fmt++;
+
+                    continue;
+
+                case 's':
+                    p = va_arg(args, unsigned char*);
+
+                    if (p == NULL) {
+                        p = (unsigned char*)"NULL";
+                    }
+
+                    if (slen == (size_t)-1) {
+                        sstr_append_of(buf, p, strlen((char*)p));
+                    } else {
+                        sstr_append_of(buf, p, slen);
+                    }
+
+                    fmt++;
+
+                    continue;
+
+                case 'T':
+                    i64 = (int64_t)va_arg(args, time_t);
+                    sign = 1;
+                    df_d = 0;
+                    break;
+
+                case 'z':
+                    if (sign) {
+                        i64 = (int64_t)va_arg(args, long);
+                    } else {
+                        ui64 = (uint64_t)va_arg(args, unsigned long);
+                    }
+                    df_d = 0;
+                    break;
+
+                case 'd':
+                    if (sign) {
+                        i64 = (int64_t)va_arg(args, int);
+                    } else {
+                        ui64 = (uint64_t)va_arg(args, unsigned int);
+                    }
+                    df_d = 0;
+                    break;
+
+                case 'l':
+                    if (sign) {
+                        i64 = (int64_t)va_arg(args, long);
+                    } else {
+                        ui64 = (uint64_t)va_arg(args, unsigned long);
+                    }
+                    df_d = 0;
+                    break;
+
+                case 'D':
+                    if (sign) {
+                        i64 = (int64_t)va_arg(args, int32_t);
+                    } else {
+                        ui64 = (uint64_t)va_arg(args, uint32_t);
+                    }
+                    df_d = 0;
+                    break;
+
+                case 'L':
+                    if (sign) {
+                        i64 = va_arg(args, int64_t);
+                    } else {
+                        ui64 = va_arg(args, uint64_t);
+                    }
+                    df_d = 0;
+                    break;
+
+                case 'f':
+                    f = va_arg(args, double);
+
+                    if (f < 0) {
+                        sstr_append_of(buf, "-", 1);
+                        f = -f;
+                    }
+
+                    ui64 = (int64_t)f;
+                    frac = 0;
+
+                    if (frac_width) {
+                        scale = 1;
+                        for (n = frac_width; n; n--) {
+                            scale *= 10;
+                        }
+
+                        frac = (uint64_t)((f - (double)ui64) * scale + 0.5);
+
+                        if (frac == scale) {
+                            ui64++;
+                            frac = 0;
+                        }
+                    }
+
+                    ptmp = legacy_sprintf_num(tmp, tmp + sizeof(tmp), ui64,
+                                              zero, 0, width);
+                    sstr_append_of(buf, tmp, ptmp - tmp);
+
+                    if (frac_width) {
+                        sstr_append_of(buf, ".", 1);
+                        ptmp = legacy_sprintf_num(tmp, tmp + sizeof(tmp),
+                                                  frac, '0', 0, frac_width);
+                        if (frac_width_set == 0) {
+                            while (ptmp > tmp && *(ptmp - 1) == '0') {
+                                ptmp--;
+                            }
+                        }
+                        sstr_append_of(buf, tmp, ptmp - tmp);
+                    }
+
+                    fmt++;
+
+                    continue;
+
+                case 'p':
+                    ui64 = (uintptr_t)va_arg(args, void*);
+                    hex = 2;
+                    sign = 0;
+                    zero = '0';
+                    width = 2 * sizeof(void*);
+                    break;
+
+                case 'c':
+                    d = va_arg(args, int);
+                    sstr_append_of(buf, (unsigned char*)&d, 1);
+                    fmt++;
+
+                    continue;
+
+                case 'Z':
+                    sstr_append_of(buf, (unsigned char*)"\0", 1);
+                    fmt++;
+
+                    continue;
+
+                case 'N':
+                    sstr_append_of(buf, (unsigned char*)"\n", 1);
+                    fmt++;
+
+                    continue;
+
+                case '%':
+                    sstr_append_of(buf, (unsigned char*)"%", 1);
+                    fmt++;
+
+                    continue;
+
+                default:
+                    if (df_d) {
+                        if (sign) {
+                            i64 = (int64_t)va_arg(args, int);
+                        } else {
+                            ui64 = (uint64_t)va_arg(args, unsigned int);
+                        }
+                        break;
+                    }
+                    if (*fmt) sstr_append_of(buf, fmt++, 1);
+
+                    continue;
+            }
+
+            if (sign) {
+                if (i64 < 0) {
+                    sstr_append_of(buf, "-", 1);
+                    ui64 = (uint64_t)-i64;
+
+                } else {
+                    ui64 = (uint64_t)i64;
+                }
+            }
+
+            ptmp = legacy_sprintf_num(tmp, tmp + sizeof(tmp), ui64, zero,
+                                      hex, width);
+            sstr_append_of(buf, tmp, ptmp - tmp);
+
+            if (df_d && *fmt) {  // %xabc not %xd, move a to buf
+                sstr_append_of(buf, fmt++, 1);
+            } else if (*fmt) {
+                fmt++;
+            }
+
+        } else {
+            ptmp = (unsigned char*)fmt;
+            while (*fmt && (*fmt) != '%') {
+                fmt++;
+            }
+            sstr_append_of(buf, ptmp, (unsigned char*)fmt - ptmp);
+        }
+    }
+
+    return buf;
+}
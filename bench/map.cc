@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sstr.h"
+
+// short keys like header names fit in the slot, long ones like URL paths
+// do not.
+static std::vector<std::string> map_keys(size_t n, bool long_keys) {
+    std::vector<std::string> v;
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(long_keys ? "/api/v2/accounts/" + std::to_string(i * 7) +
+                                    "/transactions/recent"
+                              : "hdr-" + std::to_string(i * 7));
+    }
+    return v;
+}
+
+#define MAP_ARGS                                                    \
+    ->Args({1000, 0})->Args({1000, 1})->Args({100000, 0})->Args( \
+        {100000, 1})
+
+static void BM_map_find(benchmark::State& state) {
+    std::vector<std::string> keys = map_keys(state.range(0), state.range(1));
+    sstr_map_t* m = sstr_map_create(0);
+    for (const auto& k : keys) {
+        *sstr_map_insert_of(m, k.data(), k.size()) = (void*)&k;
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        const std::string& k = keys[i++ % keys.size()];
+        benchmark::DoNotOptimize(sstr_map_find_of(m, k.data(), k.size()));
+    }
+    state.SetItemsProcessed(state.iterations());
+    sstr_map_destroy(m);
+}
+BENCHMARK(BM_map_find) MAP_ARGS;
+
+static void BM_map_find_unordered_map(benchmark::State& state) {
+    std::vector<std::string> keys = map_keys(state.range(0), state.range(1));
+    std::unordered_map<std::string, void*> m;
+    for (const auto& k : keys) {
+        m[k] = (void*)&k;
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m.find(keys[i++ % keys.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_map_find_unordered_map) MAP_ARGS;
+
+// lookups of keys that are not in the map.
+static void BM_map_miss(benchmark::State& state) {
+    std::vector<std::string> keys = map_keys(state.range(0), state.range(1));
+    sstr_map_t* m = sstr_map_create(0);
+    for (const auto& k : keys) {
+        *sstr_map_insert_of(m, k.data(), k.size()) = (void*)&k;
+    }
+    for (auto& k : keys) {
+        k += "?";
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        const std::string& k = keys[i++ % keys.size()];
+        benchmark::DoNotOptimize(sstr_map_find_of(m, k.data(), k.size()));
+    }
+    state.SetItemsProcessed(state.iterations());
+    sstr_map_destroy(m);
+}
+BENCHMARK(BM_map_miss) MAP_ARGS;
+
+static void BM_map_miss_unordered_map(benchmark::State& state) {
+    std::vector<std::string> keys = map_keys(state.range(0), state.range(1));
+    std::unordered_map<std::string, void*> m;
+    for (const auto& k : keys) {
+        m[k] = (void*)&k;
+    }
+    for (auto& k : keys) {
+        k += "?";
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m.find(keys[i++ % keys.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_map_miss_unordered_map) MAP_ARGS;
+
+static void BM_map_insert(benchmark::State& state) {
+    std::vector<std::string> keys = map_keys(state.range(0), state.range(1));
+    for (auto _ : state) {
+        sstr_map_t* m = sstr_map_create(0);
+        for (const auto& k : keys) {
+            *sstr_map_insert_of(m, k.data(), k.size()) = (void*)&k;
+        }
+        sstr_map_destroy(m);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_map_insert) MAP_ARGS;
+
+static void BM_map_insert_unordered_map(benchmark::State& state) {
+    std::vector<std::string> keys = map_keys(state.range(0), state.range(1));
+    for (auto _ : state) {
+        std::unordered_map<std::string, void*> m;
+        for (const auto& k : keys) {
+            m[k] = (void*)&k;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_map_insert_unordered_map) MAP_ARGS;
@@ -0,0 +1,351 @@
+#include <benchmark/benchmark.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <charconv>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sstr.h"
+
+extern "C" sstr_t legacy_vslprintf_append(sstr_t buf, const char* fmt,
+                                          va_list args);
+
+static void legacy_printf_append(sstr_t s, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    legacy_vslprintf_append(s, fmt, args);
+    va_end(args);
+}
+
+// sstr_append_long_str() of 1.1.1, one digit per division.
+static void legacy_append_long_str(sstr_t s, long l) {
+    unsigned char buf[21];
+    unsigned char* p = buf + 20;
+    uint64_t ui64;
+    int negative = 0;
+    if (l < 0) {
+        negative = 1;
+        ui64 = 0ULL - (uint64_t)l;
+    } else {
+        ui64 = (uint64_t)l;
+    }
+
+    do {
+        *--p = (unsigned char)(ui64 % 10 + '0');
+    } while (ui64 /= 10);
+    if (negative) {
+        sstr_append_of(s, "-", 1);
+    }
+    sstr_append_of(s, p, buf + 20 - p);
+}
+
+#define NUM_INPUTS 4096
+
+static double sstr_bench_pow10(int e) {
+    double r = 1;
+    for (; e > 0; e--) {
+        r *= 10;
+    }
+    for (; e < 0; e++) {
+        r /= 10;
+    }
+    return r;
+}
+
+// uniform over the whole range: almost every value has 18 or 19 digits.
+static const std::vector<long>& uniform_inputs() {
+    static std::vector<long> v;
+    if (v.empty()) {
+        std::mt19937_64 rng(1);
+        for (int i = 0; i < NUM_INPUTS; ++i) {
+            v.push_back((long)(rng() >> 1));
+        }
+    }
+    return v;
+}
+
+// log-uniform: every digit count is equally likely, closer to counters,
+// sizes and latencies found in log lines.
+static const std::vector<long>& log_uniform_inputs() {
+    static std::vector<long> v;
+    if (v.empty()) {
+        std::mt19937_64 rng(2);
+        for (int i = 0; i < NUM_INPUTS; ++i) {
+            v.push_back((long)((rng() >> 1) >> (rng() % 63)));
+        }
+    }
+    return v;
+}
+
+template <void (*Append)(sstr_t, long)>
+static void run_append(benchmark::State& state, const std::vector<long>& in) {
+    sstr_t s = sstr_new();
+    size_t i = 0;
+    for (auto _ : state) {
+        sstr_clear(s);
+        Append(s, in[i++ % NUM_INPUTS]);
+        benchmark::DoNotOptimize(sstr_cstr(s));
+    }
+    sstr_free(s);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_long_str_uniform(benchmark::State& state) {
+    run_append<sstr_append_long_str>(state, uniform_inputs());
+}
+BENCHMARK(BM_long_str_uniform);
+
+static void BM_long_str_uniform_legacy(benchmark::State& state) {
+    run_append<legacy_append_long_str>(state, uniform_inputs());
+}
+BENCHMARK(BM_long_str_uniform_legacy);
+
+static void BM_long_str_log_uniform(benchmark::State& state) {
+    run_append<sstr_append_long_str>(state, log_uniform_inputs());
+}
+BENCHMARK(BM_long_str_log_uniform);
+
+static void BM_long_str_log_uniform_legacy(benchmark::State& state) {
+    run_append<legacy_append_long_str>(state, log_uniform_inputs());
+}
+BENCHMARK(BM_long_str_log_uniform_legacy);
+
+static void BM_long_str_log_uniform_snprintf(benchmark::State& state) {
+    const std::vector<long>& in = log_uniform_inputs();
+    char buf[32];
+    size_t i = 0;
+    for (auto _ : state) {
+        snprintf(buf, sizeof(buf), "%ld", in[i++ % NUM_INPUTS]);
+        benchmark::DoNotOptimize(buf);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_long_str_log_uniform_snprintf);
+
+// padded printf directives go through sstr_sprintf_num().
+static void printf_num(sstr_t s, long v) {
+    sstr_printf_append(s, "%l %08l", v, v);
+}
+
+static void legacy_printf_num(sstr_t s, long v) {
+    legacy_printf_append(s, "%l %08l", v, v);
+}
+
+static void BM_printf_num_log_uniform(benchmark::State& state) {
+    run_append<printf_num>(state, log_uniform_inputs());
+}
+BENCHMARK(BM_printf_num_log_uniform);
+
+static void BM_printf_num_log_uniform_legacy(benchmark::State& state) {
+    run_append<legacy_printf_num>(state, log_uniform_inputs());
+}
+BENCHMARK(BM_printf_num_log_uniform_legacy);
+
+// sstr_append_double_str() of 1.1.1: truncating cast and multiply-by-10.
+static void legacy_append_double_str(sstr_t s, double f, int precision) {
+    unsigned char buf[21];
+    unsigned char* p = buf + 20;
+    uint64_t ui64;
+    int negative = 0;
+    double f2;
+
+    if (f < 0) {
+        negative = 1;
+        ui64 = (uint64_t)-f;
+        f2 = -f - ui64;
+    } else {
+        ui64 = (uint64_t)f;
+        f2 = f - ui64;
+    }
+    do {
+        *--p = (unsigned char)(ui64 % 10 + '0');
+    } while (ui64 /= 10);
+    if (negative) {
+        sstr_append_of(s, "-", 1);
+    }
+    sstr_append_of(s, p, buf + 20 - p);
+
+    if (f2 > 0 && f2 > 1e-6) {
+        sstr_append_of(s, ".", 1);
+        p = buf;
+        do {
+            f2 *= 10;
+            *p++ = (unsigned char)(f2 + '0');
+            f2 -= (long)f2;
+        } while (f2 > 1e-6 && f2 > 0.0 && p < buf + precision);
+        sstr_append_of(s, buf, p - buf);
+    }
+}
+
+// metric-like values: a few significant digits over many magnitudes.
+static const std::vector<double>& double_inputs() {
+    static std::vector<double> v;
+    if (v.empty()) {
+        std::mt19937_64 rng(3);
+        std::uniform_real_distribution<double> mant(1.0, 10.0);
+        for (int i = 0; i < NUM_INPUTS; ++i) {
+            v.push_back(mant(rng) * sstr_bench_pow10((int)(rng() % 12) - 4));
+        }
+    }
+    return v;
+}
+
+template <typename Append>
+static void run_double(benchmark::State& state, Append append) {
+    const std::vector<double>& in = double_inputs();
+    sstr_t s = sstr_new();
+    size_t i = 0;
+    for (auto _ : state) {
+        sstr_clear(s);
+        append(s, in[i++ % NUM_INPUTS]);
+        benchmark::DoNotOptimize(sstr_cstr(s));
+    }
+    sstr_free(s);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_double_str_6(benchmark::State& state) {
+    run_double(state,
+               [](sstr_t s, double f) { sstr_append_double_str(s, f, 6); });
+}
+BENCHMARK(BM_double_str_6);
+
+static void BM_double_str_6_legacy(benchmark::State& state) {
+    run_double(state, [](sstr_t s, double f) {
+        legacy_append_double_str(s, f, 6);
+    });
+}
+BENCHMARK(BM_double_str_6_legacy);
+
+static void BM_double_shortest(benchmark::State& state) {
+    run_double(state,
+               [](sstr_t s, double f) { sstr_append_double_shortest(s, f); });
+}
+BENCHMARK(BM_double_shortest);
+
+static void BM_double_shortest_snprintf(benchmark::State& state) {
+    run_double(state, [](sstr_t, double f) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.17g", f);
+        benchmark::DoNotOptimize(buf);
+    });
+}
+BENCHMARK(BM_double_shortest_snprintf);
+
+static void BM_printf_double(benchmark::State& state) {
+    run_double(state,
+               [](sstr_t s, double f) { sstr_printf_append(s, "%.3f", f); });
+}
+BENCHMARK(BM_printf_double);
+
+static void BM_printf_double_legacy(benchmark::State& state) {
+    run_double(state,
+               [](sstr_t s, double f) { legacy_printf_append(s, "%.3f", f); });
+}
+BENCHMARK(BM_printf_double_legacy);
+
+static void BM_printf_double_snprintf(benchmark::State& state) {
+    run_double(state, [](sstr_t, double f) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.3f", f);
+        benchmark::DoNotOptimize(buf);
+    });
+}
+BENCHMARK(BM_printf_double_snprintf);
+
+// the inputs above printed as text, one field per entry.
+template <typename T, typename Print>
+static std::vector<std::string> as_text(const std::vector<T>& in,
+                                        Print print) {
+    std::vector<std::string> out;
+    for (T v : in) {
+        out.push_back(print(v));
+    }
+    return out;
+}
+
+static const std::vector<std::string>& integer_fields() {
+    static std::vector<std::string> v = as_text(
+        log_uniform_inputs(), [](long l) { return std::to_string(l); });
+    return v;
+}
+
+static const std::vector<std::string>& double_fields() {
+    static std::vector<std::string> v =
+        as_text(double_inputs(), [](double f) {
+            sstr_t s = sstr_new();
+            sstr_append_double_shortest(s, f);
+            std::string r(sstr_cstr(s), sstr_length(s));
+            sstr_free(s);
+            return r;
+        });
+    return v;
+}
+
+template <typename Parse>
+static void run_parse(benchmark::State& state,
+                      const std::vector<std::string>& in, Parse parse) {
+    size_t i = 0, bytes = 0;
+    for (auto _ : state) {
+        const std::string& f = in[i++ % NUM_INPUTS];
+        parse(f);
+        bytes += f.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+
+static void BM_parse_i64(benchmark::State& state) {
+    run_parse(state, integer_fields(), [](const std::string& f) {
+        int64_t v = 0;
+        sstr_parse_i64_of(f.data(), f.size(), &v, NULL);
+        benchmark::DoNotOptimize(v);
+    });
+}
+BENCHMARK(BM_parse_i64);
+
+static void BM_parse_i64_strtoll(benchmark::State& state) {
+    run_parse(state, integer_fields(), [](const std::string& f) {
+        long long v = strtoll(f.c_str(), NULL, 10);
+        benchmark::DoNotOptimize(v);
+    });
+}
+BENCHMARK(BM_parse_i64_strtoll);
+
+static void BM_parse_i64_from_chars(benchmark::State& state) {
+    run_parse(state, integer_fields(), [](const std::string& f) {
+        int64_t v = 0;
+        std::from_chars(f.data(), f.data() + f.size(), v);
+        benchmark::DoNotOptimize(v);
+    });
+}
+BENCHMARK(BM_parse_i64_from_chars);
+
+static void BM_parse_f64(benchmark::State& state) {
+    run_parse(state, double_fields(), [](const std::string& f) {
+        double v = 0;
+        sstr_parse_f64_of(f.data(), f.size(), &v, NULL);
+        benchmark::DoNotOptimize(v);
+    });
+}
+BENCHMARK(BM_parse_f64);
+
+static void BM_parse_f64_strtod(benchmark::State& state) {
+    run_parse(state, double_fields(), [](const std::string& f) {
+        double v = strtod(f.c_str(), NULL);
+        benchmark::DoNotOptimize(v);
+    });
+}
+BENCHMARK(BM_parse_f64_strtod);
+
+static void BM_parse_f64_from_chars(benchmark::State& state) {
+    run_parse(state, double_fields(), [](const std::string& f) {
+        double v = 0;
+        std::from_chars(f.data(), f.data() + f.size(), v);
+        benchmark::DoNotOptimize(v);
+    });
+}
+BENCHMARK(BM_parse_f64_from_chars);
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <string>
+
+#include "sstr.h"
+#include "sstr_format.hpp"
+
+extern "C" sstr_t legacy_vslprintf_append(sstr_t buf, const char* fmt,
+                                          va_list args);
+
+static sstr_t legacy_printf(const char* fmt, ...) {
+    va_list args;
+    sstr_t res = sstr_new();
+
+    va_start(args, fmt);
+    legacy_vslprintf_append(res, fmt, args);
+    va_end(args);
+    return res;
+}
+
+#define LOG_FMT "%s [%s] %S: %s %s -> %d, %ul bytes in %d.%03d ms, peer %s:%d%N"
+#define LOG_FMT_C \
+    "%s [%s] %s: %s %s -> %d, %lu bytes in %d.%03d ms, peer %s:%d\n"
+#define LOG_ARGS(module)                                                       \
+    "2023-03-24T10:00:00Z", "INFO", module, "GET", "/api/v1/items?id=42", 200, \
+        (unsigned long)1048576, 12, 345, "10.0.0.1", 43210
+
+static void BM_printf_log_sstr(benchmark::State& state) {
+    sstr_t module = sstr("http.server");
+    for (auto _ : state) {
+        sstr_t s = sstr_printf(LOG_FMT, LOG_ARGS(module));
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    sstr_free(module);
+}
+BENCHMARK(BM_printf_log_sstr);
+
+static void BM_printf_log_legacy(benchmark::State& state) {
+    sstr_t module = sstr("http.server");
+    for (auto _ : state) {
+        sstr_t s = legacy_printf(LOG_FMT, LOG_ARGS(module));
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    sstr_free(module);
+}
+BENCHMARK(BM_printf_log_legacy);
+
+static void BM_printf_log_format(benchmark::State& state) {
+    sstr_t module = sstr("http.server");
+    for (auto _ : state) {
+        sstr_t s = sstr_fmt::format(SSTR_FMT(LOG_FMT), LOG_ARGS(module));
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    sstr_free(module);
+}
+BENCHMARK(BM_printf_log_format);
+
+static void BM_printf_log_snprintf(benchmark::State& state) {
+    char buf[256];
+    for (auto _ : state) {
+        int n = snprintf(buf, sizeof(buf), LOG_FMT_C, LOG_ARGS("http.server"));
+        benchmark::DoNotOptimize(n);
+        benchmark::DoNotOptimize(buf);
+    }
+}
+BENCHMARK(BM_printf_log_snprintf);
+
+static void BM_printf_hex_sstr(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    sstr_t in = sstr_of(data.data(), data.size());
+    for (auto _ : state) {
+        sstr_t s = sstr_printf("payload=%xS", in);
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    sstr_free(in);
+}
+BENCHMARK(BM_printf_hex_sstr)->Range(16, 4096);
+
+static void BM_printf_hex_legacy(benchmark::State& state) {
+    std::string data(state.range(0), 'x');
+    sstr_t in = sstr_of(data.data(), data.size());
+    for (auto _ : state) {
+        sstr_t s = legacy_printf("payload=%xS", in);
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    sstr_free(in);
+}
+BENCHMARK(BM_printf_hex_legacy)->Range(16, 4096);
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+
+#include "sstr.h"
+
+// 1 MB of template text with a "{{name}}" token every 32 bytes, 32768
+// matches.
+static std::string template_text() {
+    std::string t;
+    while (t.size() < (1 << 20)) {
+        t += "Hello {{name}}, welcome back. ";
+        t += "\n\n";
+    }
+    return t;
+}
+
+// replacements shorter than, as long as and longer than the token.
+static const char* replacement(int64_t kind) {
+    return kind == 0 ? "Bob" : kind == 1 ? "Jonathan" : "Alexander Hamilton";
+}
+
+#define REPLACE_ARGS ->Arg(0)->Arg(1)->Arg(2)
+
+static void BM_replace_all(benchmark::State& state) {
+    std::string in = template_text();
+    const char* r = replacement(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        sstr_t s = sstr_of(in.data(), in.size());
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(
+            sstr_replace_all_of(s, "{{name}}", 8, r, strlen(r)));
+        state.PauseTiming();
+        sstr_free(s);
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_replace_all) REPLACE_ARGS;
+
+// the rebuild replace_all replaces: sstr_find_of() and appends to a new
+// string.
+static void BM_replace_all_rebuild(benchmark::State& state) {
+    std::string in = template_text();
+    const char* r = replacement(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        sstr_t out = sstr_new();
+        size_t from = 0, pos;
+        while ((pos = sstr_find_of(s, "{{name}}", 8, from)) != SSTR_NPOS) {
+            sstr_append_of(out, sstr_cstr(s) + from, pos - from);
+            sstr_append_cstr(out, r);
+            from = pos + 8;
+        }
+        sstr_append_of(out, sstr_cstr(s) + from, sstr_length(s) - from);
+        benchmark::DoNotOptimize(sstr_cstr(out));
+        sstr_free(out);
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_replace_all_rebuild) REPLACE_ARGS;
+
+static void BM_replace_all_std_string(benchmark::State& state) {
+    std::string in = template_text();
+    std::string r = replacement(state.range(0));
+    for (auto _ : state) {
+        std::string out;
+        out.reserve(in.size());
+        size_t from = 0, pos;
+        while ((pos = in.find("{{name}}", from)) != std::string::npos) {
+            out.append(in, from, pos - from);
+            out += r;
+            from = pos + 8;
+        }
+        out.append(in, from, std::string::npos);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_replace_all_std_string) REPLACE_ARGS;
+
+// 16 bytes inserted in the middle of 1 MB and erased again.
+static void BM_insert_erase(benchmark::State& state) {
+    std::string in = template_text();
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        sstr_insert_of(s, in.size() / 2, "0123456789abcdef", 16);
+        sstr_erase(s, in.size() / 2, 16);
+    }
+    sstr_free(s);
+}
+BENCHMARK(BM_insert_erase);
+
+static void BM_insert_erase_std_string(benchmark::State& state) {
+    std::string s = template_text();
+    size_t mid = s.size() / 2;
+    for (auto _ : state) {
+        s.insert(mid, "0123456789abcdef", 16);
+        s.erase(mid, 16);
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+BENCHMARK(BM_insert_erase_std_string);
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+
+#include "sstr.h"
+
+// 16 byte inserts at random positions of a text of the given size, like an
+// editor or a template engine splicing into a large document.
+#define ROPE_ARGS ->Arg(64 << 10)->Arg(1 << 20)->Arg(4 << 20)
+
+static void BM_rope_insert(benchmark::State& state) {
+    std::string text(state.range(0), 't');
+    sstr_rope_t* r = sstr_rope_of(text.data(), text.size());
+    std::mt19937 rng(1);
+    for (auto _ : state) {
+        sstr_rope_insert_of(r, rng() % text.size(), "0123456789abcdef", 16);
+        // keep the size steady
+        sstr_rope_erase(r, rng() % text.size(), 16);
+    }
+    state.SetItemsProcessed(state.iterations());
+    sstr_rope_free(r);
+}
+BENCHMARK(BM_rope_insert) ROPE_ARGS;
+
+static void BM_rope_insert_std_string(benchmark::State& state) {
+    std::string text(state.range(0), 't');
+    std::mt19937 rng(1);
+    for (auto _ : state) {
+        text.insert(rng() % text.size(), "0123456789abcdef", 16);
+        text.erase(rng() % (text.size() - 16), 16);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_rope_insert_std_string) ROPE_ARGS;
+
+// random access after many edits have split the text into chunks.
+static void BM_rope_at(benchmark::State& state) {
+    std::string text(state.range(0), 't');
+    sstr_rope_t* r = sstr_rope_of(text.data(), text.size());
+    std::mt19937 rng(1);
+    for (int i = 0; i < 10000; ++i) {
+        sstr_rope_insert_of(r, rng() % text.size(), "0123456789abcdef", 16);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_rope_at(r, rng() % text.size()));
+    }
+    state.SetItemsProcessed(state.iterations());
+    sstr_rope_free(r);
+}
+BENCHMARK(BM_rope_at) ROPE_ARGS;
+
+static void BM_rope_flatten(benchmark::State& state) {
+    std::string text(state.range(0), 't');
+    sstr_rope_t* r = sstr_rope_of(text.data(), text.size());
+    std::mt19937 rng(1);
+    for (int i = 0; i < 1000; ++i) {
+        sstr_rope_insert_of(r, rng() % text.size(), "0123456789abcdef", 16);
+    }
+    for (auto _ : state) {
+        sstr_t s = sstr_rope_flatten(r);
+        benchmark::DoNotOptimize(sstr_cstr(s));
+        sstr_free(s);
+    }
+    state.SetBytesProcessed(state.iterations() * sstr_rope_length(r));
+    sstr_rope_free(r);
+}
+BENCHMARK(BM_rope_flatten) ROPE_ARGS;
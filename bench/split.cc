@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "sstr.h"
+
+// a CSV record of 1000 short fields: ids, words and prices.
+static const std::string& csv_line() {
+    static std::string s;
+    if (s.empty()) {
+        std::mt19937 rng(13);
+        static const char* words[] = {"alpha", "beta", "gamma", "delta"};
+        for (int i = 0; i < 1000; ++i) {
+            if (i) {
+                s += ',';
+            }
+            switch (i % 3) {
+                case 0:
+                    s += std::to_string(rng() % 100000);
+                    break;
+                case 1:
+                    s += words[rng() % 4];
+                    break;
+                default:
+                    s += std::to_string(rng() % 1000) + ".99";
+            }
+        }
+    }
+    return s;
+}
+
+template <typename Split>
+static void run_split(benchmark::State& state, Split split) {
+    const std::string& line = csv_line();
+    size_t fields = 0;
+    for (auto _ : state) {
+        fields += split(line);
+    }
+    state.SetItemsProcessed(fields);
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+
+static void BM_split_sstr(benchmark::State& state) {
+    sstr_t s = sstr_of(csv_line().data(), csv_line().size());
+    run_split(state, [s](const std::string&) {
+        sstr_split_t it;
+        sstr_t field;
+        size_t n = 0;
+        sstr_split_init(&it, s, ",", 1, 0);
+        while ((field = sstr_split_next(&it)) != NULL) {
+            benchmark::DoNotOptimize(sstr_cstr(field));
+            n++;
+        }
+        return n;
+    });
+    sstr_free(s);
+}
+BENCHMARK(BM_split_sstr);
+
+static void BM_split_sstr_any_of(benchmark::State& state) {
+    sstr_t s = sstr_of(csv_line().data(), csv_line().size());
+    run_split(state, [s](const std::string&) {
+        sstr_split_t it;
+        sstr_t field;
+        size_t n = 0;
+        sstr_split_init(&it, s, ",;",
+                        2, SSTR_SPLIT_ANY_OF | SSTR_SPLIT_SKIP_EMPTY);
+        while ((field = sstr_split_next(&it)) != NULL) {
+            benchmark::DoNotOptimize(sstr_cstr(field));
+            n++;
+        }
+        return n;
+    });
+    sstr_free(s);
+}
+BENCHMARK(BM_split_sstr_any_of);
+
+// the way fields were cut before: a copy per field.
+static void BM_split_sstr_substr(benchmark::State& state) {
+    sstr_t s = sstr_of(csv_line().data(), csv_line().size());
+    run_split(state, [s](const std::string&) {
+        size_t n = 0, start = 0, end;
+        for (;;) {
+            end = sstr_find_char(s, ',', start);
+            sstr_t field = sstr_substr(
+                s, start, (end == SSTR_NPOS ? sstr_length(s) : end) - start);
+            benchmark::DoNotOptimize(sstr_cstr(field));
+            sstr_free(field);
+            n++;
+            if (end == SSTR_NPOS) {
+                return n;
+            }
+            start = end + 1;
+        }
+    });
+    sstr_free(s);
+}
+BENCHMARK(BM_split_sstr_substr);
+
+// strtok_r() writes into the line, so it works on a copy.
+template <size_t N>
+static size_t strtok_fields(const std::string& line, const char (&delim)[N]) {
+    static std::string copy;
+    char *save, *tok;
+    size_t n = 0;
+    copy = line;
+    for (tok = strtok_r(&copy[0], delim, &save); tok;
+         tok = strtok_r(NULL, delim, &save)) {
+        benchmark::DoNotOptimize(tok);
+        n++;
+    }
+    return n;
+}
+
+static void BM_split_strtok(benchmark::State& state) {
+    run_split(state, [](const std::string& line) {
+        return strtok_fields(line, ",");
+    });
+}
+BENCHMARK(BM_split_strtok);
+
+static void BM_split_strtok_any_of(benchmark::State& state) {
+    run_split(state, [](const std::string& line) {
+        return strtok_fields(line, ",;");
+    });
+}
+BENCHMARK(BM_split_strtok_any_of);
+
+static void BM_split_string_view(benchmark::State& state) {
+    run_split(state, [](const std::string& line) {
+        std::string_view v(line);
+        size_t n = 0, start = 0, end;
+        for (;;) {
+            end = v.find(',', start);
+            benchmark::DoNotOptimize(v.substr(start, end - start).data());
+            n++;
+            if (end == std::string_view::npos) {
+                return n;
+            }
+            start = end + 1;
+        }
+    });
+}
+BENCHMARK(BM_split_string_view);
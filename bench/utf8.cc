@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "sstr.h"
+
+// 1 MB of ASCII log lines, or of mixed Latin, CJK and emoji text.
+static std::string utf8_text(int64_t mixed) {
+    const char* line = mixed ? "caf\xc3\xa9 \xe4\xb8\xad\xe6\x96\x87 "
+                               "\xf0\x9f\x98\x80 na\xc3\xafve text\n"
+                             : "GET /index.html HTTP/1.1 200 5120\n";
+    std::string s;
+    while (s.size() < (1 << 20)) {
+        s += line;
+    }
+    return s;
+}
+
+#define UTF8_ARGS ->Arg(0)->Arg(1)
+
+// a decoder one codepoint at a time, what the validation replaces.
+static bool utf8_valid_loop(const unsigned char* p, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        unsigned char c = p[i];
+        size_t len = c < 0x80 ? 1 : c < 0xC2 ? 0 : c < 0xE0 ? 2 : c < 0xF0 ? 3
+                                                  : c < 0xF5 ? 4 : 0;
+        if (len == 0 || i + len > n) {
+            return false;
+        }
+        for (size_t k = 1; k < len; ++k) {
+            if ((p[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        if ((c == 0xE0 && p[i + 1] < 0xA0) || (c == 0xED && p[i + 1] > 0x9F) ||
+            (c == 0xF0 && p[i + 1] < 0x90) || (c == 0xF4 && p[i + 1] > 0x8F)) {
+            return false;
+        }
+        i += len;
+    }
+    return true;
+}
+
+static void BM_utf8_valid(benchmark::State& state) {
+    std::string in = utf8_text(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_utf8_valid(s));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_utf8_valid) UTF8_ARGS;
+
+static void BM_utf8_valid_loop(benchmark::State& state) {
+    std::string in = utf8_text(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            utf8_valid_loop((const unsigned char*)in.data(), in.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_utf8_valid_loop) UTF8_ARGS;
+
+static void BM_utf8_count(benchmark::State& state) {
+    std::string in = utf8_text(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_utf8_count(s));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_utf8_count) UTF8_ARGS;
+
+static void BM_utf8_count_loop(benchmark::State& state) {
+    std::string in = utf8_text(state.range(0));
+    for (auto _ : state) {
+        size_t n = 0;
+        for (unsigned char c : in) {
+            n += (c & 0xC0) != 0x80;
+        }
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_utf8_count_loop) UTF8_ARGS;
+
+static void BM_utf8_to_utf16(benchmark::State& state) {
+    std::string in = utf8_text(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    std::vector<uint16_t> out(sstr_utf8_to_utf16(s, NULL, 0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sstr_utf8_to_utf16(s, out.data(), out.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_utf8_to_utf16) UTF8_ARGS;
+
+static void BM_append_utf16(benchmark::State& state) {
+    std::string in = utf8_text(state.range(0));
+    sstr_t s = sstr_of(in.data(), in.size());
+    std::vector<uint16_t> units(sstr_utf8_to_utf16(s, NULL, 0));
+    sstr_utf8_to_utf16(s, units.data(), units.size());
+    for (auto _ : state) {
+        sstr_t out = sstr_new();
+        sstr_append_utf16(out, units.data(), units.size());
+        benchmark::DoNotOptimize(sstr_cstr(out));
+        sstr_free(out);
+    }
+    state.SetBytesProcessed(state.iterations() * in.size());
+    sstr_free(s);
+}
+BENCHMARK(BM_append_utf16) UTF8_ARGS;
@@ -6,24 +6,58 @@
 #include "sstr.h"
 
 #include <assert.h>
-#include <ctype.h>
+#include <float.h>
+#include <limits.h>
 #include <malloc.h>
+#include <math.h>
+#include <pthread.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <time.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #define STR struct sstr_s
 #define SSTR(s) ((STR*)(s))
 
-#define STR_PTR(s)                                                        \
-    ((SSTR(s))->type == SSTR_TYPE_SHORT                                   \
-         ? (SSTR(s))->un.short_str                                        \
-         : (SSTR(s)->type == SSTR_TYPE_LONG ? (SSTR(s)->un.long_str.data) \
-                                            : (SSTR(s)->un.ref_str.data)))
+// the last byte of the header, see struct sstr_s.
+#define STR_LAST(s) (((unsigned char*)(s))[SHORT_STR_CAPACITY])
+#define STR_TYPE(s) (STR_LAST(s) >> 6)
+#define STR_IS_SHORT(s) (STR_LAST(s) < 0x40)
+// set in the last byte of SHORT strings with an allocator.
+#define STR_SHORT_ALLOC 0x20
+// the content of SHORT strings with an allocator starts after it, LONG,
+// SHARED and REF strings all point to theirs.
+#define STR_PTR(s)                                                     \
+    (STR_IS_SHORT(s)                                                   \
+         ? SSTR(s)->un.short_str +                                     \
+               (STR_LAST(s) & STR_SHORT_ALLOC ? sizeof(void*) : 0)     \
+         : SSTR(s)->un.heap.data)
+#define STR_ALLOCATOR(s) \
+    (STR_LAST(s) < STR_SHORT_ALLOC ? NULL : SSTR(s)->un.heap.allocator)
+#define STR_GROWTH(s) (STR_IS_SHORT(s) ? NULL : SSTR(s)->un.heap.growth)
+// content and its capacity of the SHORT strings of allocator a.
+#define STR_SHORT_PTR(s, a) \
+    ((a) ? SSTR(s)->un.short_alloc.str : SSTR(s)->un.short_str)
+#define STR_SHORT_CAPACITY(a) \
+    ((a) ? SSTR_SHORT_ALLOC_CAPACITY : (size_t)SHORT_STR_CAPACITY)
+
+_Static_assert(sizeof(STR) == SHORT_STR_CAPACITY + 1,
+               "the last byte of struct sstr_s tells the types apart");
 
 static void char_to_hex(unsigned char c, unsigned char* buf, int cap) {
     static unsigned char hex[] = "0123456789abcdef";
@@ -38,10 +72,185 @@ static void char_to_hex(unsigned char c, unsigned char* buf, int cap) {
     }
 }
 
-sstr_t sstr_new() {
-    STR* s = (STR*)malloc(sizeof(STR));
-    memset(s, 0, sizeof(STR));
-    return s;
+static const sstr_allocator_t* sstr_global_allocator = NULL;
+
+static void* sstr_mem_alloc(const sstr_allocator_t* a, size_t size) {
+    return a ? a->alloc(a->ctx, size) : malloc(size);
+}
+
+static void* sstr_mem_realloc(const sstr_allocator_t* a, void* ptr,
+                              size_t old_size, size_t new_size) {
+    return a ? a->realloc(a->ctx, ptr, old_size, new_size)
+             : realloc(ptr, new_size);
+}
+
+static void sstr_mem_free(const sstr_allocator_t* a, void* ptr, size_t size) {
+    if (a) {
+        a->free(a->ctx, ptr, size);
+    } else {
+        free(ptr);
+    }
+}
+
+// Every long buffer starts with this prefix, un.heap.data points right after
+// it. A buffer of capacity cap takes sizeof(sstr_buf_t) + cap + 1 bytes.
+typedef struct sstr_buf_s {
+    // number of strings using the buffer. Always 1 for SSTR_TYPE_LONG, a
+    // SSTR_TYPE_SHARED string may see any count, the last one frees it.
+    atomic_size_t refs;
+    // sstr_hash() of the content, 0 if not computed. Every write to the
+    // buffer goes through sstr_grow(), which resets it.
+    _Atomic(uint64_t) hash;
+    // bytes the buffer can hold, not counting the null-terminal.
+    size_t capacity;
+} sstr_buf_t;
+
+#define SSTR_BUF_OF(data) ((sstr_buf_t*)(data)-1)
+
+// empty LONG strings point here rather than to a buffer of their own, so
+// STR_PTR() never gives NULL. It is never written nor freed, the first
+// write to such a string allocates.
+static struct {
+    sstr_buf_t buf;
+    char data[1];
+} sstr_empty_buf = {{1, 0, 0}, {0}};
+
+#define SSTR_EMPTY_DATA (sstr_empty_buf.data)
+
+static char* sstr_buf_alloc(const sstr_allocator_t* a, size_t cap) {
+    sstr_buf_t* b =
+        (sstr_buf_t*)sstr_mem_alloc(a, sizeof(sstr_buf_t) + cap + 1);
+    atomic_init(&b->refs, 1);
+    atomic_init(&b->hash, 0);
+    b->capacity = cap;
+    return (char*)(b + 1);
+}
+
+static char* sstr_buf_realloc(const sstr_allocator_t* a, char* data,
+                              size_t cap) {
+    sstr_buf_t* b;
+
+    if (data == SSTR_EMPTY_DATA) {
+        return sstr_buf_alloc(a, cap);
+    }
+    b = (sstr_buf_t*)sstr_mem_realloc(
+        a, SSTR_BUF_OF(data),
+        sizeof(sstr_buf_t) + SSTR_BUF_OF(data)->capacity + 1,
+        sizeof(sstr_buf_t) + cap + 1);
+    b->capacity = cap;
+    return (char*)(b + 1);
+}
+
+static void sstr_buf_free(const sstr_allocator_t* a, char* data) {
+    if (data != SSTR_EMPTY_DATA) {
+        sstr_mem_free(a, SSTR_BUF_OF(data),
+                      sizeof(sstr_buf_t) + SSTR_BUF_OF(data)->capacity + 1);
+    }
+}
+
+// make ss a SHORT string of allocator a, of the length bytes already at
+// STR_SHORT_PTR(). The null-terminal is written.
+static void sstr_set_short(STR* ss, const sstr_allocator_t* a,
+                           size_t length) {
+    if (a == NULL) {
+        ss->un.short_str[length] = '\0';
+        STR_LAST(ss) = (unsigned char)(SHORT_STR_CAPACITY - length);
+    } else {
+        ss->un.short_alloc.allocator = a;
+        ss->un.short_alloc.str[length] = '\0';
+        STR_LAST(ss) = (unsigned char)(STR_SHORT_ALLOC |
+                                       (SSTR_SHORT_ALLOC_CAPACITY - length));
+    }
+}
+
+// set the length of ss, its type is kept. The content and the null-terminal
+// are the business of the caller.
+static void sstr_set_length(STR* ss, size_t length) {
+    if (STR_LAST(ss) < STR_SHORT_ALLOC) {
+        STR_LAST(ss) = (unsigned char)(SHORT_STR_CAPACITY - length);
+    } else if (STR_IS_SHORT(ss)) {
+        STR_LAST(ss) = (unsigned char)(STR_SHORT_ALLOC |
+                                       (SSTR_SHORT_ALLOC_CAPACITY - length));
+    } else {
+        ss->un.heap.tag = SSTR_TAG(length, STR_TYPE(ss));
+    }
+}
+
+// change the type of the non-SHORT ss, its length is kept.
+static void sstr_set_type(STR* ss, int type) {
+    ss->un.heap.tag = SSTR_TAG(SSTR_TAG_LENGTH(ss->un.heap.tag), type);
+}
+
+// make ss empty. It is SHORT unless it has a growth policy.
+static STR* sstr_set_empty(STR* ss, const sstr_allocator_t* allocator,
+                           const sstr_growth_t* growth) {
+    if (growth == NULL) {
+        sstr_set_short(ss, allocator, 0);
+    } else {
+        ss->un.heap.data = SSTR_EMPTY_DATA;
+        ss->un.heap.allocator = allocator;
+        ss->un.heap.growth = growth;
+        ss->un.heap.tag = SSTR_TAG(0, SSTR_TYPE_LONG);
+    }
+    return ss;
+}
+
+// move the content of the SHORT ss out to a buffer of capacity cap.
+static void sstr_unshort(STR* ss, size_t cap) {
+    const sstr_allocator_t* a = STR_ALLOCATOR(ss);
+    size_t length = sstr_length(ss);
+    char* data = cap ? sstr_buf_alloc(a, cap) : SSTR_EMPTY_DATA;
+
+    if (cap) {
+        memcpy(data, STR_PTR(ss), length);
+        data[length] = '\0';
+    }
+    ss->un.heap.data = data;
+    ss->un.heap.allocator = a;
+    ss->un.heap.growth = NULL;
+    ss->un.heap.tag = SSTR_TAG(length, SSTR_TYPE_LONG);
+}
+
+void sstr_set_default_allocator(const sstr_allocator_t* allocator) {
+    sstr_global_allocator = allocator;
+}
+
+const sstr_allocator_t* sstr_default_allocator() {
+    return sstr_global_allocator;
+}
+
+sstr_t sstr_new_alloc(const sstr_allocator_t* allocator) {
+    STR* s = (STR*)sstr_mem_alloc(allocator, sizeof(STR));
+    return sstr_set_empty(s, allocator, NULL);
+}
+
+sstr_t sstr_new() { return sstr_new_alloc(sstr_global_allocator); }
+
+void sstr_init_alloc(struct sstr_s* s, const sstr_allocator_t* allocator) {
+    sstr_set_empty(s, allocator, NULL);
+}
+
+void sstr_init(struct sstr_s* s) { sstr_init_alloc(s, sstr_global_allocator); }
+
+// release the long buffer of ss, if any. A shared buffer is freed by the
+// last string that releases it.
+static void sstr_free_buffer(STR* ss) {
+    switch (STR_TYPE(ss)) {
+        case SSTR_TYPE_LONG:
+            sstr_buf_free(ss->un.heap.allocator, ss->un.heap.data);
+            break;
+        case SSTR_TYPE_SHARED:
+            if (atomic_fetch_sub_explicit(&SSTR_BUF_OF(ss->un.heap.data)->refs,
+                                          1, memory_order_acq_rel) == 1) {
+                sstr_buf_free(ss->un.heap.allocator, ss->un.heap.data);
+            }
+            break;
+    }
+}
+
+void sstr_deinit(struct sstr_s* s) {
+    sstr_free_buffer(s);
+    sstr_init_alloc(s, STR_ALLOCATOR(s));
 }
 
 void sstr_free(sstr_t s) {
@@ -49,34 +258,61 @@ void sstr_free(sstr_t s) {
         return;
     }
     STR* ss = (STR*)s;
-    if (ss->type == SSTR_TYPE_LONG) {
-        free(ss->un.long_str.data);
+    sstr_free_buffer(ss);
+    sstr_mem_free(STR_ALLOCATOR(ss), s, sizeof(STR));
+}
+
+// give the empty s a copy of data, through the allocator of s.
+static STR* sstr_set_copy(STR* s, const void* data, size_t length) {
+    if (STR_IS_SHORT(s)) {
+        const sstr_allocator_t* a = STR_ALLOCATOR(s);
+        if (length <= STR_SHORT_CAPACITY(a)) {
+            memcpy(STR_SHORT_PTR(s, a), data, length);
+            sstr_set_short(s, a, length);
+            return s;
+        }
+        s->un.heap.allocator = a;
+        s->un.heap.growth = NULL;
+    }
+    if (length) {
+        s->un.heap.data = sstr_buf_alloc(s->un.heap.allocator, length);
+        memcpy(s->un.heap.data, data, length);
+        s->un.heap.data[length] = '\0';
     }
-    free(s);
+    s->un.heap.tag = SSTR_TAG(length, SSTR_TYPE_LONG);
+    return s;
+}
+
+sstr_t sstr_of_alloc(const sstr_allocator_t* allocator, const void* data,
+                     size_t length) {
+    return sstr_set_copy((STR*)sstr_new_alloc(allocator), data, length);
 }
 
 sstr_t sstr_of(const void* data, size_t length) {
-    STR* s = (STR*)sstr_new();
-    if (length <= SHORT_STR_CAPACITY) {
-        memcpy(s->un.short_str, data, length);
-        s->un.short_str[length] = '\0';
-        s->type = SSTR_TYPE_SHORT;
-    } else {
-        s->un.long_str.data = (char*)malloc(length + 1);
-        memcpy(s->un.long_str.data, data, length);
-        s->un.long_str.capacity = length;
-        s->un.long_str.data[length] = '\0';
-        s->type = SSTR_TYPE_LONG;
+    return sstr_of_alloc(sstr_global_allocator, data, length);
+}
+
+// make the empty s a reference to data, the allocator and growth of s are
+// kept.
+static STR* sstr_set_ref(STR* s, const void* data, size_t length) {
+    if (STR_IS_SHORT(s)) {
+        s->un.heap.allocator = STR_ALLOCATOR(s);
+        s->un.heap.growth = NULL;
     }
-    s->length = length;
+    s->un.heap.data = (char*)data;
+    s->un.heap.tag = SSTR_TAG(length, SSTR_TYPE_REF);
     return s;
 }
 
 sstr_t sstr_ref(const void* data, size_t length) {
-    STR* s = (STR*)sstr_new();
-    s->un.ref_str.data = (char*)data;
-    s->length = length;
-    s->type = SSTR_TYPE_REF;
+    return sstr_set_ref((STR*)sstr_new(), data, length);
+}
+
+sstr_t sstr_ref_init(struct sstr_s* s, const void* data, size_t length) {
+    s->un.heap.data = (char*)data;
+    s->un.heap.allocator = NULL;
+    s->un.heap.growth = NULL;
+    s->un.heap.tag = SSTR_TAG(length, SSTR_TYPE_REF);
     return s;
 }
 
@@ -121,48 +357,166 @@ int sstr_compare_c(sstr_t a, const char* b) {
     return alen > blen;
 }
 
-void sstr_append_zero(sstr_t s, size_t length) {
-    STR* ss = (STR*)s;
+static const sstr_growth_t sstr_builtin_growth = {1.5, CAP_ADD_DELTA, 0};
+static const sstr_growth_t* sstr_global_growth = &sstr_builtin_growth;
 
-    assert(ss->type != SSTR_TYPE_REF);
+void sstr_set_default_growth(const sstr_growth_t* growth) {
+    sstr_global_growth = growth ? growth : &sstr_builtin_growth;
+}
 
-    if (ss->type == SSTR_TYPE_SHORT) {
-        if (ss->length + length <= SHORT_STR_CAPACITY) {
-            memset(ss->un.short_str + ss->length, 0, length + 1);
-            ss->length += length;
-            return;
-        } else {
-            char* ldata =
-                (char*)malloc(length + ss->length + CAP_ADD_DELTA + 1);
-            memcpy(ldata, ss->un.short_str, ss->length);
-            memset(ldata + ss->length, 0, length + 1);
-            ss->un.long_str.data = ldata;
-            ss->un.long_str.capacity = length + ss->length + CAP_ADD_DELTA;
-            ss->length += length;
-            ss->type = SSTR_TYPE_LONG;
+const sstr_growth_t* sstr_default_growth() { return sstr_global_growth; }
+
+void sstr_set_growth(sstr_t s, const sstr_growth_t* growth) {
+    STR* ss = SSTR(s);
+
+    if (STR_IS_SHORT(ss)) {
+        if (growth == NULL) {
             return;
         }
-    } else {
-        if (ss->un.long_str.capacity - ss->length > length) {
-            memset(ss->un.long_str.data + ss->length, 0, length + 1);
-            ss->length += length;
-            return;
-        } else {
-            ss->un.long_str.data = (char*)realloc(
-                STR_PTR(s), length + ss->length + CAP_ADD_DELTA + 1);
-            ss->un.long_str.capacity = length + ss->length + CAP_ADD_DELTA + 1;
-            memset(ss->un.long_str.data + ss->length, 0, length + 1);
-            ss->length += length;
-            return;
+        // the header has no room for the policy next to the content
+        sstr_unshort(ss, sstr_length(ss));
+    }
+    ss->un.heap.growth = growth;
+}
+
+// compute the new capacity of ss, growing from capacity to hold at least need
+// bytes, following the growth policy of ss.
+static size_t sstr_next_capacity(STR* ss, size_t capacity, size_t need) {
+    const sstr_growth_t* g =
+        STR_GROWTH(ss) ? STR_GROWTH(ss) : sstr_global_growth;
+    size_t step = 0;
+    size_t cap;
+
+    if (g->factor > 1.0) {
+        step = (size_t)((double)capacity * (g->factor - 1.0));
+    }
+    if (step < g->min_step) {
+        step = g->min_step;
+    }
+    if (g->max_step && step > g->max_step) {
+        step = g->max_step;
+    }
+    cap = capacity + step;
+    if (cap < need) {
+        cap = need + g->min_step;
+    }
+    if (cap < need) {  // overflow
+        cap = need;
+    }
+    return cap;
+}
+
+// give the SHARED ss a buffer of its own before it is written, with room for
+// need bytes. The sole owner takes the buffer over, others copy it.
+static void sstr_unshare(STR* ss, size_t need) {
+    char* data = ss->un.heap.data;
+    size_t cap = SSTR_BUF_OF(data)->capacity;
+
+    if (atomic_load_explicit(&SSTR_BUF_OF(data)->refs, memory_order_acquire) ==
+        1) {
+        sstr_set_type(ss, SSTR_TYPE_LONG);
+        return;
+    }
+    if (need > cap) {
+        cap = sstr_next_capacity(ss, cap, need);
+    }
+    ss->un.heap.data = sstr_buf_alloc(ss->un.heap.allocator, cap);
+    memcpy(ss->un.heap.data, data, sstr_length(ss) + 1);
+    if (atomic_fetch_sub_explicit(&SSTR_BUF_OF(data)->refs, 1,
+                                  memory_order_acq_rel) == 1) {
+        // the other owners let go meanwhile
+        sstr_buf_free(ss->un.heap.allocator, data);
+    }
+    sstr_set_type(ss, SSTR_TYPE_LONG);
+}
+
+// the content of the LONG ss is about to change, forget its cached hash.
+static void sstr_hash_forget(STR* ss) {
+    atomic_store_explicit(&SSTR_BUF_OF(ss->un.heap.data)->hash, 0,
+                          memory_order_relaxed);
+}
+
+// make sure ss has room for length more bytes, the content, length and the
+// null-terminal are kept.
+static void sstr_grow(STR* ss, size_t length) {
+    size_t need = sstr_length(ss) + length;
+    size_t cap;
+
+    assert(STR_TYPE(ss) != SSTR_TYPE_REF);
+
+    if (STR_IS_SHORT(ss)) {
+        cap = STR_SHORT_CAPACITY(STR_ALLOCATOR(ss));
+        if (need > cap) {
+            sstr_unshort(ss, sstr_next_capacity(ss, cap, need));
         }
+        return;
+    }
+    if (STR_TYPE(ss) == SSTR_TYPE_SHARED) {
+        sstr_unshare(ss, need);
+    }
+    cap = SSTR_BUF_OF(ss->un.heap.data)->capacity;
+    if (need > cap || ss->un.heap.data == SSTR_EMPTY_DATA) {
+        ss->un.heap.data =
+            sstr_buf_realloc(ss->un.heap.allocator, ss->un.heap.data,
+                             sstr_next_capacity(ss, cap, need));
+    }
+    // the caller is about to write
+    sstr_hash_forget(ss);
+}
+
+// number of bytes ss can hold without reallocation.
+static size_t sstr_capacity_of(STR* ss) {
+    switch (STR_TYPE(ss)) {
+        case SSTR_TYPE_SHORT:
+            return STR_SHORT_CAPACITY(STR_ALLOCATOR(ss));
+        case SSTR_TYPE_REF:
+            return sstr_length(ss);
+        default:
+            return SSTR_BUF_OF(ss->un.heap.data)->capacity;
     }
 }
 
+void sstr_append_zero(sstr_t s, size_t length) {
+    STR* ss = (STR*)s;
+    size_t old = sstr_length(ss);
+
+    sstr_grow(ss, length);
+    memset(STR_PTR(ss) + old, 0, length + 1);
+    sstr_set_length(ss, old + length);
+}
+
 void sstr_append_of(sstr_t s, const void* data, size_t length) {
-    size_t oldlen = sstr_length(s);
-    sstr_append_zero(s, length);
-    memcpy(STR_PTR(s) + oldlen, data, length);
-    STR_PTR(s)[sstr_length(s)] = '\0';
+    STR* ss = (STR*)s;
+    unsigned char last = STR_LAST(ss);
+    size_t old;
+    char* p;
+
+    // fast paths: room left in a buffer of our own, or in the header
+    if (STR_TYPE(ss) == SSTR_TYPE_LONG) {
+        old = SSTR_TAG_LENGTH(ss->un.heap.tag);
+        p = ss->un.heap.data;
+        if (length <= SSTR_BUF_OF(p)->capacity - old &&
+            p != SSTR_EMPTY_DATA) {
+            sstr_hash_forget(ss);
+            memcpy(p + old, data, length);
+            p[old + length] = '\0';
+            ss->un.heap.tag = SSTR_TAG(old + length, SSTR_TYPE_LONG);
+            return;
+        }
+    } else if (last < STR_SHORT_ALLOC && length <= last) {
+        p = ss->un.short_str + (SHORT_STR_CAPACITY - last);
+        memcpy(p, data, length);
+        p[length] = '\0';
+        STR_LAST(ss) = (unsigned char)(last - length);
+        return;
+    }
+
+    old = sstr_length(ss);
+    sstr_grow(ss, length);
+    p = STR_PTR(ss) + old;
+    memcpy(p, data, length);
+    p[length] = '\0';
+    sstr_set_length(ss, old + length);
 }
 
 void sstr_append(sstr_t dst, sstr_t src) {
@@ -173,659 +527,6062 @@ void sstr_append_cstr(sstr_t dst, const char* src) {
     sstr_append_of(dst, src, strlen(src));
 }
 
-sstr_t sstr_dup(sstr_t s) { return sstr_of(STR_PTR(s), sstr_length(s)); }
+// make data, a buffer of allocator a holding length bytes, the content of
+// ss. The old buffer of ss is released, its growth policy is kept.
+static void sstr_set_buffer(STR* ss, const sstr_allocator_t* a, char* data,
+                            size_t length) {
+    if (STR_IS_SHORT(ss)) {
+        ss->un.heap.allocator = a;
+        ss->un.heap.growth = NULL;
+    } else {
+        sstr_free_buffer(ss);
+    }
+    ss->un.heap.data = data;
+    ss->un.heap.tag = SSTR_TAG(length, SSTR_TYPE_LONG);
+}
 
-sstr_t sstr_substr(sstr_t s, size_t index, size_t len) {
-    size_t minlen = len;
-    size_t str_len = sstr_length(s);
-    if (index > str_len) {
-        return sstr_new();
+// ss is about to be written in place. Return 0 if it can not be: its
+// buffer is still shared with other strings.
+static int sstr_writable(STR* ss) {
+    assert(STR_TYPE(ss) != SSTR_TYPE_REF);
+
+    if (STR_IS_SHORT(ss)) {
+        return 1;
     }
-    if (index + minlen > str_len) {
-        minlen = str_len - index;
+    if (STR_TYPE(ss) == SSTR_TYPE_SHARED) {
+        if (atomic_load_explicit(&SSTR_BUF_OF(ss->un.heap.data)->refs,
+                                 memory_order_acquire) != 1) {
+            return 0;
+        }
+        // the other owners let go, the buffer is ours
+        sstr_set_type(ss, SSTR_TYPE_LONG);
     }
-    return sstr_of(STR_PTR(s) + index, minlen);
+    sstr_hash_forget(ss);
+    return 1;
 }
 
-void sstr_clear(sstr_t s) {
-    STR* ss = (STR*)s;
+// replace the erase bytes at index of ss with a gap of insert bytes, return
+// the gap. The bytes after it move once: in place, or straight into a new
+// buffer when ss is short of room or shares its buffer. At least one of
+// erase and insert is not 0.
+static char* sstr_splice(STR* ss, size_t index, size_t erase, size_t insert) {
+    size_t length = sstr_length(ss);
+    size_t need = length - erase + insert;
+    size_t cap = sstr_capacity_of(ss);
+    char* p = STR_PTR(ss);
+    char* data;
 
-    switch (ss->type) {
-        case SSTR_TYPE_REF:
-            ss->length = 0;
-            ss->un.ref_str.data = NULL;
-            break;
-        case SSTR_TYPE_SHORT:
-            ss->length = 0;
-            ss->un.short_str[0] = 0;
-            break;
-        case SSTR_TYPE_LONG:
-            ss->length = 0;
-            free(ss->un.long_str.data);
-            ss->un.long_str.data = NULL;
-            ss->un.long_str.capacity = 0;
-            break;
+    if (need > cap || !sstr_writable(ss)) {
+        const sstr_allocator_t* a = STR_ALLOCATOR(ss);
+        data = sstr_buf_alloc(
+            a, need > cap ? sstr_next_capacity(ss, cap, need) : cap);
+        memcpy(data, p, index);
+        memcpy(data + index + insert, p + index + erase,
+               length - index - erase);
+        data[need] = '\0';
+        sstr_set_buffer(ss, a, data, need);
+        return data + index;
     }
+    memmove(p + index + insert, p + index + erase, length - index - erase);
+    p[need] = '\0';
+    sstr_set_length(ss, need);
+    return p + index;
 }
 
-static unsigned char* sstr_sprintf_num(unsigned char* buf, unsigned char* last,
-                                       uint64_t ui64, unsigned char zero,
-                                       unsigned int hexadecimal,
-                                       unsigned width);
+void sstr_insert_of(sstr_t s, size_t index, const void* data, size_t length) {
+    STR* ss = SSTR(s);
+    const char* p = STR_PTR(ss);
+    size_t len = sstr_length(ss);
+    struct sstr_s tmp;
 
-sstr_t sstr_printf(const char* fmt, ...) {
-    va_list args;
-    sstr_t res;
+    if (length == 0) {
+        return;
+    }
+    if (index > len) {
+        index = len;
+    }
+    if ((const char*)data < p + len && (const char*)data + length > p) {
+        // data is a part of s, which is about to move
+        sstr_init(&tmp);
+        sstr_append_of(&tmp, data, length);
+        memcpy(sstr_splice(ss, index, 0, length), STR_PTR(&tmp), length);
+        sstr_deinit(&tmp);
+        return;
+    }
+    memcpy(sstr_splice(ss, index, 0, length), data, length);
+}
 
-    va_start(args, fmt);
-    res = sstr_vslprintf(fmt, args);
-    va_end(args);
-    return res;
+void sstr_insert(sstr_t s, size_t index, sstr_t src) {
+    sstr_insert_of(s, index, STR_PTR(src), sstr_length(src));
 }
 
-sstr_t sstr_printf_append(sstr_t buf, const char* fmt, ...) {
-    va_list args;
-    sstr_t res;
+void sstr_erase(sstr_t s, size_t index, size_t length) {
+    size_t len = sstr_length(s);
 
-    va_start(args, fmt);
-    res = sstr_vslprintf_append(buf, fmt, args);
-    va_end(args);
-    return res;
+    if (index >= len || length == 0) {
+        return;
+    }
+    if (length > len - index) {
+        length = len - index;
+    }
+    sstr_splice(SSTR(s), index, length, 0);
 }
 
-sstr_t sstr_vslprintf(const char* fmt, va_list args) {
-    sstr_t res = sstr_new();
-    sstr_vslprintf_append(res, fmt, args);
-    return res;
+// ss has a long buffer of its own or shared, that sstr_share() can share.
+#define STR_SHAREABLE(ss)                                                   \
+    ((STR_TYPE(ss) == SSTR_TYPE_LONG || STR_TYPE(ss) == SSTR_TYPE_SHARED) && \
+     (ss)->un.heap.data != SSTR_EMPTY_DATA)
+
+// make the header d a SHARED copy of the STR_SHAREABLE() ss, the first
+// write to either string copies the buffer. A SHARED ss is only read, rope
+// leaves are shared this way by several threads.
+static STR* sstr_share(STR* ss, STR* d) {
+    atomic_fetch_add_explicit(&SSTR_BUF_OF(ss->un.heap.data)->refs, 1,
+                              memory_order_relaxed);
+    if (STR_TYPE(ss) != SSTR_TYPE_SHARED) {
+        sstr_set_type(ss, SSTR_TYPE_SHARED);
+    }
+    d->un.heap = ss->un.heap;
+    d->un.heap.growth = NULL;
+    return d;
 }
 
-sstr_t sstr_vslprintf_append(sstr_t buf, const char* fmt, va_list args) {
-    unsigned char *p, zero;
-    int d;
-    double f;
-    size_t slen;
-    size_t i;
-    int64_t i64;
-    uint64_t ui64, frac, scale;
-    unsigned int width, sign, hex, frac_width, frac_width_set, n;
-    STR* S;
-    /* a default d after %..x/u  */
-    int df_d;
-    unsigned char tmp[100];
-    unsigned char* ptmp;
+sstr_t sstr_dup(sstr_t s) {
+    STR* ss = SSTR(s);
 
-    while (*fmt) {
-        if (*fmt == '%') {
-            i64 = 0;
-            ui64 = 0;
+    if (!STR_SHAREABLE(ss)) {
+        return sstr_of_alloc(STR_ALLOCATOR(ss), STR_PTR(s), sstr_length(s));
+    }
+    return sstr_share(
+        ss, (STR*)sstr_mem_alloc(ss->un.heap.allocator, sizeof(STR)));
+}
 
-            zero = (unsigned char)((*++fmt == '0') ? '0' : ' ');
-            width = 0;
-            sign = 1;
-            hex = 0;
-            frac_width = 6;
-            frac_width_set = 0;
-            slen = (size_t)-1;
+// clamp the substring [*index, *index + len) to the content of s, return
+// its length. An index past the end becomes the end.
+static size_t sstr_substr_range(sstr_t s, size_t* index, size_t len) {
+    size_t str_len = sstr_length(s);
 
-            while (*fmt >= '0' && *fmt <= '9') {
-                width = width * 10 + (*fmt++ - '0');
-            }
+    if (*index > str_len) {
+        *index = str_len;
+    }
+    if (len > str_len - *index) {
+        len = str_len - *index;
+    }
+    return len;
+}
 
-            df_d = 0;
-            for (;;) {
-                switch (*fmt) {
-                    case 'u':
-                        sign = 0;
-                        fmt++;
-                        df_d = 1;
-                        continue;
+sstr_t sstr_substr(sstr_t s, size_t index, size_t len) {
+    if (index > sstr_length(s)) {
+        return sstr_new_alloc(STR_ALLOCATOR(s));
+    }
+    len = sstr_substr_range(s, &index, len);
+    return sstr_of_alloc(STR_ALLOCATOR(s), STR_PTR(s) + index, len);
+}
 
-                    case 'X':
-                        hex = 2;
-                        sign = 0;
-                        fmt++;
-                        df_d = 1;
-                        continue;
+sstr_t sstr_substr_ref(sstr_t s, size_t index, size_t len) {
+    len = sstr_substr_range(s, &index, len);
+    return sstr_set_ref((STR*)sstr_new_alloc(STR_ALLOCATOR(s)),
+                        STR_PTR(s) + index, len);
+}
 
-                    case 'x':
-                        hex = 1;
-                        sign = 0;
-                        fmt++;
-                        df_d = 1;
-                        continue;
+sstr_t sstr_substr_ref_init(struct sstr_s* view, sstr_t s, size_t index,
+                            size_t len) {
+    len = sstr_substr_range(s, &index, len);
+    return sstr_ref_init(view, STR_PTR(s) + index, len);
+}
 
-                    case '.':
-                        fmt++;
-                        frac_width = 0;
-                        while (*fmt >= '0' && *fmt <= '9') {
-                            frac_width = frac_width * 10 + (*fmt++ - '0');
-                            frac_width_set = 1;
-                        }
+void sstr_clear(sstr_t s) {
+    STR* ss = (STR*)s;
 
-                        break;
+    switch (STR_TYPE(ss)) {
+        case SSTR_TYPE_SHORT:
+            sstr_set_short(ss, STR_ALLOCATOR(ss), 0);
+            break;
+        case SSTR_TYPE_REF:
+            ss->un.heap.data = SSTR_EMPTY_DATA;
+            ss->un.heap.tag = SSTR_TAG(0, SSTR_TYPE_REF);
+            break;
+        default:
+            // a shared buffer is let go, nothing to copy
+            sstr_free_buffer(ss);
+            sstr_set_empty(ss, ss->un.heap.allocator, ss->un.heap.growth);
+            break;
+    }
+}
 
-                    case '*':
-                        slen = va_arg(args, size_t);
-                        fmt++;
-                        continue;
+void sstr_clear_keep_capacity(sstr_t s) {
+    STR* ss = (STR*)s;
 
-                    default:
-                        break;
-                }
+    // the sole owner of a shared buffer may write to it
+    if (STR_TYPE(ss) == SSTR_TYPE_SHARED &&
+        atomic_load_explicit(&SSTR_BUF_OF(ss->un.heap.data)->refs,
+                             memory_order_acquire) == 1) {
+        sstr_set_type(ss, SSTR_TYPE_LONG);
+    }
+    if (STR_TYPE(ss) != SSTR_TYPE_LONG || ss->un.heap.data == SSTR_EMPTY_DATA) {
+        sstr_clear(s);
+        return;
+    }
+    sstr_hash_forget(ss);
+    ss->un.heap.data[0] = '\0';
+    ss->un.heap.tag = SSTR_TAG(0, SSTR_TYPE_LONG);
+}
 
-                break;
+size_t sstr_capacity(sstr_t s) { return sstr_capacity_of(SSTR(s)); }
+
+void sstr_reserve(sstr_t s, size_t capacity) {
+    STR* ss = (STR*)s;
+
+    switch (STR_TYPE(ss)) {
+        case SSTR_TYPE_REF:
+            return;
+        case SSTR_TYPE_SHORT:
+            if (capacity > STR_SHORT_CAPACITY(STR_ALLOCATOR(ss))) {
+                sstr_unshort(ss, capacity);
             }
+            return;
+        case SSTR_TYPE_SHARED:
+            // writes are coming, get a buffer of our own now
+            sstr_unshare(ss, capacity);
+            break;
+    }
+    if (capacity > SSTR_BUF_OF(ss->un.heap.data)->capacity) {
+        ss->un.heap.data = sstr_buf_realloc(ss->un.heap.allocator,
+                                            ss->un.heap.data, capacity);
+        ss->un.heap.data[sstr_length(ss)] = '\0';
+    }
+}
 
-            switch (*fmt) {
-                case 'S':
-                    S = va_arg(args, STR*);
-                    if (S == NULL) {
-                        p = (unsigned char*)"NULL";
-                        sstr_append_of(buf, p, 4);
-                    } else if (hex == 0) {
-                        sstr_append(buf, S);
-                    } else if (hex) {
-                        p = (unsigned char*)STR_PTR(S);
-                        slen = sstr_length(S);
-                        for (i = 0; i < slen; ++i) {
-                            char_to_hex(p[i], tmp, hex == 2);
-                            sstr_append_of(buf, tmp, 2);
-                        }
-                    }
+void sstr_shrink_to_fit(sstr_t s) {
+    STR* ss = (STR*)s;
+    const sstr_allocator_t* a;
+    size_t length = sstr_length(ss);
+    char tmp[SHORT_STR_CAPACITY];
 
-                    fmt++;
+    if (STR_TYPE(ss) != SSTR_TYPE_LONG && STR_TYPE(ss) != SSTR_TYPE_SHARED) {
+        return;
+    }
+    a = ss->un.heap.allocator;
+    if (length <= STR_SHORT_CAPACITY(a) && ss->un.heap.growth == NULL) {
+        // move the content back into the header
+        memcpy(tmp, ss->un.heap.data, length);
+        sstr_free_buffer(ss);
+        memcpy(STR_SHORT_PTR(ss, a), tmp, length);
+        sstr_set_short(ss, a, length);
+    } else if (length == 0) {
+        sstr_free_buffer(ss);
+        ss->un.heap.data = SSTR_EMPTY_DATA;
+        ss->un.heap.tag = SSTR_TAG(0, SSTR_TYPE_LONG);
+    } else if (STR_TYPE(ss) == SSTR_TYPE_LONG &&
+               SSTR_BUF_OF(ss->un.heap.data)->capacity > length) {
+        ss->un.heap.data =
+            sstr_buf_realloc(ss->un.heap.allocator, ss->un.heap.data, length);
+    }
+}
 
-                    continue;
+#define SSTR_ARENA_ALIGN 16
+#define SSTR_ARENA_ALIGN_UP(n) \
+    (((n) + SSTR_ARENA_ALIGN - 1) & ~(size_t)(SSTR_ARENA_ALIGN - 1))
 
-                case 's':
-                    p = va_arg(args, unsigned char*);
+struct sstr_arena_block_s {
+    struct sstr_arena_block_s* next;
+    size_t size;
+    size_t used;
+};
 
-                    if (p == NULL) {
-                        p = (unsigned char*)"NULL";
-                    }
+#define SSTR_ARENA_BLOCK_HDR \
+    SSTR_ARENA_ALIGN_UP(sizeof(struct sstr_arena_block_s))
+#define SSTR_ARENA_BLOCK_DATA(b) ((char*)(b) + SSTR_ARENA_BLOCK_HDR)
 
-                    if (slen == (size_t)-1) {
-                        sstr_append_of(buf, p, strlen((char*)p));
-                    } else {
-                        sstr_append_of(buf, p, slen);
-                    }
+struct sstr_arena_s {
+    sstr_allocator_t allocator;
+    size_t block_size;
+    struct sstr_arena_block_s* head;
+    struct sstr_arena_block_s* cur;
+    // the most recent allocation, it can grow or be freed in place.
+    char* last;
+};
 
-                    fmt++;
+static void* sstr_arena_alloc(void* ctx, size_t size) {
+    sstr_arena_t* arena = (sstr_arena_t*)ctx;
+    struct sstr_arena_block_s* b = arena->cur;
+    char* p;
 
-                    continue;
+    size = SSTR_ARENA_ALIGN_UP(size);
+    if (b->size - b->used < size) {
+        // blocks after cur are unused, take the next one if large enough.
+        if (b->next && b->next->size >= size) {
+            b = b->next;
+        } else {
+            size_t bsize = size > arena->block_size ? size : arena->block_size;
+            struct sstr_arena_block_s* nb = (struct sstr_arena_block_s*)malloc(
+                SSTR_ARENA_BLOCK_HDR + bsize);
+            nb->size = bsize;
+            nb->used = 0;
+            nb->next = b->next;
+            b->next = nb;
+            b = nb;
+        }
+        arena->cur = b;
+    }
+    p = SSTR_ARENA_BLOCK_DATA(b) + b->used;
+    b->used += size;
+    arena->last = p;
+    return p;
+}
 
-                case 'T':
-                    i64 = (int64_t)va_arg(args, time_t);
-                    sign = 1;
-                    df_d = 0;
-                    break;
+static void* sstr_arena_realloc(void* ctx, void* ptr, size_t old_size,
+                                size_t new_size) {
+    sstr_arena_t* arena = (sstr_arena_t*)ctx;
+    struct sstr_arena_block_s* b = arena->cur;
+    void* p;
 
-                case 'z':
-                    if (sign) {
-                        i64 = (int64_t)va_arg(args, long);
-                    } else {
-                        ui64 = (uint64_t)va_arg(args, unsigned long);
-                    }
-                    df_d = 0;
-                    break;
+    if (ptr == NULL) {
+        return sstr_arena_alloc(ctx, new_size);
+    }
+    if (new_size <= old_size) {
+        return ptr;
+    }
+    if (ptr == arena->last) {
+        size_t offset = (char*)ptr - SSTR_ARENA_BLOCK_DATA(b);
+        if (b->size - offset >= SSTR_ARENA_ALIGN_UP(new_size)) {
+            b->used = offset + SSTR_ARENA_ALIGN_UP(new_size);
+            return ptr;
+        }
+    }
+    p = sstr_arena_alloc(ctx, new_size);
+    memcpy(p, ptr, old_size);
+    return p;
+}
 
-                case 'd':
-                    if (sign) {
-                        i64 = (int64_t)va_arg(args, int);
-                    } else {
-                        ui64 = (uint64_t)va_arg(args, unsigned int);
-                    }
-                    df_d = 0;
-                    break;
+static void sstr_arena_free(void* ctx, void* ptr, size_t size) {
+    sstr_arena_t* arena = (sstr_arena_t*)ctx;
+    (void)size;
 
-                case 'l':
-                    if (sign) {
-                        i64 = (int64_t)va_arg(args, long);
-                    } else {
-                        ui64 = (uint64_t)va_arg(args, unsigned long);
-                    }
-                    df_d = 0;
-                    break;
+    if (ptr == arena->last) {
+        arena->cur->used = (char*)ptr - SSTR_ARENA_BLOCK_DATA(arena->cur);
+        arena->last = NULL;
+    }
+}
 
-                case 'D':
-                    if (sign) {
-                        i64 = (int64_t)va_arg(args, int32_t);
-                    } else {
-                        ui64 = (uint64_t)va_arg(args, uint32_t);
-                    }
-                    df_d = 0;
-                    break;
+sstr_arena_t* sstr_arena_create(size_t block_size) {
+    sstr_arena_t* arena = (sstr_arena_t*)malloc(sizeof(sstr_arena_t));
 
-                case 'L':
-                    if (sign) {
-                        i64 = va_arg(args, int64_t);
-                    } else {
-                        ui64 = va_arg(args, uint64_t);
-                    }
-                    df_d = 0;
-                    break;
+    if (block_size == 0) {
+        block_size = SSTR_ARENA_BLOCK_SIZE;
+    }
+    arena->allocator.alloc = sstr_arena_alloc;
+    arena->allocator.realloc = sstr_arena_realloc;
+    arena->allocator.free = sstr_arena_free;
+    arena->allocator.ctx = arena;
+    arena->block_size = SSTR_ARENA_ALIGN_UP(block_size);
+    arena->head = (struct sstr_arena_block_s*)malloc(SSTR_ARENA_BLOCK_HDR +
+                                                     arena->block_size);
+    arena->head->next = NULL;
+    arena->head->size = arena->block_size;
+    arena->head->used = 0;
+    arena->cur = arena->head;
+    arena->last = NULL;
+    return arena;
+}
 
-                case 'f':
-                    f = va_arg(args, double);
+void sstr_arena_reset(sstr_arena_t* arena) {
+    struct sstr_arena_block_s* b;
 
-                    if (f < 0) {
-                        sstr_append_of(buf, "-", 1);
-                        f = -f;
-                    }
+    for (b = arena->head; b; b = b->next) {
+        b->used = 0;
+    }
+    arena->cur = arena->head;
+    arena->last = NULL;
+}
 
-                    ui64 = (int64_t)f;
-                    frac = 0;
+void sstr_arena_destroy(sstr_arena_t* arena) {
+    struct sstr_arena_block_s* b;
 
-                    if (frac_width) {
-                        scale = 1;
-                        for (n = frac_width; n; n--) {
-                            scale *= 10;
-                        }
+    if (arena == NULL) {
+        return;
+    }
+    b = arena->head;
+    while (b) {
+        struct sstr_arena_block_s* next = b->next;
+        free(b);
+        b = next;
+    }
+    free(arena);
+}
 
-                        frac = (uint64_t)((f - (double)ui64) * scale + 0.5);
+const sstr_allocator_t* sstr_arena_allocator(sstr_arena_t* arena) {
+    return &arena->allocator;
+}
 
-                        if (frac == scale) {
-                            ui64++;
-                            frac = 0;
-                        }
-                    }
+sstr_t sstr_arena_new(sstr_arena_t* arena) {
+    return sstr_new_alloc(&arena->allocator);
+}
 
-                    ptmp = sstr_sprintf_num(tmp, tmp + sizeof(tmp), ui64, zero,
-                                            0, width);
-                    sstr_append_of(buf, tmp, ptmp - tmp);
-
-                    if (frac_width) {
-                        sstr_append_of(buf, ".", 1);
-                        ptmp = sstr_sprintf_num(tmp, tmp + sizeof(tmp), frac,
-                                                '0', 0, frac_width);
-                        if (frac_width_set == 0) {
-                            while (ptmp > tmp && *(ptmp - 1) == '0') {
-                                ptmp--;
-                            }
-                        }
-                        sstr_append_of(buf, tmp, ptmp - tmp);
-                    }
+sstr_t sstr_arena_of(sstr_arena_t* arena, const void* data, size_t length) {
+    return sstr_of_alloc(&arena->allocator, data, length);
+}
 
-                    fmt++;
+sstr_t sstr_arena_printf(sstr_arena_t* arena, const char* fmt, ...) {
+    va_list args;
+    sstr_t res = sstr_new_alloc(&arena->allocator);
 
-                    continue;
+    va_start(args, fmt);
+    sstr_vslprintf_append(res, fmt, args);
+    va_end(args);
+    return res;
+}
 
-                case 'p':
-                    ui64 = (uintptr_t)va_arg(args, void*);
-                    hex = 2;
-                    sign = 0;
-                    zero = '0';
-                    width = 2 * sizeof(void*);
-                    break;
+#define SSTR_INT32_LEN (sizeof("-2147483648") - 1)
+#define SSTR_INT64_LEN (sizeof("-9223372036854775808") - 1)
 
-                case 'c':
-                    d = va_arg(args, int);
-                    sstr_append_of(buf, (unsigned char*)&d, 1);
-                    fmt++;
+#define SSTR_MAX_UINT32_VALUE (uint32_t)0xffffffff
+#define SSTR_MAX_INT32_VALUE (uint32_t)0x7fffffff
+
+// "00" "01" ... "99", two ASCII digits per entry, so the decimal writers
+// below emit a digit pair per division instead of a single digit.
+static const char sstr_digit_pairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint64_t sstr_pow10[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+// v must not be 0.
+static unsigned sstr_clz64(uint64_t v) {
+#if defined(__GNUC__)
+    return (unsigned)__builtin_clzll(v);
+#else
+    unsigned n = 0;
+    while (!(v & 0x8000000000000000ULL)) {
+        v <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief number of decimal digits of \a v, 1 for 0.
+ *
+ * log10(v) is estimated from the bit length (1233 / 4096 ~ log10(2)), then
+ * corrected by one comparison against the power of ten table.
+ */
+static unsigned sstr_count_digits(uint64_t v) {
+    unsigned t;
+    if (v < 10) {
+        return 1;
+    }
+    t = ((64 - sstr_clz64(v)) * 1233) >> 12;
+    return t + (v >= sstr_pow10[t]);
+}
+
+/**
+ * @brief write the decimal digits of \a v so that the last one lands just
+ * before \a end. The caller must provide sstr_count_digits(v) bytes.
+ * @return pointer to the first digit.
+ */
+static unsigned char* sstr_write_dec(unsigned char* end, uint64_t v) {
+    uint32_t v32;
+    unsigned i;
+
+    while (v > (uint64_t)SSTR_MAX_UINT32_VALUE) {
+        i = (unsigned)(v % 100) * 2;
+        v /= 100;
+        end -= 2;
+        memcpy(end, sstr_digit_pairs + i, 2);
+    }
+
+    /* 32-bit divisions are cheaper, finish in that range */
+    v32 = (uint32_t)v;
+    while (v32 >= 100) {
+        i = (v32 % 100) * 2;
+        v32 /= 100;
+        end -= 2;
+        memcpy(end, sstr_digit_pairs + i, 2);
+    }
+    if (v32 >= 10) {
+        end -= 2;
+        memcpy(end, sstr_digit_pairs + v32 * 2, 2);
+    } else {
+        *--end = (unsigned char)('0' + v32);
+    }
+    return end;
+}
+
+static unsigned char* sstr_sprintf_num(unsigned char* buf, unsigned char* last,
+                                       uint64_t ui64, unsigned char zero,
+                                       unsigned int hexadecimal,
+                                       unsigned width);
+
+sstr_t sstr_printf(const char* fmt, ...) {
+    va_list args;
+    sstr_t res;
+
+    va_start(args, fmt);
+    res = sstr_vslprintf(fmt, args);
+    va_end(args);
+    return res;
+}
+
+sstr_t sstr_printf_append(sstr_t buf, const char* fmt, ...) {
+    va_list args;
+    sstr_t res;
+
+    va_start(args, fmt);
+    res = sstr_vslprintf_append(buf, fmt, args);
+    va_end(args);
+    return res;
+}
+
+sstr_t sstr_vslprintf(const char* fmt, va_list args) {
+    sstr_t res = sstr_new();
+    sstr_vslprintf_append(res, fmt, args);
+    return res;
+}
+
+// size of the buffer sstr_format_num() writes to.
+#define SSTR_FORMAT_LEN 256
+
+// format a number directive into buf, return the end of output.
+static unsigned char* sstr_format_num(unsigned char* buf, uint64_t ui64,
+                                      int negative, unsigned char zero,
+                                      unsigned int hexadecimal,
+                                      unsigned width) {
+    unsigned char* p = buf;
+
+    if (negative) {
+        *p++ = '-';
+    }
+    return sstr_sprintf_num(p, buf + 100, ui64, zero, hexadecimal, width);
+}
+
+/*
+ * Floating point formatting.
+ *
+ * A finite double is exactly m * 2^e. sstr_format_fixed() prints that value
+ * rounded half to even to frac_width digits, the same digits glibc prints.
+ * Fractions of at most 60 bits are expanded with uint64_t arithmetic, others
+ * with a small bignum. sstr_format_shortest() runs Grisu3 (F. Loitsch,
+ * "Printing Floating-Point Numbers Quickly and Accurately with Integers"),
+ * which either proves its digits are the shortest that read back to the same
+ * double, or gives up. For the about 0.5% of inputs it gives up on, the digits
+ * are generated exactly with the same bignum (R. Burger and R. Dybvig,
+ * "Printing Floating-Point Numbers Quickly and Accurately").
+ */
+
+#define SSTR_DBL_SIGN_MASK 0x8000000000000000ULL
+#define SSTR_DBL_EXP_MASK 0x7FF0000000000000ULL
+#define SSTR_DBL_FRAC_MASK 0x000FFFFFFFFFFFFFULL
+#define SSTR_DBL_HIDDEN_BIT 0x0010000000000000ULL
+#define SSTR_DBL_FRAC_BITS 52
+#define SSTR_DBL_EXP_BIAS 1075
+
+// size of a sstr_format_shortest() result: "-0.00000" and 17 digits, or 17
+// digits, a dot and "e-308".
+#define SSTR_SHORTEST_LEN 32
+
+static uint64_t sstr_double_bits(double f) {
+    uint64_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// v must not be 0.
+static unsigned sstr_ctz64(uint64_t v) {
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctzll(v);
+#else
+    unsigned n = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// nan and inf, spelled like glibc and padded with spaces to width.
+static unsigned char* sstr_format_special(unsigned char* p, uint64_t bits,
+                                          unsigned width) {
+    const char* s = (bits & SSTR_DBL_FRAC_MASK) ? "nan" : "inf";
+    for (; width > 3; width--) {
+        *p++ = ' ';
+    }
+    memcpy(p, s, 3);
+    return p + 3;
+}
+
+// little endian base 2^32 natural number, wide enough for 2^1024, and for the
+// 1074 bit fraction of the smallest subnormal times 10.
+#define SSTR_BIG_LIMBS 36
+
+typedef struct {
+    uint32_t d[SSTR_BIG_LIMBS];
+    int n;
+} sstr_big_t;
+
+// big = m * 2^e, m < 2^53, e < 1088.
+static void sstr_big_shl(sstr_big_t* big, uint64_t m, unsigned e) {
+    unsigned w = e / 32, b = e % 32;
+
+    memset(big->d, 0, sizeof(big->d));
+    big->d[w] = (uint32_t)(m << b);
+    if (b == 0) {
+        big->d[w + 1] = (uint32_t)(m >> 32);
+    } else {
+        big->d[w + 1] = (uint32_t)(m >> (32 - b));
+        big->d[w + 2] = (uint32_t)(m >> (64 - b));
+    }
+    big->n = (int)w + 3;
+    while (big->n && big->d[big->n - 1] == 0) {
+        big->n--;
+    }
+}
+
+// big /= div, return the remainder.
+static uint32_t sstr_big_divmod(sstr_big_t* big, uint32_t div) {
+    uint64_t cur = 0;
+    int i;
+
+    for (i = big->n - 1; i >= 0; --i) {
+        cur = (cur << 32) | big->d[i];
+        big->d[i] = (uint32_t)(cur / div);
+        cur %= div;
+    }
+    while (big->n && big->d[big->n - 1] == 0) {
+        big->n--;
+    }
+    return (uint32_t)cur;
+}
+
+// print m * 2^e, e > 11, in decimal with the integer padding of %f.
+static unsigned char* sstr_format_big_int(unsigned char* p, uint64_t m,
+                                          unsigned e, unsigned char zero,
+                                          unsigned width) {
+    sstr_big_t big;
+    uint32_t chunk[SSTR_BIG_LIMBS + 2];  // base 10^9, least significant first
+    unsigned char *q, *w;
+    unsigned len;
+    int nc = 0, i;
+
+    sstr_big_shl(&big, m, e);
+    while (big.n) {
+        chunk[nc++] = sstr_big_divmod(&big, 1000000000);
+    }
+
+    len = sstr_count_digits(chunk[nc - 1]) + 9 * (unsigned)(nc - 1);
+    for (; width > len; width--) {
+        *p++ = zero;
+    }
+    for (i = nc - 1; i >= 0; --i) {
+        q = p + (i == nc - 1 ? sstr_count_digits(chunk[i]) : 9);
+        w = sstr_write_dec(q, chunk[i]);
+        while (w > p) {
+            *--w = '0';
+        }
+        p = q;
+    }
+    return p;
+}
+
+// next decimal digit of the fraction big / 2^k, big keeps the rest.
+static unsigned sstr_big_next_digit(sstr_big_t* big, unsigned k) {
+    unsigned w = k / 32, b = k % 32;
+    uint64_t carry = 0;
+    unsigned d;
+    int i;
+
+    for (i = 0; i < big->n; ++i) {
+        carry += (uint64_t)big->d[i] * 10;
+        big->d[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    d = (unsigned)((((uint64_t)big->d[w + 1] << 32) | big->d[w]) >> b);
+    big->d[w] &= (uint32_t)((1ULL << b) - 1);
+    big->d[w + 1] = 0;
+    return d;
+}
+
+// compare the fraction big / 2^k with 1/2.
+static int sstr_big_cmp_half(const sstr_big_t* big, unsigned k) {
+    unsigned w = (k - 1) / 32, b = (k - 1) % 32;
+    unsigned i;
+
+    if (!((big->d[w] >> b) & 1)) {
+        return -1;
+    }
+    if (big->d[w] & (uint32_t)((1ULL << b) - 1)) {
+        return 1;
+    }
+    for (i = 0; i < w; ++i) {
+        if (big->d[i]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// add one unit in the last place to the digits in [begin, end), the dot is
+// skipped. A carry out of the integer part takes a padding byte, or shifts
+// everything right by one when there is none.
+static unsigned char* sstr_fixed_round_up(unsigned char* begin,
+                                          unsigned char* end) {
+    unsigned char* q = end;
+
+    while (q > begin) {
+        --q;
+        if (*q == '.') {
+            continue;
+        }
+        if (*q == '9') {
+            *q = '0';
+            continue;
+        }
+        if (*q >= '0' && *q <= '8') {
+            (*q)++;
+        } else {
+            *q = '1';  // space padding
+        }
+        return end;
+    }
+    memmove(begin + 1, begin, end - begin);
+    *begin = '1';
+    return end + 1;
+}
+
+// write v in decimal, padded with zero to width.
+static unsigned char* sstr_format_padded_dec(unsigned char* p, uint64_t v,
+                                             unsigned char zero,
+                                             unsigned width) {
+    unsigned n = sstr_count_digits(v);
+
+    for (; width > n; width--) {
+        *p++ = zero;
+    }
+    sstr_write_dec(p + n, v);
+    return p + n;
+}
+
+// upper bound of the sstr_format_fixed() output.
+static size_t sstr_fixed_len(double f, unsigned width, unsigned frac_width) {
+    int e = (int)((sstr_double_bits(f) & SSTR_DBL_EXP_MASK) >>
+                  SSTR_DBL_FRAC_BITS) -
+            1022;  // |f| < 2^e
+    size_t digits = e > 0 ? (((unsigned)e * 1233) >> 12) + 1 : 1;
+
+    if (digits < width) {
+        digits = width;
+    }
+    // sign, a carry from rounding, the dot
+    return digits + frac_width + 3;
+}
+
+// format a %f directive into buf, return the end of output. The integer part is
+// padded to width, trailing zeros of the fraction are removed if trim. buf must
+// hold sstr_fixed_len() bytes.
+static unsigned char* sstr_format_fixed(unsigned char* buf, double f,
+                                        unsigned char zero, unsigned width,
+                                        unsigned frac_width, int trim) {
+    uint64_t bits = sstr_double_bits(f);
+    uint64_t m = bits & SSTR_DBL_FRAC_MASK, mask, frac, half;
+    int e = (int)((bits & SSTR_DBL_EXP_MASK) >> SSTR_DBL_FRAC_BITS);
+    unsigned char *p = buf, *begin;
+    unsigned i = 0, k, n;
+    sstr_big_t big;
+    int cmp;
+
+    if (bits & SSTR_DBL_SIGN_MASK) {
+        *p++ = '-';
+    }
+    if ((bits & SSTR_DBL_EXP_MASK) == SSTR_DBL_EXP_MASK) {
+        return sstr_format_special(p, bits, width);
+    }
+
+    if (e) {
+        m |= SSTR_DBL_HIDDEN_BIT;
+        e -= SSTR_DBL_EXP_BIAS;
+    } else {
+        e = 1 - SSTR_DBL_EXP_BIAS;
+    }
+    if (m) {
+        n = sstr_ctz64(m);
+        m >>= n;
+        e += (int)n;
+    }
+
+    begin = p;
+    k = 0;
+    if (m == 0) {
+        // e is meaningless for zero, do not shift by it
+        p = sstr_format_padded_dec(p, 0, zero, width);
+    } else if (e >= 0) {
+        // an integer, nothing to round
+        if (e <= 11) {
+            p = sstr_format_padded_dec(p, m << e, zero, width);
+        } else {
+            p = sstr_format_big_int(p, m, (unsigned)e, zero, width);
+        }
+    } else {
+        k = (unsigned)-e;
+        p = sstr_format_padded_dec(p, k < 64 ? m >> k : 0, zero, width);
+    }
+    if (frac_width) {
+        *p++ = '.';
+    }
+
+    // the fraction is m / 2^k, after k digits the rest of it is 0
+    cmp = -1;
+    if (k && k <= 57) {
+        // frac * 100 fits, two digits per step
+        mask = (1ULL << k) - 1;
+        frac = m & mask;
+        for (; i + 1 < frac_width && i < k; i += 2) {
+            frac *= 100;
+            memcpy(p, sstr_digit_pairs + (frac >> k) * 2, 2);
+            p += 2;
+            frac &= mask;
+        }
+        for (; i < frac_width && i < k; ++i) {
+            frac *= 10;
+            *p++ = (unsigned char)('0' + (frac >> k));
+            frac &= mask;
+        }
+        half = 1ULL << (k - 1);
+        cmp = frac > half ? 1 : (frac == half ? 0 : -1);
+    } else if (k && k <= 60) {
+        mask = (1ULL << k) - 1;
+        frac = m & mask;
+        for (; i < frac_width && i < k; ++i) {
+            frac *= 10;
+            *p++ = (unsigned char)('0' + (frac >> k));
+            frac &= mask;
+        }
+        half = 1ULL << (k - 1);
+        cmp = frac > half ? 1 : (frac == half ? 0 : -1);
+    } else if (k) {
+        memset(big.d, 0, sizeof(big.d));
+        big.d[0] = (uint32_t)m;
+        big.d[1] = (uint32_t)(m >> 32);
+        big.n = (int)(k / 32) + 2;
+        for (; i < frac_width && i < k; ++i) {
+            *p++ = (unsigned char)('0' + sstr_big_next_digit(&big, k));
+        }
+        cmp = sstr_big_cmp_half(&big, k);
+    }
+    memset(p, '0', frac_width - i);
+    p += frac_width - i;
+
+    if (cmp > 0 || (cmp == 0 && ((p[-1] - '0') & 1))) {
+        p = sstr_fixed_round_up(begin, p);
+    }
+
+    if (trim && frac_width) {
+        for (n = frac_width; n && p[-1] == '0'; n--) {
+            p--;
+        }
+        if (n == 0) {
+            p--;  // the dot
+        }
+    }
+    return p;
+}
+
+typedef struct {
+    uint64_t f;
+    int e;
+} sstr_diyfp_t;
+
+// 10^k for k = -348, -340, ..., 340, as f * 2^e with the top bit of f set,
+// f = round(10^k / 2^e), computed with exact rational arithmetic.
+static const sstr_diyfp_t sstr_cached_powers[] = {
+    {0xfa8fd5a0081c0288ULL, -1220},  // 1e-348
+    {0xbaaee17fa23ebf76ULL, -1193},  // 1e-340
+    {0x8b16fb203055ac76ULL, -1166},  // 1e-332
+    {0xcf42894a5dce35eaULL, -1140},  // 1e-324
+    {0x9a6bb0aa55653b2dULL, -1113},  // 1e-316
+    {0xe61acf033d1a45dfULL, -1087},  // 1e-308
+    {0xab70fe17c79ac6caULL, -1060},  // 1e-300
+    {0xff77b1fcbebcdc4fULL, -1034},  // 1e-292
+    {0xbe5691ef416bd60cULL, -1007},  // 1e-284
+    {0x8dd01fad907ffc3cULL, -980},  // 1e-276
+    {0xd3515c2831559a83ULL, -954},  // 1e-268
+    {0x9d71ac8fada6c9b5ULL, -927},  // 1e-260
+    {0xea9c227723ee8bcbULL, -901},  // 1e-252
+    {0xaecc49914078536dULL, -874},  // 1e-244
+    {0x823c12795db6ce57ULL, -847},  // 1e-236
+    {0xc21094364dfb5637ULL, -821},  // 1e-228
+    {0x9096ea6f3848984fULL, -794},  // 1e-220
+    {0xd77485cb25823ac7ULL, -768},  // 1e-212
+    {0xa086cfcd97bf97f4ULL, -741},  // 1e-204
+    {0xef340a98172aace5ULL, -715},  // 1e-196
+    {0xb23867fb2a35b28eULL, -688},  // 1e-188
+    {0x84c8d4dfd2c63f3bULL, -661},  // 1e-180
+    {0xc5dd44271ad3cdbaULL, -635},  // 1e-172
+    {0x936b9fcebb25c996ULL, -608},  // 1e-164
+    {0xdbac6c247d62a584ULL, -582},  // 1e-156
+    {0xa3ab66580d5fdaf6ULL, -555},  // 1e-148
+    {0xf3e2f893dec3f126ULL, -529},  // 1e-140
+    {0xb5b5ada8aaff80b8ULL, -502},  // 1e-132
+    {0x87625f056c7c4a8bULL, -475},  // 1e-124
+    {0xc9bcff6034c13053ULL, -449},  // 1e-116
+    {0x964e858c91ba2655ULL, -422},  // 1e-108
+    {0xdff9772470297ebdULL, -396},  // 1e-100
+    {0xa6dfbd9fb8e5b88fULL, -369},  // 1e-92
+    {0xf8a95fcf88747d94ULL, -343},  // 1e-84
+    {0xb94470938fa89bcfULL, -316},  // 1e-76
+    {0x8a08f0f8bf0f156bULL, -289},  // 1e-68
+    {0xcdb02555653131b6ULL, -263},  // 1e-60
+    {0x993fe2c6d07b7facULL, -236},  // 1e-52
+    {0xe45c10c42a2b3b06ULL, -210},  // 1e-44
+    {0xaa242499697392d3ULL, -183},  // 1e-36
+    {0xfd87b5f28300ca0eULL, -157},  // 1e-28
+    {0xbce5086492111aebULL, -130},  // 1e-20
+    {0x8cbccc096f5088ccULL, -103},  // 1e-12
+    {0xd1b71758e219652cULL, -77},  // 1e-4
+    {0x9c40000000000000ULL, -50},  // 1e4
+    {0xe8d4a51000000000ULL, -24},  // 1e12
+    {0xad78ebc5ac620000ULL, 3},  // 1e20
+    {0x813f3978f8940984ULL, 30},  // 1e28
+    {0xc097ce7bc90715b3ULL, 56},  // 1e36
+    {0x8f7e32ce7bea5c70ULL, 83},  // 1e44
+    {0xd5d238a4abe98068ULL, 109},  // 1e52
+    {0x9f4f2726179a2245ULL, 136},  // 1e60
+    {0xed63a231d4c4fb27ULL, 162},  // 1e68
+    {0xb0de65388cc8ada8ULL, 189},  // 1e76
+    {0x83c7088e1aab65dbULL, 216},  // 1e84
+    {0xc45d1df942711d9aULL, 242},  // 1e92
+    {0x924d692ca61be758ULL, 269},  // 1e100
+    {0xda01ee641a708deaULL, 295},  // 1e108
+    {0xa26da3999aef774aULL, 322},  // 1e116
+    {0xf209787bb47d6b85ULL, 348},  // 1e124
+    {0xb454e4a179dd1877ULL, 375},  // 1e132
+    {0x865b86925b9bc5c2ULL, 402},  // 1e140
+    {0xc83553c5c8965d3dULL, 428},  // 1e148
+    {0x952ab45cfa97a0b3ULL, 455},  // 1e156
+    {0xde469fbd99a05fe3ULL, 481},  // 1e164
+    {0xa59bc234db398c25ULL, 508},  // 1e172
+    {0xf6c69a72a3989f5cULL, 534},  // 1e180
+    {0xb7dcbf5354e9beceULL, 561},  // 1e188
+    {0x88fcf317f22241e2ULL, 588},  // 1e196
+    {0xcc20ce9bd35c78a5ULL, 614},  // 1e204
+    {0x98165af37b2153dfULL, 641},  // 1e212
+    {0xe2a0b5dc971f303aULL, 667},  // 1e220
+    {0xa8d9d1535ce3b396ULL, 694},  // 1e228
+    {0xfb9b7cd9a4a7443cULL, 720},  // 1e236
+    {0xbb764c4ca7a44410ULL, 747},  // 1e244
+    {0x8bab8eefb6409c1aULL, 774},  // 1e252
+    {0xd01fef10a657842cULL, 800},  // 1e260
+    {0x9b10a4e5e9913129ULL, 827},  // 1e268
+    {0xe7109bfba19c0c9dULL, 853},  // 1e276
+    {0xac2820d9623bf429ULL, 880},  // 1e284
+    {0x80444b5e7aa7cf85ULL, 907},  // 1e292
+    {0xbf21e44003acdd2dULL, 933},  // 1e300
+    {0x8e679c2f5e44ff8fULL, 960},  // 1e308
+    {0xd433179d9c8cb841ULL, 986},  // 1e316
+    {0x9e19db92b4e31ba9ULL, 1013},  // 1e324
+    {0xeb96bf6ebadf77d9ULL, 1039},  // 1e332
+    {0xaf87023b9bf0ee6bULL, 1066},  // 1e340
+};
+
+#define SSTR_CACHED_POWERS_MIN_K (-348)
+#define SSTR_CACHED_POWERS_STEP 8
+
+// x * y rounded to the 64 most significant bits.
+static sstr_diyfp_t sstr_diyfp_mul(sstr_diyfp_t x, sstr_diyfp_t y) {
+    const uint64_t m32 = 0xFFFFFFFFULL;
+    uint64_t a = x.f >> 32, b = x.f & m32, c = y.f >> 32, d = y.f & m32;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t tmp = (bd >> 32) + (ad & m32) + (bc & m32) + (1ULL << 31);
+    sstr_diyfp_t r;
+
+    r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+    r.e = x.e + y.e + 64;
+    return r;
+}
+
+static sstr_diyfp_t sstr_diyfp_normalize(sstr_diyfp_t x) {
+    unsigned s = sstr_clz64(x.f);
+    x.f <<= s;
+    x.e -= (int)s;
+    return x;
+}
+
+// the cached power c such that the binary exponent of w * c lands in
+// [-60, -32], for w of exponent e. *K is set to -k of c = 10^k.
+static sstr_diyfp_t sstr_cached_power(int e, int* K) {
+    double dk = (-61 - e) * 0.30102999566398114 + 347;  // log10(2)
+    int k = (int)dk;
+    int index;
+
+    if (dk - k > 0.0) {
+        k++;
+    }
+    index = (k >> 3) + 1;
+    *K = -(SSTR_CACHED_POWERS_MIN_K + index * SSTR_CACHED_POWERS_STEP);
+    return sstr_cached_powers[index];
+}
+
+// move the last digit towards w as long as it stays inside the unsafe interval
+// of width delta. wp_w is the distance from its top to w, each of them may be
+// off by unit. Return 0 unless the digits are provably the closest to w inside
+// the real interval.
+static int sstr_grisu_round(unsigned char* buf, int len, uint64_t delta,
+                            uint64_t rest, uint64_t ten_kappa, uint64_t wp_w,
+                            uint64_t unit) {
+    uint64_t small = wp_w - unit, big = wp_w + unit;
+
+    while (rest < small && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < small ||
+            small - rest >= rest + ten_kappa - small)) {
+        buf[len - 1]--;
+        rest += ten_kappa;
+    }
+    // another digit could be closer to w, or rest is too close to the edges
+    if (rest < big && delta - rest >= ten_kappa &&
+        (rest + ten_kappa < big || big - rest > rest + ten_kappa - big)) {
+        return 0;
+    }
+    return 2 * unit <= rest && rest <= delta - 4 * unit;
+}
+
+// shortest digits of the unsafe interval [mp - delta, mp] around w, or 0 if
+// they can not be told apart from the digits of the real interval.
+static int sstr_grisu_digits(sstr_diyfp_t w, sstr_diyfp_t mp, uint64_t delta,
+                             unsigned char* buf, int* K) {
+    const unsigned shift = (unsigned)-mp.e;
+    const uint64_t one = 1ULL << shift;
+    const uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> shift);
+    uint64_t p2 = mp.f & (one - 1);
+    uint64_t unit = 1;
+    int kappa = (int)sstr_count_digits(p1);
+    int len = 0;
+    uint32_t d, pow10;
+    uint64_t rest;
+
+    while (kappa > 0) {
+        pow10 = (uint32_t)sstr_pow10[kappa - 1];
+        d = p1 / pow10;
+        p1 %= pow10;
+        if (d || len) {
+            buf[len++] = (unsigned char)('0' + d);
+        }
+        kappa--;
+        rest = ((uint64_t)p1 << shift) + p2;
+        if (rest < delta) {
+            *K += kappa;
+            return sstr_grisu_round(buf, len, delta, rest,
+                                    (uint64_t)pow10 << shift, wp_w, unit)
+                       ? len
+                       : 0;
+        }
+    }
+
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        unit *= 10;
+        d = (uint32_t)(p2 >> shift);
+        if (d || len) {
+            buf[len++] = (unsigned char)('0' + d);
+        }
+        p2 &= one - 1;
+        kappa--;
+        if (p2 < delta) {
+            *K += kappa;
+            return sstr_grisu_round(buf, len, delta, p2, one, wp_w * unit,
+                                    unit)
+                       ? len
+                       : 0;
+        }
+    }
+}
+
+// digits of the finite, non-zero double of bits into buf, the value is
+// buf * 10^K. Return the number of digits, at most 17, or 0 if Grisu3 can not
+// prove they are the shortest.
+static int sstr_grisu3(uint64_t bits, unsigned char* buf, int* K) {
+    int biased = (int)((bits & SSTR_DBL_EXP_MASK) >> SSTR_DBL_FRAC_BITS);
+    sstr_diyfp_t v, w_m, w_p, c_mk, W, Wp, Wm;
+
+    v.f = bits & SSTR_DBL_FRAC_MASK;
+    if (biased) {
+        v.f += SSTR_DBL_HIDDEN_BIT;
+        v.e = biased - SSTR_DBL_EXP_BIAS;
+    } else {
+        v.e = 1 - SSTR_DBL_EXP_BIAS;
+    }
+
+    // the boundaries halfway to the neighbouring doubles
+    w_p.f = (v.f << 1) + 1;
+    w_p.e = v.e - 1;
+    w_p = sstr_diyfp_normalize(w_p);
+    if (v.f == SSTR_DBL_HIDDEN_BIT && biased > 1) {
+        w_m.f = (v.f << 2) - 1;
+        w_m.e = v.e - 2;
+    } else {
+        w_m.f = (v.f << 1) - 1;
+        w_m.e = v.e - 1;
+    }
+    w_m.f <<= w_m.e - w_p.e;
+    w_m.e = w_p.e;
+
+    c_mk = sstr_cached_power(w_p.e, K);
+    W = sstr_diyfp_mul(sstr_diyfp_normalize(v), c_mk);
+    Wp = sstr_diyfp_mul(w_p, c_mk);
+    Wm = sstr_diyfp_mul(w_m, c_mk);
+    // the products are off by at most one, widen to the unsafe interval
+    Wm.f--;
+    Wp.f++;
+    return sstr_grisu_digits(W, Wp, Wp.f - Wm.f, buf, K);
+}
+
+// big *= x.
+static void sstr_big_mul_small(sstr_big_t* big, uint32_t x) {
+    uint64_t carry = 0;
+    int i;
+
+    for (i = 0; i < big->n; ++i) {
+        carry += (uint64_t)big->d[i] * x;
+        big->d[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    if (carry) {
+        big->d[big->n++] = (uint32_t)carry;
+    }
+}
+
+// big *= 10^k.
+static void sstr_big_mul_pow10(sstr_big_t* big, unsigned k) {
+    for (; k >= 9; k -= 9) {
+        sstr_big_mul_small(big, 1000000000);
+    }
+    if (k) {
+        sstr_big_mul_small(big, (uint32_t)sstr_pow10[k]);
+    }
+}
+
+// r = a + b, r may be a.
+static void sstr_big_add(sstr_big_t* r, const sstr_big_t* a,
+                         const sstr_big_t* b) {
+    int n = a->n > b->n ? a->n : b->n, i;
+    uint64_t carry = 0;
+
+    for (i = 0; i < n; ++i) {
+        carry += (uint64_t)(i < a->n ? a->d[i] : 0) + (i < b->n ? b->d[i] : 0);
+        r->d[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    r->n = n;
+    if (carry) {
+        r->d[r->n++] = (uint32_t)carry;
+    }
+}
+
+// a -= b, a >= b.
+static void sstr_big_sub(sstr_big_t* a, const sstr_big_t* b) {
+    int64_t borrow = 0;
+    int i;
+
+    for (i = 0; i < a->n; ++i) {
+        borrow += (int64_t)a->d[i] - (i < b->n ? b->d[i] : 0);
+        a->d[i] = (uint32_t)borrow;
+        borrow = borrow < 0 ? -1 : 0;
+    }
+    while (a->n && a->d[a->n - 1] == 0) {
+        a->n--;
+    }
+}
+
+static int sstr_big_cmp(const sstr_big_t* a, const sstr_big_t* b) {
+    int i;
+
+    if (a->n != b->n) {
+        return a->n < b->n ? -1 : 1;
+    }
+    for (i = a->n - 1; i >= 0; --i) {
+        if (a->d[i] != b->d[i]) {
+            return a->d[i] < b->d[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// compare a + b with c.
+static int sstr_big_cmp_sum(const sstr_big_t* a, const sstr_big_t* b,
+                            const sstr_big_t* c) {
+    sstr_big_t sum;
+
+    sstr_big_add(&sum, a, b);
+    return sstr_big_cmp(&sum, c);
+}
+
+// the exact shortest digits of sstr_grisu3(), for the inputs it gives up on.
+// The value v and the distances mp and mm to the boundaries halfway to its
+// neighbours are kept as fractions r / s, mp / s and mm / s of 10^k. The
+// boundaries read back to v when its significand is even.
+static int sstr_shortest_big(uint64_t bits, unsigned char* buf, int* K) {
+    int biased = (int)((bits & SSTR_DBL_EXP_MASK) >> SSTR_DBL_FRAC_BITS);
+    uint64_t f = bits & SSTR_DBL_FRAC_MASK;
+    sstr_big_t r, s, mp, mm;
+    int e, k, even, low, high, len = 0;
+    unsigned d;
+    double dk;
+
+    if (biased) {
+        f += SSTR_DBL_HIDDEN_BIT;
+        e = biased - SSTR_DBL_EXP_BIAS;
+    } else {
+        e = 1 - SSTR_DBL_EXP_BIAS;
+    }
+    even = !(f & 1);
+
+    // v = r / s, mp = mp / s, mm = mm / s, twice the distances when the
+    // boundary below is closer
+    if (f == SSTR_DBL_HIDDEN_BIT && biased > 1) {
+        if (e >= 0) {
+            sstr_big_shl(&r, f, (unsigned)e + 2);
+            sstr_big_shl(&s, 4, 0);
+            sstr_big_shl(&mp, 1, (unsigned)e + 1);
+            sstr_big_shl(&mm, 1, (unsigned)e);
+        } else {
+            sstr_big_shl(&r, f, 2);
+            sstr_big_shl(&s, 1, (unsigned)(2 - e));
+            sstr_big_shl(&mp, 2, 0);
+            sstr_big_shl(&mm, 1, 0);
+        }
+    } else if (e >= 0) {
+        sstr_big_shl(&r, f, (unsigned)e + 1);
+        sstr_big_shl(&s, 2, 0);
+        sstr_big_shl(&mp, 1, (unsigned)e);
+        sstr_big_shl(&mm, 1, (unsigned)e);
+    } else {
+        sstr_big_shl(&r, f, 1);
+        sstr_big_shl(&s, 1, (unsigned)(1 - e));
+        sstr_big_shl(&mp, 1, 0);
+        sstr_big_shl(&mm, 1, 0);
+    }
+
+    // 2^b <= v < 2^(b+1) gives 10^(k-1) <= v < 10^(k+1), then fix k so the
+    // upper boundary is below 10^k
+    dk = (e + 63 - (int)sstr_clz64(f)) * 0.30102999566398114;  // log10(2)
+    k = (int)dk;
+    if (dk - k > 0.0) {
+        k++;
+    }
+    if (k >= 0) {
+        sstr_big_mul_pow10(&s, (unsigned)k);
+    } else {
+        sstr_big_mul_pow10(&r, (unsigned)-k);
+        sstr_big_mul_pow10(&mp, (unsigned)-k);
+        sstr_big_mul_pow10(&mm, (unsigned)-k);
+    }
+    if (sstr_big_cmp_sum(&r, &mp, &s) > -even) {
+        sstr_big_mul_small(&s, 10);
+        k++;
+    }
+
+    for (;;) {
+        sstr_big_mul_small(&r, 10);
+        sstr_big_mul_small(&mp, 10);
+        sstr_big_mul_small(&mm, 10);
+        for (d = 0; sstr_big_cmp(&r, &s) >= 0; ++d) {
+            sstr_big_sub(&r, &s);
+        }
+        low = sstr_big_cmp(&r, &mm) < even;
+        high = sstr_big_cmp_sum(&r, &mp, &s) > -even;
+        if (low || high) {
+            break;
+        }
+        buf[len++] = (unsigned char)('0' + d);
+    }
+    if (low && high) {
+        // as close to both, round half to even
+        sstr_big_mul_small(&r, 2);
+        high = sstr_big_cmp(&r, &s);
+        high = high > 0 || (high == 0 && (d & 1));
+    }
+    buf[len++] = (unsigned char)('0' + d + (unsigned)high);
+    *K = k - len;
+    return len;
+}
+
+// format f in the shortest form that reads back to f into buf, which must hold
+// SSTR_SHORTEST_LEN bytes. Plain decimals are used for 1e-6 <= |f| < 1e21,
+// exponents otherwise, like JavaScript: 100, 0.25, 1e+21, 1.5e-7.
+static unsigned char* sstr_format_shortest(unsigned char* buf, double f) {
+    uint64_t bits = sstr_double_bits(f);
+    unsigned char* p = buf;
+    int len, K, kk, e10;
+    unsigned n;
+
+    if (bits & SSTR_DBL_SIGN_MASK) {
+        *p++ = '-';
+    }
+    if ((bits & SSTR_DBL_EXP_MASK) == SSTR_DBL_EXP_MASK) {
+        return sstr_format_special(p, bits, 0);
+    }
+    if ((bits & ~SSTR_DBL_SIGN_MASK) == 0) {
+        *p++ = '0';
+        return p;
+    }
+
+    len = sstr_grisu3(bits, p, &K);
+    if (len == 0) {
+        len = sstr_shortest_big(bits, p, &K);
+    }
+    kk = len + K;  // 10^(kk - 1) <= |f| < 10^kk
+
+    if (K >= 0 && kk <= 21) {  // 1234e7 -> 12340000000
+        memset(p + len, '0', K);
+        return p + kk;
+    }
+    if (kk > 0 && kk <= 21) {  // 1234e-2 -> 12.34
+        memmove(p + kk + 1, p + kk, len - kk);
+        p[kk] = '.';
+        return p + len + 1;
+    }
+    if (kk > -6 && kk <= 0) {  // 1234e-6 -> 0.001234
+        memmove(p + 2 - kk, p, len);
+        p[0] = '0';
+        p[1] = '.';
+        memset(p + 2, '0', -kk);
+        return p + 2 - kk + len;
+    }
+
+    // 1234e30 -> 1.234e+33
+    if (len > 1) {
+        memmove(p + 2, p + 1, len - 1);
+        p[1] = '.';
+        p += len + 1;
+    } else {
+        p++;
+    }
+    *p++ = 'e';
+    e10 = kk - 1;
+    if (e10 < 0) {
+        *p++ = '-';
+        e10 = -e10;
+    } else {
+        *p++ = '+';
+    }
+    n = sstr_count_digits((uint64_t)e10);
+    sstr_write_dec(p + n, (uint64_t)e10);
+    return p + n;
+}
+
+void sstr_append_num(sstr_t s, uint64_t ui64, int negative, char zero,
+                     unsigned int hex, unsigned int width) {
+    unsigned char tmp[SSTR_FORMAT_LEN];
+    unsigned char* p =
+        sstr_format_num(tmp, ui64, negative, (unsigned char)zero, hex, width);
+    sstr_append_of(s, tmp, p - tmp);
+}
+
+void sstr_append_fixed(sstr_t s, double f, char zero, unsigned int width,
+                       unsigned int frac_width, int trim) {
+    STR* ss = SSTR(s);
+    unsigned char *out, *p;
+
+    sstr_grow(ss, sstr_fixed_len(f, width, frac_width));
+    out = (unsigned char*)STR_PTR(ss) + sstr_length(ss);
+    p = sstr_format_fixed(out, f, (unsigned char)zero, width, frac_width,
+                          trim);
+    *p = '\0';
+    sstr_set_length(ss, p - (unsigned char*)STR_PTR(ss));
+}
+
+void sstr_append_double_shortest(sstr_t s, double f) {
+    STR* ss = SSTR(s);
+    unsigned char *out, *p;
+
+    sstr_grow(ss, SSTR_SHORTEST_LEN);
+    out = (unsigned char*)STR_PTR(ss) + sstr_length(ss);
+    p = sstr_format_shortest(out, f);
+    *p = '\0';
+    sstr_set_length(ss, p - (unsigned char*)STR_PTR(ss));
+}
+
+void sstr_append_hex(sstr_t s, const void* data, size_t length, int upper) {
+    size_t oldlen = sstr_length(s);
+    const unsigned char* p = (const unsigned char*)data;
+    unsigned char* out;
+    size_t i;
+
+    sstr_append_zero(s, length * 2);
+    out = (unsigned char*)STR_PTR(s) + oldlen;
+    for (i = 0; i < length; ++i) {
+        char_to_hex(p[i], out, upper);
+        out += 2;
+    }
+}
+
+// make room for n more bytes at out, the bytes before out are committed to the
+// length of ss. Return the new write position and update *end to the end of
+// the capacity.
+static unsigned char* sstr_printf_reserve(STR* ss, unsigned char* out,
+                                          size_t n, unsigned char** end) {
+    size_t length = out - (unsigned char*)STR_PTR(ss);
+
+    sstr_set_length(ss, length);
+    sstr_grow(ss, n);
+    *end = (unsigned char*)STR_PTR(ss) + sstr_capacity_of(ss);
+    return (unsigned char*)STR_PTR(ss) + length;
+}
+
+#define SSTR_PRINTF_ENSURE(n)                               \
+    do {                                                    \
+        if ((size_t)(end - out) < (size_t)(n)) {            \
+            out = sstr_printf_reserve(ss, out, (n), &end);  \
+        }                                                   \
+    } while (0)
+
+sstr_t sstr_vslprintf_append(sstr_t buf, const char* fmt, va_list args) {
+    unsigned char *p, zero;
+    int d;
+    double f;
+    size_t slen;
+    size_t i;
+    int64_t i64;
+    uint64_t ui64;
+    unsigned int width, sign, hex, frac_width, frac_width_set;
+    STR* S;
+    /* a default d after %..x/u  */
+    int df_d;
+    unsigned char tmp[SSTR_FORMAT_LEN];
+    unsigned char* ptmp;
+    STR* ss = SSTR(buf);
+    unsigned char *out, *end;
+
+    // the literal part of fmt is a cheap lower bound of the output, reserve it
+    // once, then every directive writes straight into the buffer.
+    end = NULL;
+    out = sstr_printf_reserve(ss, (unsigned char*)STR_PTR(ss) + sstr_length(ss),
+                              strlen(fmt), &end);
+
+    while (*fmt) {
+        if (*fmt == '%') {
+            i64 = 0;
+            ui64 = 0;
+
+            zero = (unsigned char)((*++fmt == '0') ? '0' : ' ');
+            width = 0;
+            sign = 1;
+            hex = 0;
+            frac_width = 6;
+            frac_width_set = 0;
+            slen = (size_t)-1;
+
+            while (*fmt >= '0' && *fmt <= '9') {
+                width = width * 10 + (*fmt++ - '0');
+            }
+
+            df_d = 0;
+            for (;;) {
+                switch (*fmt) {
+                    case 'u':
+                        sign = 0;
+                        fmt++;
+                        df_d = 1;
+                        continue;
+
+                    case 'X':
+                        hex = 2;
+                        sign = 0;
+                        fmt++;
+                        df_d = 1;
+                        continue;
+
+                    case 'x':
+                        hex = 1;
+                        sign = 0;
+                        fmt++;
+                        df_d = 1;
+                        continue;
+
+                    case '.':
+                        fmt++;
+                        frac_width = 0;
+                        while (*fmt >= '0' && *fmt <= '9') {
+                            frac_width = frac_width * 10 + (*fmt++ - '0');
+                            frac_width_set = 1;
+                        }
+
+                        break;
+
+                    case '*':
+                        slen = va_arg(args, size_t);
+                        fmt++;
+                        continue;
+
+                    default:
+                        break;
+                }
+
+                break;
+            }
+
+            switch (*fmt) {
+                case 'S':
+                    S = va_arg(args, STR*);
+                    if (S == NULL) {
+                        SSTR_PRINTF_ENSURE(4);
+                        memcpy(out, "NULL", 4);
+                        out += 4;
+                    } else if (hex == 0) {
+                        slen = sstr_length(S);
+                        SSTR_PRINTF_ENSURE(slen);
+                        memcpy(out, STR_PTR(S), slen);
+                        out += slen;
+                    } else {
+                        p = (unsigned char*)STR_PTR(S);
+                        slen = sstr_length(S);
+                        SSTR_PRINTF_ENSURE(slen * 2);
+                        for (i = 0; i < slen; ++i) {
+                            char_to_hex(p[i], out, hex == 2);
+                            out += 2;
+                        }
+                    }
+
+                    fmt++;
+
+                    continue;
+
+                case 's':
+                    p = va_arg(args, unsigned char*);
+
+                    if (p == NULL) {
+                        p = (unsigned char*)"NULL";
+                    }
+
+                    if (slen == (size_t)-1) {
+                        slen = strlen((char*)p);
+                    }
+                    SSTR_PRINTF_ENSURE(slen);
+                    memcpy(out, p, slen);
+                    out += slen;
+
+                    fmt++;
+
+                    continue;
+
+                case 'T':
+                    i64 = (int64_t)va_arg(args, time_t);
+                    sign = 1;
+                    df_d = 0;
+                    break;
+
+                case 'z':
+                    if (sign) {
+                        i64 = (int64_t)va_arg(args, long);
+                    } else {
+                        ui64 = (uint64_t)va_arg(args, unsigned long);
+                    }
+                    df_d = 0;
+                    break;
+
+                case 'd':
+                    if (sign) {
+                        i64 = (int64_t)va_arg(args, int);
+                    } else {
+                        ui64 = (uint64_t)va_arg(args, unsigned int);
+                    }
+                    df_d = 0;
+                    break;
+
+                case 'l':
+                    if (sign) {
+                        i64 = (int64_t)va_arg(args, long);
+                    } else {
+                        ui64 = (uint64_t)va_arg(args, unsigned long);
+                    }
+                    df_d = 0;
+                    break;
+
+                case 'D':
+                    if (sign) {
+                        i64 = (int64_t)va_arg(args, int32_t);
+                    } else {
+                        ui64 = (uint64_t)va_arg(args, uint32_t);
+                    }
+                    df_d = 0;
+                    break;
+
+                case 'L':
+                    if (sign) {
+                        i64 = va_arg(args, int64_t);
+                    } else {
+                        ui64 = va_arg(args, uint64_t);
+                    }
+                    df_d = 0;
+                    break;
+
+                case 'f':
+                    f = va_arg(args, double);
+                    SSTR_PRINTF_ENSURE(sstr_fixed_len(f, width, frac_width));
+                    out = sstr_format_fixed(out, f, zero, width, frac_width,
+                                            !frac_width_set);
+
+                    fmt++;
+
+                    continue;
+
+                case 'p':
+                    ui64 = (uintptr_t)va_arg(args, void*);
+                    hex = 2;
+                    sign = 0;
+                    zero = '0';
+                    width = 2 * sizeof(void*);
+                    break;
+
+                case 'c':
+                    d = va_arg(args, int);
+                    SSTR_PRINTF_ENSURE(1);
+                    *out++ = (unsigned char)d;
+                    fmt++;
+
+                    continue;
+
+                case 'Z':
+                    SSTR_PRINTF_ENSURE(1);
+                    *out++ = '\0';
+                    fmt++;
+
+                    continue;
+
+                case 'N':
+                    SSTR_PRINTF_ENSURE(1);
+                    *out++ = '\n';
+                    fmt++;
+
+                    continue;
+
+                case '%':
+                    SSTR_PRINTF_ENSURE(1);
+                    *out++ = '%';
+                    fmt++;
+
+                    continue;
+
+                default:
+                    if (df_d) {
+                        if (sign) {
+                            i64 = (int64_t)va_arg(args, int);
+                        } else {
+                            ui64 = (uint64_t)va_arg(args, unsigned int);
+                        }
+                        break;
+                    }
+                    if (*fmt) {
+                        SSTR_PRINTF_ENSURE(1);
+                        *out++ = (unsigned char)*fmt++;
+                    }
+
+                    continue;
+            }
+
+            d = 0;
+            if (sign) {
+                if (i64 < 0) {
+                    d = 1;
+                    ui64 = 0ULL - (uint64_t)i64;
+
+                } else {
+                    ui64 = (uint64_t)i64;
+                }
+            }
+
+            ptmp = sstr_format_num(tmp, ui64, d, zero, hex, width);
+            SSTR_PRINTF_ENSURE(ptmp - tmp + 1);
+            memcpy(out, tmp, ptmp - tmp);
+            out += ptmp - tmp;
+
+            if (df_d && *fmt) {  // %xabc not %xd, move a to buf
+                *out++ = (unsigned char)*fmt++;
+            } else if (*fmt) {
+                fmt++;
+            }
+
+        } else {
+            ptmp = (unsigned char*)fmt;
+            while (*fmt && (*fmt) != '%') {
+                fmt++;
+            }
+            slen = (unsigned char*)fmt - ptmp;
+            SSTR_PRINTF_ENSURE(slen);
+            memcpy(out, ptmp, slen);
+            out += slen;
+        }
+    }
+
+    *out = '\0';
+    sstr_set_length(ss, out - (unsigned char*)STR_PTR(ss));
+    return buf;
+}
+
+static unsigned char* sstr_sprintf_num(unsigned char* buf, unsigned char* last,
+                                       uint64_t ui64, unsigned char zero,
+                                       unsigned int hexadecimal,
+                                       unsigned width) {
+    unsigned char *p, temp[SSTR_INT64_LEN + 1];
+    size_t len;
+    static unsigned char hex[] = "0123456789abcdef";
+    static unsigned char HEX[] = "0123456789ABCDEF";
+
+    p = temp + SSTR_INT64_LEN;
+
+    if (hexadecimal == 0) {
+        p = sstr_write_dec(p, ui64);
+
+    } else if (hexadecimal == 1) {
+        do {
+            *--p = hex[(uint32_t)(ui64 & 0xf)];
+        } while (ui64 >>= 4);
+
+    } else { /* hexadecimal == 2 */
+
+        do {
+            *--p = HEX[(uint32_t)(ui64 & 0xf)];
+        } while (ui64 >>= 4);
+    }
+
+    /* zero or space padding */
+
+    len = (temp + SSTR_INT64_LEN) - p;
+
+    while (len++ < width && buf < last) {
+        *buf++ = zero;
+    }
+
+    /* number safe copy */
+
+    len = (temp + SSTR_INT64_LEN) - p;
+
+    if (buf + len > last) {
+        len = last - buf;
+    }
+
+    memcpy(buf, p, len);
+    buf += len;
+    return buf;
+}
+
+const char* sstr_version() {
+    static const char* const version = "1.1.1";
+    return version;
+}
+
+// digits are counted first so they can be written straight into the buffer.
+static void sstr_append_dec(sstr_t s, uint64_t v, int negative) {
+    STR* ss = SSTR(s);
+    size_t n = sstr_count_digits(v) + (negative ? 1 : 0);
+    unsigned char* p;
+
+    sstr_grow(ss, n);
+    p = (unsigned char*)STR_PTR(ss) + sstr_length(ss);
+    if (negative) {
+        *p = '-';
+    }
+    sstr_write_dec(p + n, v);
+    p[n] = '\0';
+    sstr_set_length(ss, p + n - (unsigned char*)STR_PTR(ss));
+}
+
+void sstr_append_int_str(sstr_t s, int i) {
+    uint32_t ui32;
+    int negative = 0;
+
+    if (i < 0) {
+        negative = 1;
+        ui32 = 0U - (uint32_t)i;
+    } else {
+        ui32 = (uint32_t)i;
+    }
+    sstr_append_dec(s, ui32, negative);
+}
+
+void sstr_append_long_str(sstr_t s, long l) {
+    uint64_t ui64;
+    int negative = 0;
+    if (l < 0) {
+        negative = 1;
+        ui64 = 0ULL - (uint64_t)l;
+    } else {
+        ui64 = (uint64_t)l;
+    }
+    sstr_append_dec(s, ui64, negative);
+}
+
+void sstr_append_float_str(sstr_t s, float f, int precission) {
+    sstr_append_double_str(s, (double)f, precission);
+}
+
+void sstr_append_double_str(sstr_t s, double f, int precision) {
+    if (precision < 0) {
+        sstr_append_double_shortest(s, f);
+    } else {
+        sstr_append_fixed(s, f, ' ', 0, (unsigned int)precision, 1);
+    }
+}
+
+/*
+ * Number parsing.
+ *
+ * Only ASCII is accepted, the parsers never look at the locale. Integers are
+ * read 8 digits at a time with SWAR (SIMD within a register), the remaining
+ * digits one by one with an overflow check.
+ *
+ * Doubles are correctly rounded, like fast_float. The first 19 significant
+ * digits go into a uint64_t mantissa w, and the value is w * 10^q. Most
+ * inputs take Clinger's fast path: w and 10^q are exact doubles, so one
+ * multiplication or division rounds correctly. Otherwise the Eisel-Lemire
+ * algorithm multiplies w by a 128-bit approximation of 10^q, and accepts the
+ * result when the truncated bits cannot change the rounding. The few
+ * remaining inputs (halfway cases with more than 19 digits, subnormals,
+ * overflow) go to strtod(). Its argument is rebuilt without a decimal point,
+ * so the locale cannot change the result.
+ */
+
+#define SSTR_IS_DIGIT(c) ((unsigned char)((c) - '0') < 10)
+#define SSTR_IS_SPACE(c) ((c) == ' ' || ((unsigned char)((c) - '\t') < 5))
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SSTR_PARSE_SWAR 1
+#endif
+
+#ifdef SSTR_PARSE_SWAR
+// 8 bytes loaded little endian are all '0'..'9'.
+static int sstr_is_8digits(uint64_t val) {
+    return !(((val + 0x4646464646464646ULL) | (val - 0x3030303030303030ULL)) &
+             0x8080808080808080ULL);
+}
+
+// value of 8 ASCII digits loaded little endian.
+static uint32_t sstr_parse_8digits(uint64_t val) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL;  // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ULL;  // 1 + (10000 << 32)
+
+    val -= 0x3030303030303030ULL;
+    val = (val * 10) + (val >> 8);  // pairs of digits
+    val = (((val & mask) * mul1) + (((val >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t)val;
+}
+#endif
+
+// skip whitespace and a sign, set *negative.
+static const char* sstr_parse_prefix(const char* p, const char* end,
+                                     int* negative) {
+    while (p < end && SSTR_IS_SPACE(*p)) {
+        p++;
+    }
+    *negative = 0;
+    if (p < end && (*p == '-' || *p == '+')) {
+        *negative = *p == '-';
+        p++;
+    }
+    return p;
+}
+
+// digits at p as uint64_t. Return the end of the digits, p if there are none.
+// *overflow is set if the value does not fit, *v is UINT64_MAX then.
+static const char* sstr_parse_digits(const char* p, const char* end,
+                                     uint64_t* v, int* overflow) {
+    uint64_t r = 0;
+    unsigned d;
+#ifdef SSTR_PARSE_SWAR
+    uint64_t chunk;
+
+    // r < 10^11 so r * 10^8 + 99999999 < 10^19 can not overflow
+    while (end - p >= 8 && r < 100000000000ULL) {
+        memcpy(&chunk, p, 8);
+        if (!sstr_is_8digits(chunk)) {
+            break;
+        }
+        r = r * 100000000 + sstr_parse_8digits(chunk);
+        p += 8;
+    }
+#endif
+    *overflow = 0;
+    while (p < end && SSTR_IS_DIGIT(*p)) {
+        d = (unsigned)(*p - '0');
+        if (r > (UINT64_MAX - d) / 10) {
+            *overflow = 1;
+            r = UINT64_MAX;
+            while (p < end && SSTR_IS_DIGIT(*p)) {
+                p++;
+            }
+            break;
+        }
+        r = r * 10 + d;
+        p++;
+    }
+    *v = r;
+    return p;
+}
+
+// accumulate the digits at p into *w, wrapping around on overflow. Return the
+// end of the digits.
+static const char* sstr_scan_digits(const char* p, const char* end,
+                                    uint64_t* w) {
+    uint64_t r = *w;
+#ifdef SSTR_PARSE_SWAR
+    uint64_t chunk;
+
+    while (end - p >= 8) {
+        memcpy(&chunk, p, 8);
+        if (!sstr_is_8digits(chunk)) {
+            break;
+        }
+        r = r * 100000000 + sstr_parse_8digits(chunk);
+        p += 8;
+    }
+#endif
+    while (p < end && SSTR_IS_DIGIT(*p)) {
+        r = r * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+    *w = r;
+    return p;
+}
+
+// magnitude and sign of an integer, the limits are checked by the callers.
+static int sstr_parse_integer(const char* data, size_t length, uint64_t* mag,
+                              int* negative, size_t* consumed) {
+    const char *p, *digits, *end = data + length;
+    int overflow;
+
+    digits = sstr_parse_prefix(data, end, negative);
+    p = sstr_parse_digits(digits, end, mag, &overflow);
+    if (p == digits) {
+        *mag = 0;
+        *negative = 0;
+        p = data;
+    }
+    if (consumed) {
+        *consumed = (size_t)(p - data);
+    }
+    if (p == data) {
+        return SSTR_PARSE_INVALID;
+    }
+    return overflow ? SSTR_PARSE_RANGE : SSTR_PARSE_OK;
+}
+
+int sstr_parse_i64_of(const void* data, size_t length, int64_t* v,
+                      size_t* consumed) {
+    uint64_t mag;
+    int negative;
+    int r = sstr_parse_integer((const char*)data, length, &mag, &negative,
+                               consumed);
+
+    if (negative) {
+        if (mag > (uint64_t)INT64_MAX + 1) {
+            *v = INT64_MIN;
+            return SSTR_PARSE_RANGE;
+        }
+        *v = (int64_t)(0 - mag);
+    } else {
+        if (mag > (uint64_t)INT64_MAX) {
+            *v = INT64_MAX;
+            return SSTR_PARSE_RANGE;
+        }
+        *v = (int64_t)mag;
+    }
+    return r;
+}
+
+int sstr_parse_u64_of(const void* data, size_t length, uint64_t* v,
+                      size_t* consumed) {
+    uint64_t mag;
+    int negative;
+    int r = sstr_parse_integer((const char*)data, length, &mag, &negative,
+                               consumed);
+
+    if (negative && mag) {
+        *v = 0;
+        return SSTR_PARSE_RANGE;
+    }
+    *v = mag;
+    return r;
+}
+
+int sstr_parse_i32_of(const void* data, size_t length, int32_t* v,
+                      size_t* consumed) {
+    int64_t i64;
+    int r = sstr_parse_i64_of(data, length, &i64, consumed);
+
+    if (i64 > INT32_MAX) {
+        *v = INT32_MAX;
+        return SSTR_PARSE_RANGE;
+    }
+    if (i64 < INT32_MIN) {
+        *v = INT32_MIN;
+        return SSTR_PARSE_RANGE;
+    }
+    *v = (int32_t)i64;
+    return r;
+}
+
+int sstr_parse_u32_of(const void* data, size_t length, uint32_t* v,
+                      size_t* consumed) {
+    uint64_t u64;
+    int r = sstr_parse_u64_of(data, length, &u64, consumed);
+
+    if (u64 > UINT32_MAX) {
+        *v = UINT32_MAX;
+        return SSTR_PARSE_RANGE;
+    }
+    *v = (uint32_t)u64;
+    return r;
+}
+
+int sstr_parse_i64(sstr_t s, int64_t* v, size_t* consumed) {
+    return sstr_parse_i64_of(STR_PTR(s), sstr_length(s), v, consumed);
+}
+
+int sstr_parse_u64(sstr_t s, uint64_t* v, size_t* consumed) {
+    return sstr_parse_u64_of(STR_PTR(s), sstr_length(s), v, consumed);
+}
+
+int sstr_parse_i32(sstr_t s, int32_t* v, size_t* consumed) {
+    return sstr_parse_i32_of(STR_PTR(s), sstr_length(s), v, consumed);
+}
+
+int sstr_parse_u32(sstr_t s, uint32_t* v, size_t* consumed) {
+    return sstr_parse_u32_of(STR_PTR(s), sstr_length(s), v, consumed);
+}
+
+// 10^e for e = -348..347, normalized to [2^127, 2^128) and rounded down,
+// low word first. Computed with exact rational arithmetic.
+static const uint64_t sstr_pow10_128[][2] = {
+    {0x1732c869cd60e453ULL, 0xfa8fd5a0081c0288ULL},  // 1e-348
+    {0x0e7fbd42205c8eb4ULL, 0x9c99e58405118195ULL},  // 1e-347
+    {0x521fac92a873b261ULL, 0xc3c05ee50655e1faULL},  // 1e-346
+    {0xe6a797b752909ef9ULL, 0xf4b0769e47eb5a78ULL},  // 1e-345
+    {0x9028bed2939a635cULL, 0x98ee4a22ecf3188bULL},  // 1e-344
+    {0x7432ee873880fc33ULL, 0xbf29dcaba82fdeaeULL},  // 1e-343
+    {0x113faa2906a13b3fULL, 0xeef453d6923bd65aULL},  // 1e-342
+    {0x4ac7ca59a424c507ULL, 0x9558b4661b6565f8ULL},  // 1e-341
+    {0x5d79bcf00d2df649ULL, 0xbaaee17fa23ebf76ULL},  // 1e-340
+    {0xf4d82c2c107973dcULL, 0xe95a99df8ace6f53ULL},  // 1e-339
+    {0x79071b9b8a4be869ULL, 0x91d8a02bb6c10594ULL},  // 1e-338
+    {0x9748e2826cdee284ULL, 0xb64ec836a47146f9ULL},  // 1e-337
+    {0xfd1b1b2308169b25ULL, 0xe3e27a444d8d98b7ULL},  // 1e-336
+    {0xfe30f0f5e50e20f7ULL, 0x8e6d8c6ab0787f72ULL},  // 1e-335
+    {0xbdbd2d335e51a935ULL, 0xb208ef855c969f4fULL},  // 1e-334
+    {0xad2c788035e61382ULL, 0xde8b2b66b3bc4723ULL},  // 1e-333
+    {0x4c3bcb5021afcc31ULL, 0x8b16fb203055ac76ULL},  // 1e-332
+    {0xdf4abe242a1bbf3dULL, 0xaddcb9e83c6b1793ULL},  // 1e-331
+    {0xd71d6dad34a2af0dULL, 0xd953e8624b85dd78ULL},  // 1e-330
+    {0x8672648c40e5ad68ULL, 0x87d4713d6f33aa6bULL},  // 1e-329
+    {0x680efdaf511f18c2ULL, 0xa9c98d8ccb009506ULL},  // 1e-328
+    {0x0212bd1b2566def2ULL, 0xd43bf0effdc0ba48ULL},  // 1e-327
+    {0x014bb630f7604b57ULL, 0x84a57695fe98746dULL},  // 1e-326
+    {0x419ea3bd35385e2dULL, 0xa5ced43b7e3e9188ULL},  // 1e-325
+    {0x52064cac828675b9ULL, 0xcf42894a5dce35eaULL},  // 1e-324
+    {0x7343efebd1940993ULL, 0x818995ce7aa0e1b2ULL},  // 1e-323
+    {0x1014ebe6c5f90bf8ULL, 0xa1ebfb4219491a1fULL},  // 1e-322
+    {0xd41a26e077774ef6ULL, 0xca66fa129f9b60a6ULL},  // 1e-321
+    {0x8920b098955522b4ULL, 0xfd00b897478238d0ULL},  // 1e-320
+    {0x55b46e5f5d5535b0ULL, 0x9e20735e8cb16382ULL},  // 1e-319
+    {0xeb2189f734aa831dULL, 0xc5a890362fddbc62ULL},  // 1e-318
+    {0xa5e9ec7501d523e4ULL, 0xf712b443bbd52b7bULL},  // 1e-317
+    {0x47b233c92125366eULL, 0x9a6bb0aa55653b2dULL},  // 1e-316
+    {0x999ec0bb696e840aULL, 0xc1069cd4eabe89f8ULL},  // 1e-315
+    {0xc00670ea43ca250dULL, 0xf148440a256e2c76ULL},  // 1e-314
+    {0x380406926a5e5728ULL, 0x96cd2a865764dbcaULL},  // 1e-313
+    {0xc605083704f5ecf2ULL, 0xbc807527ed3e12bcULL},  // 1e-312
+    {0xf7864a44c633682eULL, 0xeba09271e88d976bULL},  // 1e-311
+    {0x7ab3ee6afbe0211dULL, 0x93445b8731587ea3ULL},  // 1e-310
+    {0x5960ea05bad82964ULL, 0xb8157268fdae9e4cULL},  // 1e-309
+    {0x6fb92487298e33bdULL, 0xe61acf033d1a45dfULL},  // 1e-308
+    {0xa5d3b6d479f8e056ULL, 0x8fd0c16206306babULL},  // 1e-307
+    {0x8f48a4899877186cULL, 0xb3c4f1ba87bc8696ULL},  // 1e-306
+    {0x331acdabfe94de87ULL, 0xe0b62e2929aba83cULL},  // 1e-305
+    {0x9ff0c08b7f1d0b14ULL, 0x8c71dcd9ba0b4925ULL},  // 1e-304
+    {0x07ecf0ae5ee44dd9ULL, 0xaf8e5410288e1b6fULL},  // 1e-303
+    {0xc9e82cd9f69d6150ULL, 0xdb71e91432b1a24aULL},  // 1e-302
+    {0xbe311c083a225cd2ULL, 0x892731ac9faf056eULL},  // 1e-301
+    {0x6dbd630a48aaf406ULL, 0xab70fe17c79ac6caULL},  // 1e-300
+    {0x092cbbccdad5b108ULL, 0xd64d3d9db981787dULL},  // 1e-299
+    {0x25bbf56008c58ea5ULL, 0x85f0468293f0eb4eULL},  // 1e-298
+    {0xaf2af2b80af6f24eULL, 0xa76c582338ed2621ULL},  // 1e-297
+    {0x1af5af660db4aee1ULL, 0xd1476e2c07286faaULL},  // 1e-296
+    {0x50d98d9fc890ed4dULL, 0x82cca4db847945caULL},  // 1e-295
+    {0xe50ff107bab528a0ULL, 0xa37fce126597973cULL},  // 1e-294
+    {0x1e53ed49a96272c8ULL, 0xcc5fc196fefd7d0cULL},  // 1e-293
+    {0x25e8e89c13bb0f7aULL, 0xff77b1fcbebcdc4fULL},  // 1e-292
+    {0x77b191618c54e9acULL, 0x9faacf3df73609b1ULL},  // 1e-291
+    {0xd59df5b9ef6a2417ULL, 0xc795830d75038c1dULL},  // 1e-290
+    {0x4b0573286b44ad1dULL, 0xf97ae3d0d2446f25ULL},  // 1e-289
+    {0x4ee367f9430aec32ULL, 0x9becce62836ac577ULL},  // 1e-288
+    {0x229c41f793cda73fULL, 0xc2e801fb244576d5ULL},  // 1e-287
+    {0x6b43527578c1110fULL, 0xf3a20279ed56d48aULL},  // 1e-286
+    {0x830a13896b78aaa9ULL, 0x9845418c345644d6ULL},  // 1e-285
+    {0x23cc986bc656d553ULL, 0xbe5691ef416bd60cULL},  // 1e-284
+    {0x2cbfbe86b7ec8aa8ULL, 0xedec366b11c6cb8fULL},  // 1e-283
+    {0x7bf7d71432f3d6a9ULL, 0x94b3a202eb1c3f39ULL},  // 1e-282
+    {0xdaf5ccd93fb0cc53ULL, 0xb9e08a83a5e34f07ULL},  // 1e-281
+    {0xd1b3400f8f9cff68ULL, 0xe858ad248f5c22c9ULL},  // 1e-280
+    {0x23100809b9c21fa1ULL, 0x91376c36d99995beULL},  // 1e-279
+    {0xabd40a0c2832a78aULL, 0xb58547448ffffb2dULL},  // 1e-278
+    {0x16c90c8f323f516cULL, 0xe2e69915b3fff9f9ULL},  // 1e-277
+    {0xae3da7d97f6792e3ULL, 0x8dd01fad907ffc3bULL},  // 1e-276
+    {0x99cd11cfdf41779cULL, 0xb1442798f49ffb4aULL},  // 1e-275
+    {0x40405643d711d583ULL, 0xdd95317f31c7fa1dULL},  // 1e-274
+    {0x482835ea666b2572ULL, 0x8a7d3eef7f1cfc52ULL},  // 1e-273
+    {0xda3243650005eecfULL, 0xad1c8eab5ee43b66ULL},  // 1e-272
+    {0x90bed43e40076a82ULL, 0xd863b256369d4a40ULL},  // 1e-271
+    {0x5a7744a6e804a291ULL, 0x873e4f75e2224e68ULL},  // 1e-270
+    {0x711515d0a205cb36ULL, 0xa90de3535aaae202ULL},  // 1e-269
+    {0x0d5a5b44ca873e03ULL, 0xd3515c2831559a83ULL},  // 1e-268
+    {0xe858790afe9486c2ULL, 0x8412d9991ed58091ULL},  // 1e-267
+    {0x626e974dbe39a872ULL, 0xa5178fff668ae0b6ULL},  // 1e-266
+    {0xfb0a3d212dc8128fULL, 0xce5d73ff402d98e3ULL},  // 1e-265
+    {0x7ce66634bc9d0b99ULL, 0x80fa687f881c7f8eULL},  // 1e-264
+    {0x1c1fffc1ebc44e80ULL, 0xa139029f6a239f72ULL},  // 1e-263
+    {0xa327ffb266b56220ULL, 0xc987434744ac874eULL},  // 1e-262
+    {0x4bf1ff9f0062baa8ULL, 0xfbe9141915d7a922ULL},  // 1e-261
+    {0x6f773fc3603db4a9ULL, 0x9d71ac8fada6c9b5ULL},  // 1e-260
+    {0xcb550fb4384d21d3ULL, 0xc4ce17b399107c22ULL},  // 1e-259
+    {0x7e2a53a146606a48ULL, 0xf6019da07f549b2bULL},  // 1e-258
+    {0x2eda7444cbfc426dULL, 0x99c102844f94e0fbULL},  // 1e-257
+    {0xfa911155fefb5308ULL, 0xc0314325637a1939ULL},  // 1e-256
+    {0x793555ab7eba27caULL, 0xf03d93eebc589f88ULL},  // 1e-255
+    {0x4bc1558b2f3458deULL, 0x96267c7535b763b5ULL},  // 1e-254
+    {0x9eb1aaedfb016f16ULL, 0xbbb01b9283253ca2ULL},  // 1e-253
+    {0x465e15a979c1cadcULL, 0xea9c227723ee8bcbULL},  // 1e-252
+    {0x0bfacd89ec191ec9ULL, 0x92a1958a7675175fULL},  // 1e-251
+    {0xcef980ec671f667bULL, 0xb749faed14125d36ULL},  // 1e-250
+    {0x82b7e12780e7401aULL, 0xe51c79a85916f484ULL},  // 1e-249
+    {0xd1b2ecb8b0908810ULL, 0x8f31cc0937ae58d2ULL},  // 1e-248
+    {0x861fa7e6dcb4aa15ULL, 0xb2fe3f0b8599ef07ULL},  // 1e-247
+    {0x67a791e093e1d49aULL, 0xdfbdcece67006ac9ULL},  // 1e-246
+    {0xe0c8bb2c5c6d24e0ULL, 0x8bd6a141006042bdULL},  // 1e-245
+    {0x58fae9f773886e18ULL, 0xaecc49914078536dULL},  // 1e-244
+    {0xaf39a475506a899eULL, 0xda7f5bf590966848ULL},  // 1e-243
+    {0x6d8406c952429603ULL, 0x888f99797a5e012dULL},  // 1e-242
+    {0xc8e5087ba6d33b83ULL, 0xaab37fd7d8f58178ULL},  // 1e-241
+    {0xfb1e4a9a90880a64ULL, 0xd5605fcdcf32e1d6ULL},  // 1e-240
+    {0x5cf2eea09a55067fULL, 0x855c3be0a17fcd26ULL},  // 1e-239
+    {0xf42faa48c0ea481eULL, 0xa6b34ad8c9dfc06fULL},  // 1e-238
+    {0xf13b94daf124da26ULL, 0xd0601d8efc57b08bULL},  // 1e-237
+    {0x76c53d08d6b70858ULL, 0x823c12795db6ce57ULL},  // 1e-236
+    {0x54768c4b0c64ca6eULL, 0xa2cb1717b52481edULL},  // 1e-235
+    {0xa9942f5dcf7dfd09ULL, 0xcb7ddcdda26da268ULL},  // 1e-234
+    {0xd3f93b35435d7c4cULL, 0xfe5d54150b090b02ULL},  // 1e-233
+    {0xc47bc5014a1a6dafULL, 0x9efa548d26e5a6e1ULL},  // 1e-232
+    {0x359ab6419ca1091bULL, 0xc6b8e9b0709f109aULL},  // 1e-231
+    {0xc30163d203c94b62ULL, 0xf867241c8cc6d4c0ULL},  // 1e-230
+    {0x79e0de63425dcf1dULL, 0x9b407691d7fc44f8ULL},  // 1e-229
+    {0x985915fc12f542e4ULL, 0xc21094364dfb5636ULL},  // 1e-228
+    {0x3e6f5b7b17b2939dULL, 0xf294b943e17a2bc4ULL},  // 1e-227
+    {0xa705992ceecf9c42ULL, 0x979cf3ca6cec5b5aULL},  // 1e-226
+    {0x50c6ff782a838353ULL, 0xbd8430bd08277231ULL},  // 1e-225
+    {0xa4f8bf5635246428ULL, 0xece53cec4a314ebdULL},  // 1e-224
+    {0x871b7795e136be99ULL, 0x940f4613ae5ed136ULL},  // 1e-223
+    {0x28e2557b59846e3fULL, 0xb913179899f68584ULL},  // 1e-222
+    {0x331aeada2fe589cfULL, 0xe757dd7ec07426e5ULL},  // 1e-221
+    {0x3ff0d2c85def7621ULL, 0x9096ea6f3848984fULL},  // 1e-220
+    {0x0fed077a756b53a9ULL, 0xb4bca50b065abe63ULL},  // 1e-219
+    {0xd3e8495912c62894ULL, 0xe1ebce4dc7f16dfbULL},  // 1e-218
+    {0x64712dd7abbbd95cULL, 0x8d3360f09cf6e4bdULL},  // 1e-217
+    {0xbd8d794d96aacfb3ULL, 0xb080392cc4349decULL},  // 1e-216
+    {0xecf0d7a0fc5583a0ULL, 0xdca04777f541c567ULL},  // 1e-215
+    {0xf41686c49db57244ULL, 0x89e42caaf9491b60ULL},  // 1e-214
+    {0x311c2875c522ced5ULL, 0xac5d37d5b79b6239ULL},  // 1e-213
+    {0x7d633293366b828bULL, 0xd77485cb25823ac7ULL},  // 1e-212
+    {0xae5dff9c02033197ULL, 0x86a8d39ef77164bcULL},  // 1e-211
+    {0xd9f57f830283fdfcULL, 0xa8530886b54dbdebULL},  // 1e-210
+    {0xd072df63c324fd7bULL, 0xd267caa862a12d66ULL},  // 1e-209
+    {0x4247cb9e59f71e6dULL, 0x8380dea93da4bc60ULL},  // 1e-208
+    {0x52d9be85f074e608ULL, 0xa46116538d0deb78ULL},  // 1e-207
+    {0x67902e276c921f8bULL, 0xcd795be870516656ULL},  // 1e-206
+    {0x00ba1cd8a3db53b6ULL, 0x806bd9714632dff6ULL},  // 1e-205
+    {0x80e8a40eccd228a4ULL, 0xa086cfcd97bf97f3ULL},  // 1e-204
+    {0x6122cd128006b2cdULL, 0xc8a883c0fdaf7df0ULL},  // 1e-203
+    {0x796b805720085f81ULL, 0xfad2a4b13d1b5d6cULL},  // 1e-202
+    {0xcbe3303674053bb0ULL, 0x9cc3a6eec6311a63ULL},  // 1e-201
+    {0xbedbfc4411068a9cULL, 0xc3f490aa77bd60fcULL},  // 1e-200
+    {0xee92fb5515482d44ULL, 0xf4f1b4d515acb93bULL},  // 1e-199
+    {0x751bdd152d4d1c4aULL, 0x991711052d8bf3c5ULL},  // 1e-198
+    {0xd262d45a78a0635dULL, 0xbf5cd54678eef0b6ULL},  // 1e-197
+    {0x86fb897116c87c34ULL, 0xef340a98172aace4ULL},  // 1e-196
+    {0xd45d35e6ae3d4da0ULL, 0x9580869f0e7aac0eULL},  // 1e-195
+    {0x8974836059cca109ULL, 0xbae0a846d2195712ULL},  // 1e-194
+    {0x2bd1a438703fc94bULL, 0xe998d258869facd7ULL},  // 1e-193
+    {0x7b6306a34627ddcfULL, 0x91ff83775423cc06ULL},  // 1e-192
+    {0x1a3bc84c17b1d542ULL, 0xb67f6455292cbf08ULL},  // 1e-191
+    {0x20caba5f1d9e4a93ULL, 0xe41f3d6a7377eecaULL},  // 1e-190
+    {0x547eb47b7282ee9cULL, 0x8e938662882af53eULL},  // 1e-189
+    {0xe99e619a4f23aa43ULL, 0xb23867fb2a35b28dULL},  // 1e-188
+    {0x6405fa00e2ec94d4ULL, 0xdec681f9f4c31f31ULL},  // 1e-187
+    {0xde83bc408dd3dd04ULL, 0x8b3c113c38f9f37eULL},  // 1e-186
+    {0x9624ab50b148d445ULL, 0xae0b158b4738705eULL},  // 1e-185
+    {0x3badd624dd9b0957ULL, 0xd98ddaee19068c76ULL},  // 1e-184
+    {0xe54ca5d70a80e5d6ULL, 0x87f8a8d4cfa417c9ULL},  // 1e-183
+    {0x5e9fcf4ccd211f4cULL, 0xa9f6d30a038d1dbcULL},  // 1e-182
+    {0x7647c3200069671fULL, 0xd47487cc8470652bULL},  // 1e-181
+    {0x29ecd9f40041e073ULL, 0x84c8d4dfd2c63f3bULL},  // 1e-180
+    {0xf468107100525890ULL, 0xa5fb0a17c777cf09ULL},  // 1e-179
+    {0x7182148d4066eeb4ULL, 0xcf79cc9db955c2ccULL},  // 1e-178
+    {0xc6f14cd848405530ULL, 0x81ac1fe293d599bfULL},  // 1e-177
+    {0xb8ada00e5a506a7cULL, 0xa21727db38cb002fULL},  // 1e-176
+    {0xa6d90811f0e4851cULL, 0xca9cf1d206fdc03bULL},  // 1e-175
+    {0x908f4a166d1da663ULL, 0xfd442e4688bd304aULL},  // 1e-174
+    {0x9a598e4e043287feULL, 0x9e4a9cec15763e2eULL},  // 1e-173
+    {0x40eff1e1853f29fdULL, 0xc5dd44271ad3cdbaULL},  // 1e-172
+    {0xd12bee59e68ef47cULL, 0xf7549530e188c128ULL},  // 1e-171
+    {0x82bb74f8301958ceULL, 0x9a94dd3e8cf578b9ULL},  // 1e-170
+    {0xe36a52363c1faf01ULL, 0xc13a148e3032d6e7ULL},  // 1e-169
+    {0xdc44e6c3cb279ac1ULL, 0xf18899b1bc3f8ca1ULL},  // 1e-168
+    {0x29ab103a5ef8c0b9ULL, 0x96f5600f15a7b7e5ULL},  // 1e-167
+    {0x7415d448f6b6f0e7ULL, 0xbcb2b812db11a5deULL},  // 1e-166
+    {0x111b495b3464ad21ULL, 0xebdf661791d60f56ULL},  // 1e-165
+    {0xcab10dd900beec34ULL, 0x936b9fcebb25c995ULL},  // 1e-164
+    {0x3d5d514f40eea742ULL, 0xb84687c269ef3bfbULL},  // 1e-163
+    {0x0cb4a5a3112a5112ULL, 0xe65829b3046b0afaULL},  // 1e-162
+    {0x47f0e785eaba72abULL, 0x8ff71a0fe2c2e6dcULL},  // 1e-161
+    {0x59ed216765690f56ULL, 0xb3f4e093db73a093ULL},  // 1e-160
+    {0x306869c13ec3532cULL, 0xe0f218b8d25088b8ULL},  // 1e-159
+    {0x1e414218c73a13fbULL, 0x8c974f7383725573ULL},  // 1e-158
+    {0xe5d1929ef90898faULL, 0xafbd2350644eeacfULL},  // 1e-157
+    {0xdf45f746b74abf39ULL, 0xdbac6c247d62a583ULL},  // 1e-156
+    {0x6b8bba8c328eb783ULL, 0x894bc396ce5da772ULL},  // 1e-155
+    {0x066ea92f3f326564ULL, 0xab9eb47c81f5114fULL},  // 1e-154
+    {0xc80a537b0efefebdULL, 0xd686619ba27255a2ULL},  // 1e-153
+    {0xbd06742ce95f5f36ULL, 0x8613fd0145877585ULL},  // 1e-152
+    {0x2c48113823b73704ULL, 0xa798fc4196e952e7ULL},  // 1e-151
+    {0xf75a15862ca504c5ULL, 0xd17f3b51fca3a7a0ULL},  // 1e-150
+    {0x9a984d73dbe722fbULL, 0x82ef85133de648c4ULL},  // 1e-149
+    {0xc13e60d0d2e0ebbaULL, 0xa3ab66580d5fdaf5ULL},  // 1e-148
+    {0x318df905079926a8ULL, 0xcc963fee10b7d1b3ULL},  // 1e-147
+    {0xfdf17746497f7052ULL, 0xffbbcfe994e5c61fULL},  // 1e-146
+    {0xfeb6ea8bedefa633ULL, 0x9fd561f1fd0f9bd3ULL},  // 1e-145
+    {0xfe64a52ee96b8fc0ULL, 0xc7caba6e7c5382c8ULL},  // 1e-144
+    {0x3dfdce7aa3c673b0ULL, 0xf9bd690a1b68637bULL},  // 1e-143
+    {0x06bea10ca65c084eULL, 0x9c1661a651213e2dULL},  // 1e-142
+    {0x486e494fcff30a62ULL, 0xc31bfa0fe5698db8ULL},  // 1e-141
+    {0x5a89dba3c3efccfaULL, 0xf3e2f893dec3f126ULL},  // 1e-140
+    {0xf89629465a75e01cULL, 0x986ddb5c6b3a76b7ULL},  // 1e-139
+    {0xf6bbb397f1135823ULL, 0xbe89523386091465ULL},  // 1e-138
+    {0x746aa07ded582e2cULL, 0xee2ba6c0678b597fULL},  // 1e-137
+    {0xa8c2a44eb4571cdcULL, 0x94db483840b717efULL},  // 1e-136
+    {0x92f34d62616ce413ULL, 0xba121a4650e4ddebULL},  // 1e-135
+    {0x77b020baf9c81d17ULL, 0xe896a0d7e51e1566ULL},  // 1e-134
+    {0x0ace1474dc1d122eULL, 0x915e2486ef32cd60ULL},  // 1e-133
+    {0x0d819992132456baULL, 0xb5b5ada8aaff80b8ULL},  // 1e-132
+    {0x10e1fff697ed6c69ULL, 0xe3231912d5bf60e6ULL},  // 1e-131
+    {0xca8d3ffa1ef463c1ULL, 0x8df5efabc5979c8fULL},  // 1e-130
+    {0xbd308ff8a6b17cb2ULL, 0xb1736b96b6fd83b3ULL},  // 1e-129
+    {0xac7cb3f6d05ddbdeULL, 0xddd0467c64bce4a0ULL},  // 1e-128
+    {0x6bcdf07a423aa96bULL, 0x8aa22c0dbef60ee4ULL},  // 1e-127
+    {0x86c16c98d2c953c6ULL, 0xad4ab7112eb3929dULL},  // 1e-126
+    {0xe871c7bf077ba8b7ULL, 0xd89d64d57a607744ULL},  // 1e-125
+    {0x11471cd764ad4972ULL, 0x87625f056c7c4a8bULL},  // 1e-124
+    {0xd598e40d3dd89bcfULL, 0xa93af6c6c79b5d2dULL},  // 1e-123
+    {0x4aff1d108d4ec2c3ULL, 0xd389b47879823479ULL},  // 1e-122
+    {0xcedf722a585139baULL, 0x843610cb4bf160cbULL},  // 1e-121
+    {0xc2974eb4ee658828ULL, 0xa54394fe1eedb8feULL},  // 1e-120
+    {0x733d226229feea32ULL, 0xce947a3da6a9273eULL},  // 1e-119
+    {0x0806357d5a3f525fULL, 0x811ccc668829b887ULL},  // 1e-118
+    {0xca07c2dcb0cf26f7ULL, 0xa163ff802a3426a8ULL},  // 1e-117
+    {0xfc89b393dd02f0b5ULL, 0xc9bcff6034c13052ULL},  // 1e-116
+    {0xbbac2078d443ace2ULL, 0xfc2c3f3841f17c67ULL},  // 1e-115
+    {0xd54b944b84aa4c0dULL, 0x9d9ba7832936edc0ULL},  // 1e-114
+    {0x0a9e795e65d4df11ULL, 0xc5029163f384a931ULL},  // 1e-113
+    {0x4d4617b5ff4a16d5ULL, 0xf64335bcf065d37dULL},  // 1e-112
+    {0x504bced1bf8e4e45ULL, 0x99ea0196163fa42eULL},  // 1e-111
+    {0xe45ec2862f71e1d6ULL, 0xc06481fb9bcf8d39ULL},  // 1e-110
+    {0x5d767327bb4e5a4cULL, 0xf07da27a82c37088ULL},  // 1e-109
+    {0x3a6a07f8d510f86fULL, 0x964e858c91ba2655ULL},  // 1e-108
+    {0x890489f70a55368bULL, 0xbbe226efb628afeaULL},  // 1e-107
+    {0x2b45ac74ccea842eULL, 0xeadab0aba3b2dbe5ULL},  // 1e-106
+    {0x3b0b8bc90012929dULL, 0x92c8ae6b464fc96fULL},  // 1e-105
+    {0x09ce6ebb40173744ULL, 0xb77ada0617e3bbcbULL},  // 1e-104
+    {0xcc420a6a101d0515ULL, 0xe55990879ddcaabdULL},  // 1e-103
+    {0x9fa946824a12232dULL, 0x8f57fa54c2a9eab6ULL},  // 1e-102
+    {0x47939822dc96abf9ULL, 0xb32df8e9f3546564ULL},  // 1e-101
+    {0x59787e2b93bc56f7ULL, 0xdff9772470297ebdULL},  // 1e-100
+    {0x57eb4edb3c55b65aULL, 0x8bfbea76c619ef36ULL},  // 1e-99
+    {0xede622920b6b23f1ULL, 0xaefae51477a06b03ULL},  // 1e-98
+    {0xe95fab368e45ecedULL, 0xdab99e59958885c4ULL},  // 1e-97
+    {0x11dbcb0218ebb414ULL, 0x88b402f7fd75539bULL},  // 1e-96
+    {0xd652bdc29f26a119ULL, 0xaae103b5fcd2a881ULL},  // 1e-95
+    {0x4be76d3346f0495fULL, 0xd59944a37c0752a2ULL},  // 1e-94
+    {0x6f70a4400c562ddbULL, 0x857fcae62d8493a5ULL},  // 1e-93
+    {0xcb4ccd500f6bb952ULL, 0xa6dfbd9fb8e5b88eULL},  // 1e-92
+    {0x7e2000a41346a7a7ULL, 0xd097ad07a71f26b2ULL},  // 1e-91
+    {0x8ed400668c0c28c8ULL, 0x825ecc24c873782fULL},  // 1e-90
+    {0x728900802f0f32faULL, 0xa2f67f2dfa90563bULL},  // 1e-89
+    {0x4f2b40a03ad2ffb9ULL, 0xcbb41ef979346bcaULL},  // 1e-88
+    {0xe2f610c84987bfa8ULL, 0xfea126b7d78186bcULL},  // 1e-87
+    {0x0dd9ca7d2df4d7c9ULL, 0x9f24b832e6b0f436ULL},  // 1e-86
+    {0x91503d1c79720dbbULL, 0xc6ede63fa05d3143ULL},  // 1e-85
+    {0x75a44c6397ce912aULL, 0xf8a95fcf88747d94ULL},  // 1e-84
+    {0xc986afbe3ee11abaULL, 0x9b69dbe1b548ce7cULL},  // 1e-83
+    {0xfbe85badce996168ULL, 0xc24452da229b021bULL},  // 1e-82
+    {0xfae27299423fb9c3ULL, 0xf2d56790ab41c2a2ULL},  // 1e-81
+    {0xdccd879fc967d41aULL, 0x97c560ba6b0919a5ULL},  // 1e-80
+    {0x5400e987bbc1c920ULL, 0xbdb6b8e905cb600fULL},  // 1e-79
+    {0x290123e9aab23b68ULL, 0xed246723473e3813ULL},  // 1e-78
+    {0xf9a0b6720aaf6521ULL, 0x9436c0760c86e30bULL},  // 1e-77
+    {0xf808e40e8d5b3e69ULL, 0xb94470938fa89bceULL},  // 1e-76
+    {0xb60b1d1230b20e04ULL, 0xe7958cb87392c2c2ULL},  // 1e-75
+    {0xb1c6f22b5e6f48c2ULL, 0x90bd77f3483bb9b9ULL},  // 1e-74
+    {0x1e38aeb6360b1af3ULL, 0xb4ecd5f01a4aa828ULL},  // 1e-73
+    {0x25c6da63c38de1b0ULL, 0xe2280b6c20dd5232ULL},  // 1e-72
+    {0x579c487e5a38ad0eULL, 0x8d590723948a535fULL},  // 1e-71
+    {0x2d835a9df0c6d851ULL, 0xb0af48ec79ace837ULL},  // 1e-70
+    {0xf8e431456cf88e65ULL, 0xdcdb1b2798182244ULL},  // 1e-69
+    {0x1b8e9ecb641b58ffULL, 0x8a08f0f8bf0f156bULL},  // 1e-68
+    {0xe272467e3d222f3fULL, 0xac8b2d36eed2dac5ULL},  // 1e-67
+    {0x5b0ed81dcc6abb0fULL, 0xd7adf884aa879177ULL},  // 1e-66
+    {0x98e947129fc2b4e9ULL, 0x86ccbb52ea94baeaULL},  // 1e-65
+    {0x3f2398d747b36224ULL, 0xa87fea27a539e9a5ULL},  // 1e-64
+    {0x8eec7f0d19a03aadULL, 0xd29fe4b18e88640eULL},  // 1e-63
+    {0x1953cf68300424acULL, 0x83a3eeeef9153e89ULL},  // 1e-62
+    {0x5fa8c3423c052dd7ULL, 0xa48ceaaab75a8e2bULL},  // 1e-61
+    {0x3792f412cb06794dULL, 0xcdb02555653131b6ULL},  // 1e-60
+    {0xe2bbd88bbee40bd0ULL, 0x808e17555f3ebf11ULL},  // 1e-59
+    {0x5b6aceaeae9d0ec4ULL, 0xa0b19d2ab70e6ed6ULL},  // 1e-58
+    {0xf245825a5a445275ULL, 0xc8de047564d20a8bULL},  // 1e-57
+    {0xeed6e2f0f0d56712ULL, 0xfb158592be068d2eULL},  // 1e-56
+    {0x55464dd69685606bULL, 0x9ced737bb6c4183dULL},  // 1e-55
+    {0xaa97e14c3c26b886ULL, 0xc428d05aa4751e4cULL},  // 1e-54
+    {0xd53dd99f4b3066a8ULL, 0xf53304714d9265dfULL},  // 1e-53
+    {0xe546a8038efe4029ULL, 0x993fe2c6d07b7fabULL},  // 1e-52
+    {0xde98520472bdd033ULL, 0xbf8fdb78849a5f96ULL},  // 1e-51
+    {0x963e66858f6d4440ULL, 0xef73d256a5c0f77cULL},  // 1e-50
+    {0xdde7001379a44aa8ULL, 0x95a8637627989aadULL},  // 1e-49
+    {0x5560c018580d5d52ULL, 0xbb127c53b17ec159ULL},  // 1e-48
+    {0xaab8f01e6e10b4a6ULL, 0xe9d71b689dde71afULL},  // 1e-47
+    {0xcab3961304ca70e8ULL, 0x9226712162ab070dULL},  // 1e-46
+    {0x3d607b97c5fd0d22ULL, 0xb6b00d69bb55c8d1ULL},  // 1e-45
+    {0x8cb89a7db77c506aULL, 0xe45c10c42a2b3b05ULL},  // 1e-44
+    {0x77f3608e92adb242ULL, 0x8eb98a7a9a5b04e3ULL},  // 1e-43
+    {0x55f038b237591ed3ULL, 0xb267ed1940f1c61cULL},  // 1e-42
+    {0x6b6c46dec52f6688ULL, 0xdf01e85f912e37a3ULL},  // 1e-41
+    {0x2323ac4b3b3da015ULL, 0x8b61313bbabce2c6ULL},  // 1e-40
+    {0xabec975e0a0d081aULL, 0xae397d8aa96c1b77ULL},  // 1e-39
+    {0x96e7bd358c904a21ULL, 0xd9c7dced53c72255ULL},  // 1e-38
+    {0x7e50d64177da2e54ULL, 0x881cea14545c7575ULL},  // 1e-37
+    {0xdde50bd1d5d0b9e9ULL, 0xaa242499697392d2ULL},  // 1e-36
+    {0x955e4ec64b44e864ULL, 0xd4ad2dbfc3d07787ULL},  // 1e-35
+    {0xbd5af13bef0b113eULL, 0x84ec3c97da624ab4ULL},  // 1e-34
+    {0xecb1ad8aeacdd58eULL, 0xa6274bbdd0fadd61ULL},  // 1e-33
+    {0x67de18eda5814af2ULL, 0xcfb11ead453994baULL},  // 1e-32
+    {0x80eacf948770ced7ULL, 0x81ceb32c4b43fcf4ULL},  // 1e-31
+    {0xa1258379a94d028dULL, 0xa2425ff75e14fc31ULL},  // 1e-30
+    {0x096ee45813a04330ULL, 0xcad2f7f5359a3b3eULL},  // 1e-29
+    {0x8bca9d6e188853fcULL, 0xfd87b5f28300ca0dULL},  // 1e-28
+    {0x775ea264cf55347dULL, 0x9e74d1b791e07e48ULL},  // 1e-27
+    {0x95364afe032a819dULL, 0xc612062576589ddaULL},  // 1e-26
+    {0x3a83ddbd83f52204ULL, 0xf79687aed3eec551ULL},  // 1e-25
+    {0xc4926a9672793542ULL, 0x9abe14cd44753b52ULL},  // 1e-24
+    {0x75b7053c0f178293ULL, 0xc16d9a0095928a27ULL},  // 1e-23
+    {0x5324c68b12dd6338ULL, 0xf1c90080baf72cb1ULL},  // 1e-22
+    {0xd3f6fc16ebca5e03ULL, 0x971da05074da7beeULL},  // 1e-21
+    {0x88f4bb1ca6bcf584ULL, 0xbce5086492111aeaULL},  // 1e-20
+    {0x2b31e9e3d06c32e5ULL, 0xec1e4a7db69561a5ULL},  // 1e-19
+    {0x3aff322e62439fcfULL, 0x9392ee8e921d5d07ULL},  // 1e-18
+    {0x09befeb9fad487c2ULL, 0xb877aa3236a4b449ULL},  // 1e-17
+    {0x4c2ebe687989a9b3ULL, 0xe69594bec44de15bULL},  // 1e-16
+    {0x0f9d37014bf60a10ULL, 0x901d7cf73ab0acd9ULL},  // 1e-15
+    {0x538484c19ef38c94ULL, 0xb424dc35095cd80fULL},  // 1e-14
+    {0x2865a5f206b06fb9ULL, 0xe12e13424bb40e13ULL},  // 1e-13
+    {0xf93f87b7442e45d3ULL, 0x8cbccc096f5088cbULL},  // 1e-12
+    {0xf78f69a51539d748ULL, 0xafebff0bcb24aafeULL},  // 1e-11
+    {0xb573440e5a884d1bULL, 0xdbe6fecebdedd5beULL},  // 1e-10
+    {0x31680a88f8953030ULL, 0x89705f4136b4a597ULL},  // 1e-9
+    {0xfdc20d2b36ba7c3dULL, 0xabcc77118461cefcULL},  // 1e-8
+    {0x3d32907604691b4cULL, 0xd6bf94d5e57a42bcULL},  // 1e-7
+    {0xa63f9a49c2c1b10fULL, 0x8637bd05af6c69b5ULL},  // 1e-6
+    {0x0fcf80dc33721d53ULL, 0xa7c5ac471b478423ULL},  // 1e-5
+    {0xd3c36113404ea4a8ULL, 0xd1b71758e219652bULL},  // 1e-4
+    {0x645a1cac083126e9ULL, 0x83126e978d4fdf3bULL},  // 1e-3
+    {0x3d70a3d70a3d70a3ULL, 0xa3d70a3d70a3d70aULL},  // 1e-2
+    {0xccccccccccccccccULL, 0xccccccccccccccccULL},  // 1e-1
+    {0x0000000000000000ULL, 0x8000000000000000ULL},  // 1e0
+    {0x0000000000000000ULL, 0xa000000000000000ULL},  // 1e1
+    {0x0000000000000000ULL, 0xc800000000000000ULL},  // 1e2
+    {0x0000000000000000ULL, 0xfa00000000000000ULL},  // 1e3
+    {0x0000000000000000ULL, 0x9c40000000000000ULL},  // 1e4
+    {0x0000000000000000ULL, 0xc350000000000000ULL},  // 1e5
+    {0x0000000000000000ULL, 0xf424000000000000ULL},  // 1e6
+    {0x0000000000000000ULL, 0x9896800000000000ULL},  // 1e7
+    {0x0000000000000000ULL, 0xbebc200000000000ULL},  // 1e8
+    {0x0000000000000000ULL, 0xee6b280000000000ULL},  // 1e9
+    {0x0000000000000000ULL, 0x9502f90000000000ULL},  // 1e10
+    {0x0000000000000000ULL, 0xba43b74000000000ULL},  // 1e11
+    {0x0000000000000000ULL, 0xe8d4a51000000000ULL},  // 1e12
+    {0x0000000000000000ULL, 0x9184e72a00000000ULL},  // 1e13
+    {0x0000000000000000ULL, 0xb5e620f480000000ULL},  // 1e14
+    {0x0000000000000000ULL, 0xe35fa931a0000000ULL},  // 1e15
+    {0x0000000000000000ULL, 0x8e1bc9bf04000000ULL},  // 1e16
+    {0x0000000000000000ULL, 0xb1a2bc2ec5000000ULL},  // 1e17
+    {0x0000000000000000ULL, 0xde0b6b3a76400000ULL},  // 1e18
+    {0x0000000000000000ULL, 0x8ac7230489e80000ULL},  // 1e19
+    {0x0000000000000000ULL, 0xad78ebc5ac620000ULL},  // 1e20
+    {0x0000000000000000ULL, 0xd8d726b7177a8000ULL},  // 1e21
+    {0x0000000000000000ULL, 0x878678326eac9000ULL},  // 1e22
+    {0x0000000000000000ULL, 0xa968163f0a57b400ULL},  // 1e23
+    {0x0000000000000000ULL, 0xd3c21bcecceda100ULL},  // 1e24
+    {0x0000000000000000ULL, 0x84595161401484a0ULL},  // 1e25
+    {0x0000000000000000ULL, 0xa56fa5b99019a5c8ULL},  // 1e26
+    {0x0000000000000000ULL, 0xcecb8f27f4200f3aULL},  // 1e27
+    {0x4000000000000000ULL, 0x813f3978f8940984ULL},  // 1e28
+    {0x5000000000000000ULL, 0xa18f07d736b90be5ULL},  // 1e29
+    {0xa400000000000000ULL, 0xc9f2c9cd04674edeULL},  // 1e30
+    {0x4d00000000000000ULL, 0xfc6f7c4045812296ULL},  // 1e31
+    {0xf020000000000000ULL, 0x9dc5ada82b70b59dULL},  // 1e32
+    {0x6c28000000000000ULL, 0xc5371912364ce305ULL},  // 1e33
+    {0xc732000000000000ULL, 0xf684df56c3e01bc6ULL},  // 1e34
+    {0x3c7f400000000000ULL, 0x9a130b963a6c115cULL},  // 1e35
+    {0x4b9f100000000000ULL, 0xc097ce7bc90715b3ULL},  // 1e36
+    {0x1e86d40000000000ULL, 0xf0bdc21abb48db20ULL},  // 1e37
+    {0x1314448000000000ULL, 0x96769950b50d88f4ULL},  // 1e38
+    {0x17d955a000000000ULL, 0xbc143fa4e250eb31ULL},  // 1e39
+    {0x5dcfab0800000000ULL, 0xeb194f8e1ae525fdULL},  // 1e40
+    {0x5aa1cae500000000ULL, 0x92efd1b8d0cf37beULL},  // 1e41
+    {0xf14a3d9e40000000ULL, 0xb7abc627050305adULL},  // 1e42
+    {0x6d9ccd05d0000000ULL, 0xe596b7b0c643c719ULL},  // 1e43
+    {0xe4820023a2000000ULL, 0x8f7e32ce7bea5c6fULL},  // 1e44
+    {0xdda2802c8a800000ULL, 0xb35dbf821ae4f38bULL},  // 1e45
+    {0xd50b2037ad200000ULL, 0xe0352f62a19e306eULL},  // 1e46
+    {0x4526f422cc340000ULL, 0x8c213d9da502de45ULL},  // 1e47
+    {0x9670b12b7f410000ULL, 0xaf298d050e4395d6ULL},  // 1e48
+    {0x3c0cdd765f114000ULL, 0xdaf3f04651d47b4cULL},  // 1e49
+    {0xa5880a69fb6ac800ULL, 0x88d8762bf324cd0fULL},  // 1e50
+    {0x8eea0d047a457a00ULL, 0xab0e93b6efee0053ULL},  // 1e51
+    {0x72a4904598d6d880ULL, 0xd5d238a4abe98068ULL},  // 1e52
+    {0x47a6da2b7f864750ULL, 0x85a36366eb71f041ULL},  // 1e53
+    {0x999090b65f67d924ULL, 0xa70c3c40a64e6c51ULL},  // 1e54
+    {0xfff4b4e3f741cf6dULL, 0xd0cf4b50cfe20765ULL},  // 1e55
+    {0xbff8f10e7a8921a4ULL, 0x82818f1281ed449fULL},  // 1e56
+    {0xaff72d52192b6a0dULL, 0xa321f2d7226895c7ULL},  // 1e57
+    {0x9bf4f8a69f764490ULL, 0xcbea6f8ceb02bb39ULL},  // 1e58
+    {0x02f236d04753d5b4ULL, 0xfee50b7025c36a08ULL},  // 1e59
+    {0x01d762422c946590ULL, 0x9f4f2726179a2245ULL},  // 1e60
+    {0x424d3ad2b7b97ef5ULL, 0xc722f0ef9d80aad6ULL},  // 1e61
+    {0xd2e0898765a7deb2ULL, 0xf8ebad2b84e0d58bULL},  // 1e62
+    {0x63cc55f49f88eb2fULL, 0x9b934c3b330c8577ULL},  // 1e63
+    {0x3cbf6b71c76b25fbULL, 0xc2781f49ffcfa6d5ULL},  // 1e64
+    {0x8bef464e3945ef7aULL, 0xf316271c7fc3908aULL},  // 1e65
+    {0x97758bf0e3cbb5acULL, 0x97edd871cfda3a56ULL},  // 1e66
+    {0x3d52eeed1cbea317ULL, 0xbde94e8e43d0c8ecULL},  // 1e67
+    {0x4ca7aaa863ee4bddULL, 0xed63a231d4c4fb27ULL},  // 1e68
+    {0x8fe8caa93e74ef6aULL, 0x945e455f24fb1cf8ULL},  // 1e69
+    {0xb3e2fd538e122b44ULL, 0xb975d6b6ee39e436ULL},  // 1e70
+    {0x60dbbca87196b616ULL, 0xe7d34c64a9c85d44ULL},  // 1e71
+    {0xbc8955e946fe31cdULL, 0x90e40fbeea1d3a4aULL},  // 1e72
+    {0x6babab6398bdbe41ULL, 0xb51d13aea4a488ddULL},  // 1e73
+    {0xc696963c7eed2dd1ULL, 0xe264589a4dcdab14ULL},  // 1e74
+    {0xfc1e1de5cf543ca2ULL, 0x8d7eb76070a08aecULL},  // 1e75
+    {0x3b25a55f43294bcbULL, 0xb0de65388cc8ada8ULL},  // 1e76
+    {0x49ef0eb713f39ebeULL, 0xdd15fe86affad912ULL},  // 1e77
+    {0x6e3569326c784337ULL, 0x8a2dbf142dfcc7abULL},  // 1e78
+    {0x49c2c37f07965404ULL, 0xacb92ed9397bf996ULL},  // 1e79
+    {0xdc33745ec97be906ULL, 0xd7e77a8f87daf7fbULL},  // 1e80
+    {0x69a028bb3ded71a3ULL, 0x86f0ac99b4e8dafdULL},  // 1e81
+    {0xc40832ea0d68ce0cULL, 0xa8acd7c0222311bcULL},  // 1e82
+    {0xf50a3fa490c30190ULL, 0xd2d80db02aabd62bULL},  // 1e83
+    {0x792667c6da79e0faULL, 0x83c7088e1aab65dbULL},  // 1e84
+    {0x577001b891185938ULL, 0xa4b8cab1a1563f52ULL},  // 1e85
+    {0xed4c0226b55e6f86ULL, 0xcde6fd5e09abcf26ULL},  // 1e86
+    {0x544f8158315b05b4ULL, 0x80b05e5ac60b6178ULL},  // 1e87
+    {0x696361ae3db1c721ULL, 0xa0dc75f1778e39d6ULL},  // 1e88
+    {0x03bc3a19cd1e38e9ULL, 0xc913936dd571c84cULL},  // 1e89
+    {0x04ab48a04065c723ULL, 0xfb5878494ace3a5fULL},  // 1e90
+    {0x62eb0d64283f9c76ULL, 0x9d174b2dcec0e47bULL},  // 1e91
+    {0x3ba5d0bd324f8394ULL, 0xc45d1df942711d9aULL},  // 1e92
+    {0xca8f44ec7ee36479ULL, 0xf5746577930d6500ULL},  // 1e93
+    {0x7e998b13cf4e1ecbULL, 0x9968bf6abbe85f20ULL},  // 1e94
+    {0x9e3fedd8c321a67eULL, 0xbfc2ef456ae276e8ULL},  // 1e95
+    {0xc5cfe94ef3ea101eULL, 0xefb3ab16c59b14a2ULL},  // 1e96
+    {0xbba1f1d158724a12ULL, 0x95d04aee3b80ece5ULL},  // 1e97
+    {0x2a8a6e45ae8edc97ULL, 0xbb445da9ca61281fULL},  // 1e98
+    {0xf52d09d71a3293bdULL, 0xea1575143cf97226ULL},  // 1e99
+    {0x593c2626705f9c56ULL, 0x924d692ca61be758ULL},  // 1e100
+    {0x6f8b2fb00c77836cULL, 0xb6e0c377cfa2e12eULL},  // 1e101
+    {0x0b6dfb9c0f956447ULL, 0xe498f455c38b997aULL},  // 1e102
+    {0x4724bd4189bd5eacULL, 0x8edf98b59a373fecULL},  // 1e103
+    {0x58edec91ec2cb657ULL, 0xb2977ee300c50fe7ULL},  // 1e104
+    {0x2f2967b66737e3edULL, 0xdf3d5e9bc0f653e1ULL},  // 1e105
+    {0xbd79e0d20082ee74ULL, 0x8b865b215899f46cULL},  // 1e106
+    {0xecd8590680a3aa11ULL, 0xae67f1e9aec07187ULL},  // 1e107
+    {0xe80e6f4820cc9495ULL, 0xda01ee641a708de9ULL},  // 1e108
+    {0x3109058d147fdcddULL, 0x884134fe908658b2ULL},  // 1e109
+    {0xbd4b46f0599fd415ULL, 0xaa51823e34a7eedeULL},  // 1e110
+    {0x6c9e18ac7007c91aULL, 0xd4e5e2cdc1d1ea96ULL},  // 1e111
+    {0x03e2cf6bc604ddb0ULL, 0x850fadc09923329eULL},  // 1e112
+    {0x84db8346b786151cULL, 0xa6539930bf6bff45ULL},  // 1e113
+    {0xe612641865679a63ULL, 0xcfe87f7cef46ff16ULL},  // 1e114
+    {0x4fcb7e8f3f60c07eULL, 0x81f14fae158c5f6eULL},  // 1e115
+    {0xe3be5e330f38f09dULL, 0xa26da3999aef7749ULL},  // 1e116
+    {0x5cadf5bfd3072cc5ULL, 0xcb090c8001ab551cULL},  // 1e117
+    {0x73d9732fc7c8f7f6ULL, 0xfdcb4fa002162a63ULL},  // 1e118
+    {0x2867e7fddcdd9afaULL, 0x9e9f11c4014dda7eULL},  // 1e119
+    {0xb281e1fd541501b8ULL, 0xc646d63501a1511dULL},  // 1e120
+    {0x1f225a7ca91a4226ULL, 0xf7d88bc24209a565ULL},  // 1e121
+    {0x3375788de9b06958ULL, 0x9ae757596946075fULL},  // 1e122
+    {0x0052d6b1641c83aeULL, 0xc1a12d2fc3978937ULL},  // 1e123
+    {0xc0678c5dbd23a49aULL, 0xf209787bb47d6b84ULL},  // 1e124
+    {0xf840b7ba963646e0ULL, 0x9745eb4d50ce6332ULL},  // 1e125
+    {0xb650e5a93bc3d898ULL, 0xbd176620a501fbffULL},  // 1e126
+    {0xa3e51f138ab4cebeULL, 0xec5d3fa8ce427affULL},  // 1e127
+    {0xc66f336c36b10137ULL, 0x93ba47c980e98cdfULL},  // 1e128
+    {0xb80b0047445d4184ULL, 0xb8a8d9bbe123f017ULL},  // 1e129
+    {0xa60dc059157491e5ULL, 0xe6d3102ad96cec1dULL},  // 1e130
+    {0x87c89837ad68db2fULL, 0x9043ea1ac7e41392ULL},  // 1e131
+    {0x29babe4598c311fbULL, 0xb454e4a179dd1877ULL},  // 1e132
+    {0xf4296dd6fef3d67aULL, 0xe16a1dc9d8545e94ULL},  // 1e133
+    {0x1899e4a65f58660cULL, 0x8ce2529e2734bb1dULL},  // 1e134
+    {0x5ec05dcff72e7f8fULL, 0xb01ae745b101e9e4ULL},  // 1e135
+    {0x76707543f4fa1f73ULL, 0xdc21a1171d42645dULL},  // 1e136
+    {0x6a06494a791c53a8ULL, 0x899504ae72497ebaULL},  // 1e137
+    {0x0487db9d17636892ULL, 0xabfa45da0edbde69ULL},  // 1e138
+    {0x45a9d2845d3c42b6ULL, 0xd6f8d7509292d603ULL},  // 1e139
+    {0x0b8a2392ba45a9b2ULL, 0x865b86925b9bc5c2ULL},  // 1e140
+    {0x8e6cac7768d7141eULL, 0xa7f26836f282b732ULL},  // 1e141
+    {0x3207d795430cd926ULL, 0xd1ef0244af2364ffULL},  // 1e142
+    {0x7f44e6bd49e807b8ULL, 0x8335616aed761f1fULL},  // 1e143
+    {0x5f16206c9c6209a6ULL, 0xa402b9c5a8d3a6e7ULL},  // 1e144
+    {0x36dba887c37a8c0fULL, 0xcd036837130890a1ULL},  // 1e145
+    {0xc2494954da2c9789ULL, 0x802221226be55a64ULL},  // 1e146
+    {0xf2db9baa10b7bd6cULL, 0xa02aa96b06deb0fdULL},  // 1e147
+    {0x6f92829494e5acc7ULL, 0xc83553c5c8965d3dULL},  // 1e148
+    {0xcb772339ba1f17f9ULL, 0xfa42a8b73abbf48cULL},  // 1e149
+    {0xff2a760414536efbULL, 0x9c69a97284b578d7ULL},  // 1e150
+    {0xfef5138519684abaULL, 0xc38413cf25e2d70dULL},  // 1e151
+    {0x7eb258665fc25d69ULL, 0xf46518c2ef5b8cd1ULL},  // 1e152
+    {0xef2f773ffbd97a61ULL, 0x98bf2f79d5993802ULL},  // 1e153
+    {0xaafb550ffacfd8faULL, 0xbeeefb584aff8603ULL},  // 1e154
+    {0x95ba2a53f983cf38ULL, 0xeeaaba2e5dbf6784ULL},  // 1e155
+    {0xdd945a747bf26183ULL, 0x952ab45cfa97a0b2ULL},  // 1e156
+    {0x94f971119aeef9e4ULL, 0xba756174393d88dfULL},  // 1e157
+    {0x7a37cd5601aab85dULL, 0xe912b9d1478ceb17ULL},  // 1e158
+    {0xac62e055c10ab33aULL, 0x91abb422ccb812eeULL},  // 1e159
+    {0x577b986b314d6009ULL, 0xb616a12b7fe617aaULL},  // 1e160
+    {0xed5a7e85fda0b80bULL, 0xe39c49765fdf9d94ULL},  // 1e161
+    {0x14588f13be847307ULL, 0x8e41ade9fbebc27dULL},  // 1e162
+    {0x596eb2d8ae258fc8ULL, 0xb1d219647ae6b31cULL},  // 1e163
+    {0x6fca5f8ed9aef3bbULL, 0xde469fbd99a05fe3ULL},  // 1e164
+    {0x25de7bb9480d5854ULL, 0x8aec23d680043beeULL},  // 1e165
+    {0xaf561aa79a10ae6aULL, 0xada72ccc20054ae9ULL},  // 1e166
+    {0x1b2ba1518094da04ULL, 0xd910f7ff28069da4ULL},  // 1e167
+    {0x90fb44d2f05d0842ULL, 0x87aa9aff79042286ULL},  // 1e168
+    {0x353a1607ac744a53ULL, 0xa99541bf57452b28ULL},  // 1e169
+    {0x42889b8997915ce8ULL, 0xd3fa922f2d1675f2ULL},  // 1e170
+    {0x69956135febada11ULL, 0x847c9b5d7c2e09b7ULL},  // 1e171
+    {0x43fab9837e699095ULL, 0xa59bc234db398c25ULL},  // 1e172
+    {0x94f967e45e03f4bbULL, 0xcf02b2c21207ef2eULL},  // 1e173
+    {0x1d1be0eebac278f5ULL, 0x8161afb94b44f57dULL},  // 1e174
+    {0x6462d92a69731732ULL, 0xa1ba1ba79e1632dcULL},  // 1e175
+    {0x7d7b8f7503cfdcfeULL, 0xca28a291859bbf93ULL},  // 1e176
+    {0x5cda735244c3d43eULL, 0xfcb2cb35e702af78ULL},  // 1e177
+    {0x3a0888136afa64a7ULL, 0x9defbf01b061adabULL},  // 1e178
+    {0x088aaa1845b8fdd0ULL, 0xc56baec21c7a1916ULL},  // 1e179
+    {0x8aad549e57273d45ULL, 0xf6c69a72a3989f5bULL},  // 1e180
+    {0x36ac54e2f678864bULL, 0x9a3c2087a63f6399ULL},  // 1e181
+    {0x84576a1bb416a7ddULL, 0xc0cb28a98fcf3c7fULL},  // 1e182
+    {0x656d44a2a11c51d5ULL, 0xf0fdf2d3f3c30b9fULL},  // 1e183
+    {0x9f644ae5a4b1b325ULL, 0x969eb7c47859e743ULL},  // 1e184
+    {0x873d5d9f0dde1feeULL, 0xbc4665b596706114ULL},  // 1e185
+    {0xa90cb506d155a7eaULL, 0xeb57ff22fc0c7959ULL},  // 1e186
+    {0x09a7f12442d588f2ULL, 0x9316ff75dd87cbd8ULL},  // 1e187
+    {0x0c11ed6d538aeb2fULL, 0xb7dcbf5354e9beceULL},  // 1e188
+    {0x8f1668c8a86da5faULL, 0xe5d3ef282a242e81ULL},  // 1e189
+    {0xf96e017d694487bcULL, 0x8fa475791a569d10ULL},  // 1e190
+    {0x37c981dcc395a9acULL, 0xb38d92d760ec4455ULL},  // 1e191
+    {0x85bbe253f47b1417ULL, 0xe070f78d3927556aULL},  // 1e192
+    {0x93956d7478ccec8eULL, 0x8c469ab843b89562ULL},  // 1e193
+    {0x387ac8d1970027b2ULL, 0xaf58416654a6babbULL},  // 1e194
+    {0x06997b05fcc0319eULL, 0xdb2e51bfe9d0696aULL},  // 1e195
+    {0x441fece3bdf81f03ULL, 0x88fcf317f22241e2ULL},  // 1e196
+    {0xd527e81cad7626c3ULL, 0xab3c2fddeeaad25aULL},  // 1e197
+    {0x8a71e223d8d3b074ULL, 0xd60b3bd56a5586f1ULL},  // 1e198
+    {0xf6872d5667844e49ULL, 0x85c7056562757456ULL},  // 1e199
+    {0xb428f8ac016561dbULL, 0xa738c6bebb12d16cULL},  // 1e200
+    {0xe13336d701beba52ULL, 0xd106f86e69d785c7ULL},  // 1e201
+    {0xecc0024661173473ULL, 0x82a45b450226b39cULL},  // 1e202
+    {0x27f002d7f95d0190ULL, 0xa34d721642b06084ULL},  // 1e203
+    {0x31ec038df7b441f4ULL, 0xcc20ce9bd35c78a5ULL},  // 1e204
+    {0x7e67047175a15271ULL, 0xff290242c83396ceULL},  // 1e205
+    {0x0f0062c6e984d386ULL, 0x9f79a169bd203e41ULL},  // 1e206
+    {0x52c07b78a3e60868ULL, 0xc75809c42c684dd1ULL},  // 1e207
+    {0xa7709a56ccdf8a82ULL, 0xf92e0c3537826145ULL},  // 1e208
+    {0x88a66076400bb691ULL, 0x9bbcc7a142b17ccbULL},  // 1e209
+    {0x6acff893d00ea435ULL, 0xc2abf989935ddbfeULL},  // 1e210
+    {0x0583f6b8c4124d43ULL, 0xf356f7ebf83552feULL},  // 1e211
+    {0xc3727a337a8b704aULL, 0x98165af37b2153deULL},  // 1e212
+    {0x744f18c0592e4c5cULL, 0xbe1bf1b059e9a8d6ULL},  // 1e213
+    {0x1162def06f79df73ULL, 0xeda2ee1c7064130cULL},  // 1e214
+    {0x8addcb5645ac2ba8ULL, 0x9485d4d1c63e8be7ULL},  // 1e215
+    {0x6d953e2bd7173692ULL, 0xb9a74a0637ce2ee1ULL},  // 1e216
+    {0xc8fa8db6ccdd0437ULL, 0xe8111c87c5c1ba99ULL},  // 1e217
+    {0x1d9c9892400a22a2ULL, 0x910ab1d4db9914a0ULL},  // 1e218
+    {0x2503beb6d00cab4bULL, 0xb54d5e4a127f59c8ULL},  // 1e219
+    {0x2e44ae64840fd61dULL, 0xe2a0b5dc971f303aULL},  // 1e220
+    {0x5ceaecfed289e5d2ULL, 0x8da471a9de737e24ULL},  // 1e221
+    {0x7425a83e872c5f47ULL, 0xb10d8e1456105dadULL},  // 1e222
+    {0xd12f124e28f77719ULL, 0xdd50f1996b947518ULL},  // 1e223
+    {0x82bd6b70d99aaa6fULL, 0x8a5296ffe33cc92fULL},  // 1e224
+    {0x636cc64d1001550bULL, 0xace73cbfdc0bfb7bULL},  // 1e225
+    {0x3c47f7e05401aa4eULL, 0xd8210befd30efa5aULL},  // 1e226
+    {0x65acfaec34810a71ULL, 0x8714a775e3e95c78ULL},  // 1e227
+    {0x7f1839a741a14d0dULL, 0xa8d9d1535ce3b396ULL},  // 1e228
+    {0x1ede48111209a050ULL, 0xd31045a8341ca07cULL},  // 1e229
+    {0x934aed0aab460432ULL, 0x83ea2b892091e44dULL},  // 1e230
+    {0xf81da84d5617853fULL, 0xa4e4b66b68b65d60ULL},  // 1e231
+    {0x36251260ab9d668eULL, 0xce1de40642e3f4b9ULL},  // 1e232
+    {0xc1d72b7c6b426019ULL, 0x80d2ae83e9ce78f3ULL},  // 1e233
+    {0xb24cf65b8612f81fULL, 0xa1075a24e4421730ULL},  // 1e234
+    {0xdee033f26797b627ULL, 0xc94930ae1d529cfcULL},  // 1e235
+    {0x169840ef017da3b1ULL, 0xfb9b7cd9a4a7443cULL},  // 1e236
+    {0x8e1f289560ee864eULL, 0x9d412e0806e88aa5ULL},  // 1e237
+    {0xf1a6f2bab92a27e2ULL, 0xc491798a08a2ad4eULL},  // 1e238
+    {0xae10af696774b1dbULL, 0xf5b5d7ec8acb58a2ULL},  // 1e239
+    {0xacca6da1e0a8ef29ULL, 0x9991a6f3d6bf1765ULL},  // 1e240
+    {0x17fd090a58d32af3ULL, 0xbff610b0cc6edd3fULL},  // 1e241
+    {0xddfc4b4cef07f5b0ULL, 0xeff394dcff8a948eULL},  // 1e242
+    {0x4abdaf101564f98eULL, 0x95f83d0a1fb69cd9ULL},  // 1e243
+    {0x9d6d1ad41abe37f1ULL, 0xbb764c4ca7a4440fULL},  // 1e244
+    {0x84c86189216dc5edULL, 0xea53df5fd18d5513ULL},  // 1e245
+    {0x32fd3cf5b4e49bb4ULL, 0x92746b9be2f8552cULL},  // 1e246
+    {0x3fbc8c33221dc2a1ULL, 0xb7118682dbb66a77ULL},  // 1e247
+    {0x0fabaf3feaa5334aULL, 0xe4d5e82392a40515ULL},  // 1e248
+    {0x29cb4d87f2a7400eULL, 0x8f05b1163ba6832dULL},  // 1e249
+    {0x743e20e9ef511012ULL, 0xb2c71d5bca9023f8ULL},  // 1e250
+    {0x914da9246b255416ULL, 0xdf78e4b2bd342cf6ULL},  // 1e251
+    {0x1ad089b6c2f7548eULL, 0x8bab8eefb6409c1aULL},  // 1e252
+    {0xa184ac2473b529b1ULL, 0xae9672aba3d0c320ULL},  // 1e253
+    {0xc9e5d72d90a2741eULL, 0xda3c0f568cc4f3e8ULL},  // 1e254
+    {0x7e2fa67c7a658892ULL, 0x8865899617fb1871ULL},  // 1e255
+    {0xddbb901b98feeab7ULL, 0xaa7eebfb9df9de8dULL},  // 1e256
+    {0x552a74227f3ea565ULL, 0xd51ea6fa85785631ULL},  // 1e257
+    {0xd53a88958f87275fULL, 0x8533285c936b35deULL},  // 1e258
+    {0x8a892abaf368f137ULL, 0xa67ff273b8460356ULL},  // 1e259
+    {0x2d2b7569b0432d85ULL, 0xd01fef10a657842cULL},  // 1e260
+    {0x9c3b29620e29fc73ULL, 0x8213f56a67f6b29bULL},  // 1e261
+    {0x8349f3ba91b47b8fULL, 0xa298f2c501f45f42ULL},  // 1e262
+    {0x241c70a936219a73ULL, 0xcb3f2f7642717713ULL},  // 1e263
+    {0xed238cd383aa0110ULL, 0xfe0efb53d30dd4d7ULL},  // 1e264
+    {0xf4363804324a40aaULL, 0x9ec95d1463e8a506ULL},  // 1e265
+    {0xb143c6053edcd0d5ULL, 0xc67bb4597ce2ce48ULL},  // 1e266
+    {0xdd94b7868e94050aULL, 0xf81aa16fdc1b81daULL},  // 1e267
+    {0xca7cf2b4191c8326ULL, 0x9b10a4e5e9913128ULL},  // 1e268
+    {0xfd1c2f611f63a3f0ULL, 0xc1d4ce1f63f57d72ULL},  // 1e269
+    {0xbc633b39673c8cecULL, 0xf24a01a73cf2dccfULL},  // 1e270
+    {0xd5be0503e085d813ULL, 0x976e41088617ca01ULL},  // 1e271
+    {0x4b2d8644d8a74e18ULL, 0xbd49d14aa79dbc82ULL},  // 1e272
+    {0xddf8e7d60ed1219eULL, 0xec9c459d51852ba2ULL},  // 1e273
+    {0xcabb90e5c942b503ULL, 0x93e1ab8252f33b45ULL},  // 1e274
+    {0x3d6a751f3b936243ULL, 0xb8da1662e7b00a17ULL},  // 1e275
+    {0x0cc512670a783ad4ULL, 0xe7109bfba19c0c9dULL},  // 1e276
+    {0x27fb2b80668b24c5ULL, 0x906a617d450187e2ULL},  // 1e277
+    {0xb1f9f660802dedf6ULL, 0xb484f9dc9641e9daULL},  // 1e278
+    {0x5e7873f8a0396973ULL, 0xe1a63853bbd26451ULL},  // 1e279
+    {0xdb0b487b6423e1e8ULL, 0x8d07e33455637eb2ULL},  // 1e280
+    {0x91ce1a9a3d2cda62ULL, 0xb049dc016abc5e5fULL},  // 1e281
+    {0x7641a140cc7810fbULL, 0xdc5c5301c56b75f7ULL},  // 1e282
+    {0xa9e904c87fcb0a9dULL, 0x89b9b3e11b6329baULL},  // 1e283
+    {0x546345fa9fbdcd44ULL, 0xac2820d9623bf429ULL},  // 1e284
+    {0xa97c177947ad4095ULL, 0xd732290fbacaf133ULL},  // 1e285
+    {0x49ed8eabcccc485dULL, 0x867f59a9d4bed6c0ULL},  // 1e286
+    {0x5c68f256bfff5a74ULL, 0xa81f301449ee8c70ULL},  // 1e287
+    {0x73832eec6fff3111ULL, 0xd226fc195c6a2f8cULL},  // 1e288
+    {0xc831fd53c5ff7eabULL, 0x83585d8fd9c25db7ULL},  // 1e289
+    {0xba3e7ca8b77f5e55ULL, 0xa42e74f3d032f525ULL},  // 1e290
+    {0x28ce1bd2e55f35ebULL, 0xcd3a1230c43fb26fULL},  // 1e291
+    {0x7980d163cf5b81b3ULL, 0x80444b5e7aa7cf85ULL},  // 1e292
+    {0xd7e105bcc332621fULL, 0xa0555e361951c366ULL},  // 1e293
+    {0x8dd9472bf3fefaa7ULL, 0xc86ab5c39fa63440ULL},  // 1e294
+    {0xb14f98f6f0feb951ULL, 0xfa856334878fc150ULL},  // 1e295
+    {0x6ed1bf9a569f33d3ULL, 0x9c935e00d4b9d8d2ULL},  // 1e296
+    {0x0a862f80ec4700c8ULL, 0xc3b8358109e84f07ULL},  // 1e297
+    {0xcd27bb612758c0faULL, 0xf4a642e14c6262c8ULL},  // 1e298
+    {0x8038d51cb897789cULL, 0x98e7e9cccfbd7dbdULL},  // 1e299
+    {0xe0470a63e6bd56c3ULL, 0xbf21e44003acdd2cULL},  // 1e300
+    {0x1858ccfce06cac74ULL, 0xeeea5d5004981478ULL},  // 1e301
+    {0x0f37801e0c43ebc8ULL, 0x95527a5202df0ccbULL},  // 1e302
+    {0xd30560258f54e6baULL, 0xbaa718e68396cffdULL},  // 1e303
+    {0x47c6b82ef32a2069ULL, 0xe950df20247c83fdULL},  // 1e304
+    {0x4cdc331d57fa5441ULL, 0x91d28b7416cdd27eULL},  // 1e305
+    {0xe0133fe4adf8e952ULL, 0xb6472e511c81471dULL},  // 1e306
+    {0x58180fddd97723a6ULL, 0xe3d8f9e563a198e5ULL},  // 1e307
+    {0x570f09eaa7ea7648ULL, 0x8e679c2f5e44ff8fULL},  // 1e308
+    {0x2cd2cc6551e513daULL, 0xb201833b35d63f73ULL},  // 1e309
+    {0xf8077f7ea65e58d1ULL, 0xde81e40a034bcf4fULL},  // 1e310
+    {0xfb04afaf27faf782ULL, 0x8b112e86420f6191ULL},  // 1e311
+    {0x79c5db9af1f9b563ULL, 0xadd57a27d29339f6ULL},  // 1e312
+    {0x18375281ae7822bcULL, 0xd94ad8b1c7380874ULL},  // 1e313
+    {0x8f2293910d0b15b5ULL, 0x87cec76f1c830548ULL},  // 1e314
+    {0xb2eb3875504ddb22ULL, 0xa9c2794ae3a3c69aULL},  // 1e315
+    {0x5fa60692a46151ebULL, 0xd433179d9c8cb841ULL},  // 1e316
+    {0xdbc7c41ba6bcd333ULL, 0x849feec281d7f328ULL},  // 1e317
+    {0x12b9b522906c0800ULL, 0xa5c7ea73224deff3ULL},  // 1e318
+    {0xd768226b34870a00ULL, 0xcf39e50feae16befULL},  // 1e319
+    {0xe6a1158300d46640ULL, 0x81842f29f2cce375ULL},  // 1e320
+    {0x60495ae3c1097fd0ULL, 0xa1e53af46f801c53ULL},  // 1e321
+    {0x385bb19cb14bdfc4ULL, 0xca5e89b18b602368ULL},  // 1e322
+    {0x46729e03dd9ed7b5ULL, 0xfcf62c1dee382c42ULL},  // 1e323
+    {0x6c07a2c26a8346d1ULL, 0x9e19db92b4e31ba9ULL},  // 1e324
+    {0xc7098b7305241885ULL, 0xc5a05277621be293ULL},  // 1e325
+    {0xb8cbee4fc66d1ea7ULL, 0xf70867153aa2db38ULL},  // 1e326
+    {0x737f74f1dc043328ULL, 0x9a65406d44a5c903ULL},  // 1e327
+    {0x505f522e53053ff2ULL, 0xc0fe908895cf3b44ULL},  // 1e328
+    {0x647726b9e7c68fefULL, 0xf13e34aabb430a15ULL},  // 1e329
+    {0x5eca783430dc19f5ULL, 0x96c6e0eab509e64dULL},  // 1e330
+    {0xb67d16413d132072ULL, 0xbc789925624c5fe0ULL},  // 1e331
+    {0xe41c5bd18c57e88fULL, 0xeb96bf6ebadf77d8ULL},  // 1e332
+    {0x8e91b962f7b6f159ULL, 0x933e37a534cbaae7ULL},  // 1e333
+    {0x723627bbb5a4adb0ULL, 0xb80dc58e81fe95a1ULL},  // 1e334
+    {0xcec3b1aaa30dd91cULL, 0xe61136f2227e3b09ULL},  // 1e335
+    {0x213a4f0aa5e8a7b1ULL, 0x8fcac257558ee4e6ULL},  // 1e336
+    {0xa988e2cd4f62d19dULL, 0xb3bd72ed2af29e1fULL},  // 1e337
+    {0x93eb1b80a33b8605ULL, 0xe0accfa875af45a7ULL},  // 1e338
+    {0xbc72f130660533c3ULL, 0x8c6c01c9498d8b88ULL},  // 1e339
+    {0xeb8fad7c7f8680b4ULL, 0xaf87023b9bf0ee6aULL},  // 1e340
+    {0xa67398db9f6820e1ULL, 0xdb68c2ca82ed2a05ULL},  // 1e341
+    {0x88083f8943a1148cULL, 0x892179be91d43a43ULL},  // 1e342
+    {0x6a0a4f6b948959b0ULL, 0xab69d82e364948d4ULL},  // 1e343
+    {0x848ce34679abb01cULL, 0xd6444e39c3db9b09ULL},  // 1e344
+    {0xf2d80e0c0c0b4e11ULL, 0x85eab0e41a6940e5ULL},  // 1e345
+    {0x6f8e118f0f0e2195ULL, 0xa7655d1d2103911fULL},  // 1e346
+    {0x4b7195f2d2d1a9fbULL, 0xd13eb46469447567ULL},  // 1e347
+};
+
+#define SSTR_POW10_128_MIN (-348)
+#define SSTR_POW10_128_MAX 347
+
+// exactly representable powers of ten.
+static const double sstr_exact_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// a * b, the low 64 bits are returned, the high ones stored in *hi.
+static uint64_t sstr_mul64(uint64_t a, uint64_t b, uint64_t* hi) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *hi = (uint64_t)(r >> 64);
+    return (uint64_t)r;
+#else
+    const uint64_t m32 = 0xFFFFFFFFULL;
+    uint64_t a_lo = a & m32, a_hi = a >> 32, b_lo = b & m32, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & m32) + lo_hi;
+
+    *hi = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    return (cross << 32) | (lo_lo & m32);
+#endif
+}
+
+// w * 10^q correctly rounded, w != 0. Return 0 if the result could not be
+// decided, or is subnormal, infinite or out of the table.
+static int sstr_eisel_lemire(uint64_t w, int q, int negative, double* v) {
+    uint64_t x_hi, x_lo, y_hi, y_lo, merged_hi, merged_lo, mant, bits;
+    int64_t exp2;
+    unsigned clz, msb;
+    const uint64_t* pow;
+
+    if (q < SSTR_POW10_128_MIN || q > SSTR_POW10_128_MAX) {
+        return 0;
+    }
+    pow = sstr_pow10_128[q - SSTR_POW10_128_MIN];
+
+    clz = sstr_clz64(w);
+    w <<= clz;
+    // floor(q * log2(10)), 217706 / 2^16 ~ log2(10)
+    exp2 = (int64_t)(((int64_t)217706 * q) >> 16) + 64 + 1023 - clz;
+
+    x_lo = sstr_mul64(w, pow[1], &x_hi);
+    // the low word of 10^q matters only if the product is near a boundary
+    if ((x_hi & 0x1FF) == 0x1FF && x_lo + w < w) {
+        y_lo = sstr_mul64(w, pow[0], &y_hi);
+        merged_hi = x_hi;
+        merged_lo = x_lo + y_hi;
+        if (merged_lo < x_lo) {
+            merged_hi++;
+        }
+        if ((merged_hi & 0x1FF) == 0x1FF && merged_lo + 1 == 0 &&
+            y_lo + w < w) {
+            return 0;
+        }
+        x_hi = merged_hi;
+        x_lo = merged_lo;
+    }
+
+    // 54 bits, then round to 53
+    msb = (unsigned)(x_hi >> 63);
+    mant = x_hi >> (msb + 9);
+    exp2 -= 1 ^ msb;
+    if (x_lo == 0 && (x_hi & 0x1FF) == 0 && (mant & 3) == 1) {
+        return 0;  // maybe halfway, the truncated bits decide
+    }
+    mant += mant & 1;
+    mant >>= 1;
+    if (mant >> 53) {
+        mant >>= 1;
+        exp2++;
+    }
+    if (exp2 <= 0 || exp2 >= 0x7FF) {
+        return 0;
+    }
+
+    bits = ((uint64_t)exp2 << SSTR_DBL_FRAC_BITS) | (mant & SSTR_DBL_FRAC_MASK);
+    if (negative) {
+        bits |= SSTR_DBL_SIGN_MASK;
+    }
+    memcpy(v, &bits, sizeof(*v));
+    return 1;
+}
+
+// enough significant digits to round any double correctly, when a non-zero
+// digit is appended for the ones cut off.
+#define SSTR_PARSE_MAX_DIGITS 768
+
+// slow path: hand the digits to strtod() as "<digits>e<exp>".
+static double sstr_parse_double_slow(const char* int_start, size_t int_len,
+                                     const char* frac_start, size_t frac_len,
+                                     int64_t exp10, int negative) {
+    char buf[SSTR_PARSE_MAX_DIGITS + 32];
+    const char* part[2];
+    size_t len[2], i, n = 0;
+    int k, nonzero = 0;
+    double r;
+
+    part[0] = int_start;
+    len[0] = int_len;
+    part[1] = frac_start;
+    len[1] = frac_len;
+    exp10 -= (int64_t)frac_len;
+    for (k = 0; k < 2; ++k) {
+        for (i = 0; i < len[k]; ++i) {
+            if (n == 0 && part[k][i] == '0') {
+                continue;
+            }
+            if (n < SSTR_PARSE_MAX_DIGITS) {
+                buf[n++] = part[k][i];
+            } else {
+                nonzero |= part[k][i] != '0';
+                exp10++;
+            }
+        }
+    }
+    if (nonzero) {
+        buf[n++] = '1';
+        exp10--;
+    }
+    if (n == 0) {
+        buf[n++] = '0';
+    }
+    snprintf(buf + n, sizeof(buf) - n, "e%ld", (long)exp10);
+    r = strtod(buf, NULL);
+    return negative ? -r : r;
+}
+
+// "inf", "infinity" or "nan" in any case, return the end, or p.
+static const char* sstr_parse_special(const char* p, const char* end,
+                                      double* v) {
+    static const char infinity[] = "infinity";
+    size_t n = (size_t)(end - p), i;
+
+    if (n >= 3 && (p[0] | 0x20) == 'n' && (p[1] | 0x20) == 'a' &&
+        (p[2] | 0x20) == 'n') {
+        *v = NAN;
+        return p + 3;
+    }
+    for (i = 0; i < 3 && i < n && (p[i] | 0x20) == infinity[i]; ++i) {
+    }
+    if (i < 3) {
+        return p;
+    }
+    while (i < 8 && i < n && (p[i] | 0x20) == infinity[i]) {
+        ++i;
+    }
+    *v = INFINITY;
+    return p + (i == 8 ? 8 : 3);
+}
+
+int sstr_parse_f64_of(const void* data, size_t length, double* v,
+                         size_t* consumed) {
+    const char *p, *q, *start, *end = (const char*)data + length;
+    const char *int_start, *frac_start = NULL, *int_end, *frac_end;
+    size_t int_len, frac_len = 0, digits;
+    uint64_t w = 0, w_exp;
+    int64_t exp10 = 0, exp_number = 0;
+    int negative, exp_negative, overflow, many = 0, rc = SSTR_PARSE_OK;
+    double r;
+
+    start = sstr_parse_prefix((const char*)data, end, &negative);
+    p = start;
+
+    int_start = p;
+    p = sstr_scan_digits(p, end, &w);
+    int_len = (size_t)(p - int_start);
+    if (p < end && *p == '.') {
+        frac_start = ++p;
+        p = sstr_scan_digits(p, end, &w);
+        frac_len = (size_t)(p - frac_start);
+    }
+
+    if (int_len + frac_len == 0) {
+        q = sstr_parse_special(start, end, &r);
+        if (q == start) {
+            *v = 0;
+            if (consumed) {
+                *consumed = 0;
+            }
+            return SSTR_PARSE_INVALID;
+        }
+        *v = negative ? -r : r;
+        if (consumed) {
+            *consumed = (size_t)(q - (const char*)data);
+        }
+        return SSTR_PARSE_OK;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        q = p + 1;
+        exp_negative = 0;
+        if (q < end && (*q == '-' || *q == '+')) {
+            exp_negative = *q++ == '-';
+        }
+        if (q < end && SSTR_IS_DIGIT(*q)) {
+            p = sstr_parse_digits(q, end, &w_exp, &overflow);
+            exp_number = w_exp > 100000 ? 100000 : (int64_t)w_exp;
+            if (exp_negative) {
+                exp_number = -exp_number;
+            }
+        }
+    }
+    if (consumed) {
+        *consumed = (size_t)(p - (const char*)data);
+    }
+
+    // more than 19 significant digits: w keeps the first 19 of them
+    int_end = int_start + int_len;
+    frac_end = frac_start ? frac_start + frac_len : NULL;
+    digits = int_len + frac_len;
+    exp10 = exp_number - (int64_t)frac_len;
+    if (digits > 19) {
+        for (q = int_start; q < int_end && *q == '0'; ++q) {
+            digits--;
+        }
+        if (q == int_end && frac_len) {
+            for (q = frac_start; q < frac_end && *q == '0'; ++q) {
+                digits--;
+            }
+        }
+        if (digits > 19) {
+            many = 1;
+            w = 0;
+            for (q = int_start; q < int_end && w < 1000000000000000000ULL;
+                 ++q) {
+                w = w * 10 + (uint64_t)(*q - '0');
+            }
+            if (w >= 1000000000000000000ULL) {
+                exp10 = exp_number + (int64_t)(int_end - q);
+            } else {
+                for (q = frac_start; q < frac_end &&
+                                     w < 1000000000000000000ULL;
+                     ++q) {
+                    w = w * 10 + (uint64_t)(*q - '0');
+                }
+                exp10 = exp_number - (int64_t)(q - frac_start);
+            }
+        }
+    }
+
+    if (w == 0) {
+        *v = negative ? -0.0 : 0.0;
+        return rc;
+    }
+
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+    // Clinger: w and 10^|exp10| are exact, one rounding
+    if (!many && w <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+        r = (double)w;
+        r = exp10 < 0 ? r / sstr_exact_pow10[-exp10]
+                      : r * sstr_exact_pow10[exp10];
+        *v = negative ? -r : r;
+        return rc;
+    }
+#endif
+
+    if (sstr_eisel_lemire(w, (int)exp10, negative, &r)) {
+        // the cut off digits lie between w and w + 1
+        double r1;
+        if (!many || (sstr_eisel_lemire(w + 1, (int)exp10, negative, &r1) &&
+                      r == r1)) {
+            *v = r;
+            return rc;
+        }
+    }
+
+    r = sstr_parse_double_slow(int_start, int_len, frac_start, frac_len,
+                               exp_number, negative);
+    if (r == 0 || r == INFINITY || r == -INFINITY) {
+        rc = SSTR_PARSE_RANGE;
+    }
+    *v = r;
+    return rc;
+}
+
+int sstr_parse_f64(sstr_t s, double* v, size_t* consumed) {
+    return sstr_parse_f64_of(STR_PTR(s), sstr_length(s), v, consumed);
+}
+
+int sstr_parse_long(sstr_t s, long* v) {
+    int64_t i64;
+    size_t n;
+
+    sstr_parse_i64(s, &i64, &n);
+#if LONG_MAX < INT64_MAX
+    if (i64 > LONG_MAX) {
+        i64 = LONG_MAX;
+    } else if (i64 < LONG_MIN) {
+        i64 = LONG_MIN;
+    }
+#endif
+    *v = (long)i64;
+    return (int)n;
+}
+
+int sstr_parse_int(sstr_t s, int* v) {
+    int32_t i32;
+    size_t n;
+
+    sstr_parse_i32(s, &i32, &n);
+    *v = (int)i32;
+    return (int)n;
+}
+
+int sstr_parse_double(sstr_t s, double* v) {
+    size_t n;
+
+    sstr_parse_f64(s, v, &n);
+    return (int)n;
+}
+
+// the byte after the backslash for bytes that must be escaped in a JSON
+// string, 'u' for \u00XX, 0 for bytes copied as is.
+static const unsigned char sstr_json_escape_table[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',  // 0
+    'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',  // 8
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',  // 16
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',  // 24
+    0, 0, '"', 0, 0, 0, 0, 0,  // 32
+    0, 0, 0, 0, 0, 0, 0, 0,  // 40
+    0, 0, 0, 0, 0, 0, 0, 0,  // 48
+    0, 0, 0, 0, 0, 0, 0, 0,  // 56
+    0, 0, 0, 0, 0, 0, 0, 0,  // 64
+    0, 0, 0, 0, 0, 0, 0, 0,  // 72
+    0, 0, 0, 0, 0, 0, 0, 0,  // 80
+    0, 0, 0, 0, '\\',  // 88
+};
+
+// Escapes are found a block of 32 (AVX2) or 16 (SSE2) bytes at a time. The
+// block is stored to the output before looking at its mask, a clean block is
+// then done, otherwise the bytes up to the first escape are kept.
+#if defined(__AVX2__)
+#define SSTR_JSON_BLOCK 32
+static unsigned sstr_json_block(const unsigned char* p, unsigned char* o) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i bslash = _mm256_set1_epi8('\\');
+    const __m256i ctl = _mm256_set1_epi8(0x1F);
+    __m256i v = _mm256_loadu_si256((const __m256i*)p);
+
+    _mm256_storeu_si256((__m256i*)o, v);
+    // v <= 0x1F unsigned <=> max(v, 0x1F) == 0x1F
+    return (unsigned)_mm256_movemask_epi8(_mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                        _mm256_cmpeq_epi8(v, bslash)),
+        _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctl), ctl)));
+}
+#elif defined(__SSE2__)
+#define SSTR_JSON_BLOCK 16
+static unsigned sstr_json_block(const unsigned char* p, unsigned char* o) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i bslash = _mm_set1_epi8('\\');
+    const __m128i ctl = _mm_set1_epi8(0x1F);
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+
+    _mm_storeu_si128((__m128i*)o, v);
+    return (unsigned)_mm_movemask_epi8(
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                  _mm_cmpeq_epi8(v, bslash)),
+                     _mm_cmpeq_epi8(_mm_max_epu8(v, ctl), ctl)));
+}
+#endif
+
+// write the escape sequence of c, return the end.
+static unsigned char* sstr_json_escape_byte(unsigned char* o, unsigned char c) {
+    unsigned char e = sstr_json_escape_table[c];
+
+    *o++ = '\\';
+    *o++ = e;
+    if (e == 'u') {
+        *o++ = '0';
+        *o++ = '0';
+        char_to_hex(c, o, 0);
+        o += 2;
+    }
+    return o;
+}
+
+int sstr_json_escape_string_append(sstr_t out, sstr_t in) {
+    STR* ss = SSTR(out);
+    const unsigned char *p, *end;
+    unsigned char* o;
+#ifdef SSTR_JSON_BLOCK
+    unsigned mask, n;
+#endif
+
+    if (in == NULL) {
+        return 0;
+    }
+    p = (const unsigned char*)STR_PTR(in);
+    end = p + sstr_length(in);
+
+    // every byte may become \u00XX, this also leaves room for the block
+    // stores, escape straight into the buffer.
+    sstr_grow(ss, sstr_length(in) * 6);
+    o = (unsigned char*)STR_PTR(ss) + sstr_length(ss);
+#ifdef SSTR_JSON_BLOCK
+    while (end - p >= SSTR_JSON_BLOCK) {
+        mask = sstr_json_block(p, o);
+        if (mask == 0) {
+            p += SSTR_JSON_BLOCK;
+            o += SSTR_JSON_BLOCK;
+            continue;
+        }
+        n = sstr_ctz64(mask);
+        o = sstr_json_escape_byte(o + n, p[n]);
+        p += n + 1;
+    }
+#endif
+    for (; p < end; ++p) {
+        if (sstr_json_escape_table[*p]) {
+            o = sstr_json_escape_byte(o, *p);
+        } else {
+            *o++ = *p;
+        }
+    }
+    *o = '\0';
+    sstr_set_length(ss, o - (unsigned char*)STR_PTR(ss));
+    return 0;
+}
+
+// value of 4 hexadecimal digits at p, -1 if they are not.
+static long sstr_hex4(const unsigned char* p) {
+    long v = 0;
+    int i, d;
+
+    for (i = 0; i < 4; ++i) {
+        if (p[i] >= '0' && p[i] <= '9') {
+            d = p[i] - '0';
+        } else if ((p[i] | 0x20) >= 'a' && (p[i] | 0x20) <= 'f') {
+            d = (p[i] | 0x20) - 'a' + 10;
+        } else {
+            return -1;
+        }
+        v = (v << 4) | d;
+    }
+    return v;
+}
+
+// write the UTF-8 encoding of code point cp, return the end.
+static unsigned char* sstr_utf8_put(unsigned char* o, uint32_t cp) {
+    if (cp < 0x80) {
+        *o++ = (unsigned char)cp;
+    } else if (cp < 0x800) {
+        *o++ = (unsigned char)(0xC0 | (cp >> 6));
+        *o++ = (unsigned char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *o++ = (unsigned char)(0xE0 | (cp >> 12));
+        *o++ = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+        *o++ = (unsigned char)(0x80 | (cp & 0x3F));
+    } else {
+        *o++ = (unsigned char)(0xF0 | (cp >> 18));
+        *o++ = (unsigned char)(0x80 | ((cp >> 12) & 0x3F));
+        *o++ = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+        *o++ = (unsigned char)(0x80 | (cp & 0x3F));
+    }
+    return o;
+}
+
+int sstr_json_unescape_string_append(sstr_t out, sstr_t in) {
+    STR* ss = SSTR(out);
+    const unsigned char *p, *q, *end;
+    unsigned char* o;
+    size_t oldlen = sstr_length(ss);
+    long cp, lo;
+
+    if (in == NULL) {
+        return 0;
+    }
+    p = (const unsigned char*)STR_PTR(in);
+    end = p + sstr_length(in);
+
+    // no escape sequence is shorter than what it stands for
+    sstr_grow(ss, sstr_length(in));
+    o = (unsigned char*)STR_PTR(ss) + sstr_length(ss);
+    for (;;) {
+        q = (const unsigned char*)memchr(p, '\\', end - p);
+        if (q == NULL) {
+            q = end;
+        }
+        memcpy(o, p, q - p);
+        o += q - p;
+        if (q == end) {
+            break;
+        }
+        if (end - q < 2) {
+            goto fail;
+        }
+        p = q + 2;
+        switch (q[1]) {
+            case '"':
+            case '\\':
+            case '/':
+                *o++ = q[1];
+                break;
+            case 'b':
+                *o++ = '\b';
+                break;
+            case 'f':
+                *o++ = '\f';
+                break;
+            case 'n':
+                *o++ = '\n';
+                break;
+            case 'r':
+                *o++ = '\r';
+                break;
+            case 't':
+                *o++ = '\t';
+                break;
+            case 'u':
+                if (end - p < 4 || (cp = sstr_hex4(p)) < 0) {
+                    goto fail;
+                }
+                p += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // a high surrogate pairs with a low one: \ud83d\ude00
+                    if (end - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+                        (lo = sstr_hex4(p + 2)) >= 0xDC00 && lo <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        p += 6;
+                    } else {
+                        cp = 0xFFFD;
+                    }
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    cp = 0xFFFD;
+                }
+                o = sstr_utf8_put(o, (uint32_t)cp);
+                break;
+            default:
+                goto fail;
+        }
+    }
+    *o = '\0';
+    sstr_set_length(ss, o - (unsigned char*)STR_PTR(ss));
+    return 0;
+
+fail:
+    STR_PTR(ss)[oldlen] = '\0';
+    sstr_set_length(ss, oldlen);
+    return -1;
+}
+
+void sstr_append_of_if(sstr_t s, const void* data, size_t length, int cond) {
+    if (cond) {
+        size_t oldlen = sstr_length(s);
+        sstr_append_zero(s, length);
+        memcpy(STR_PTR(s) + oldlen, data, length);
+        STR_PTR(s)[sstr_length(s)] = '\0';
+    }
+}
+
+void sstr_append_indent(sstr_t s, size_t indent) {
+    if (indent == 0) {
+        return;
+    }
+    size_t cur_len = sstr_length(s);
+    sstr_append_zero(s, indent);
+    for (size_t i = 0; i < indent; i++) {
+        STR_PTR(s)[cur_len + i] = ' ';
+    }
+}
+
+/*
+ * Searching.
+ *
+ * The substring search compares the first and the last byte of the needle
+ * with 32 (AVX2) or 16 (SSE2) positions of the haystack at once. Text often
+ * repeats such a pair (think of "e...t"), so the second byte is compared as
+ * well, and only positions where all three match are verified with memcmp().
+ * A branch per false candidate costs more than the third comparison. Single
+ * bytes are looked up with memchr(), which the C library already vectorizes.
+ * Without SSE2 the same filtering runs one position at a time.
+ */
+
+#if defined(__AVX2__)
+#define SSTR_VEC_BYTES 32
+#define SSTR_VEC_T __m256i
+#define SSTR_VEC_LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define SSTR_VEC_SET1(c) _mm256_set1_epi8((char)(c))
+#define SSTR_VEC_EQ(a, b) _mm256_cmpeq_epi8(a, b)
+#define SSTR_VEC_AND(a, b) _mm256_and_si256(a, b)
+#define SSTR_VEC_MASK(v) ((uint32_t)_mm256_movemask_epi8(v))
+#define SSTR_VEC_STORE(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define SSTR_VEC_OR(a, b) _mm256_or_si256(a, b)
+#define SSTR_VEC_XOR(a, b) _mm256_xor_si256(a, b)
+#define SSTR_VEC_ADD(a, b) _mm256_add_epi8(a, b)
+#define SSTR_VEC_SUB(a, b) _mm256_sub_epi8(a, b)
+#define SSTR_VEC_GT(a, b) _mm256_cmpgt_epi8(a, b)
+#elif defined(__SSE2__)
+#define SSTR_VEC_BYTES 16
+#define SSTR_VEC_T __m128i
+#define SSTR_VEC_LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define SSTR_VEC_SET1(c) _mm_set1_epi8((char)(c))
+#define SSTR_VEC_EQ(a, b) _mm_cmpeq_epi8(a, b)
+#define SSTR_VEC_AND(a, b) _mm_and_si128(a, b)
+#define SSTR_VEC_MASK(v) ((uint32_t)_mm_movemask_epi8(v))
+#define SSTR_VEC_STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define SSTR_VEC_OR(a, b) _mm_or_si128(a, b)
+#define SSTR_VEC_XOR(a, b) _mm_xor_si128(a, b)
+#define SSTR_VEC_ADD(a, b) _mm_add_epi8(a, b)
+#define SSTR_VEC_SUB(a, b) _mm_sub_epi8(a, b)
+#define SSTR_VEC_GT(a, b) _mm_cmpgt_epi8(a, b)
+#endif
+
+#ifdef SSTR_VEC_BYTES
+// bit k is set when p[k], p2[k] and t[k] are first, second and tail.
+static inline uint32_t sstr_find_block(const char* p, const char* p2,
+                                       const char* t, SSTR_VEC_T first,
+                                       SSTR_VEC_T second, SSTR_VEC_T tail) {
+    return SSTR_VEC_MASK(
+        SSTR_VEC_AND(SSTR_VEC_AND(SSTR_VEC_EQ(SSTR_VEC_LOAD(p), first),
+                                  SSTR_VEC_EQ(SSTR_VEC_LOAD(p2), second)),
+                     SSTR_VEC_EQ(SSTR_VEC_LOAD(t), tail)));
+}
+
+// first offset in mask where the needle n matches p, SSTR_NPOS if none.
+static size_t sstr_find_verify(const char* p, const char* n, size_t nlen,
+                               uint64_t mask) {
+    size_t at;
+
+    for (; mask; mask &= mask - 1) {
+        at = sstr_ctz64(mask);
+        if (memcmp(p + at + 1, n + 1, nlen - 2) == 0) {
+            return at;
+        }
+    }
+    return SSTR_NPOS;
+}
+#endif
+
+// first position >= from of needle n in haystack h.
+static size_t sstr_find_in(const char* h, size_t hlen, const char* n,
+                           size_t nlen, size_t from) {
+    const char* hit;
+    size_t i, last;
+
+    if (from > hlen || nlen > hlen - from) {
+        return SSTR_NPOS;
+    }
+    if (nlen == 0) {
+        return from;
+    }
+    if (nlen == 1) {
+        hit = (const char*)memchr(h + from, n[0], hlen - from);
+        return hit ? (size_t)(hit - h) : SSTR_NPOS;
+    }
+
+    i = from;
+    last = hlen - nlen;  // last position the needle fits at
+#ifdef SSTR_VEC_BYTES
+    {
+        SSTR_VEC_T first = SSTR_VEC_SET1(n[0]);
+        SSTR_VEC_T second = SSTR_VEC_SET1(n[1]);
+        SSTR_VEC_T tail = SSTR_VEC_SET1(n[nlen - 1]);
+        const char* t = h + nlen - 1;  // t[i] is under the last needle byte
+        uint64_t mask;
+        size_t at;
+
+        // two blocks per branch, then the last whole block
+        for (; last - i + 1 >= 2 * SSTR_VEC_BYTES; i += 2 * SSTR_VEC_BYTES) {
+            const char* p = h + i + SSTR_VEC_BYTES;
+            mask = sstr_find_block(h + i, h + i + 1, t + i, first, second,
+                                   tail) |
+                   (uint64_t)sstr_find_block(p, p + 1, t + i + SSTR_VEC_BYTES,
+                                             first, second, tail)
+                       << SSTR_VEC_BYTES;
+            if (mask && (at = sstr_find_verify(h + i, n, nlen, mask)) !=
+                            SSTR_NPOS) {
+                return i + at;
+            }
+        }
+        if (last - i + 1 >= SSTR_VEC_BYTES) {
+            mask = sstr_find_block(h + i, h + i + 1, t + i, first, second,
+                                   tail);
+            if (mask && (at = sstr_find_verify(h + i, n, nlen, mask)) !=
+                            SSTR_NPOS) {
+                return i + at;
+            }
+            i += SSTR_VEC_BYTES;
+        }
+    }
+#endif
+    while (i <= last) {
+        hit = (const char*)memchr(h + i, n[0], last - i + 1);
+        if (hit == NULL) {
+            break;
+        }
+        i = hit - h;
+        if (h[i + nlen - 1] == n[nlen - 1] &&
+            memcmp(h + i + 1, n + 1, nlen - 2) == 0) {
+            return i;
+        }
+        i++;
+    }
+    return SSTR_NPOS;
+}
+
+// up to max non-overlapping positions >= from of needle n in haystack h,
+// stored in pos. Returns how many were found; fewer than max means there
+// are no more. Dense matches cost one block per match instead of a whole
+// sstr_find_in() call each.
+static size_t sstr_find_batch(const char* h, size_t hlen, const char* n,
+                              size_t nlen, size_t from, size_t* pos,
+                              size_t max) {
+    size_t count = 0, i = from, at;
+
+    if (nlen == 0 || nlen > hlen) {
+        return 0;
+    }
+#ifdef SSTR_VEC_BYTES
+    if (nlen > 1) {
+        SSTR_VEC_T first = SSTR_VEC_SET1(n[0]);
+        SSTR_VEC_T second = SSTR_VEC_SET1(n[1]);
+        SSTR_VEC_T tail = SSTR_VEC_SET1(n[nlen - 1]);
+        const char* t = h + nlen - 1;
+        size_t last = hlen - nlen;
+        uint32_t mask;
+
+        while (count < max && i <= last && last - i + 1 >= SSTR_VEC_BYTES) {
+            mask = sstr_find_block(h + i, h + i + 1, t + i, first, second,
+                                   tail);
+            if (mask && (at = sstr_find_verify(h + i, n, nlen, mask)) !=
+                            SSTR_NPOS) {
+                pos[count++] = i + at;
+                i += at + nlen;
+            } else {
+                i += SSTR_VEC_BYTES;
+            }
+        }
+    }
+#endif
+    while (count < max &&
+           (at = sstr_find_in(h, hlen, n, nlen, i)) != SSTR_NPOS) {
+        pos[count++] = at;
+        i = at + nlen;
+    }
+    return count;
+}
+
+// last position <= from of needle n in haystack h.
+static size_t sstr_rfind_in(const char* h, size_t hlen, const char* n,
+                            size_t nlen, size_t from) {
+    size_t i;
+
+    if (nlen > hlen) {
+        return SSTR_NPOS;
+    }
+    i = hlen - nlen;
+    if (from < i) {
+        i = from;
+    }
+    if (nlen == 0) {
+        return i;
+    }
+
+#ifdef SSTR_VEC_BYTES
+    {
+        SSTR_VEC_T first = SSTR_VEC_SET1(n[0]);
+        // a single byte needle compares its first byte twice
+        SSTR_VEC_T second = SSTR_VEC_SET1(n[nlen > 1]);
+        SSTR_VEC_T tail = SSTR_VEC_SET1(n[nlen - 1]);
+        const char* h2 = h + (nlen > 1);
+        const char* t = h + nlen - 1;
+        uint32_t mask;
+        size_t b;
+
+        // blocks of positions [i - SSTR_VEC_BYTES + 1, i], highest first
+        for (; i + 1 >= SSTR_VEC_BYTES; i -= SSTR_VEC_BYTES) {
+            b = i + 1 - SSTR_VEC_BYTES;
+            mask = sstr_find_block(h + b, h2 + b, t + b, first, second, tail);
+            while (mask) {
+                unsigned bit = 63 - sstr_clz64(mask);
+                if (nlen == 1 ||
+                    memcmp(h + b + bit + 1, n + 1, nlen - 2) == 0) {
+                    return b + bit;
+                }
+                mask &= ~((uint32_t)1 << bit);
+            }
+        }
+        if (i == (size_t)-1) {  // the blocks ended right at 0
+            return SSTR_NPOS;
+        }
+    }
+#endif
+    for (;; i--) {
+        if (h[i] == n[0] && h[i + nlen - 1] == n[nlen - 1] &&
+            (nlen == 1 || memcmp(h + i + 1, n + 1, nlen - 2) == 0)) {
+            return i;
+        }
+        if (i == 0) {
+            return SSTR_NPOS;
+        }
+    }
+}
+
+size_t sstr_find(sstr_t s, sstr_t needle, size_t from) {
+    return sstr_find_in(STR_PTR(s), sstr_length(s), STR_PTR(needle),
+                        sstr_length(needle), from);
+}
+
+size_t sstr_find_of(sstr_t s, const void* needle, size_t length,
+                    size_t from) {
+    return sstr_find_in(STR_PTR(s), sstr_length(s), (const char*)needle,
+                        length, from);
+}
+
+size_t sstr_rfind(sstr_t s, sstr_t needle, size_t from) {
+    return sstr_rfind_in(STR_PTR(s), sstr_length(s), STR_PTR(needle),
+                         sstr_length(needle), from);
+}
+
+size_t sstr_rfind_of(sstr_t s, const void* needle, size_t length,
+                     size_t from) {
+    return sstr_rfind_in(STR_PTR(s), sstr_length(s), (const char*)needle,
+                         length, from);
+}
+
+size_t sstr_find_char(sstr_t s, int c, size_t from) {
+    char n = (char)c;
+    return sstr_find_in(STR_PTR(s), sstr_length(s), &n, 1, from);
+}
+
+size_t sstr_rfind_char(sstr_t s, int c, size_t from) {
+    char n = (char)c;
+    return sstr_rfind_in(STR_PTR(s), sstr_length(s), &n, 1, from);
+}
+
+// A set of bytes in 32 bytes: byte c is in the set when bit (c >> 4) & 7 of
+// set[(c >> 7) * 16 + (c & 15)] is set. The two rows of 16 bytes are the
+// nibble lookup tables of AVX2.
+#define SSTR_BYTESET_HAS(set, c) \
+    (((set)[((c) >> 3 & 16) | ((c) & 15)] >> ((c) >> 4 & 7)) & 1)
+
+static void sstr_byteset_init(unsigned char set[32], const unsigned char* cs,
+                              size_t length) {
+    size_t k;
+
+    memset(set, 0, 32);
+    for (k = 0; k < length; k++) {
+        set[(cs[k] >> 3 & 16) | (cs[k] & 15)] |=
+            (unsigned char)(1 << (cs[k] >> 4 & 7));
+    }
+}
+
+// first position >= from in h of a byte in set, the set has the length bytes
+// of cs.
+static size_t sstr_find_byteset(const unsigned char* h, size_t hlen,
+                                const unsigned char set[32],
+                                const unsigned char* cs, size_t length,
+                                size_t from) {
+    size_t i = from;
+
+    (void)cs;
+    (void)length;
+#if defined(__AVX2__)
+    {
+        // the low nibble picks a row byte, the high nibble a bit of it,
+        // the top bit of the byte picks the row.
+        __m256i lo_rows = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i*)set));
+        __m256i hi_rows = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i*)(set + 16)));
+        __m256i bits = _mm256_setr_epi8(
+            1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2,
+            4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        __m256i nib = _mm256_set1_epi8(15);
+        __m256i v, lo, hi, row, bit;
+        uint32_t mask;
+
+        for (; hlen - i >= 32; i += 32) {
+            v = _mm256_loadu_si256((const __m256i*)(h + i));
+            lo = _mm256_and_si256(v, nib);
+            hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nib);
+            row = _mm256_blendv_epi8(_mm256_shuffle_epi8(lo_rows, lo),
+                                     _mm256_shuffle_epi8(hi_rows, lo), v);
+            bit = _mm256_shuffle_epi8(bits, hi);
+            mask = (uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit));
+            if (mask) {
+                return i + sstr_ctz64(mask);
+            }
+        }
+    }
+#elif defined(__SSE2__)
+    // one comparison per byte of the set, worth it for small sets only.
+    if (length <= 8) {
+        __m128i needles[8], v, eq;
+        uint32_t mask;
+        size_t k;
+
+        for (k = 0; k < length; k++) {
+            needles[k] = _mm_set1_epi8((char)cs[k]);
+        }
+        for (; hlen - i >= 16; i += 16) {
+            v = _mm_loadu_si128((const __m128i*)(h + i));
+            eq = _mm_cmpeq_epi8(v, needles[0]);
+            for (k = 1; k < length; k++) {
+                eq = _mm_or_si128(eq, _mm_cmpeq_epi8(v, needles[k]));
+            }
+            mask = (uint32_t)_mm_movemask_epi8(eq);
+            if (mask) {
+                return i + sstr_ctz64(mask);
+            }
+        }
+    }
+#endif
+    for (; i < hlen; i++) {
+        if (SSTR_BYTESET_HAS(set, h[i])) {
+            return i;
+        }
+    }
+    return SSTR_NPOS;
+}
+
+size_t sstr_find_any_of(sstr_t s, const void* set, size_t length,
+                        size_t from) {
+    const unsigned char* cs = (const unsigned char*)set;
+    unsigned char byteset[32];
+
+    if (from >= sstr_length(s) || length == 0) {
+        return SSTR_NPOS;
+    }
+    if (length == 1) {
+        return sstr_find_char(s, cs[0], from);
+    }
+    sstr_byteset_init(byteset, cs, length);
+    return sstr_find_byteset((const unsigned char*)STR_PTR(s), sstr_length(s),
+                             byteset, cs, length, from);
+}
+
+// matches sstr_replace_all_of() finds per sstr_find_batch() call.
+#define SSTR_REPLACE_BATCH 256
+
+// writes h[*from, pos[i]) and r for each of the got matches in pos to w.
+static char* sstr_replace_batch(char* w, const char* h, size_t* from,
+                                const size_t* pos, size_t got, size_t nlen,
+                                const char* r, size_t rlen) {
+    size_t i;
+
+    for (i = 0; i < got; i++) {
+        memmove(w, h + *from, pos[i] - *from);
+        w += pos[i] - *from;
+        memcpy(w, r, rlen);
+        w += rlen;
+        *from = pos[i] + nlen;
+    }
+    return w;
+}
+
+size_t sstr_replace_all_of(sstr_t s, const void* needle, size_t needle_length,
+                           const void* replacement,
+                           size_t replacement_length) {
+    STR* ss = SSTR(s);
+    const char* h = STR_PTR(ss);
+    const char* n = (const char*)needle;
+    const char* r = (const char*)replacement;
+    size_t length = sstr_length(ss), count, got, from = 0, need;
+    size_t pos[SSTR_REPLACE_BATCH];
+    char tmp[SHORT_STR_CAPACITY + 1];
+    const sstr_allocator_t* a = STR_ALLOCATOR(ss);
+    char *out, *w;
+
+    count = got = sstr_find_batch(h, length, n, needle_length, 0, pos,
+                                  SSTR_REPLACE_BATCH);
+    if (count == 0) {
+        return 0;
+    }
+
+    // the output never overtakes the input when it is not longer, unless
+    // the needle or the replacement are read from s itself. Then matches
+    // are replaced as they are found: the search only reads bytes at or
+    // after from, which are not written yet.
+    if (replacement_length <= needle_length &&
+        (n >= h + length || n + needle_length <= h) &&
+        (r >= h + length || r + replacement_length <= h) && sstr_writable(ss)) {
+        w = sstr_replace_batch((char*)h, h, &from, pos, got, needle_length, r,
+                               replacement_length);
+        while (got == SSTR_REPLACE_BATCH) {
+            got = sstr_find_batch(h, length, n, needle_length, from, pos,
+                                  SSTR_REPLACE_BATCH);
+            w = sstr_replace_batch(w, h, &from, pos, got, needle_length, r,
+                                   replacement_length);
+            count += got;
+        }
+        memmove(w, h + from, length - from);
+        need = w + length - from - h;
+        ((char*)h)[need] = '\0';
+        sstr_set_length(ss, need);
+        return count;
+    }
+
+    // a longer result is allocated once at its exact size, so the matches
+    // are counted first. pos still holds all of them if there is one batch.
+    while (got == SSTR_REPLACE_BATCH) {
+        got = sstr_find_batch(h, length, n, needle_length,
+                              pos[SSTR_REPLACE_BATCH - 1] + needle_length,
+                              pos, SSTR_REPLACE_BATCH);
+        count += got;
+    }
+    need = length - count * needle_length + count * replacement_length;
+    if (STR_IS_SHORT(ss) && need <= STR_SHORT_CAPACITY(a)) {
+        out = tmp;
+    } else {
+        out = sstr_buf_alloc(a, need);
+    }
+    if (count <= SSTR_REPLACE_BATCH) {
+        w = sstr_replace_batch(out, h, &from, pos, count, needle_length, r,
+                               replacement_length);
+    } else {
+        w = out;
+        do {
+            got = sstr_find_batch(h, length, n, needle_length, from, pos,
+                                  SSTR_REPLACE_BATCH);
+            w = sstr_replace_batch(w, h, &from, pos, got, needle_length, r,
+                                   replacement_length);
+        } while (got == SSTR_REPLACE_BATCH);
+    }
+    memcpy(w, h + from, length - from);
+    out[need] = '\0';
+
+    if (out == tmp) {
+        memcpy(STR_SHORT_PTR(ss, a), tmp, need);
+        sstr_set_short(ss, a, need);
+    } else {
+        sstr_set_buffer(ss, a, out, need);
+    }
+    return count;
+}
+
+size_t sstr_replace_all(sstr_t s, sstr_t needle, sstr_t replacement) {
+    return sstr_replace_all_of(s, STR_PTR(needle), sstr_length(needle),
+                               STR_PTR(replacement),
+                               sstr_length(replacement));
+}
+
+/*
+ * Case.
+ *
+ * Only the ASCII letters have a case here: bytes 0x80 and up are left alone,
+ * so UTF-8 text keeps its multi-byte sequences intact and nothing depends on
+ * the locale. A byte b is in the 26 letters starting at lo when b - lo,
+ * shifted by 0x80, is below -128 + 26 as a signed byte, one add and one
+ * compare per 32 (AVX2) or 16 (SSE2) bytes. Letters flip case with 0x20.
+ */
+
+#define SSTR_IS_LETTER_AT(c, lo) ((unsigned char)((c) - (lo)) < 26)
+
+static inline unsigned char sstr_ascii_lower(unsigned char c) {
+    return SSTR_IS_LETTER_AT(c, 'A') ? c | 0x20 : c;
+}
+
+#ifdef SSTR_VEC_BYTES
+// v with the letters in [lo, lo + 25] flipped to the other case.
+static inline SSTR_VEC_T sstr_vec_flip_case(SSTR_VEC_T v, SSTR_VEC_T shift,
+                                            SSTR_VEC_T below,
+                                            SSTR_VEC_T bit) {
+    SSTR_VEC_T in = SSTR_VEC_GT(below, SSTR_VEC_ADD(v, shift));
+    return SSTR_VEC_XOR(v, SSTR_VEC_AND(in, bit));
+}
+
+#define SSTR_VEC_CASE_INIT(lo)                     \
+    SSTR_VEC_T shift = SSTR_VEC_SET1(0x80 - (lo)); \
+    SSTR_VEC_T below = SSTR_VEC_SET1(-128 + 26);   \
+    SSTR_VEC_T bit = SSTR_VEC_SET1(0x20)
+#define SSTR_VEC_FLIP(v) sstr_vec_flip_case(v, shift, below, bit)
+#endif
+
+// the 8 bytes of w with the letters in [lo, lo + 25] flipped to the other
+// case. Bytes 0x80 and up are masked out of the range test by ~w.
+static inline uint64_t sstr_swar_flip_case(uint64_t w, char lo) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    uint64_t h = w & (ones * 0x7f);
+    uint64_t ge = h + ones * (unsigned char)(0x80 - lo);
+    uint64_t gt = h + ones * (unsigned char)(0x80 - lo - 26);
+    return w ^ (((ge & ~gt & ~w) & (ones * 0x80)) >> 2);
+}
+
+// n bytes of src with the letters in [lo, lo + 25] flipped to the other
+// case, to dst. dst may be src. The tail is one last block or word that
+// overlaps the ones before it. It is loaded before they are stored: in
+// place, a load of bytes just stored would wait for the stores to retire.
+static void sstr_case_map(char* dst, const char* src, size_t n, char lo) {
+    size_t i;
+    uint64_t w, last;
+    uint32_t head, tail;
+
+#ifdef SSTR_VEC_BYTES
+    if (n >= SSTR_VEC_BYTES) {
+        SSTR_VEC_CASE_INIT(lo);
+        SSTR_VEC_T end = SSTR_VEC_FLIP(SSTR_VEC_LOAD(src + n - SSTR_VEC_BYTES));
+        for (i = 0; i + SSTR_VEC_BYTES < n; i += SSTR_VEC_BYTES) {
+            SSTR_VEC_STORE(dst + i, SSTR_VEC_FLIP(SSTR_VEC_LOAD(src + i)));
+        }
+        SSTR_VEC_STORE(dst + n - SSTR_VEC_BYTES, end);
+        return;
+    }
+#endif
+    if (n >= 8) {
+        memcpy(&last, src + n - 8, 8);
+        last = sstr_swar_flip_case(last, lo);
+        for (i = 0; i + 8 < n; i += 8) {
+            memcpy(&w, src + i, 8);
+            w = sstr_swar_flip_case(w, lo);
+            memcpy(dst + i, &w, 8);
+        }
+        memcpy(dst + n - 8, &last, 8);
+        return;
+    }
+    if (n >= 4) {
+        memcpy(&head, src, 4);
+        memcpy(&tail, src + n - 4, 4);
+        head = (uint32_t)sstr_swar_flip_case(head, lo);
+        tail = (uint32_t)sstr_swar_flip_case(tail, lo);
+        memcpy(dst, &head, 4);
+        memcpy(dst + n - 4, &tail, 4);
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        dst[i] = SSTR_IS_LETTER_AT(src[i], lo) ? src[i] ^ 0x20 : src[i];
+    }
+}
+
+static void sstr_case_apply(STR* ss, char lo) {
+    size_t length = sstr_length(ss);
+    char* p = STR_PTR(ss);
+    const sstr_allocator_t* a;
+    char* data;
+
+    if (sstr_writable(ss)) {
+        sstr_case_map(p, p, length, lo);
+        return;
+    }
+    // map straight into a private copy of the shared buffer
+    a = STR_ALLOCATOR(ss);
+    data = sstr_buf_alloc(a, sstr_capacity_of(ss));
+    sstr_case_map(data, p, length, lo);
+    data[length] = '\0';
+    sstr_set_buffer(ss, a, data, length);
+}
+
+static sstr_t sstr_case_copy(STR* ss, char lo) {
+    size_t length = sstr_length(ss);
+    const sstr_allocator_t* a = STR_ALLOCATOR(ss);
+    STR* d = (STR*)sstr_new_alloc(a);
+
+    if (length <= STR_SHORT_CAPACITY(a)) {
+        sstr_case_map(STR_SHORT_PTR(d, a), STR_PTR(ss), length, lo);
+        sstr_set_short(d, a, length);
+        return d;
+    }
+    d->un.heap.allocator = a;
+    d->un.heap.growth = NULL;
+    d->un.heap.data = sstr_buf_alloc(a, length);
+    sstr_case_map(d->un.heap.data, STR_PTR(ss), length, lo);
+    d->un.heap.data[length] = '\0';
+    d->un.heap.tag = SSTR_TAG(length, SSTR_TYPE_LONG);
+    return d;
+}
+
+void sstr_tolower(sstr_t s) { sstr_case_apply(SSTR(s), 'A'); }
+
+void sstr_toupper(sstr_t s) { sstr_case_apply(SSTR(s), 'a'); }
+
+sstr_t sstr_tolower_copy(sstr_t s) { return sstr_case_copy(SSTR(s), 'A'); }
+
+sstr_t sstr_toupper_copy(sstr_t s) { return sstr_case_copy(SSTR(s), 'a'); }
+
+int sstr_is_ascii_of(const void* data, size_t length) {
+    const unsigned char* p = (const unsigned char*)data;
+    size_t i = 0;
+
+#ifdef SSTR_VEC_BYTES
+    // four blocks per branch, the high bits are collected with OR
+    for (; i + 4 * SSTR_VEC_BYTES <= length; i += 4 * SSTR_VEC_BYTES) {
+        SSTR_VEC_T v = SSTR_VEC_OR(
+            SSTR_VEC_OR(SSTR_VEC_LOAD(p + i),
+                        SSTR_VEC_LOAD(p + i + SSTR_VEC_BYTES)),
+            SSTR_VEC_OR(SSTR_VEC_LOAD(p + i + 2 * SSTR_VEC_BYTES),
+                        SSTR_VEC_LOAD(p + i + 3 * SSTR_VEC_BYTES)));
+        if (SSTR_VEC_MASK(v)) {
+            return 0;
+        }
+    }
+#endif
+    for (; i + 8 <= length; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        if (w & 0x8080808080808080ULL) {
+            return 0;
+        }
+    }
+    for (; i < length; i++) {
+        if (p[i] & 0x80) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int sstr_is_ascii(sstr_t s) {
+    return sstr_is_ascii_of(STR_PTR(s), sstr_length(s));
+}
+
+#ifdef SSTR_VEC_BYTES
+// movemask of the bytes of the blocks at x and y that are equal once their
+// letters are lowered.
+#define SSTR_VEC_CASE_EQ(x, y)                   \
+    SSTR_VEC_EQ(SSTR_VEC_FLIP(SSTR_VEC_LOAD(x)), \
+                SSTR_VEC_FLIP(SSTR_VEC_LOAD(y)))
+#define SSTR_VEC_ALL ((uint32_t)((1ULL << SSTR_VEC_BYTES) - 1))
+#endif
+
+// like memcmp() of n bytes of a and b with their letters in lower case.
+static int sstr_casecmp_in(const char* a, const char* b, size_t n) {
+    const unsigned char* x = (const unsigned char*)a;
+    const unsigned char* y = (const unsigned char*)b;
+    size_t i = 0;
+    uint64_t wx, wy;
+
+#ifdef SSTR_VEC_BYTES
+    if (n >= SSTR_VEC_BYTES) {
+        SSTR_VEC_CASE_INIT('A');
+        uint32_t eq;
+
+        // two blocks per branch, the block that differs is found below
+        for (; i + 2 * SSTR_VEC_BYTES <= n; i += 2 * SSTR_VEC_BYTES) {
+            if (SSTR_VEC_MASK(SSTR_VEC_AND(
+                    SSTR_VEC_CASE_EQ(x + i, y + i),
+                    SSTR_VEC_CASE_EQ(x + i + SSTR_VEC_BYTES,
+                                     y + i + SSTR_VEC_BYTES))) !=
+                SSTR_VEC_ALL) {
+                break;
+            }
+        }
+        for (;; i += SSTR_VEC_BYTES) {
+            if (i + SSTR_VEC_BYTES > n) {
+                if (i == n) {
+                    return 0;
+                }
+                i = n - SSTR_VEC_BYTES;
+            }
+            eq = SSTR_VEC_MASK(SSTR_VEC_CASE_EQ(x + i, y + i));
+            if (eq != SSTR_VEC_ALL) {
+                i += sstr_ctz64(~eq);
+                return sstr_ascii_lower(x[i]) - sstr_ascii_lower(y[i]);
+            }
+            if (i + SSTR_VEC_BYTES == n) {
+                return 0;
+            }
+        }
+    }
+#endif
+    // a word that differs is looked into byte by byte, the tail is one
+    // last word overlapping the bytes compared already
+    for (; i + 8 <= n; i += 8) {
+        memcpy(&wx, x + i, 8);
+        memcpy(&wy, y + i, 8);
+        if (sstr_swar_flip_case(wx, 'A') != sstr_swar_flip_case(wy, 'A')) {
+            break;
+        }
+    }
+    if (i + 8 > n && i < n && n >= 8) {
+        memcpy(&wx, x + n - 8, 8);
+        memcpy(&wy, y + n - 8, 8);
+        if (sstr_swar_flip_case(wx, 'A') == sstr_swar_flip_case(wy, 'A')) {
+            return 0;
+        }
+    }
+    for (; i < n; i++) {
+        if (sstr_ascii_lower(x[i]) != sstr_ascii_lower(y[i])) {
+            return sstr_ascii_lower(x[i]) - sstr_ascii_lower(y[i]);
+        }
+    }
+    return 0;
+}
+
+static int sstr_compare_nocase_in(const char* a, size_t alen, const char* b,
+                                  size_t blen) {
+    int c = sstr_casecmp_in(a, b, alen < blen ? alen : blen);
+
+    if (c != 0) {
+        return c;
+    }
+    return (alen > blen) - (alen < blen);
+}
+
+int sstr_compare_nocase(sstr_t a, sstr_t b) {
+    if (a == NULL || b == NULL) {
+        return (a != NULL) - (b != NULL);
+    }
+    return sstr_compare_nocase_in(STR_PTR(a), sstr_length(a), STR_PTR(b),
+                                  sstr_length(b));
+}
+
+int sstr_compare_nocase_c(sstr_t a, const char* b) {
+    return sstr_compare_nocase_in(STR_PTR(a), sstr_length(a), b, strlen(b));
+}
+
+// first position >= from of needle n in haystack h, ignoring the case of
+// letters. The blocks are filtered like sstr_find_in(), with the haystack
+// lowered on the fly.
+static size_t sstr_find_nocase_in(const char* h, size_t hlen, const char* n,
+                                  size_t nlen, size_t from) {
+    size_t i, last;
+
+    if (from > hlen || nlen > hlen - from) {
+        return SSTR_NPOS;
+    }
+    if (nlen == 0) {
+        return from;
+    }
+
+    i = from;
+    last = hlen - nlen;
+#ifdef SSTR_VEC_BYTES
+    {
+        SSTR_VEC_CASE_INIT('A');
+        SSTR_VEC_T first = SSTR_VEC_SET1(sstr_ascii_lower(n[0]));
+        // a single byte needle compares its first byte twice
+        SSTR_VEC_T second = SSTR_VEC_SET1(sstr_ascii_lower(n[nlen > 1]));
+        SSTR_VEC_T tail = SSTR_VEC_SET1(sstr_ascii_lower(n[nlen - 1]));
+        const char* h2 = h + (nlen > 1);
+        const char* t = h + nlen - 1;
+        uint32_t mask;
+
+        for (; last - i + 1 >= SSTR_VEC_BYTES; i += SSTR_VEC_BYTES) {
+            mask = SSTR_VEC_MASK(SSTR_VEC_AND(
+                SSTR_VEC_AND(
+                    SSTR_VEC_EQ(SSTR_VEC_FLIP(SSTR_VEC_LOAD(h + i)), first),
+                    SSTR_VEC_EQ(SSTR_VEC_FLIP(SSTR_VEC_LOAD(h2 + i)),
+                                second)),
+                SSTR_VEC_EQ(SSTR_VEC_FLIP(SSTR_VEC_LOAD(t + i)), tail)));
+            for (; mask; mask &= mask - 1) {
+                size_t at = i + sstr_ctz64(mask);
+                if (nlen <= 2 ||
+                    sstr_casecmp_in(h + at + 1, n + 1, nlen - 2) == 0) {
+                    return at;
+                }
+            }
+        }
+    }
+#endif
+    for (; i <= last; i++) {
+        if (sstr_ascii_lower(h[i]) == sstr_ascii_lower(n[0]) &&
+            sstr_casecmp_in(h + i, n, nlen) == 0) {
+            return i;
+        }
+    }
+    return SSTR_NPOS;
+}
+
+size_t sstr_find_nocase(sstr_t s, sstr_t needle, size_t from) {
+    return sstr_find_nocase_in(STR_PTR(s), sstr_length(s), STR_PTR(needle),
+                               sstr_length(needle), from);
+}
+
+size_t sstr_find_nocase_of(sstr_t s, const void* needle, size_t length,
+                           size_t from) {
+    return sstr_find_nocase_in(STR_PTR(s), sstr_length(s),
+                               (const char*)needle, length, from);
+}
+
+/*
+ * UTF-8.
+ *
+ * Validation follows Keiser and Lemire, "Validating UTF-8 In Less Than One
+ * Instruction Per Byte": with SSSE3 or AVX2, three 16-entry tables indexed
+ * by the nibbles of each byte and of the byte before it flag every error
+ * of a pair of bytes at once (overlong, surrogate, too large, missing or
+ * extra continuation). The third and fourth bytes of longer sequences are
+ * then checked against the lead two and three bytes back. Blocks that are
+ * all ASCII only carry an error from a sequence cut by the block before.
+ * Other builds skip ASCII 8 bytes at a time and decode the rest.
+ */
+
+// the codepoint at p, the n > 0 bytes left, to *cp. Returns the length of
+// the sequence, or minus the length of its longest valid prefix (at least
+// 1) if it is not valid: that many bytes make one U+FFFD.
+static int sstr_utf8_decode(const unsigned char* p, size_t n, uint32_t* cp) {
+    unsigned char c = p[0], lo = 0x80, hi = 0xBF;
+    uint32_t v;
+    size_t need, k;
+
+    if (c < 0x80) {
+        *cp = c;
+        return 1;
+    }
+    if (c < 0xC2) {
+        return -1;
+    } else if (c < 0xE0) {
+        need = 1;
+        v = c & 0x1F;
+    } else if (c < 0xF0) {
+        need = 2;
+        v = c & 0x0F;
+        lo = c == 0xE0 ? 0xA0 : 0x80;  // overlong
+        hi = c == 0xED ? 0x9F : 0xBF;  // surrogates
+    } else if (c < 0xF5) {
+        need = 3;
+        v = c & 0x07;
+        lo = c == 0xF0 ? 0x90 : 0x80;  // overlong
+        hi = c == 0xF4 ? 0x8F : 0xBF;  // above U+10FFFF
+    } else {
+        return -1;
+    }
+    for (k = 1; k <= need; k++) {
+        if (k >= n || p[k] < lo || p[k] > hi) {
+            return -(int)k;
+        }
+        v = (v << 6) | (p[k] & 0x3F);
+        lo = 0x80;
+        hi = 0xBF;
+    }
+    *cp = v;
+    return (int)k;
+}
+
+// index of the first byte at or after i that is not ASCII, n if none.
+static size_t sstr_utf8_skip_ascii(const unsigned char* p, size_t n,
+                                   size_t i) {
+    uint64_t w;
+
+    for (; i + 8 <= n; i += 8) {
+        memcpy(&w, p + i, 8);
+        if (w & 0x8080808080808080ULL) {
+            break;
+        }
+    }
+    while (i < n && p[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+#if defined(__AVX2__)
+#define SSTR_UTF8_BLOCK 32
+#define SSTR_U8_T __m256i
+#define SSTR_U8_LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define SSTR_U8_SET1(c) _mm256_set1_epi8((char)(c))
+#define SSTR_U8_TABLE(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+#define SSTR_U8_LOOKUP(t, i) _mm256_shuffle_epi8(t, i)
+#define SSTR_U8_HIGH(v) \
+    _mm256_and_si256(_mm256_srli_epi16(v, 4), SSTR_U8_SET1(0x0F))
+#define SSTR_U8_LOW(v) _mm256_and_si256(v, SSTR_U8_SET1(0x0F))
+// the block in shifted n bytes later, the last n bytes of prev first.
+#define SSTR_U8_PREV(in, prev, n)                                           \
+    _mm256_alignr_epi8(in, _mm256_permute2x128_si256(prev, in, 0x21), \
+                       16 - (n))
+#define SSTR_U8_SUBS(a, b) _mm256_subs_epu8(a, b)
+#define SSTR_U8_AND(a, b) _mm256_and_si256(a, b)
+#define SSTR_U8_OR(a, b) _mm256_or_si256(a, b)
+#define SSTR_U8_XOR(a, b) _mm256_xor_si256(a, b)
+#define SSTR_U8_MASK(v) ((uint32_t)_mm256_movemask_epi8(v))
+#define SSTR_U8_ZERO(v) \
+    (_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, SSTR_U8_SET1(0))) == -1)
+#elif defined(__SSSE3__)
+#define SSTR_UTF8_BLOCK 16
+#define SSTR_U8_T __m128i
+#define SSTR_U8_LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define SSTR_U8_SET1(c) _mm_set1_epi8((char)(c))
+#define SSTR_U8_TABLE(...) _mm_setr_epi8(__VA_ARGS__)
+#define SSTR_U8_LOOKUP(t, i) _mm_shuffle_epi8(t, i)
+#define SSTR_U8_HIGH(v) _mm_and_si128(_mm_srli_epi16(v, 4), SSTR_U8_SET1(0x0F))
+#define SSTR_U8_LOW(v) _mm_and_si128(v, SSTR_U8_SET1(0x0F))
+#define SSTR_U8_PREV(in, prev, n) _mm_alignr_epi8(in, prev, 16 - (n))
+#define SSTR_U8_SUBS(a, b) _mm_subs_epu8(a, b)
+#define SSTR_U8_AND(a, b) _mm_and_si128(a, b)
+#define SSTR_U8_OR(a, b) _mm_or_si128(a, b)
+#define SSTR_U8_XOR(a, b) _mm_xor_si128(a, b)
+#define SSTR_U8_MASK(v) ((uint32_t)_mm_movemask_epi8(v))
+#define SSTR_U8_ZERO(v) \
+    (_mm_movemask_epi8(_mm_cmpeq_epi8(v, SSTR_U8_SET1(0))) == 0xFFFF)
+#endif
+
+#ifdef SSTR_UTF8_BLOCK
+// errors of a byte and the byte before it, see sstr_utf8_check().
+#define SSTR_U8_TOO_SHORT 0x01   // lead or ASCII, then lead or ASCII
+#define SSTR_U8_TOO_LONG 0x02    // ASCII, then continuation
+#define SSTR_U8_OVERLONG_3 0x04  // 11100000 100_____
+#define SSTR_U8_TOO_LARGE 0x08   // 11110100 1001____ and above
+#define SSTR_U8_SURROGATE 0x10   // 11101101 101_____
+#define SSTR_U8_OVERLONG_2 0x20  // 1100000_ 10______
+#define SSTR_U8_TOO_LARGE_1000 0x40  // 11110101 1000____ and above
+#define SSTR_U8_OVERLONG_4 0x40      // 11110000 1000____
+#define SSTR_U8_TWO_CONTS 0x80  // continuation, then continuation
+// the errors that do not depend on the low nibble of the first byte.
+#define SSTR_U8_CARRY \
+    (SSTR_U8_TOO_SHORT | SSTR_U8_TOO_LONG | SSTR_U8_TWO_CONTS)
+#define SSTR_U8_C(v) ((char)(v))
+
+// bytes with errors of the block in, prev is the block before it. Bit 0x80
+// of a continuation that the lead two or three bytes back asks for is
+// flipped back to valid.
+static inline SSTR_U8_T sstr_utf8_check(SSTR_U8_T in, SSTR_U8_T prev) {
+    const SSTR_U8_T byte_1_high = SSTR_U8_TABLE(
+        // 0_______ ASCII
+        SSTR_U8_C(SSTR_U8_TOO_LONG), SSTR_U8_C(SSTR_U8_TOO_LONG),
+        SSTR_U8_C(SSTR_U8_TOO_LONG), SSTR_U8_C(SSTR_U8_TOO_LONG),
+        SSTR_U8_C(SSTR_U8_TOO_LONG), SSTR_U8_C(SSTR_U8_TOO_LONG),
+        SSTR_U8_C(SSTR_U8_TOO_LONG), SSTR_U8_C(SSTR_U8_TOO_LONG),
+        // 10______ continuation
+        SSTR_U8_C(SSTR_U8_TWO_CONTS), SSTR_U8_C(SSTR_U8_TWO_CONTS),
+        SSTR_U8_C(SSTR_U8_TWO_CONTS), SSTR_U8_C(SSTR_U8_TWO_CONTS),
+        // 1100____, 1101____ two byte lead
+        SSTR_U8_C(SSTR_U8_TOO_SHORT | SSTR_U8_OVERLONG_2),
+        SSTR_U8_C(SSTR_U8_TOO_SHORT),
+        // 1110____ three byte lead
+        SSTR_U8_C(SSTR_U8_TOO_SHORT | SSTR_U8_OVERLONG_3 |
+                  SSTR_U8_SURROGATE),
+        // 1111____ four byte lead
+        SSTR_U8_C(SSTR_U8_TOO_SHORT | SSTR_U8_TOO_LARGE |
+                  SSTR_U8_TOO_LARGE_1000 | SSTR_U8_OVERLONG_4));
+    const SSTR_U8_T byte_1_low = SSTR_U8_TABLE(
+        // ____0000
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_OVERLONG_3 | SSTR_U8_OVERLONG_2 |
+                  SSTR_U8_OVERLONG_4),
+        // ____0001
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_OVERLONG_2),
+        // ____001_
+        SSTR_U8_C(SSTR_U8_CARRY), SSTR_U8_C(SSTR_U8_CARRY),
+        // ____0100
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE),
+        // ____0101 to ____1100
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE | SSTR_U8_TOO_LARGE_1000),
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE | SSTR_U8_TOO_LARGE_1000),
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE | SSTR_U8_TOO_LARGE_1000),
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE | SSTR_U8_TOO_LARGE_1000),
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE | SSTR_U8_TOO_LARGE_1000),
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE | SSTR_U8_TOO_LARGE_1000),
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE | SSTR_U8_TOO_LARGE_1000),
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE | SSTR_U8_TOO_LARGE_1000),
+        // ____1101
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE | SSTR_U8_TOO_LARGE_1000 |
+                  SSTR_U8_SURROGATE),
+        // ____111_
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE | SSTR_U8_TOO_LARGE_1000),
+        SSTR_U8_C(SSTR_U8_CARRY | SSTR_U8_TOO_LARGE |
+                  SSTR_U8_TOO_LARGE_1000));
+    const SSTR_U8_T byte_2_high = SSTR_U8_TABLE(
+        // 0_______ ASCII
+        SSTR_U8_C(SSTR_U8_TOO_SHORT), SSTR_U8_C(SSTR_U8_TOO_SHORT),
+        SSTR_U8_C(SSTR_U8_TOO_SHORT), SSTR_U8_C(SSTR_U8_TOO_SHORT),
+        SSTR_U8_C(SSTR_U8_TOO_SHORT), SSTR_U8_C(SSTR_U8_TOO_SHORT),
+        SSTR_U8_C(SSTR_U8_TOO_SHORT), SSTR_U8_C(SSTR_U8_TOO_SHORT),
+        // 1000____
+        SSTR_U8_C(SSTR_U8_TOO_LONG | SSTR_U8_OVERLONG_2 | SSTR_U8_TWO_CONTS |
+                  SSTR_U8_OVERLONG_3 | SSTR_U8_TOO_LARGE_1000 |
+                  SSTR_U8_OVERLONG_4),
+        // 1001____
+        SSTR_U8_C(SSTR_U8_TOO_LONG | SSTR_U8_OVERLONG_2 | SSTR_U8_TWO_CONTS |
+                  SSTR_U8_OVERLONG_3 | SSTR_U8_TOO_LARGE),
+        // 101_____
+        SSTR_U8_C(SSTR_U8_TOO_LONG | SSTR_U8_OVERLONG_2 | SSTR_U8_TWO_CONTS |
+                  SSTR_U8_SURROGATE | SSTR_U8_TOO_LARGE),
+        SSTR_U8_C(SSTR_U8_TOO_LONG | SSTR_U8_OVERLONG_2 | SSTR_U8_TWO_CONTS |
+                  SSTR_U8_SURROGATE | SSTR_U8_TOO_LARGE),
+        // 11______ lead
+        SSTR_U8_C(SSTR_U8_TOO_SHORT), SSTR_U8_C(SSTR_U8_TOO_SHORT),
+        SSTR_U8_C(SSTR_U8_TOO_SHORT), SSTR_U8_C(SSTR_U8_TOO_SHORT));
+    SSTR_U8_T prev1 = SSTR_U8_PREV(in, prev, 1);
+    SSTR_U8_T sc = SSTR_U8_AND(
+        SSTR_U8_AND(SSTR_U8_LOOKUP(byte_1_high, SSTR_U8_HIGH(prev1)),
+                    SSTR_U8_LOOKUP(byte_1_low, SSTR_U8_LOW(prev1))),
+        SSTR_U8_LOOKUP(byte_2_high, SSTR_U8_HIGH(in)));
+    // only 111_____ two bytes back and 1111____ three bytes back stay at
+    // 0x80 or above
+    SSTR_U8_T third = SSTR_U8_SUBS(SSTR_U8_PREV(in, prev, 2),
+                                   SSTR_U8_SET1(0xE0 - 0x80));
+    SSTR_U8_T fourth = SSTR_U8_SUBS(SSTR_U8_PREV(in, prev, 3),
+                                    SSTR_U8_SET1(0xF0 - 0x80));
+    SSTR_U8_T must = SSTR_U8_AND(SSTR_U8_OR(third, fourth),
+                                 SSTR_U8_SET1(0x80));
+    return SSTR_U8_XOR(must, sc);
+}
+
+// bytes at or above these in the last three positions of a block start a
+// sequence that goes on in the next block.
+static const unsigned char sstr_utf8_incomplete[32] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+#endif
+
+int sstr_utf8_valid_of(const void* data, size_t length) {
+    const unsigned char* p = (const unsigned char*)data;
+    size_t i = 0;
+    uint32_t cp;
+    int r;
+
+#ifdef SSTR_UTF8_BLOCK
+    const SSTR_U8_T max = SSTR_U8_LOAD(sstr_utf8_incomplete + 32 -
+                                       SSTR_UTF8_BLOCK);
+    SSTR_U8_T prev = SSTR_U8_SET1(0), incomplete = prev, error = prev, in;
+    unsigned char tail[SSTR_UTF8_BLOCK] = {0};
+
+    for (;; i += SSTR_UTF8_BLOCK) {
+        if (i + SSTR_UTF8_BLOCK <= length) {
+            in = SSTR_U8_LOAD(p + i);
+        } else {
+            // the zeros after the tail end a cut sequence as an error
+            memcpy(tail, p + i, length - i);
+            in = SSTR_U8_LOAD(tail);
+        }
+        if (SSTR_U8_MASK(in) == 0) {
+            error = SSTR_U8_OR(error, incomplete);
+            incomplete = SSTR_U8_SET1(0);
+        } else {
+            error = SSTR_U8_OR(error, sstr_utf8_check(in, prev));
+            incomplete = SSTR_U8_SUBS(in, max);
+        }
+        if (i + SSTR_UTF8_BLOCK > length) {
+            return SSTR_U8_ZERO(error);
+        }
+        prev = in;
+    }
+#endif
+    while ((i = sstr_utf8_skip_ascii(p, length, i)) < length) {
+        if ((r = sstr_utf8_decode(p + i, length - i, &cp)) < 0) {
+            return 0;
+        }
+        i += r;
+    }
+    return 1;
+}
+
+int sstr_utf8_valid(sstr_t s) {
+    return sstr_utf8_valid_of(STR_PTR(s), sstr_length(s));
+}
+
+#ifdef SSTR_VEC_BYTES
+// the sum of the bytes of v.
+static size_t sstr_vec_sum_bytes(SSTR_VEC_T v) {
+#if defined(__AVX2__)
+    __m256i s = _mm256_sad_epu8(v, _mm256_setzero_si256());
+    __m128i h = _mm_add_epi64(_mm256_castsi256_si128(s),
+                              _mm256_extracti128_si256(s, 1));
+#else
+    __m128i h = _mm_sad_epu8(v, _mm_setzero_si128());
+#endif
+    return (size_t)_mm_cvtsi128_si32(h) +
+           (size_t)_mm_cvtsi128_si32(_mm_srli_si128(h, 8));
+}
+#endif
+
+size_t sstr_utf8_count_of(const void* data, size_t length) {
+    const unsigned char* p = (const unsigned char*)data;
+    size_t i = 0, count = 0, k;
+
+#ifdef SSTR_VEC_BYTES
+    // bytes above 10111111 as signed, the ones that are not continuations,
+    // are counted in byte lanes, summed before a lane can wrap
+    SSTR_VEC_T cont = SSTR_VEC_SET1(0xBF);
+    while (i + SSTR_VEC_BYTES <= length) {
+        SSTR_VEC_T acc = SSTR_VEC_SET1(0);
+        for (k = 0; k < 255 && i + SSTR_VEC_BYTES <= length;
+             k++, i += SSTR_VEC_BYTES) {
+            acc = SSTR_VEC_SUB(acc, SSTR_VEC_GT(SSTR_VEC_LOAD(p + i), cont));
+        }
+        count += sstr_vec_sum_bytes(acc);
+    }
+#else
+    (void)k;
+#endif
+    for (; i < length; i++) {
+        count += (p[i] & 0xC0) != 0x80;
+    }
+    return count;
+}
+
+size_t sstr_utf8_count(sstr_t s) {
+    return sstr_utf8_count_of(STR_PTR(s), sstr_length(s));
+}
+
+size_t sstr_utf8_boundary(sstr_t s, size_t index) {
+    const unsigned char* p = (const unsigned char*)STR_PTR(s);
+    size_t length = sstr_length(s), end;
+
+    if (index >= length) {
+        return length;
+    }
+    // a codepoint has at most three continuation bytes
+    end = index > 3 ? index - 3 : 0;
+    while (index > end && (p[index] & 0xC0) == 0x80) {
+        index--;
+    }
+    return index;
+}
+
+size_t sstr_utf8_truncate(sstr_t s, size_t length) {
+    length = sstr_utf8_boundary(s, length);
+    sstr_erase(s, length, sstr_length(s) - length);
+    return length;
+}
+
+size_t sstr_utf8_sanitize_append(sstr_t out, sstr_t in) {
+    STR* ss = SSTR(out);
+    const unsigned char* p = (const unsigned char*)STR_PTR(in);
+    size_t length = sstr_length(in), i = 0, j, count = 0;
+    unsigned char* o;
+    uint32_t cp;
+    int r;
+
+    if (sstr_utf8_valid_of(p, length)) {
+        sstr_append_of(out, p, length);
+        return 0;
+    }
+    // every byte may become the 3 bytes of U+FFFD
+    sstr_grow(ss, length * 3);
+    o = (unsigned char*)STR_PTR(ss) + sstr_length(ss);
+    while (i < length) {
+        j = sstr_utf8_skip_ascii(p, length, i);
+        memcpy(o, p + i, j - i);
+        o += j - i;
+        if ((i = j) == length) {
+            break;
+        }
+        r = sstr_utf8_decode(p + i, length - i, &cp);
+        if (r > 0) {
+            memcpy(o, p + i, r);
+            o += r;
+            i += r;
+        } else {
+            *o++ = 0xEF;
+            *o++ = 0xBF;
+            *o++ = 0xBD;
+            i += -r;
+            count++;
+        }
+    }
+    *o = '\0';
+    sstr_set_length(ss, o - (unsigned char*)STR_PTR(ss));
+    return count;
+}
+
+#ifdef SSTR_UTF8_BLOCK
+// the codepoint at p, known to be valid UTF-8 and not ASCII, to *cp.
+// Returns the length of its sequence.
+static int sstr_utf8_decode_valid(const unsigned char* p, uint32_t* cp) {
+    if (p[0] < 0xE0) {
+        *cp = ((p[0] & 0x1Fu) << 6) | (p[1] & 0x3Fu);
+        return 2;
+    }
+    if (p[0] < 0xF0) {
+        *cp = ((p[0] & 0x0Fu) << 12) | ((p[1] & 0x3Fu) << 6) | (p[2] & 0x3Fu);
+        return 3;
+    }
+    *cp = ((p[0] & 0x07u) << 18) | ((p[1] & 0x3Fu) << 12) |
+          ((p[2] & 0x3Fu) << 6) | (p[3] & 0x3Fu);
+    return 4;
+}
+#endif
+
+size_t sstr_utf8_to_utf16(sstr_t s, uint16_t* out, size_t capacity) {
+    const unsigned char* p = (const unsigned char*)STR_PTR(s);
+    size_t length = sstr_length(s), i = 0, w = 0;
+    uint32_t cp;
+    int r;
+
+#ifdef SSTR_UTF8_BLOCK
+    // validated at block speed first, the decoding trusts the lead bytes
+    if (!sstr_utf8_valid_of(p, length)) {
+        return SSTR_NPOS;
+    }
+#endif
+    while (i < length) {
+        if (p[i] < 0x80) {
+#if defined(__SSE2__)
+            // 16 ASCII bytes widen to 16 units with zeros
+            if (i + 16 <= length && w + 16 <= capacity) {
+                __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+                if (_mm_movemask_epi8(v) == 0) {
+                    __m128i z = _mm_setzero_si128();
+                    _mm_storeu_si128((__m128i*)(out + w),
+                                     _mm_unpacklo_epi8(v, z));
+                    _mm_storeu_si128((__m128i*)(out + w + 8),
+                                     _mm_unpackhi_epi8(v, z));
+                    i += 16;
+                    w += 16;
+                    continue;
+                }
+            }
+#endif
+            cp = p[i++];
+        } else {
+#ifdef SSTR_UTF8_BLOCK
+            r = sstr_utf8_decode_valid(p + i, &cp);
+#else
+            if ((r = sstr_utf8_decode(p + i, length - i, &cp)) < 0) {
+                return SSTR_NPOS;
+            }
+#endif
+            i += r;
+        }
+        if (cp < 0x10000) {
+            if (w + 1 > capacity) {
+                capacity = 0;  // out holds a prefix, only count from now on
+            } else {
+                out[w] = (uint16_t)cp;
+            }
+            w += 1;
+        } else {
+            if (w + 2 > capacity) {
+                capacity = 0;
+            } else {
+                cp -= 0x10000;
+                out[w] = (uint16_t)(0xD800 | (cp >> 10));
+                out[w + 1] = (uint16_t)(0xDC00 | (cp & 0x3FF));
+            }
+            w += 2;
+        }
+    }
+    return w;
+}
+
+int sstr_append_utf16(sstr_t s, const uint16_t* data, size_t length) {
+    STR* ss = SSTR(s);
+    size_t i = 0;
+    unsigned char *start, *o;
+    uint32_t u, lo;
+
+    // a unit takes 3 bytes at most, a surrogate pair 4
+    sstr_grow(ss, length * 3);
+    start = o = (unsigned char*)STR_PTR(ss) + sstr_length(ss);
+    while (i < length) {
+#if defined(__SSE2__)
+        // 8 units below 0x80 narrow to 8 bytes
+        if (i + 8 <= length) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+            __m128i high = _mm_and_si128(v, _mm_set1_epi16((short)0xFF80));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(
+                    high, _mm_setzero_si128())) == 0xFFFF) {
+                _mm_storel_epi64((__m128i*)o, _mm_packus_epi16(v, v));
+                o += 8;
+                i += 8;
+                continue;
+            }
+        }
+#endif
+        u = data[i++];
+        if (u < 0x80) {
+            *o++ = (unsigned char)u;
+        } else if (u < 0x800) {
+            *o++ = (unsigned char)(0xC0 | (u >> 6));
+            *o++ = (unsigned char)(0x80 | (u & 0x3F));
+        } else if (u < 0xD800 || u > 0xDFFF) {
+            *o++ = (unsigned char)(0xE0 | (u >> 12));
+            *o++ = (unsigned char)(0x80 | ((u >> 6) & 0x3F));
+            *o++ = (unsigned char)(0x80 | (u & 0x3F));
+        } else if (u < 0xDC00 && i < length &&
+                   (lo = data[i]) >= 0xDC00 && lo <= 0xDFFF) {
+            i++;
+            u = 0x10000 + ((u - 0xD800) << 10) + (lo - 0xDC00);
+            *o++ = (unsigned char)(0xF0 | (u >> 18));
+            *o++ = (unsigned char)(0x80 | ((u >> 12) & 0x3F));
+            *o++ = (unsigned char)(0x80 | ((u >> 6) & 0x3F));
+            *o++ = (unsigned char)(0x80 | (u & 0x3F));
+        } else {
+            *start = '\0';  // a lone surrogate, keep s as it was
+            return -1;
+        }
+    }
+    *o = '\0';
+    sstr_set_length(ss, o - (unsigned char*)STR_PTR(ss));
+    return 0;
+}
+
+// first byte c at or after from, like memchr(). Fields are short, where
+// the call to memchr() costs more than the scan.
+static size_t sstr_find_byte(const char* h, size_t hlen, char c, size_t from) {
+    size_t i = from;
+
+#ifdef SSTR_VEC_BYTES
+    SSTR_VEC_T n = SSTR_VEC_SET1(c);
+    uint32_t mask;
+
+    for (; hlen - i >= SSTR_VEC_BYTES; i += SSTR_VEC_BYTES) {
+        mask = SSTR_VEC_MASK(SSTR_VEC_EQ(SSTR_VEC_LOAD(h + i), n));
+        if (mask) {
+            return i + sstr_ctz64(mask);
+        }
+    }
+#endif
+    for (; i < hlen; i++) {
+        if (h[i] == c) {
+            return i;
+        }
+    }
+    return SSTR_NPOS;
+}
+
+void sstr_split_init(sstr_split_t* it, sstr_t s, const void* delim,
+                     size_t length, int flags) {
+    it->data = STR_PTR(s);
+    it->length = sstr_length(s);
+    it->pos = 0;
+    it->delim = (const char*)delim;
+    it->delim_length = length;
+    it->flags = length == 1 ? flags & ~SSTR_SPLIT_ANY_OF : flags;
+    if (it->flags & SSTR_SPLIT_ANY_OF) {
+        sstr_byteset_init(it->delim_set, (const unsigned char*)delim, length);
+    }
+    sstr_ref_init(&it->field, it->data, 0);
+}
+
+sstr_t sstr_split_next(sstr_split_t* it) {
+    size_t start, end;
+
+    // pos is one past the end once the last field is out
+    while (it->pos <= it->length) {
+        start = it->pos;
+        if (it->delim_length == 0) {
+            end = SSTR_NPOS;
+        } else if (it->delim_length == 1) {
+            end = sstr_find_byte(it->data, it->length, it->delim[0], start);
+        } else if (it->flags & SSTR_SPLIT_ANY_OF) {
+            end = sstr_find_byteset(
+                (const unsigned char*)it->data, it->length, it->delim_set,
+                (const unsigned char*)it->delim, it->delim_length, start);
+        } else {
+            end = sstr_find_in(it->data, it->length, it->delim,
+                               it->delim_length, start);
+        }
+        if (end == SSTR_NPOS) {
+            end = it->length;
+            it->pos = it->length + 1;
+        } else if (it->flags & SSTR_SPLIT_ANY_OF) {
+            it->pos = end + 1;  // one byte of the set
+        } else {
+            it->pos = end + it->delim_length;
+        }
+        if (end == start && (it->flags & SSTR_SPLIT_SKIP_EMPTY)) {
+            continue;
+        }
+        it->field.un.heap.data = (char*)it->data + start;
+        it->field.un.heap.tag = SSTR_TAG(end - start, SSTR_TYPE_REF);
+        return &it->field;
+    }
+    return NULL;
+}
+
+#define SSTR_HASH_P0 0x2d358dccaa6c78a5ULL
+#define SSTR_HASH_P1 0x8bb84b93962eacc9ULL
+#define SSTR_HASH_P2 0x4b33a62ed433d4a3ULL
+#define SSTR_HASH_P3 0x4d5a2da51de1aa47ULL
+#define SSTR_HASH_P32 0x9e3779b1ULL
+// inputs longer than this are mixed in stripes of 64 bytes, 8 lanes of 8.
+#define SSTR_HASH_STRIPE_MIN 1024
+#define SSTR_HASH_STRIPE 64
+// stripes between two scrambles of the lanes.
+#define SSTR_HASH_BLOCK 8
+
+// keys of the stripes and of the scrambles, see sstr_hash_stripes().
+static const uint64_t sstr_hash_secret[24] = {
+    0xfd9ac318a2de2524ULL, 0x6a4ef3a2b93f1506ULL, 0x96c8470c93f37a75ULL,
+    0xb7ca190ff12feacdULL, 0x5169ec5f224ec7baULL, 0xde58af6086585c26ULL,
+    0x3f90ada5dca019bdULL, 0x66aa2f192bf65136ULL, 0x9d79f0696049d9dfULL,
+    0xf4d23e4c65a03642ULL, 0x8fd6067c543c3e9fULL, 0x4db5fd18b3e404e8ULL,
+    0x9f9c672da2966d67ULL, 0x84a4a5b255a606beULL, 0xb0927ebcbf0056b3ULL,
+    0x3ee9f023ec802179ULL, 0xd8ddd78d09f0c7abULL, 0x013a5d4fa7e1fb6eULL,
+    0x165e23b61ef858ecULL, 0x39e631240db2031bULL, 0xebb4a7151e7893dbULL,
+    0x7e6672b4067a3089ULL, 0x9dbd7de4c8ae4f4fULL, 0x7b075e15eb48e1f3ULL,
+};
+
+static uint64_t sstr_read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t sstr_read32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// the 128-bit product of *a and *b, low half in *a, high half in *b.
+static void sstr_hash_mum(uint64_t* a, uint64_t* b) {
+    uint64_t hi;
+    *a = sstr_mul64(*a, *b, &hi);
+    *b = hi;
+}
+
+// fold the 128-bit product of a and b to 64 bits.
+static uint64_t sstr_hash_mix(uint64_t a, uint64_t b) {
+    sstr_hash_mum(&a, &b);
+    return a ^ b;
+}
+
+// Every lane of a stripe adds the product of the low and high halves of its
+// keyed input to itself, and the unkeyed input to its neighbour. The SIMD
+// versions below compute exactly what the scalar one does.
+#if defined(__AVX2__)
+static __m256i sstr_hash_lanes256(__m256i acc, const unsigned char* p,
+                                  const uint64_t* key) {
+    __m256i d = _mm256_loadu_si256((const __m256i*)p);
+    __m256i dk =
+        _mm256_xor_si256(d, _mm256_loadu_si256((const __m256i*)key));
+    __m256i prod = _mm256_mul_epu32(
+        dk, _mm256_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1)));
+    __m256i swap = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm256_add_epi64(acc, _mm256_add_epi64(prod, swap));
+}
+
+static __m256i sstr_hash_scramble256(__m256i acc, const uint64_t* key) {
+    const __m256i prime = _mm256_set1_epi32((int)SSTR_HASH_P32);
+    __m256i a = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+    a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)key));
+    return _mm256_add_epi64(
+        _mm256_mul_epu32(a, prime),
+        _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime),
+                          32));
+}
+#elif defined(__SSE2__)
+static __m128i sstr_hash_lanes128(__m128i acc, const unsigned char* p,
+                                  const uint64_t* key) {
+    __m128i d = _mm_loadu_si128((const __m128i*)p);
+    __m128i dk = _mm_xor_si128(d, _mm_loadu_si128((const __m128i*)key));
+    __m128i prod =
+        _mm_mul_epu32(dk, _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1)));
+    __m128i swap = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm_add_epi64(acc, _mm_add_epi64(prod, swap));
+}
+
+static __m128i sstr_hash_scramble128(__m128i acc, const uint64_t* key) {
+    const __m128i prime = _mm_set1_epi32((int)SSTR_HASH_P32);
+    __m128i a = _mm_xor_si128(acc, _mm_srli_epi64(acc, 47));
+    a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)key));
+    return _mm_add_epi64(
+        _mm_mul_epu32(a, prime),
+        _mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), prime), 32));
+}
+#endif
+
+// add the n stripes at p to acc, stripe i is keyed by key + i. Then, if
+// scramble is not NULL, scramble the lanes with it.
+static void sstr_hash_accumulate(uint64_t* acc, const unsigned char* p,
+                                 size_t n, const uint64_t* key,
+                                 const uint64_t* scramble) {
+    size_t i;
+#if defined(__AVX2__)
+    __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+    __m256i a1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+
+    for (i = 0; i < n; i++, p += SSTR_HASH_STRIPE) {
+        a0 = sstr_hash_lanes256(a0, p, key + i);
+        a1 = sstr_hash_lanes256(a1, p + 32, key + i + 4);
+    }
+    if (scramble) {
+        a0 = sstr_hash_scramble256(a0, scramble);
+        a1 = sstr_hash_scramble256(a1, scramble + 4);
+    }
+    _mm256_storeu_si256((__m256i*)acc, a0);
+    _mm256_storeu_si256((__m256i*)(acc + 4), a1);
+#elif defined(__SSE2__)
+    __m128i a0 = _mm_loadu_si128((const __m128i*)acc);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)(acc + 2));
+    __m128i a2 = _mm_loadu_si128((const __m128i*)(acc + 4));
+    __m128i a3 = _mm_loadu_si128((const __m128i*)(acc + 6));
+
+    for (i = 0; i < n; i++, p += SSTR_HASH_STRIPE) {
+        a0 = sstr_hash_lanes128(a0, p, key + i);
+        a1 = sstr_hash_lanes128(a1, p + 16, key + i + 2);
+        a2 = sstr_hash_lanes128(a2, p + 32, key + i + 4);
+        a3 = sstr_hash_lanes128(a3, p + 48, key + i + 6);
+    }
+    if (scramble) {
+        a0 = sstr_hash_scramble128(a0, scramble);
+        a1 = sstr_hash_scramble128(a1, scramble + 2);
+        a2 = sstr_hash_scramble128(a2, scramble + 4);
+        a3 = sstr_hash_scramble128(a3, scramble + 6);
+    }
+    _mm_storeu_si128((__m128i*)acc, a0);
+    _mm_storeu_si128((__m128i*)(acc + 2), a1);
+    _mm_storeu_si128((__m128i*)(acc + 4), a2);
+    _mm_storeu_si128((__m128i*)(acc + 6), a3);
+#else
+    int j;
+
+    for (i = 0; i < n; i++, p += SSTR_HASH_STRIPE) {
+        for (j = 0; j < 8; j++) {
+            uint64_t d = sstr_read64(p + 8 * j), dk = d ^ key[i + j];
+            acc[j ^ 1] += d;
+            acc[j] += (dk & 0xffffffff) * (dk >> 32);
+        }
+    }
+    for (j = 0; scramble && j < 8; j++) {
+        acc[j] ^= acc[j] >> 47;
+        acc[j] ^= scramble[j];
+        acc[j] *= SSTR_HASH_P32;
+    }
+#endif
+}
+
+// mix the n > SSTR_HASH_STRIPE_MIN bytes at p down to 64 bits: full blocks
+// of stripes, the stripes left, and the last 64 bytes as one more stripe.
+// The seed goes into the lanes, the scramble of the first block spreads it.
+static uint64_t sstr_hash_stripes(const unsigned char* p, size_t n,
+                                  uint64_t seed) {
+    const size_t block = SSTR_HASH_STRIPE * SSTR_HASH_BLOCK;
+    const uint64_t* key = sstr_hash_secret;
+    size_t nblocks = (n - 1) / block, i;
+    uint64_t acc[8] = {SSTR_HASH_P0 + seed,  SSTR_HASH_P1 - seed,
+                       SSTR_HASH_P2 + seed,  SSTR_HASH_P3 - seed,
+                       ~SSTR_HASH_P0 + seed, ~SSTR_HASH_P1 - seed,
+                       ~SSTR_HASH_P2 + seed, ~SSTR_HASH_P3 - seed};
+    uint64_t h = n * SSTR_HASH_P1;
+
+    for (i = 0; i < nblocks; i++) {
+        sstr_hash_accumulate(acc, p + i * block, SSTR_HASH_BLOCK, key,
+                             key + 16);
+    }
+    sstr_hash_accumulate(acc, p + nblocks * block,
+                         ((n - 1) % block) / SSTR_HASH_STRIPE, key, NULL);
+    sstr_hash_accumulate(acc, p + n - SSTR_HASH_STRIPE, 1, key + 9, NULL);
+    for (i = 0; i < 8; i += 2) {
+        h += sstr_hash_mix(acc[i] ^ key[16 + i], acc[i + 1] ^ key[17 + i]);
+    }
+    return h;
+}
+
+uint64_t sstr_hash_of(const void* data, size_t length, uint64_t seed) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t a = 0, b = 0;
+    size_t n = length;
+
+    seed ^= sstr_hash_mix(seed ^ SSTR_HASH_P0, SSTR_HASH_P1);
+    if (n <= 16) {
+        // two overlapping loads, no loop
+        if (n >= 4) {
+            size_t mid = (n >> 3) << 2;
+            a = (sstr_read32(p) << 32) | sstr_read32(p + mid);
+            b = (sstr_read32(p + n - 4) << 32) | sstr_read32(p + n - 4 - mid);
+        } else if (n > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[n >> 1] << 8) | p[n - 1];
+        }
+    } else {
+        if (n > SSTR_HASH_STRIPE_MIN) {
+            seed = sstr_hash_stripes(p, n, seed);
+            p += n - 16;
+            n = 16;
+        } else if (n > 48) {
+            // three independent lanes of 16 bytes
+            uint64_t seed1 = seed, seed2 = seed;
+            do {
+                seed = sstr_hash_mix(sstr_read64(p) ^ SSTR_HASH_P1,
+                                     sstr_read64(p + 8) ^ seed);
+                seed1 = sstr_hash_mix(sstr_read64(p + 16) ^ SSTR_HASH_P2,
+                                      sstr_read64(p + 24) ^ seed1);
+                seed2 = sstr_hash_mix(sstr_read64(p + 32) ^ SSTR_HASH_P3,
+                                      sstr_read64(p + 40) ^ seed2);
+                p += 48;
+                n -= 48;
+            } while (n > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (n > 16) {
+            seed = sstr_hash_mix(sstr_read64(p) ^ SSTR_HASH_P1,
+                                 sstr_read64(p + 8) ^ seed);
+            p += 16;
+            n -= 16;
+        }
+        a = sstr_read64(p + n - 16);
+        b = sstr_read64(p + n - 8);
+    }
+    a ^= SSTR_HASH_P1;
+    b ^= seed;
+    sstr_hash_mum(&a, &b);
+    return sstr_hash_mix(a ^ SSTR_HASH_P0 ^ length, b ^ SSTR_HASH_P1);
+}
+
+uint64_t sstr_hash_seed(sstr_t s, uint64_t seed) {
+    return sstr_hash_of(STR_PTR(s), sstr_length(s), seed);
+}
+
+uint64_t sstr_hash(sstr_t s) {
+    STR* ss = SSTR(s);
+    sstr_buf_t* b;
+    uint64_t h;
+
+    if ((STR_TYPE(ss) != SSTR_TYPE_LONG && STR_TYPE(ss) != SSTR_TYPE_SHARED) ||
+        ss->un.heap.data == SSTR_EMPTY_DATA) {
+        return sstr_hash_of(STR_PTR(s), sstr_length(ss), 0);
+    }
+    // cached in the buffer prefix, 0 means not computed yet
+    b = SSTR_BUF_OF(ss->un.heap.data);
+    h = atomic_load_explicit(&b->hash, memory_order_relaxed);
+    if (h == 0) {
+        h = sstr_hash_of(ss->un.heap.data, sstr_length(ss), 0);
+        atomic_store_explicit(&b->hash, h, memory_order_relaxed);
+    }
+    return h;
+}
+
+#define SSTR_INTERN_SHARDS 16
+#define SSTR_INTERN_MAX_SHARDS 256
+#define SSTR_INTERN_MIN_SLOTS 16
+// interned strings are packed into arena blocks of this size.
+#define SSTR_INTERN_BLOCK_SIZE 65536
+
+// Slots are only ever filled, never emptied or moved, so readers probe
+// without a lock: a writer stores the hash first and publishes the string
+// with a release store. A resize publishes a new table the same way, the old
+// one may still be read and is only freed by sstr_intern_destroy().
+struct sstr_intern_slot_s {
+    uint64_t hash;
+    _Atomic(STR*) str;  // NULL for an empty slot
+};
+
+struct sstr_intern_table_s {
+    size_t mask;  // mask + 1 slots, open addressing with linear probing
+    struct sstr_intern_table_s* retired;  // the table this one replaced
+    struct sstr_intern_slot_s slots[];
+};
+
+// a shard per cache line, so that writers to two shards do not contend.
+struct sstr_intern_shard_s {
+    _Alignas(64) pthread_mutex_t lock;  // serializes the writers
+    _Atomic(struct sstr_intern_table_s*) table;
+    size_t count;
+    size_t bytes;
+    sstr_arena_t* arena;
+};
+
+struct sstr_intern_s {
+    size_t shard_mask;
+    struct sstr_intern_shard_s* shards;
+};
+
+static struct sstr_intern_table_s* sstr_intern_table_new(size_t slots) {
+    struct sstr_intern_table_s* t = (struct sstr_intern_table_s*)calloc(
+        1, sizeof(struct sstr_intern_table_s) +
+               slots * sizeof(struct sstr_intern_slot_s));
+    t->mask = slots - 1;
+    return t;
+}
+
+sstr_intern_t* sstr_intern_create(size_t shards) {
+    sstr_intern_t* pool = (sstr_intern_t*)malloc(sizeof(sstr_intern_t));
+    size_t n = 1, i;
+
+    if (shards == 0) {
+        shards = SSTR_INTERN_SHARDS;
+    }
+    while (n < shards && n < SSTR_INTERN_MAX_SHARDS) {
+        n <<= 1;
+    }
+    pool->shard_mask = n - 1;
+    pool->shards = (struct sstr_intern_shard_s*)aligned_alloc(
+        _Alignof(struct sstr_intern_shard_s),
+        n * sizeof(struct sstr_intern_shard_s));
+    for (i = 0; i < n; i++) {
+        struct sstr_intern_shard_s* sh = &pool->shards[i];
+        pthread_mutex_init(&sh->lock, NULL);
+        atomic_init(&sh->table, sstr_intern_table_new(SSTR_INTERN_MIN_SLOTS));
+        sh->count = 0;
+        sh->bytes = 0;
+        sh->arena = sstr_arena_create(SSTR_INTERN_BLOCK_SIZE);
+    }
+    return pool;
+}
+
+void sstr_intern_destroy(sstr_intern_t* pool) {
+    size_t i;
+
+    if (pool == NULL) {
+        return;
+    }
+    for (i = 0; i <= pool->shard_mask; i++) {
+        struct sstr_intern_shard_s* sh = &pool->shards[i];
+        struct sstr_intern_table_s* t = atomic_load(&sh->table);
+        while (t) {
+            struct sstr_intern_table_s* retired = t->retired;
+            free(t);
+            t = retired;
+        }
+        pthread_mutex_destroy(&sh->lock);
+        sstr_arena_destroy(sh->arena);
+    }
+    free(pool->shards);
+    free(pool);
+}
+
+// the shard is picked by the top bits of the hash, the slot by the low ones.
+static struct sstr_intern_shard_s* sstr_intern_shard(sstr_intern_t* pool,
+                                                     uint64_t hash) {
+    return &pool->shards[(hash >> 56) & pool->shard_mask];
+}
+
+static STR* sstr_intern_probe(struct sstr_intern_table_s* t, uint64_t hash,
+                              const void* data, size_t length) {
+    size_t i = hash & t->mask;
+    STR* s;
+
+    for (;; i = (i + 1) & t->mask) {
+        s = atomic_load_explicit(&t->slots[i].str, memory_order_acquire);
+        if (s == NULL) {
+            return NULL;
+        }
+        if (t->slots[i].hash == hash && sstr_length(s) == length &&
+            memcmp(STR_PTR(s), data, length) == 0) {
+            return s;
+        }
+    }
+}
+
+static void sstr_intern_put(struct sstr_intern_table_s* t, uint64_t hash,
+                            STR* s) {
+    size_t i = hash & t->mask;
+
+    while (atomic_load_explicit(&t->slots[i].str, memory_order_relaxed)) {
+        i = (i + 1) & t->mask;
+    }
+    t->slots[i].hash = hash;
+    atomic_store_explicit(&t->slots[i].str, s, memory_order_release);
+}
+
+// return a table of sh with room for one more string, keeping the load
+// factor below 3/4. The caller holds the lock of sh.
+static struct sstr_intern_table_s* sstr_intern_reserve(
+    struct sstr_intern_shard_s* sh) {
+    struct sstr_intern_table_s* t =
+        atomic_load_explicit(&sh->table, memory_order_relaxed);
+    struct sstr_intern_table_s* nt;
+    size_t i;
+
+    if ((sh->count + 1) * 4 <= (t->mask + 1) * 3) {
+        return t;
+    }
+    nt = sstr_intern_table_new((t->mask + 1) * 2);
+    for (i = 0; i <= t->mask; i++) {
+        STR* s = atomic_load_explicit(&t->slots[i].str, memory_order_relaxed);
+        if (s) {
+            sstr_intern_put(nt, t->slots[i].hash, s);
+        }
+    }
+    nt->retired = t;
+    atomic_store_explicit(&sh->table, nt, memory_order_release);
+    return nt;
+}
+
+// copy data into the arena of sh as a canonical string: header and bytes in
+// one piece, a short string in the header, a long one right after it.
+static STR* sstr_intern_make(struct sstr_intern_shard_s* sh, const void* data,
+                             size_t length) {
+    STR* s;
+
+    // sstr_dup() copies through the default allocator, never the arena.
+    if (length <= STR_SHORT_CAPACITY(sstr_global_allocator)) {
+        s = (STR*)sstr_arena_alloc(sh->arena, sizeof(STR));
+        memcpy(STR_SHORT_PTR(s, sstr_global_allocator), data, length);
+        sstr_set_short(s, sstr_global_allocator, length);
+    } else {
+        s = (STR*)sstr_arena_alloc(sh->arena, sizeof(STR) + length + 1);
+        memcpy(s + 1, data, length);
+        ((char*)(s + 1))[length] = '\0';
+        sstr_ref_init(s, s + 1, length);
+        s->un.heap.allocator = sstr_global_allocator;
+    }
+    return s;
+}
+
+// sstr_intern_of() with the hash of data already computed.
+static sstr_t sstr_intern_hashed(sstr_intern_t* pool, uint64_t hash,
+                                 const void* data, size_t length) {
+    struct sstr_intern_shard_s* sh = sstr_intern_shard(pool, hash);
+    STR* s = sstr_intern_probe(
+        atomic_load_explicit(&sh->table, memory_order_acquire), hash, data,
+        length);
+    struct sstr_intern_table_s* t;
+
+    if (s) {
+        return s;
+    }
+    pthread_mutex_lock(&sh->lock);
+    // another writer may have interned it meanwhile
+    s = sstr_intern_probe(
+        atomic_load_explicit(&sh->table, memory_order_relaxed), hash, data,
+        length);
+    if (s == NULL) {
+        t = sstr_intern_reserve(sh);
+        s = sstr_intern_make(sh, data, length);
+        sstr_intern_put(t, hash, s);
+        sh->count++;
+        sh->bytes += length;
+    }
+    pthread_mutex_unlock(&sh->lock);
+    return s;
+}
+
+sstr_t sstr_intern_of(sstr_intern_t* pool, const void* data, size_t length) {
+    return sstr_intern_hashed(pool, sstr_hash_of(data, length, 0), data,
+                              length);
+}
+
+sstr_t sstr_intern(sstr_intern_t* pool, sstr_t s) {
+    return sstr_intern_hashed(pool, sstr_hash(s), STR_PTR(s), sstr_length(s));
+}
+
+sstr_t sstr_intern_find(sstr_intern_t* pool, const void* data,
+                        size_t length) {
+    uint64_t hash = sstr_hash_of(data, length, 0);
+    struct sstr_intern_shard_s* sh = sstr_intern_shard(pool, hash);
+
+    return sstr_intern_probe(
+        atomic_load_explicit(&sh->table, memory_order_acquire), hash, data,
+        length);
+}
+
+void sstr_intern_stats(sstr_intern_t* pool, sstr_intern_stats_t* stats) {
+    size_t i;
+    struct sstr_intern_table_s* t;
+    struct sstr_arena_block_s* b;
+
+    stats->count = 0;
+    stats->bytes = 0;
+    stats->memory = sizeof(sstr_intern_t) +
+                    (pool->shard_mask + 1) * sizeof(struct sstr_intern_shard_s);
+    for (i = 0; i <= pool->shard_mask; i++) {
+        struct sstr_intern_shard_s* sh = &pool->shards[i];
+        pthread_mutex_lock(&sh->lock);
+        stats->count += sh->count;
+        stats->bytes += sh->bytes;
+        stats->memory += sizeof(sstr_arena_t);
+        for (t = atomic_load_explicit(&sh->table, memory_order_relaxed); t;
+             t = t->retired) {
+            stats->memory += sizeof(struct sstr_intern_table_s) +
+                             (t->mask + 1) * sizeof(struct sstr_intern_slot_s);
+        }
+        for (b = sh->arena->head; b; b = b->next) {
+            stats->memory += SSTR_ARENA_BLOCK_HDR + b->size;
+        }
+        pthread_mutex_unlock(&sh->lock);
+    }
+}
+
+// Swiss table: a control byte per slot tells empty, deleted or full, and a
+// full one holds 7 bits of the hash of its key. A lookup compares the
+// control bytes of 16 slots at once and only looks at the keys of slots
+// whose 7 bits match.
+#define SSTR_MAP_GROUP 16
+#define SSTR_MAP_MIN_CAPACITY 16
+#define SSTR_MAP_EMPTY ((int8_t)-128)
+#define SSTR_MAP_DELETED ((int8_t)-2)
+
+struct sstr_map_slot_s {
+    struct sstr_s key;  // short keys live in the slot itself
+    void* value;
+};
+
+struct sstr_map_s {
+    // capacity + SSTR_MAP_GROUP control bytes, the last SSTR_MAP_GROUP
+    // repeat the first ones so a group can be loaded at any slot.
+    int8_t* ctrl;
+    struct sstr_map_slot_s* slots;
+    size_t mask;         // capacity - 1, capacity is a power of two
+    size_t size;         // full slots
+    size_t growth_left;  // empty slots that may still be filled
+};
+
+// bit i set if control byte i of the group at ctrl is c.
+static uint32_t sstr_map_match(const int8_t* ctrl, int8_t c) {
+#if defined(__SSE2__)
+    __m128i g = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(c)));
+#else
+    uint32_t m = 0;
+    int i;
+    for (i = 0; i < SSTR_MAP_GROUP; i++) {
+        m |= (uint32_t)(ctrl[i] == c) << i;
+    }
+    return m;
+#endif
+}
+
+// bit i set if slot i of the group at ctrl is empty or deleted.
+static uint32_t sstr_map_match_free(const int8_t* ctrl) {
+#if defined(__SSE2__)
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_loadu_si128((const __m128i*)ctrl));
+#else
+    uint32_t m = 0;
+    int i;
+    for (i = 0; i < SSTR_MAP_GROUP; i++) {
+        m |= (uint32_t)(ctrl[i] < 0) << i;
+    }
+    return m;
+#endif
+}
+
+static void sstr_map_set_ctrl(sstr_map_t* map, size_t i, int8_t c) {
+    map->ctrl[i] = c;
+    if (i < SSTR_MAP_GROUP) {
+        map->ctrl[map->mask + 1 + i] = c;
+    }
+}
+
+static void sstr_map_alloc(sstr_map_t* map, size_t capacity) {
+    map->ctrl = (int8_t*)malloc(capacity + SSTR_MAP_GROUP);
+    memset(map->ctrl, SSTR_MAP_EMPTY, capacity + SSTR_MAP_GROUP);
+    map->slots = (struct sstr_map_slot_s*)malloc(
+        capacity * sizeof(struct sstr_map_slot_s));
+    map->mask = capacity - 1;
+    map->growth_left = capacity - capacity / 8;
+}
+
+sstr_map_t* sstr_map_create(size_t capacity) {
+    sstr_map_t* map = (sstr_map_t*)malloc(sizeof(sstr_map_t));
+    size_t cap = SSTR_MAP_MIN_CAPACITY;
+
+    while (cap - cap / 8 < capacity) {
+        cap <<= 1;
+    }
+    sstr_map_alloc(map, cap);
+    map->size = 0;
+    return map;
+}
+
+void sstr_map_destroy(sstr_map_t* map) {
+    size_t i;
+
+    if (map == NULL) {
+        return;
+    }
+    for (i = 0; i <= map->mask; i++) {
+        if (map->ctrl[i] >= 0) {
+            sstr_deinit(&map->slots[i].key);
+        }
+    }
+    free(map->ctrl);
+    free(map->slots);
+    free(map);
+}
+
+size_t sstr_map_size(sstr_map_t* map) { return map->size; }
+
+// the slot of key in map, or SSTR_NPOS. If avail is not NULL, *avail is set
+// to the first empty or deleted slot on the way.
+static size_t sstr_map_lookup(sstr_map_t* map, uint64_t hash,
+                              const void* key, size_t length, size_t* avail) {
+    int8_t h2 = (int8_t)(hash & 0x7f);
+    size_t pos = (size_t)(hash >> 7) & map->mask, step = 0, i;
+    uint32_t m;
+
+    if (avail) {
+        *avail = SSTR_NPOS;
+    }
+    for (;;) {
+        const int8_t* g = map->ctrl + pos;
+        for (m = sstr_map_match(g, h2); m; m &= m - 1) {
+            i = (pos + sstr_ctz64(m)) & map->mask;
+            STR* k = &map->slots[i].key;
+            if (sstr_length(k) == length &&
+                memcmp(STR_PTR(k), key, length) == 0) {
+                return i;
+            }
+        }
+        m = sstr_map_match_free(g);
+        if (avail && *avail == SSTR_NPOS && m) {
+            *avail = (pos + sstr_ctz64(m)) & map->mask;
+        }
+        if (sstr_map_match(g, SSTR_MAP_EMPTY)) {
+            return SSTR_NPOS;
+        }
+        // triangular steps of whole groups visit every group once
+        step += SSTR_MAP_GROUP;
+        pos = (pos + step) & map->mask;
+    }
+}
+
+// first empty or deleted slot of the probe sequence of hash.
+static size_t sstr_map_find_free(sstr_map_t* map, uint64_t hash) {
+    size_t pos = (size_t)(hash >> 7) & map->mask, step = 0;
+    uint32_t m;
+
+    while ((m = sstr_map_match_free(map->ctrl + pos)) == 0) {
+        step += SSTR_MAP_GROUP;
+        pos = (pos + step) & map->mask;
+    }
+    return (pos + sstr_ctz64(m)) & map->mask;
+}
+
+// move every entry into new arrays of capacity slots, dropping the deleted
+// ones.
+static void sstr_map_rehash(sstr_map_t* map, size_t capacity) {
+    int8_t* ctrl = map->ctrl;
+    struct sstr_map_slot_s* slots = map->slots;
+    size_t old_capacity = map->mask + 1, i, j;
+
+    sstr_map_alloc(map, capacity);
+    for (i = 0; i < old_capacity; i++) {
+        if (ctrl[i] >= 0) {
+            // long keys cache their hash, short ones are cheap to hash
+            uint64_t hash = sstr_hash(&slots[i].key);
+            j = sstr_map_find_free(map, hash);
+            sstr_map_set_ctrl(map, j, (int8_t)(hash & 0x7f));
+            map->slots[j] = slots[i];
+        }
+    }
+    map->growth_left -= map->size;
+    free(ctrl);
+    free(slots);
+}
+
+static void** sstr_map_insert_hashed(sstr_map_t* map, uint64_t hash,
+                                     const void* key, size_t length) {
+    size_t avail, i = sstr_map_lookup(map, hash, key, length, &avail);
+    struct sstr_map_slot_s* slot;
+
+    if (i != SSTR_NPOS) {
+        return &map->slots[i].value;
+    }
+    if (map->ctrl[avail] == SSTR_MAP_EMPTY && map->growth_left == 0) {
+        // grow, unless deleted slots take the room
+        size_t capacity = map->mask + 1;
+        if ((map->size + 1) * 16 > capacity * 7) {
+            capacity *= 2;
+        }
+        sstr_map_rehash(map, capacity);
+        avail = sstr_map_find_free(map, hash);
+    }
+    if (map->ctrl[avail] == SSTR_MAP_EMPTY) {
+        map->growth_left--;
+    }
+    sstr_map_set_ctrl(map, avail, (int8_t)(hash & 0x7f));
+    slot = &map->slots[avail];
+    sstr_init(&slot->key);
+    sstr_set_copy(&slot->key, key, length);
+    slot->value = NULL;
+    map->size++;
+    return &slot->value;
+}
+
+void** sstr_map_insert_of(sstr_map_t* map, const void* key, size_t length) {
+    return sstr_map_insert_hashed(map, sstr_hash_of(key, length, 0), key,
+                                  length);
+}
+
+void** sstr_map_insert(sstr_map_t* map, sstr_t key) {
+    return sstr_map_insert_hashed(map, sstr_hash(key), STR_PTR(key),
+                                  sstr_length(key));
+}
+
+void** sstr_map_find_of(sstr_map_t* map, const void* key, size_t length) {
+    size_t i = sstr_map_lookup(map, sstr_hash_of(key, length, 0), key, length,
+                               NULL);
+    return i == SSTR_NPOS ? NULL : &map->slots[i].value;
+}
+
+void** sstr_map_find(sstr_map_t* map, sstr_t key) {
+    size_t i = sstr_map_lookup(map, sstr_hash(key), STR_PTR(key),
+                               sstr_length(key), NULL);
+    return i == SSTR_NPOS ? NULL : &map->slots[i].value;
+}
+
+static int sstr_map_erase_hashed(sstr_map_t* map, uint64_t hash,
+                                 const void* key, size_t length) {
+    size_t i = sstr_map_lookup(map, hash, key, length, NULL);
+
+    if (i == SSTR_NPOS) {
+        return 0;
+    }
+    sstr_deinit(&map->slots[i].key);
+    // a probe may have passed this full slot, leave a tombstone
+    sstr_map_set_ctrl(map, i, SSTR_MAP_DELETED);
+    map->size--;
+    return 1;
+}
 
-                    continue;
+int sstr_map_erase_of(sstr_map_t* map, const void* key, size_t length) {
+    return sstr_map_erase_hashed(map, sstr_hash_of(key, length, 0), key,
+                                 length);
+}
 
-                case 'Z':
-                    sstr_append_of(buf, (unsigned char*)"\0", 1);
-                    fmt++;
+int sstr_map_erase(sstr_map_t* map, sstr_t key) {
+    return sstr_map_erase_hashed(map, sstr_hash(key), STR_PTR(key),
+                                 sstr_length(key));
+}
 
-                    continue;
+sstr_t sstr_map_next(sstr_map_t* map, size_t* iter, void** value) {
+    size_t i;
 
-                case 'N':
-                    sstr_append_of(buf, (unsigned char*)"\n", 1);
-                    fmt++;
+    for (i = *iter; i <= map->mask; i++) {
+        if (map->ctrl[i] >= 0) {
+            *iter = i + 1;
+            if (value) {
+                *value = map->slots[i].value;
+            }
+            return &map->slots[i].key;
+        }
+    }
+    *iter = i;
+    return NULL;
+}
 
-                    continue;
+#define SSTR_BUILDER_MIN_SEGMENTS 16
+// content shorter than this is copied next to the segment before it rather
+// than shared as a segment of its own: a copy that small costs less than
+// one more iovec entry.
+#define SSTR_BUILDER_SHARE_MIN 256
 
-                case '%':
-                    sstr_append_of(buf, (unsigned char*)"%", 1);
-                    fmt++;
+struct sstr_builder_s {
+    // the segments are [start, count), the ones before start are consumed.
+    struct iovec* iov;
+    size_t start;
+    size_t count;
+    size_t capacity;
+    size_t length;  // bytes in the segments
+    // headers of the long buffers shared by the segments.
+    STR* shared;
+    size_t shared_count;
+    size_t shared_capacity;
+    // copies are packed into the blocks of this arena.
+    sstr_arena_t* arena;
+};
 
-                    continue;
+sstr_builder_t* sstr_builder_create() {
+    sstr_builder_t* b = (sstr_builder_t*)calloc(1, sizeof(sstr_builder_t));
 
-                default:
-                    if (df_d) {
-                        if (sign) {
-                            i64 = (int64_t)va_arg(args, int);
-                        } else {
-                            ui64 = (uint64_t)va_arg(args, unsigned int);
-                        }
-                        break;
-                    }
-                    if (*fmt) sstr_append_of(buf, fmt++, 1);
+    b->capacity = SSTR_BUILDER_MIN_SEGMENTS;
+    b->iov = (struct iovec*)malloc(b->capacity * sizeof(struct iovec));
+    b->arena = sstr_arena_create(0);
+    return b;
+}
 
-                    continue;
-            }
+void sstr_builder_destroy(sstr_builder_t* b) {
+    if (b == NULL) {
+        return;
+    }
+    sstr_builder_clear(b);
+    sstr_arena_destroy(b->arena);
+    free(b->shared);
+    free(b->iov);
+    free(b);
+}
 
-            if (sign) {
-                if (i64 < 0) {
-                    sstr_append_of(buf, "-", 1);
-                    ui64 = (uint64_t)-i64;
+void sstr_builder_clear(sstr_builder_t* b) {
+    size_t i;
 
-                } else {
-                    ui64 = (uint64_t)i64;
-                }
-            }
+    for (i = 0; i < b->shared_count; i++) {
+        sstr_free_buffer(&b->shared[i]);
+    }
+    b->shared_count = 0;
+    b->start = 0;
+    b->count = 0;
+    b->length = 0;
+    sstr_arena_reset(b->arena);
+}
 
-            ptmp = sstr_sprintf_num(tmp, tmp + sizeof(tmp), ui64, zero, hex,
-                                    width);
-            sstr_append_of(buf, tmp, ptmp - tmp);
+size_t sstr_builder_length(sstr_builder_t* b) { return b->length; }
 
-            if (df_d && *fmt) {  // %xabc not %xd, move a to buf
-                sstr_append_of(buf, fmt++, 1);
-            } else if (*fmt) {
-                fmt++;
-            }
+// add a segment of the length > 0 bytes at data.
+static void sstr_builder_push(sstr_builder_t* b, const void* data,
+                              size_t length) {
+    if (b->count == b->capacity) {
+        b->capacity *= 2;
+        b->iov = (struct iovec*)realloc(b->iov,
+                                        b->capacity * sizeof(struct iovec));
+    }
+    b->iov[b->count].iov_base = (void*)data;
+    b->iov[b->count].iov_len = length;
+    b->count++;
+    b->length += length;
+}
 
-        } else {
-            ptmp = (unsigned char*)fmt;
-            while (*fmt && (*fmt) != '%') {
-                fmt++;
-            }
-            sstr_append_of(buf, ptmp, (unsigned char*)fmt - ptmp);
+void sstr_builder_append_of(sstr_builder_t* b, const void* data,
+                            size_t length) {
+    sstr_arena_t* arena = b->arena;
+    char* p;
+
+    if (length == 0) {
+        return;
+    }
+    // the last segment is the latest copy, extend it if its block has room
+    if (b->count > b->start && b->iov[b->count - 1].iov_base == arena->last) {
+        struct iovec* v = &b->iov[b->count - 1];
+        struct sstr_arena_block_s* blk = arena->cur;
+        size_t offset = arena->last - SSTR_ARENA_BLOCK_DATA(blk);
+        size_t size = SSTR_ARENA_ALIGN_UP(v->iov_len + length);
+        if (blk->size - offset >= size) {
+            memcpy(arena->last + v->iov_len, data, length);
+            blk->used = offset + size;
+            v->iov_len += length;
+            b->length += length;
+            return;
         }
     }
-
-    return buf;
+    p = (char*)sstr_arena_alloc(arena, length);
+    memcpy(p, data, length);
+    sstr_builder_push(b, p, length);
 }
 
-#define SSTR_INT32_LEN (sizeof("-2147483648") - 1)
-#define SSTR_INT64_LEN (sizeof("-9223372036854775808") - 1)
+void sstr_builder_append(sstr_builder_t* b, sstr_t s) {
+    STR* ss = SSTR(s);
+    size_t length = sstr_length(ss);
 
-#define SSTR_MAX_UINT32_VALUE (uint32_t)0xffffffff
-#define SSTR_MAX_INT32_VALUE (uint32_t)0x7fffffff
+    if (length < SSTR_BUILDER_SHARE_MIN || !STR_SHAREABLE(ss)) {
+        sstr_builder_append_of(b, STR_PTR(ss), length);
+        return;
+    }
+    if (b->shared_count == b->shared_capacity) {
+        b->shared_capacity = b->shared_capacity
+                                 ? b->shared_capacity * 2
+                                 : SSTR_BUILDER_MIN_SEGMENTS;
+        b->shared = (STR*)realloc(b->shared, b->shared_capacity * sizeof(STR));
+    }
+    sstr_share(ss, &b->shared[b->shared_count++]);
+    sstr_builder_push(b, ss->un.heap.data, length);
+}
 
-static unsigned char* sstr_sprintf_num(unsigned char* buf, unsigned char* last,
-                                       uint64_t ui64, unsigned char zero,
-                                       unsigned int hexadecimal,
-                                       unsigned width) {
-    unsigned char *p, temp[SSTR_INT64_LEN + 1];
-    size_t len;
-    uint32_t ui32;
-    static unsigned char hex[] = "0123456789abcdef";
-    static unsigned char HEX[] = "0123456789ABCDEF";
+void sstr_builder_append_ref(sstr_builder_t* b, const void* data,
+                             size_t length) {
+    if (length) {
+        sstr_builder_push(b, data, length);
+    }
+}
 
-    p = temp + SSTR_INT64_LEN;
+void sstr_builder_printf(sstr_builder_t* b, const char* fmt, ...) {
+    struct sstr_s tmp;
+    va_list args;
 
-    if (hexadecimal == 0) {
-        if (ui64 <= (uint64_t)SSTR_MAX_UINT32_VALUE) {
-            ui32 = (uint32_t)ui64;
+    sstr_init(&tmp);
+    va_start(args, fmt);
+    sstr_vslprintf_append(&tmp, fmt, args);
+    va_end(args);
+    // a long result is shared, not copied again
+    sstr_builder_append(b, &tmp);
+    sstr_deinit(&tmp);
+}
 
-            do {
-                *--p = (unsigned char)(ui32 % 10 + '0');
-            } while (ui32 /= 10);
+const struct iovec* sstr_builder_iovec(sstr_builder_t* b, size_t* count) {
+    *count = b->count - b->start;
+    return b->iov + b->start;
+}
 
-        } else {
-            do {
-                *--p = (unsigned char)(ui64 % 10 + '0');
-            } while (ui64 /= 10);
+void sstr_builder_consume(sstr_builder_t* b, size_t n) {
+    while (n && b->start < b->count) {
+        struct iovec* v = &b->iov[b->start];
+        if (n < v->iov_len) {
+            v->iov_base = (char*)v->iov_base + n;
+            v->iov_len -= n;
+            b->length -= n;
+            return;
         }
+        n -= v->iov_len;
+        b->length -= v->iov_len;
+        b->start++;
+    }
+}
 
-    } else if (hexadecimal == 1) {
-        do {
-            *--p = hex[(uint32_t)(ui64 & 0xf)];
-        } while (ui64 >>= 4);
+sstr_t sstr_builder_flatten(sstr_builder_t* b) {
+    sstr_t s = sstr_new();
 
-    } else { /* hexadecimal == 2 */
+    sstr_reserve(s, b->length);
+    sstr_builder_flatten_append(b, s);
+    return s;
+}
 
-        do {
-            *--p = HEX[(uint32_t)(ui64 & 0xf)];
-        } while (ui64 >>= 4);
+void sstr_builder_flatten_append(sstr_builder_t* b, sstr_t out) {
+    STR* ss = SSTR(out);
+    size_t old = sstr_length(ss), i;
+    char* p;
+
+    sstr_grow(ss, b->length);
+    p = STR_PTR(ss) + old;
+    for (i = b->start; i < b->count; i++) {
+        memcpy(p, b->iov[i].iov_base, b->iov[i].iov_len);
+        p += b->iov[i].iov_len;
     }
+    *p = '\0';
+    sstr_set_length(ss, old + b->length);
+}
 
-    /* zero or space padding */
+// adjacent chunks whose total is at most this are merged into one, so a run
+// of small edits does not leave a node per edit.
+#define SSTR_ROPE_MERGE_MAX 256
 
-    len = (temp + SSTR_INT64_LEN) - p;
+// Nodes are immutable once built and reference counted, an edit builds new
+// nodes along its path and shares the rest of the tree. Leaves have height 0,
+// the heights of the children of a node differ by at most one.
+struct sstr_rope_node_s {
+    atomic_size_t refs;
+    size_t length;  // bytes in the subtree
+    int height;
+    union {
+        struct {
+            struct sstr_rope_node_s* left;
+            struct sstr_rope_node_s* right;
+        } node;
+        struct {
+            // a SHORT string, or a SHARED one whose buffer other leaves may
+            // share. The leaf is length bytes at offset of it.
+            struct sstr_s str;
+            size_t offset;
+        } leaf;
+    } un;
+};
 
-    while (len++ < width && buf < last) {
-        *buf++ = zero;
-    }
+#define NODE struct sstr_rope_node_s
+#define ROPE_LEAF_PTR(n) (STR_PTR(&(n)->un.leaf.str) + (n)->un.leaf.offset)
 
-    /* number safe copy */
+struct sstr_rope_s {
+    NODE* root;  // NULL for an empty rope
+};
 
-    len = (temp + SSTR_INT64_LEN) - p;
+static NODE* sstr_rope_ref(NODE* n) {
+    if (n) {
+        atomic_fetch_add_explicit(&n->refs, 1, memory_order_relaxed);
+    }
+    return n;
+}
 
-    if (buf + len > last) {
-        len = last - buf;
+static void sstr_rope_unref(NODE* n) {
+    if (n == NULL ||
+        atomic_fetch_sub_explicit(&n->refs, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+    if (n->height == 0) {
+        sstr_free_buffer(&n->un.leaf.str);
+    } else {
+        sstr_rope_unref(n->un.node.left);
+        sstr_rope_unref(n->un.node.right);
     }
+    free(n);
+}
 
-    memcpy(buf, p, len);
-    buf += len;
-    return buf;
+static NODE* sstr_rope_node_alloc(size_t length, int height) {
+    NODE* n = (NODE*)malloc(sizeof(NODE));
+    atomic_init(&n->refs, 1);
+    n->length = length;
+    n->height = height;
+    return n;
 }
 
-const char* sstr_version() {
-    static const char* const version = "1.1.1";
-    return version;
+// a node of the balanced l and r, their references are taken over.
+static NODE* sstr_rope_node(NODE* l, NODE* r) {
+    NODE* n = sstr_rope_node_alloc(
+        l->length + r->length,
+        (l->height > r->height ? l->height : r->height) + 1);
+    assert(l->height - r->height <= 1 && r->height - l->height <= 1);
+    n->un.node.left = l;
+    n->un.node.right = r;
+    return n;
 }
 
-void sstr_append_int_str(sstr_t s, int i) {
-    unsigned char buf[SSTR_INT32_LEN + 1];
-    unsigned char* p = buf + SSTR_INT32_LEN;
-    uint32_t ui32;
-    int negative = 0;
+// a leaf of a copy of the alength bytes of a followed by the blength bytes
+// of b.
+static NODE* sstr_rope_leaf_copy(const char* a, size_t alength,
+                                 const char* b, size_t blength) {
+    NODE* n = sstr_rope_node_alloc(alength + blength, 0);
+    STR* ss = &n->un.leaf.str;
 
-    if (i < 0) {
-        negative = 1;
-        ui32 = (uint32_t)-i;
-    } else {
-        ui32 = (uint32_t)i;
+    sstr_init(ss);
+    sstr_reserve(ss, alength + blength);
+    sstr_append_of(ss, a, alength);
+    if (blength) {
+        sstr_append_of(ss, b, blength);
+    }
+    if (!STR_IS_SHORT(ss)) {
+        // other leaves may share the buffer later
+        sstr_set_type(ss, SSTR_TYPE_SHARED);
     }
+    n->un.leaf.offset = 0;
+    return n;
+}
 
-    do {
-        *--p = (unsigned char)(ui32 % 10 + '0');
-    } while (ui32 /= 10);
+// a leaf of the length bytes at offset of the content of ss. Long content
+// shares the buffer of ss.
+static NODE* sstr_rope_leaf_of(STR* ss, size_t offset, size_t length) {
+    NODE* n;
 
-    if (negative) {
-        sstr_append_of(s, "-", 1);
+    if (length == 0) {
+        return NULL;
     }
-    sstr_append_of(s, p, buf + SSTR_INT32_LEN - p);
+    if (length <= SHORT_STR_CAPACITY || !STR_SHAREABLE(ss)) {
+        return sstr_rope_leaf_copy(STR_PTR(ss) + offset, length, NULL, 0);
+    }
+    n = sstr_rope_node_alloc(length, 0);
+    sstr_share(ss, &n->un.leaf.str);
+    n->un.leaf.offset = offset;
+    return n;
 }
 
-int sstr_parse_long(sstr_t s, long* v) {
-    size_t i = 0;
-    int negative = 0;
-    *v = 0;
-    unsigned char* p = (unsigned char*)STR_PTR(s);
-    for (i = 0; i < sstr_length(s); ++i) {
-        if (isspace(p[i])) {
-            continue;
-        }
-        if (p[i] == '-') {
-            negative = 1;
+// take the children of the internal n out, its reference is taken over. A
+// tree owned by a single rope is edited without touching the reference
+// counts below the path.
+static void sstr_rope_open(NODE* n, NODE** l, NODE** r) {
+    *l = n->un.node.left;
+    *r = n->un.node.right;
+    if (atomic_load_explicit(&n->refs, memory_order_acquire) == 1) {
+        free(n);
+    } else {
+        sstr_rope_ref(*l);
+        sstr_rope_ref(*r);
+        sstr_rope_unref(n);
+    }
+}
+
+// a node of a and b, whose heights differ by at most 2, rotated back into
+// balance. The references are taken over.
+static NODE* sstr_rope_balance(NODE* a, NODE* b) {
+    NODE *x, *y, *z;
+
+    if (a->height > b->height + 1) {
+        sstr_rope_open(a, &x, &y);
+        if (x->height >= y->height) {
+            return sstr_rope_node(x, sstr_rope_node(y, b));
         }
+        sstr_rope_open(y, &y, &z);
+        return sstr_rope_node(sstr_rope_node(x, y), sstr_rope_node(z, b));
     }
-    for (; i < sstr_length(s); ++i) {
-        if (isdigit(p[i])) {
-            *v = *v * 10 + p[i] - '0';
+    if (b->height > a->height + 1) {
+        sstr_rope_open(b, &y, &z);
+        if (z->height >= y->height) {
+            return sstr_rope_node(sstr_rope_node(a, y), z);
         }
+        sstr_rope_open(y, &x, &y);
+        return sstr_rope_node(sstr_rope_node(a, x), sstr_rope_node(y, z));
     }
+    return sstr_rope_node(a, b);
+}
 
-    if (negative) {
-        *v = -*v;
-    }
+// the concatenation of l and r, their references are taken over. The
+// shorter tree is joined along the spine of the taller one, O(difference of
+// the heights).
+static NODE* sstr_rope_join(NODE* l, NODE* r) {
+    NODE *x, *y;
 
-    return i;
+    if (l == NULL) {
+        return r;
+    }
+    if (r == NULL) {
+        return l;
+    }
+    if (l->height == 0 && r->height == 0 &&
+        l->length + r->length <= SSTR_ROPE_MERGE_MAX) {
+        x = sstr_rope_leaf_copy(ROPE_LEAF_PTR(l), l->length,
+                                ROPE_LEAF_PTR(r), r->length);
+        sstr_rope_unref(l);
+        sstr_rope_unref(r);
+        return x;
+    }
+    if (l->height > r->height + 1) {
+        sstr_rope_open(l, &x, &y);
+        return sstr_rope_balance(x, sstr_rope_join(y, r));
+    }
+    if (r->height > l->height + 1) {
+        sstr_rope_open(r, &x, &y);
+        return sstr_rope_balance(sstr_rope_join(l, x), y);
+    }
+    return sstr_rope_node(l, r);
 }
 
-int sstr_parse_int(sstr_t* s, int* v) {
-    long vr;
-    int r = sstr_parse_long(s, &vr);
-    *v = (int)vr;
-    return r;
-}
+// split n into the first index bytes, stored in *l, and the rest, stored in
+// *r. The reference of n is taken over.
+static void sstr_rope_split(NODE* n, size_t index, NODE** l, NODE** r) {
+    NODE *x, *y, *t;
 
-void sstr_append_long_str(sstr_t s, long l) {
-    unsigned char buf[SSTR_INT64_LEN + 1];
-    unsigned char* p = buf + SSTR_INT64_LEN;
-    uint64_t ui64;
-    int negative = 0;
-    if (l < 0) {
-        negative = 1;
-        ui64 = (uint64_t)-l;
+    if (n == NULL || index == 0) {
+        *l = NULL;
+        *r = n;
+        return;
+    }
+    if (index >= n->length) {
+        *l = n;
+        *r = NULL;
+        return;
+    }
+    if (n->height == 0) {
+        STR* ss = &n->un.leaf.str;
+        *l = sstr_rope_leaf_of(ss, n->un.leaf.offset, index);
+        *r = sstr_rope_leaf_of(ss, n->un.leaf.offset + index,
+                               n->length - index);
+        sstr_rope_unref(n);
+        return;
+    }
+    sstr_rope_open(n, &x, &y);
+    if (index <= x->length) {
+        sstr_rope_split(x, index, l, &t);
+        *r = sstr_rope_join(t, y);
     } else {
-        ui64 = (uint64_t)l;
+        sstr_rope_split(y, index - x->length, &t, r);
+        *l = sstr_rope_join(x, t);
     }
+}
 
-    do {
-        *--p = (unsigned char)(ui64 % 10 + '0');
-    } while (ui64 /= 10);
-    if (negative) {
-        sstr_append_of(s, "-", 1);
+// the leaf holding byte *index of the non-empty n, *index is made relative
+// to the leaf.
+static NODE* sstr_rope_find(NODE* n, size_t* index) {
+    while (n->height) {
+        if (*index < n->un.node.left->length) {
+            n = n->un.node.left;
+        } else {
+            *index -= n->un.node.left->length;
+            n = n->un.node.right;
+        }
     }
-    sstr_append_of(s, p, buf + SSTR_INT64_LEN - p);
+    return n;
 }
 
-void sstr_append_float_str(sstr_t s, float f, int precission) {
-    sstr_append_double_str(s, (double)f, precission);
+static sstr_rope_t* sstr_rope_with(NODE* root) {
+    sstr_rope_t* r = (sstr_rope_t*)malloc(sizeof(sstr_rope_t));
+    r->root = root;
+    return r;
 }
 
-// #define MAX_DOUBLE_LEN (sizeof("-1.7976931348623157E+308") - 1)
-void sstr_append_double_str(sstr_t s, double f, int precision) {
-    unsigned char buf[SSTR_INT64_LEN + 1];
-    unsigned char* p = buf + SSTR_INT64_LEN;
-    uint64_t ui64;
-    int negative = 0;
-    double f2;  // fractional part
+sstr_rope_t* sstr_rope_new() { return sstr_rope_with(NULL); }
 
-    // int part
-    if (f < 0) {
-        negative = 1;
-        ui64 = (uint64_t)-f;
-        f2 = -f - ui64;
-    } else {
-        ui64 = (uint64_t)f;
-        f2 = f - ui64;
+sstr_rope_t* sstr_rope_of(const void* data, size_t length) {
+    return sstr_rope_with(
+        length ? sstr_rope_leaf_copy((const char*)data, length, NULL, 0)
+               : NULL);
+}
+
+sstr_rope_t* sstr_rope_from(sstr_t s) {
+    return sstr_rope_with(sstr_rope_leaf_of(SSTR(s), 0, sstr_length(s)));
+}
+
+sstr_rope_t* sstr_rope_dup(sstr_rope_t* r) {
+    return sstr_rope_with(sstr_rope_ref(r->root));
+}
+
+void sstr_rope_free(sstr_rope_t* r) {
+    if (r == NULL) {
+        return;
     }
+    sstr_rope_unref(r->root);
+    free(r);
+}
 
-    do {
-        *--p = (unsigned char)(ui64 % 10 + '0');
-    } while (ui64 /= 10);
-    if (negative) {
-        sstr_append_of(s, "-", 1);
+size_t sstr_rope_length(sstr_rope_t* r) {
+    return r->root ? r->root->length : 0;
+}
+
+int sstr_rope_at(sstr_rope_t* r, size_t index) {
+    NODE* n;
+
+    if (index >= sstr_rope_length(r)) {
+        return -1;
     }
-    sstr_append_of(s, p, buf + SSTR_INT64_LEN - p);
+    n = sstr_rope_find(r->root, &index);
+    return (unsigned char)ROPE_LEAF_PTR(n)[index];
+}
 
-    // float part
-    if (f2 > 0 && f2 > 1e-6) {
-        sstr_append_of(s, ".", 1);
-        p = buf;
-        do {
-            f2 *= 10;
-            *p++ = (unsigned char)(f2 + '0');
-            f2 -= (long)f2;
-        } while (f2 > 1e-6 && f2 > 0.0 && p < buf + precision);
+const char* sstr_rope_chunk(sstr_rope_t* r, size_t index, size_t* length) {
+    NODE* n;
 
-        sstr_append_of(s, buf, p - buf);
+    if (index >= sstr_rope_length(r)) {
+        *length = 0;
+        return NULL;
     }
+    n = sstr_rope_find(r->root, &index);
+    *length = n->length - index;
+    return ROPE_LEAF_PTR(n) + index;
 }
 
-int sstr_parse_double(sstr_t s, double* v) {
-    size_t i = 0;
-    int negative = 0;
-    *v = 0;
-    unsigned char* p = (unsigned char*)STR_PTR(s);
-    for (i = 0; i < sstr_length(s); ++i) {
-        if (isspace(p[i])) {
-            continue;
+// n with the subtree m inserted at index, the references are taken over.
+// Only the path down to index is rebuilt, an insert into a small leaf makes
+// a single leaf of both.
+static NODE* sstr_rope_insert_node(NODE* n, size_t index, NODE* m) {
+    char tmp[SSTR_ROPE_MERGE_MAX];
+    NODE *x, *y;
+
+    if (n == NULL || m == NULL) {
+        return n ? n : m;
+    }
+    if (n->height == 0) {
+        if (index > n->length) {
+            index = n->length;
         }
-        if (p[i] == '-') {
-            negative = 1;
+        if (m->height == 0 && n->length + m->length <= SSTR_ROPE_MERGE_MAX) {
+            memcpy(tmp, ROPE_LEAF_PTR(n), index);
+            memcpy(tmp + index, ROPE_LEAF_PTR(m), m->length);
+            memcpy(tmp + index + m->length, ROPE_LEAF_PTR(n) + index,
+                   n->length - index);
+            x = sstr_rope_leaf_copy(tmp, n->length + m->length, NULL, 0);
+            sstr_rope_unref(n);
+            sstr_rope_unref(m);
+            return x;
         }
+        sstr_rope_split(n, index, &x, &y);
+        return sstr_rope_join(sstr_rope_join(x, m), y);
     }
-    for (; i < sstr_length(s); ++i) {
-        if (isdigit(p[i])) {
-            *v = *v * 10 + p[i] - '0';
-        }
+    sstr_rope_open(n, &x, &y);
+    if (index <= x->length) {
+        return sstr_rope_join(sstr_rope_insert_node(x, index, m), y);
     }
-    if (p[i] == '.') i++;
+    return sstr_rope_join(x, sstr_rope_insert_node(y, index - x->length, m));
+}
+
+// n without its length bytes at index, which are inside n. The reference of
+// n is taken over.
+static NODE* sstr_rope_erase_node(NODE* n, size_t index, size_t length) {
+    char tmp[SSTR_ROPE_MERGE_MAX];
+    NODE *x, *y, *t;
+    size_t rest = n->length - index - length;
 
-    double v2 = 0, d2 = 10;
-    for (; i < sstr_length(s); ++i) {
-        if (isdigit(p[i])) {
-            v2 += (p[i] - '0') / d2;
-            d2 *= 10;
+    if (n->height == 0) {
+        STR* ss = &n->un.leaf.str;
+        if (index + rest <= SSTR_ROPE_MERGE_MAX) {
+            memcpy(tmp, ROPE_LEAF_PTR(n), index);
+            memcpy(tmp + index, ROPE_LEAF_PTR(n) + index + length, rest);
+            x = index + rest ? sstr_rope_leaf_copy(tmp, index + rest, NULL, 0)
+                             : NULL;
+        } else {
+            x = sstr_rope_join(
+                sstr_rope_leaf_of(ss, n->un.leaf.offset, index),
+                sstr_rope_leaf_of(ss, n->un.leaf.offset + index + length,
+                                  rest));
         }
+        sstr_rope_unref(n);
+        return x;
+    }
+    sstr_rope_open(n, &x, &y);
+    if (index + length <= x->length) {
+        return sstr_rope_join(sstr_rope_erase_node(x, index, length), y);
     }
-    *v += v2;
+    if (index >= x->length) {
+        return sstr_rope_join(
+            x, sstr_rope_erase_node(y, index - x->length, length));
+    }
+    // the range spans both children
+    length -= x->length - index;
+    sstr_rope_split(x, index, &x, &t);
+    sstr_rope_unref(t);
+    sstr_rope_split(y, length, &t, &y);
+    sstr_rope_unref(t);
+    return sstr_rope_join(x, y);
+}
 
-    if (negative) {
-        *v = -*v;
+// insert the subtree n at index of r, its reference is taken over.
+static void sstr_rope_splice(sstr_rope_t* r, size_t index, NODE* n) {
+    r->root = sstr_rope_insert_node(r->root, index, n);
+}
+
+void sstr_rope_insert_of(sstr_rope_t* r, size_t index, const void* data,
+                         size_t length) {
+    if (length) {
+        sstr_rope_splice(
+            r, index, sstr_rope_leaf_copy((const char*)data, length, NULL, 0));
     }
+}
 
-    return i;
+void sstr_rope_insert(sstr_rope_t* r, size_t index, sstr_t s) {
+    sstr_rope_splice(r, index, sstr_rope_leaf_of(SSTR(s), 0, sstr_length(s)));
 }
 
-int sstr_json_escape_string_append(sstr_t out, sstr_t in) {
-    if (in == NULL) {
-        return 0;
+void sstr_rope_insert_rope(sstr_rope_t* r, size_t index, sstr_rope_t* other) {
+    sstr_rope_splice(r, index, sstr_rope_ref(other->root));
+}
+
+void sstr_rope_append_of(sstr_rope_t* r, const void* data, size_t length) {
+    sstr_rope_insert_of(r, sstr_rope_length(r), data, length);
+}
+
+void sstr_rope_erase(sstr_rope_t* r, size_t index, size_t length) {
+    size_t total = sstr_rope_length(r);
+
+    if (index >= total || length == 0) {
+        return;
     }
-    size_t i = 0;
-    unsigned char* data = (unsigned char*)sstr_cstr(in);
-    size_t in_len = sstr_length(in);
-    for (i = 0; i < in_len; ++i) {
-        if (data[i] <= 31 || data[i] == '\"' || data[i] == '\\') {
-            // character needs to be escaped
-            sstr_append_of(out, "\\", 1);
-            switch (data[i]) {
-                case '\\':
-                    sstr_append_of(out, "\\", 1);
-                    break;
-                case '\"':
-                    sstr_append_of(out, "\"", 1);
-                    break;
-                case '\b':
-                    sstr_append_of(out, "b", 1);
-                    break;
-                case '\f':
-                    sstr_append_of(out, "f", 1);
-                    break;
-                case '\n':
-                    sstr_append_of(out, "n", 1);
-                    break;
-                case '\r':
-                    sstr_append_of(out, "r", 1);
-                    break;
-                case '\t':
-                    sstr_append_of(out, "t", 1);
-                    break;
-                default: {
-                    // escape and print as unicode codepoint
-                    char tmp[7] = {0};
-                    sprintf(tmp, "u%04x", *(data + i));
-                    sstr_append_cstr(out, tmp);
-                }
-            }
-        } else {
-            size_t j;
-            for (j = i + 1; j < in_len; ++j) {
-                if (data[j] <= 31 || data[j] == '\"' || data[j] == '\\') {
-                    break;
-                }
-            }
-            sstr_append_of(out, data + i, j - i);
-            i += j - i - 1;
-        }
+    if (length > total - index) {
+        length = total - index;
     }
-    return 0;
+    r->root = sstr_rope_erase_node(r->root, index, length);
 }
 
-void sstr_append_of_if(sstr_t s, const void* data, size_t length, int cond) {
-    if (cond) {
-        size_t oldlen = sstr_length(s);
-        sstr_append_zero(s, length);
-        memcpy(STR_PTR(s) + oldlen, data, length);
-        STR_PTR(s)[sstr_length(s)] = '\0';
+sstr_rope_t* sstr_rope_substr(sstr_rope_t* r, size_t index, size_t length) {
+    NODE *a, *b, *mid;
+
+    sstr_rope_split(sstr_rope_ref(r->root), index, &a, &b);
+    sstr_rope_unref(a);
+    sstr_rope_split(b, length, &mid, &b);
+    sstr_rope_unref(b);
+    return sstr_rope_with(mid);
+}
+
+// copy the content of n to p, return the end.
+static char* sstr_rope_copy(NODE* n, char* p) {
+    while (n->height) {
+        p = sstr_rope_copy(n->un.node.left, p);
+        n = n->un.node.right;
     }
+    memcpy(p, ROPE_LEAF_PTR(n), n->length);
+    return p + n->length;
 }
 
-void sstr_append_indent(sstr_t s, size_t indent) {
-    if (indent == 0) {
-        return;
+sstr_t sstr_rope_flatten(sstr_rope_t* r) {
+    NODE* n = r->root;
+    STR* ss;
+
+    if (n == NULL) {
+        return sstr_new();
     }
-    size_t cur_len = sstr_length(s);
-    sstr_append_zero(s, indent);
-    for (size_t i = 0; i < indent; i++) {
-        STR_PTR(s)[cur_len + i] = ' ';
+    if (n->height == 0 && n->un.leaf.offset == 0 &&
+        n->length == sstr_length(&n->un.leaf.str) &&
+        STR_SHAREABLE(&n->un.leaf.str)) {
+        return sstr_dup(&n->un.leaf.str);
     }
+    ss = (STR*)sstr_new();
+    sstr_reserve(ss, n->length);
+    *sstr_rope_copy(n, STR_PTR(ss)) = '\0';
+    sstr_set_length(ss, n->length);
+    return ss;
 }
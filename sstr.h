@@ -37,41 +37,127 @@
 
 #include <stdarg.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define SHORT_STR_CAPACITY 25
+// content up to SHORT_STR_CAPACITY bytes is stored inside struct sstr_s.
+#if SIZE_MAX > 0xffffffffu
+#define SHORT_STR_CAPACITY 31
+#else
+#define SHORT_STR_CAPACITY 15
+#endif
+// the same for strings with an allocator of their own, which takes a word.
+#define SSTR_SHORT_ALLOC_CAPACITY (SHORT_STR_CAPACITY - sizeof(void*) - 1)
 #define CAP_ADD_DELTA 256
+#define SSTR_ARENA_BLOCK_SIZE 8192
 
+/*
+ * The header is four words, its last byte tells the layouts apart:
+ *
+ * - below 0x20: a SHORT string of the default allocator, the byte is
+ *   SHORT_STR_CAPACITY minus the length. It doubles as the null-terminal of
+ *   a full string.
+ * - 0x20 to 0x3f: a SHORT string with an allocator, the low 5 bits are
+ *   SSTR_SHORT_ALLOC_CAPACITY minus the length.
+ * - above: the type in the two high bits, the length in the rest of
+ *   un.heap.tag, see SSTR_TAG().
+ *
+ * Strings with a growth policy of their own never store their content in
+ * the header.
+ */
 struct sstr_s {
-    size_t length;  // MUST FIRST, see sstr_length at sstr.h
-    char type;
     union {
-        // short string store datas in short_str
         char short_str[SHORT_STR_CAPACITY + 1];
-        // long string allocate a buffer and store datas in long_str
         struct {
-            size_t capacity;
-            char* data;
-        } long_str;
-        // reference to a memory buffer
+            const struct sstr_allocator_s* allocator;
+            char str[SHORT_STR_CAPACITY + 1 - sizeof(void*)];
+        } short_alloc;
         struct {
+            // allocator of the header and buffer, NULL for malloc/realloc/free.
+            const struct sstr_allocator_s* allocator;
+            // growth policy of this string, NULL to use the process default.
+            const struct sstr_growth_s* growth;
+            // long buffer of LONG and SHARED strings, memory of REF ones.
             char* data;
-        } ref_str;
+            // length and type, the type is in the last byte of the header.
+            size_t tag;
+        } heap;
     } un;
 };
 
 #define SSTR_TYPE_SHORT 0
 #define SSTR_TYPE_LONG 1
 #define SSTR_TYPE_REF 2
+// a long buffer shared copy-on-write by sstr_dup() copies
+#define SSTR_TYPE_SHARED 3
+
+// type of the sstr_t s, one of SSTR_TYPE_*.
+#define SSTR_TYPE_OF(s) \
+    (((const unsigned char*)(s))[SHORT_STR_CAPACITY] >> 6)
+
+// un.heap.tag of a string of type type and length length, the length is
+// limited to SIZE_MAX >> 8.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define SSTR_TAG(length, type) \
+    (((size_t)(length) << 8) | ((size_t)(type) << 6))
+#define SSTR_TAG_LENGTH(tag) ((tag) >> 8)
+#else
+#define SSTR_TAG(length, type) \
+    ((size_t)(length) | ((size_t)(type) << (sizeof(size_t) * 8 - 2)))
+#define SSTR_TAG_LENGTH(tag) ((tag) & (SIZE_MAX >> 8))
+#endif
+
+// see sstr_length().
+static inline size_t sstr_length_of_header(const struct sstr_s* s) {
+    unsigned char last = ((const unsigned char*)s)[SHORT_STR_CAPACITY];
+    if (last < 0x20) {
+        return SHORT_STR_CAPACITY - last;
+    }
+    return last < 0x40 ? SSTR_SHORT_ALLOC_CAPACITY - (last & 0x1f)
+                       : SSTR_TAG_LENGTH(s->un.heap.tag);
+}
 
 /**
  * @brief sstr_t are objects that represent sequences of characters.
  */
 typedef void* sstr_t;
 
+/**
+ * @brief Capacity growth policy of long strings.
+ * @details When an append does not fit into the capacity of a string, the new
+ * capacity is computed as `capacity * factor`. The step (new capacity minus
+ * old capacity) is then clamped to [\a min_step, \a max_step], and the result
+ * is never less than the required length. A geometric \a factor greater than
+ * 1 makes appends amortized O(1).
+ */
+typedef struct sstr_growth_s {
+    double factor;    ///< geometric growth factor, 1 for linear growth.
+    size_t min_step;  ///< minimum bytes to grow by.
+    size_t max_step;  ///< maximum bytes to grow by, 0 for no upper clamp.
+} sstr_growth_t;
+
+/**
+ * @brief Memory allocator hooks used for the sstr_t headers and buffers.
+ * @details Every allocation of a sstr_t goes through the allocator it was
+ * created with. \a ctx is passed back to each hook, so one set of hooks can
+ * serve several arenas or pools. The hooks receive the size of the block on
+ * realloc and free, so sized allocators (slabs, arenas) need no bookkeeping of
+ * their own.
+ */
+typedef struct sstr_allocator_s {
+    /// allocate \a size bytes.
+    void* (*alloc)(void* ctx, size_t size);
+    /// resize \a ptr of \a old_size bytes to \a new_size, \a ptr may be NULL.
+    void* (*realloc)(void* ctx, void* ptr, size_t old_size, size_t new_size);
+    /// release \a ptr of \a size bytes.
+    void (*free)(void* ctx, void* ptr, size_t size);
+    /// opaque context passed to the hooks.
+    void* ctx;
+} sstr_allocator_t;
+
 /**
  * @brief Create an empty sstr_t.
  *
@@ -79,6 +165,547 @@ typedef void* sstr_t;
  */
 sstr_t sstr_new();
 
+/**
+ * @brief Create an empty sstr_t that allocates through \a allocator.
+ * @details The header and every buffer of the result are allocated by
+ * \a allocator, strings derived from it by sstr_dup() and sstr_substr() use
+ * the same allocator.
+ *
+ * @param allocator allocator to use, NULL for malloc/realloc/free. It is not
+ * copied and must outlive the result.
+ * @return sstr_t
+ */
+sstr_t sstr_new_alloc(const sstr_allocator_t* allocator);
+
+/**
+ * @brief Set the process-wide default allocator.
+ * @details sstr_new(), sstr_of() and every other function that creates a
+ * sstr_t without an explicit allocator use the default one. Set it before
+ * creating any string, strings are always freed by the allocator they were
+ * created with.
+ *
+ * @param allocator the new default, NULL to restore malloc/realloc/free.
+ */
+void sstr_set_default_allocator(const sstr_allocator_t* allocator);
+
+/**
+ * @brief Return the process-wide default allocator.
+ *
+ * @return const sstr_allocator_t* current default, NULL if malloc is used.
+ */
+const sstr_allocator_t* sstr_default_allocator();
+
+/**
+ * @brief Bump allocator for request-scoped strings.
+ * @details An arena carves headers and buffers out of large blocks. Strings
+ * created in an arena need no sstr_free(), sstr_arena_reset() releases all
+ * of them at once and keeps the blocks for reuse. Growing the most recently
+ * allocated buffer extends it in place.
+ * @note An arena is not thread safe.
+ */
+typedef struct sstr_arena_s sstr_arena_t;
+
+/**
+ * @brief Create an arena.
+ *
+ * @param block_size size of the blocks the arena allocates from, 0 for the
+ * default of SSTR_ARENA_BLOCK_SIZE bytes. Larger allocations get a block of
+ * their own.
+ * @return sstr_arena_t* the new arena.
+ */
+sstr_arena_t* sstr_arena_create(size_t block_size);
+
+/**
+ * @brief Release every string allocated from \a arena, the blocks are kept
+ * for reuse.
+ *
+ * @param arena arena to reset.
+ */
+void sstr_arena_reset(sstr_arena_t* arena);
+
+/**
+ * @brief Destroy \a arena and every string allocated from it.
+ *
+ * @param arena arena to destroy.
+ */
+void sstr_arena_destroy(sstr_arena_t* arena);
+
+/**
+ * @brief Return the allocator of \a arena, to use with sstr_new_alloc() and
+ * sstr_of_alloc().
+ *
+ * @param arena the arena.
+ * @return const sstr_allocator_t* allocator that allocates from \a arena.
+ */
+const sstr_allocator_t* sstr_arena_allocator(sstr_arena_t* arena);
+
+/**
+ * @brief Create an empty sstr_t in \a arena.
+ *
+ * @param arena arena to allocate from.
+ * @return sstr_t
+ */
+sstr_t sstr_arena_new(sstr_arena_t* arena);
+
+/**
+ * @brief Same as sstr_of(), but allocate from \a arena.
+ *
+ * @param arena arena to allocate from.
+ * @param data data to copy to the result sstr_t.
+ * @param length length of \a data.
+ * @return sstr_t containing data copied from \a data.
+ */
+sstr_t sstr_arena_of(sstr_arena_t* arena, const void* data, size_t length);
+
+/**
+ * @brief Same as sstr_printf(), but allocate from \a arena.
+ *
+ * @param arena arena to allocate from.
+ * @param fmt format string.
+ * @param ... arguments.
+ * @return sstr_t result string.
+ */
+sstr_t sstr_arena_printf(sstr_arena_t* arena, const char* fmt, ...);
+
+/**
+ * @brief Pool of canonical, immutable strings.
+ * @details sstr_intern_of() returns the same sstr_t for equal bytes, so two
+ * interned strings are equal if and only if they are the same pointer, no
+ * sstr_compare() needed. The pool owns every string it returns: they stay
+ * valid until sstr_intern_destroy() and must neither be modified nor freed,
+ * sstr_dup() one to get a private, mutable copy. Strings are packed into
+ * large blocks, a short one takes a single header.
+ *
+ * A pool can be shared by any number of threads. Looking up a string already
+ * interned takes no lock at all, only interning a new one locks, and just one
+ * of the shards the table is split into.
+ */
+typedef struct sstr_intern_s sstr_intern_t;
+
+/**
+ * @brief Memory statistics of an intern pool, see sstr_intern_stats().
+ */
+typedef struct sstr_intern_stats_s {
+    size_t count;   ///< number of interned strings.
+    size_t bytes;   ///< total length of the interned strings.
+    size_t memory;  ///< bytes held by the pool: blocks, tables and headers.
+} sstr_intern_stats_t;
+
+/**
+ * @brief Create an intern pool.
+ *
+ * @param shards number of shards, rounded up to a power of two (at most 256),
+ * 0 for the default of 16. More shards let more threads intern at once.
+ * @return sstr_intern_t* the new pool.
+ */
+sstr_intern_t* sstr_intern_create(size_t shards);
+
+/**
+ * @brief Destroy \a pool and every string interned in it.
+ *
+ * @param pool pool to destroy.
+ */
+void sstr_intern_destroy(sstr_intern_t* pool);
+
+/**
+ * @brief Return the canonical string of the \a length bytes of \a data,
+ * interning a copy of them on first sight.
+ *
+ * @param pool the pool.
+ * @param data bytes to intern.
+ * @param length length of \a data.
+ * @return sstr_t the string owned by \a pool, equal bytes always give the
+ * same pointer.
+ */
+sstr_t sstr_intern_of(sstr_intern_t* pool, const void* data, size_t length);
+
+/**
+ * @brief Same as sstr_intern_of(), with the content of \a s.
+ */
+sstr_t sstr_intern(sstr_intern_t* pool, sstr_t s);
+
+/**
+ * @brief Look up the canonical string of the \a length bytes of \a data
+ * without interning them.
+ *
+ * @return sstr_t the string owned by \a pool, NULL if not interned.
+ */
+sstr_t sstr_intern_find(sstr_intern_t* pool, const void* data,
+                        size_t length);
+
+/**
+ * @brief Fill \a stats with the memory statistics of \a pool.
+ *
+ * @param pool the pool.
+ * @param stats where to store the statistics.
+ */
+void sstr_intern_stats(sstr_intern_t* pool, sstr_intern_stats_t* stats);
+
+/**
+ * @brief Hash map from sstr_t keys to void* values.
+ * @details An open addressing table in the style of Swiss tables: a byte of
+ * metadata per slot, compared 16 slots at a time, so most lookups touch one
+ * group of metadata and one slot. Every slot embeds its key as a struct
+ * sstr_s, keys up to SHORT_STR_CAPACITY bytes are stored right there and
+ * compared without chasing a pointer. The map keeps copies of its keys.
+ *
+ *     sstr_map_t* m = sstr_map_create(0);
+ *     *sstr_map_insert_of(m, "answer", 6) = &answer;
+ *     void** v = sstr_map_find_of(m, "answer", 6);
+ *     sstr_map_destroy(m);
+ *
+ * @note A map is not thread safe. The value pointers returned stay valid
+ * until the next insert or erase.
+ */
+typedef struct sstr_map_s sstr_map_t;
+
+/**
+ * @brief Create an empty map.
+ *
+ * @param capacity number of entries to make room for, 0 for a small map.
+ * @return sstr_map_t* the new map.
+ */
+sstr_map_t* sstr_map_create(size_t capacity);
+
+/**
+ * @brief Destroy \a map and its copies of the keys, values are not touched.
+ *
+ * @param map map to destroy.
+ */
+void sstr_map_destroy(sstr_map_t* map);
+
+/**
+ * @brief Return the number of entries of \a map.
+ */
+size_t sstr_map_size(sstr_map_t* map);
+
+/**
+ * @brief Find the value of the \a length bytes key at \a key.
+ *
+ * @param map the map.
+ * @param key bytes of the key.
+ * @param length length of \a key.
+ * @return void** where the value is stored, NULL if \a key is not in \a map.
+ */
+void** sstr_map_find_of(sstr_map_t* map, const void* key, size_t length);
+
+/**
+ * @brief Same as sstr_map_find_of(), with the content of \a key.
+ */
+void** sstr_map_find(sstr_map_t* map, sstr_t key);
+
+/**
+ * @brief Find the value of the \a length bytes key at \a key, adding the key
+ * with a NULL value if it is not in \a map.
+ *
+ * @param map the map.
+ * @param key bytes of the key, copied.
+ * @param length length of \a key.
+ * @return void** where the value is stored.
+ */
+void** sstr_map_insert_of(sstr_map_t* map, const void* key, size_t length);
+
+/**
+ * @brief Same as sstr_map_insert_of(), with the content of \a key.
+ */
+void** sstr_map_insert(sstr_map_t* map, sstr_t key);
+
+/**
+ * @brief Remove the \a length bytes key at \a key from \a map.
+ *
+ * @return int 1 if the key was removed, 0 if it was not in \a map.
+ */
+int sstr_map_erase_of(sstr_map_t* map, const void* key, size_t length);
+
+/**
+ * @brief Same as sstr_map_erase_of(), with the content of \a key.
+ */
+int sstr_map_erase(sstr_map_t* map, sstr_t key);
+
+/**
+ * @brief Iterate over the entries of \a map, in no particular order.
+ * @details Start with *\a iter set to 0:
+ *
+ *     size_t it = 0;
+ *     void* v;
+ *     sstr_t k;
+ *     while ((k = sstr_map_next(m, &it, &v)) != NULL) {
+ *         ...
+ *     }
+ *
+ * @param map the map, not modified during the iteration.
+ * @param iter position of the iteration.
+ * @param value where to store the value of the entry, may be NULL.
+ * @return sstr_t key of the next entry, owned by \a map and read only, NULL
+ * after the last one.
+ */
+sstr_t sstr_map_next(sstr_map_t* map, size_t* iter, void** value);
+
+struct iovec;
+
+/**
+ * @brief String assembled from segments, concatenated only on demand.
+ * @details A builder records what is appended instead of copying it into
+ * one buffer. Large strings are shared with sstr_dup() semantics, views of
+ * memory the caller keeps alive are kept by pointer, and small pieces are
+ * copied into blocks of the builder, consecutive ones side by side. The
+ * segments are handed to writev() as they are, a contiguous copy is only
+ * made by sstr_builder_flatten():
+ *
+ *     sstr_builder_t* b = sstr_builder_create();
+ *     sstr_builder_printf(b, "HTTP/1.1 200 OK\r\nContent-Length: %z\r\n\r\n",
+ *                         sstr_length(body));
+ *     sstr_builder_append(b, body);
+ *     while (sstr_builder_length(b)) {
+ *         size_t n;
+ *         const struct iovec* iov = sstr_builder_iovec(b, &n);
+ *         ssize_t w = writev(fd, iov, n < IOV_MAX ? n : IOV_MAX);
+ *         ...
+ *         sstr_builder_consume(b, w);
+ *     }
+ *     sstr_builder_destroy(b);
+ *
+ * @note A builder is not thread safe.
+ */
+typedef struct sstr_builder_s sstr_builder_t;
+
+/**
+ * @brief Create an empty builder.
+ *
+ * @return sstr_builder_t* the new builder.
+ */
+sstr_builder_t* sstr_builder_create();
+
+/**
+ * @brief Destroy \a b, releasing the strings it shares.
+ *
+ * @param b builder to destroy, may be NULL.
+ */
+void sstr_builder_destroy(sstr_builder_t* b);
+
+/**
+ * @brief Remove every segment of \a b, its memory is kept for reuse.
+ */
+void sstr_builder_clear(sstr_builder_t* b);
+
+/**
+ * @brief Return the total length of the segments of \a b.
+ */
+size_t sstr_builder_length(sstr_builder_t* b);
+
+/**
+ * @brief Append a copy of the \a length bytes of \a data to \a b.
+ */
+void sstr_builder_append_of(sstr_builder_t* b, const void* data,
+                            size_t length);
+
+/**
+ * @brief Append the content of \a s to \a b.
+ * @details A long buffer is shared like sstr_dup() does, with no copy, \a s
+ * may be modified or freed afterwards. Short strings and references are
+ * copied.
+ */
+void sstr_builder_append(sstr_builder_t* b, sstr_t s);
+
+/**
+ * @brief Append the \a length bytes of \a data to \a b by reference.
+ *
+ * @param b the builder.
+ * @param data bytes to append, not copied. They must stay unchanged until
+ * \a b is cleared or destroyed.
+ * @param length length of \a data.
+ */
+void sstr_builder_append_ref(sstr_builder_t* b, const void* data,
+                             size_t length);
+
+/**
+ * @brief Append to \a b like sstr_printf_append() does to a sstr_t.
+ */
+void sstr_builder_printf(sstr_builder_t* b, const char* fmt, ...);
+
+/**
+ * @brief Return the segments of \a b as an array for writev().
+ *
+ * @param b the builder.
+ * @param count where to store the number of entries.
+ * @return const struct iovec* the segments, owned by \a b. They stay valid
+ * until the next call that modifies \a b.
+ */
+const struct iovec* sstr_builder_iovec(sstr_builder_t* b, size_t* count);
+
+/**
+ * @brief Drop the first \a n bytes of \a b, the ones a writev() of
+ * sstr_builder_iovec() has written.
+ */
+void sstr_builder_consume(sstr_builder_t* b, size_t n);
+
+/**
+ * @brief Concatenate the segments of \a b into a new sstr_t.
+ * @details The result is allocated once with the exact length. \a b is not
+ * changed.
+ *
+ * @return sstr_t the new string.
+ */
+sstr_t sstr_builder_flatten(sstr_builder_t* b);
+
+/**
+ * @brief Same as sstr_builder_flatten(), but append to \a out.
+ */
+void sstr_builder_flatten_append(sstr_builder_t* b, sstr_t out);
+
+/**
+ * @brief Rope: a string kept as a balanced tree of chunks, for large content
+ * that is edited in place.
+ * @details Insert, erase, substring and index take O(log n), whatever the
+ * length. The chunks are sstr_t, short ones in the tree nodes and long ones
+ * sharing the buffers they come from: building a rope of a long sstr_t, or
+ * splitting a chunk, copies nothing. Small edits next to each other are
+ * merged into one chunk.
+ *
+ * Nodes are immutable and shared, so sstr_rope_dup() and sstr_rope_substr()
+ * are O(1) and O(log n) and leave the source as it is. A rope is not thread
+ * safe, but ropes sharing nodes may be used by different threads.
+ *
+ *     sstr_rope_t* r = sstr_rope_of(text, length);
+ *     sstr_rope_insert_of(r, 100, "hello", 5);
+ *     sstr_rope_erase(r, 0, 10);
+ *     sstr_t flat = sstr_rope_flatten(r);
+ *     sstr_rope_free(r);
+ *
+ * Indexes past the end stand for the end, like sstr_substr() does.
+ */
+typedef struct sstr_rope_s sstr_rope_t;
+
+/**
+ * @brief Create an empty rope.
+ */
+sstr_rope_t* sstr_rope_new();
+
+/**
+ * @brief Create a rope of a copy of the \a length bytes of \a data.
+ */
+sstr_rope_t* sstr_rope_of(const void* data, size_t length);
+
+/**
+ * @brief Create a rope of the content of \a s, a long buffer is shared like
+ * sstr_dup() does.
+ */
+sstr_rope_t* sstr_rope_from(sstr_t s);
+
+/**
+ * @brief Return a copy of \a r, in O(1).
+ */
+sstr_rope_t* sstr_rope_dup(sstr_rope_t* r);
+
+/**
+ * @brief Free \a r, which may be NULL.
+ */
+void sstr_rope_free(sstr_rope_t* r);
+
+/**
+ * @brief Return the length of \a r.
+ */
+size_t sstr_rope_length(sstr_rope_t* r);
+
+/**
+ * @brief Return the byte at \a index of \a r as an unsigned char, -1 if
+ * \a index is past the end.
+ */
+int sstr_rope_at(sstr_rope_t* r, size_t index);
+
+/**
+ * @brief Return the contiguous bytes of \a r starting at \a index.
+ * @details Iterate over the content of a rope without flattening it:
+ *
+ *     size_t i, n;
+ *     for (i = 0; i < sstr_rope_length(r); i += n) {
+ *         const char* p = sstr_rope_chunk(r, i, &n);
+ *         fwrite(p, 1, n, f);
+ *     }
+ *
+ * @param r the rope.
+ * @param index position of the first byte.
+ * @param length where to store the number of bytes up to the end of the
+ * chunk, 0 if \a index is past the end.
+ * @return const char* the bytes, not null-terminated. They stay valid while
+ * \a r is not modified.
+ */
+const char* sstr_rope_chunk(sstr_rope_t* r, size_t index, size_t* length);
+
+/**
+ * @brief Insert a copy of the \a length bytes of \a data at \a index.
+ */
+void sstr_rope_insert_of(sstr_rope_t* r, size_t index, const void* data,
+                         size_t length);
+
+/**
+ * @brief Insert the content of \a s at \a index, a long buffer is shared
+ * like sstr_dup() does.
+ */
+void sstr_rope_insert(sstr_rope_t* r, size_t index, sstr_t s);
+
+/**
+ * @brief Insert the content of \a other at \a index, sharing its nodes.
+ */
+void sstr_rope_insert_rope(sstr_rope_t* r, size_t index, sstr_rope_t* other);
+
+/**
+ * @brief Same as sstr_rope_insert_of() at the end of \a r.
+ */
+void sstr_rope_append_of(sstr_rope_t* r, const void* data, size_t length);
+
+/**
+ * @brief Remove \a length bytes of \a r starting at \a index.
+ */
+void sstr_rope_erase(sstr_rope_t* r, size_t index, size_t length);
+
+/**
+ * @brief Return a new rope of the \a length bytes of \a r at \a index.
+ * @details The new rope shares the nodes of \a r, which is not modified.
+ */
+sstr_rope_t* sstr_rope_substr(sstr_rope_t* r, size_t index, size_t length);
+
+/**
+ * @brief Concatenate the chunks of \a r into a new sstr_t.
+ * @details A rope of a single long chunk shares its buffer, nothing is
+ * copied. Otherwise the result is allocated once with the exact length.
+ */
+sstr_t sstr_rope_flatten(sstr_rope_t* r);
+
+/**
+ * @brief Initialize caller-owned storage as an empty sstr_t.
+ * @details Use this to keep a sstr_t on the stack or embedded in another
+ * struct, the header is not allocated. Short contents live inside \a s, so
+ * building short strings makes no heap allocation at all:
+ *
+ *     struct sstr_s tmp;
+ *     sstr_init(&tmp);
+ *     sstr_printf_append(&tmp, "%d-%d", 1, 2);
+ *     puts(sstr_cstr(&tmp));
+ *     sstr_deinit(&tmp);
+ *
+ * @param s storage to initialize, pass it wherever a sstr_t is expected.
+ * @note Never sstr_free() an initialized storage, use sstr_deinit().
+ */
+void sstr_init(struct sstr_s* s);
+
+/**
+ * @brief Same as sstr_init(), but allocate buffers through \a allocator.
+ *
+ * @param s storage to initialize.
+ * @param allocator allocator to use, see sstr_new_alloc().
+ */
+void sstr_init_alloc(struct sstr_s* s, const sstr_allocator_t* allocator);
+
+/**
+ * @brief Release the buffer of a storage initialized by sstr_init().
+ * @details The storage itself is not freed, it is left as an empty string
+ * and may be used again.
+ *
+ * @param s storage to release.
+ */
+void sstr_deinit(struct sstr_s* s);
+
 /**
  * @brief delete a sstr_t.
  *
@@ -97,6 +724,17 @@ void sstr_free(sstr_t s);
  */
 sstr_t sstr_of(const void* data, size_t length);
 
+/**
+ * @brief Same as sstr_of(), but allocate through \a allocator.
+ *
+ * @param allocator allocator to use, see sstr_new_alloc().
+ * @param data data to copy to the result sstr_t.
+ * @param length length of \a data.
+ * @return sstr_t containing data copied from \a data.
+ */
+sstr_t sstr_of_alloc(const sstr_allocator_t* allocator, const void* data,
+                     size_t length);
+
 /**
  * @brief Create a sstr_t from data with length bytes. The data is not
  * copied, but have a pointer to data.
@@ -110,6 +748,25 @@ sstr_t sstr_of(const void* data, size_t length);
  */
 sstr_t sstr_ref(const void* data, size_t length);
 
+/**
+ * @brief Initialize a caller-provided struct sstr_s as a reference to \a data
+ * with \a length bytes.
+ * @details Like sstr_ref(), without allocating the header. The view needs no
+ * cleanup, do not sstr_free() it.
+ *
+ *     struct sstr_s view;
+ *     if (sstr_compare(sstr_ref_init(&view, "GET", 3), method) == 0) {
+ *         ...
+ *     }
+ *
+ * @param s the struct sstr_s to initialize.
+ * @param data data referenced, it must outlive the view.
+ * @param length length of \a data.
+ * @return sstr_t \a s, as a sstr_t.
+ * @note The view is not null-terminated unless \a data is.
+ */
+sstr_t sstr_ref_init(struct sstr_s* s, const void* data, size_t length);
+
 /**
  * @brief Create a sstr_t from C-style (NULL-terminated) string \a str.
  * @details The \a cstr is copied to the new sstr_t, so you can free \a cstr
@@ -131,6 +788,8 @@ sstr_t sstr(const char* cstr);
  * @param s sstr_t instance to convert to C-style string.
  * @return char* C-style string representation of \a s.
  * @note The returned string is reused by \a s, do not free it yourself.
+ * @note Do not write through the pointer of a SSTR_TYPE_SHARED string, see
+ * sstr_dup(), the bytes are seen by every string sharing them.
  */
 char* sstr_cstr(sstr_t s);
 
@@ -147,7 +806,7 @@ char* sstr_cstr(sstr_t s);
  * @param s sstr_t instance to get length of.
  * @return size_t The number of bytes of \a s.
  */
-#define sstr_length(s) ((struct sstr_s*)s)->length
+#define sstr_length(s) sstr_length_of_header((const struct sstr_s*)(s))
 
 /**
  * @brief Compare \a a and \a b
@@ -175,6 +834,56 @@ int sstr_compare(sstr_t a, sstr_t b);
  */
 int sstr_compare_c(sstr_t a, const char* b);
 
+/**
+ * @brief Compare \a a and \a b like sstr_compare(), ignoring the case of
+ * ASCII letters.
+ * @details Both strings are compared as if their letters 'A' to 'Z' were
+ * lower case, bytes 0x80 and up compare as they are, whatever the locale.
+ * Nothing is allocated: 16 or 32 bytes are folded and compared at once with
+ * SSE2 or AVX2.
+ *
+ * @return int 0 if equal, <0 if \a a sorts first, >0 if \a b does.
+ */
+int sstr_compare_nocase(sstr_t a, sstr_t b);
+
+/**
+ * @brief Like sstr_compare_nocase(), with the c-style string \a b.
+ */
+int sstr_compare_nocase_c(sstr_t a, const char* b);
+
+/**
+ * @brief 64-bit hash of the \a length bytes of \a data.
+ * @details A fast, non-cryptographic hash of the wyhash family. Inputs up to
+ * 16 bytes take two multiplies and no loop, medium ones are mixed 48 bytes at
+ * a time over three independent lanes, long ones (over 1 KB) in 64-byte
+ * SIMD stripes. The SSE2, AVX2 and scalar builds give the same values.
+ *
+ * @param data bytes to hash.
+ * @param length length of \a data.
+ * @param seed seed of the hash, different seeds give unrelated hashes. Use a
+ * random secret seed for tables exposed to untrusted keys.
+ * @return uint64_t the hash.
+ */
+uint64_t sstr_hash_of(const void* data, size_t length, uint64_t seed);
+
+/**
+ * @brief Hash of the content of \a s with seed 0, same as
+ * `sstr_hash_of(sstr_cstr(s), sstr_length(s), 0)`.
+ * @details The hash of a heap allocated string is cached in its buffer, so
+ * hashing an unchanged string again costs a load. Appending to or clearing
+ * the string forgets it, and sstr_dup() copies share it.
+ *
+ * @param s sstr_t to hash.
+ * @return uint64_t the hash.
+ * @note The cache does not notice writes made through sstr_cstr().
+ */
+uint64_t sstr_hash(sstr_t s);
+
+/**
+ * @brief Same as sstr_hash_of() with the content of \a s, not cached.
+ */
+uint64_t sstr_hash_seed(sstr_t s, uint64_t seed);
+
 /**
  * @brief Extends the sstr_t by appending additional '\0' characters at the end
  * of its current value.
@@ -212,8 +921,42 @@ void sstr_append(sstr_t dst, sstr_t src);
  */
 void sstr_append_cstr(sstr_t dst, const char* src);
 
+/**
+ * @brief Insert the \a length bytes of \a data at \a index of \a s.
+ * @details The bytes after \a index are moved once, straight into a new
+ * buffer when \a s has to grow or shares its buffer.
+ *
+ * @param s sstr_t to insert into, not a SSTR_TYPE_REF one.
+ * @param index position to insert at, past the end means the end.
+ * @param data bytes to insert, they may be a part of \a s.
+ * @param length length of \a data.
+ */
+void sstr_insert_of(sstr_t s, size_t index, const void* data, size_t length);
+
+/**
+ * @brief Same as sstr_insert_of(), with the content of \a src.
+ */
+void sstr_insert(sstr_t s, size_t index, sstr_t src);
+
+/**
+ * @brief Remove \a length bytes of \a s starting at \a index.
+ *
+ * @param s sstr_t to erase from, not a SSTR_TYPE_REF one.
+ * @param index position of the first byte to remove.
+ * @param length number of bytes to remove, clamped to the end of \a s.
+ */
+void sstr_erase(sstr_t s, size_t index, size_t length);
+
 /**
  * @brief Duplicate \a s and return.
+ * @details The duplicate uses the same allocator as \a s. Long strings are
+ * not copied: \a s and the duplicate share the buffer (SSTR_TYPE_SHARED)
+ * through an atomic reference count, in O(1). The first call that modifies
+ * either of them, like sstr_append_of() or sstr_printf_append(), gives it a
+ * private copy first. sstr_clear() just lets go of the shared buffer. Strings
+ * sharing a buffer may be used and freed from different threads. sstr_dup()
+ * marks \a s as shared though, so like the calls that modify \a s it must not
+ * run concurrently with other calls on \a s.
  *
  * @param s sstr_t to duplicate.
  * @return sstr_t  duplicate of \a s.
@@ -222,6 +965,7 @@ sstr_t sstr_dup(sstr_t s);
 
 /**
  * @brief Get substring of \a s starting at \a index with \a length bytes.
+ * @details The substring uses the same allocator as \a s.
  *
  * @param s sstr_t instance to get substring of.
  * @param index index of the first byte of the substring.
@@ -231,13 +975,427 @@ sstr_t sstr_dup(sstr_t s);
  */
 sstr_t sstr_substr(sstr_t s, size_t index, size_t len);
 
+/**
+ * @brief Get a view of the substring of \a s starting at \a index with
+ * \a len bytes, the bytes are not copied.
+ * @details The range is clamped like sstr_substr(). The result is a
+ * SSTR_TYPE_REF sstr_t pointing into \a s, its header is allocated with the
+ * allocator of \a s, free it with sstr_free().
+ *
+ * @param s sstr_t instance to get substring of.
+ * @param index index of the first byte of the substring.
+ * @param len number of bytes of the substring.
+ * @return sstr_t view into \a s.
+ * @note The view is valid while \a s is neither freed nor modified, and it is
+ * not null-terminated unless the substring ends at the end of \a s.
+ */
+sstr_t sstr_substr_ref(sstr_t s, size_t index, size_t len);
+
+/**
+ * @brief Like sstr_substr_ref(), in the caller-provided \a view.
+ * @details Nothing is allocated, the view needs no cleanup, do not
+ * sstr_free() it. Slicing a buffer this way is O(1).
+ *
+ * @param view the struct sstr_s to initialize.
+ * @param s sstr_t instance to get substring of.
+ * @param index index of the first byte of the substring.
+ * @param len number of bytes of the substring.
+ * @return sstr_t \a view, as a sstr_t.
+ */
+sstr_t sstr_substr_ref_init(struct sstr_s* view, sstr_t s, size_t index,
+                            size_t len);
+
+/**
+ * @brief Returned by the search functions when nothing is found.
+ */
+#define SSTR_NPOS ((size_t)-1)
+
+/**
+ * @brief Find the first occurrence of \a needle in \a s at or after \a from.
+ * @details The search uses the length of both strings, embedded '\0' bytes
+ * match like any other byte. An empty needle is found at \a from if \a from
+ * is not beyond the end of \a s.
+ *
+ * @param s sstr_t to search in.
+ * @param needle sstr_t to search for.
+ * @param from index of \a s the search starts at.
+ * @return size_t index of the first match, SSTR_NPOS if not found.
+ */
+size_t sstr_find(sstr_t s, sstr_t needle, size_t from);
+
+/**
+ * @brief Like sstr_find(), the needle is \a length bytes of \a needle.
+ */
+size_t sstr_find_of(sstr_t s, const void* needle, size_t length,
+                    size_t from);
+
+/**
+ * @brief Find the last occurrence of \a needle in \a s starting at or before
+ * \a from.
+ *
+ * @param s sstr_t to search in.
+ * @param needle sstr_t to search for.
+ * @param from the last index of \a s a match may start at, SSTR_NPOS to
+ * search the whole string.
+ * @return size_t index of the last match, SSTR_NPOS if not found.
+ */
+size_t sstr_rfind(sstr_t s, sstr_t needle, size_t from);
+
+/**
+ * @brief Like sstr_rfind(), the needle is \a length bytes of \a needle.
+ */
+size_t sstr_rfind_of(sstr_t s, const void* needle, size_t length,
+                     size_t from);
+
+/**
+ * @brief Find the first byte \a c in \a s at or after \a from.
+ *
+ * @return size_t index of the byte, SSTR_NPOS if not found.
+ */
+size_t sstr_find_char(sstr_t s, int c, size_t from);
+
+/**
+ * @brief Find the last byte \a c in \a s at or before \a from.
+ *
+ * @return size_t index of the byte, SSTR_NPOS if not found.
+ */
+size_t sstr_rfind_char(sstr_t s, int c, size_t from);
+
+/**
+ * @brief Find the first byte of \a s at or after \a from that is one of the
+ * \a length bytes in \a set.
+ *
+ * @param s sstr_t to search in.
+ * @param set bytes to search for, '\0' may be one of them.
+ * @param length number of bytes in \a set.
+ * @param from index of \a s the search starts at.
+ * @return size_t index of the byte, SSTR_NPOS if not found.
+ */
+size_t sstr_find_any_of(sstr_t s, const void* set, size_t length,
+                        size_t from);
+
+/**
+ * @brief Replace every occurrence of \a needle in \a s with \a replacement.
+ * @details Occurrences are found from the left and do not overlap, like
+ * sstr_find() stepping past each one. A result that is not longer is
+ * written in place while they are found, unless the buffer is shared. A
+ * longer one is counted first and written into one new buffer of the exact
+ * length.
+ *
+ * @param s sstr_t to modify, not a SSTR_TYPE_REF one.
+ * @param needle bytes to replace, nothing is replaced if empty.
+ * @param needle_length length of \a needle.
+ * @param replacement bytes to put in place of each occurrence.
+ * @param replacement_length length of \a replacement.
+ * @return size_t number of occurrences replaced.
+ */
+size_t sstr_replace_all_of(sstr_t s, const void* needle, size_t needle_length,
+                           const void* replacement,
+                           size_t replacement_length);
+
+/**
+ * @brief Same as sstr_replace_all_of(), with the content of \a needle and
+ * \a replacement.
+ */
+size_t sstr_replace_all(sstr_t s, sstr_t needle, sstr_t replacement);
+
+/**
+ * @brief Like sstr_find(), ignoring the case of ASCII letters.
+ * @details Letters compare like sstr_compare_nocase() does, the haystack is
+ * folded on the fly in SIMD blocks and not copied.
+ */
+size_t sstr_find_nocase(sstr_t s, sstr_t needle, size_t from);
+
+/**
+ * @brief Like sstr_find_nocase(), the needle is \a length bytes of
+ * \a needle.
+ */
+size_t sstr_find_nocase_of(sstr_t s, const void* needle, size_t length,
+                           size_t from);
+
+/**
+ * @brief Convert the ASCII letters of \a s to lower case, in place.
+ * @details Only 'A' to 'Z' change, other bytes, UTF-8 sequences included,
+ * are kept, so the result does not depend on the locale. The conversion
+ * runs 16 or 32 bytes at a time with SSE2 or AVX2. A shared buffer is
+ * converted straight into a private copy.
+ *
+ * @param s sstr_t to convert, not a SSTR_TYPE_REF one.
+ */
+void sstr_tolower(sstr_t s);
+
+/**
+ * @brief Like sstr_tolower(), converting 'a' to 'z' to upper case.
+ */
+void sstr_toupper(sstr_t s);
+
+/**
+ * @brief A new string with the content of \a s in lower case, see
+ * sstr_tolower().
+ * @details The bytes are converted while they are copied, \a s may be of
+ * any type and is left unchanged. The copy uses the allocator of \a s.
+ */
+sstr_t sstr_tolower_copy(sstr_t s);
+
+/**
+ * @brief Like sstr_tolower_copy(), in upper case.
+ */
+sstr_t sstr_toupper_copy(sstr_t s);
+
+/**
+ * @brief Tell whether the \a length bytes of \a data are all ASCII, below
+ * 0x80.
+ * @details Checks 128 bytes per branch with AVX2 (64 with SSE2) and 8 bytes
+ * at a time otherwise.
+ *
+ * @return int 1 if they are, 0 if not.
+ */
+int sstr_is_ascii_of(const void* data, size_t length);
+
+/**
+ * @brief Like sstr_is_ascii_of(), with the content of \a s.
+ */
+int sstr_is_ascii(sstr_t s);
+
+/**
+ * @brief Tell whether the \a length bytes of \a data are valid UTF-8.
+ * @details Valid means well-formed per the Unicode standard: no overlong
+ * forms, no surrogates (U+D800 to U+DFFF), nothing above U+10FFFF and no
+ * sequence cut at the end. Builds with SSSE3 or AVX2 (see SSTR_NATIVE in
+ * the Makefile) check 16 or 32 bytes at a time with table lookups and no
+ * branch per byte, others skip ASCII 8 bytes at a time and decode the rest.
+ *
+ * @return int 1 if valid, 0 if not.
+ */
+int sstr_utf8_valid_of(const void* data, size_t length);
+
+/**
+ * @brief Like sstr_utf8_valid_of(), with the content of \a s.
+ */
+int sstr_utf8_valid(sstr_t s);
+
+/**
+ * @brief Number of codepoints in the \a length bytes of UTF-8 at \a data.
+ * @details The bytes that are not continuation bytes (10xxxxxx) are
+ * counted, 16 or 32 at a time with SSE2 or AVX2. The count of invalid
+ * UTF-8 is not meaningful.
+ */
+size_t sstr_utf8_count_of(const void* data, size_t length);
+
+/**
+ * @brief Like sstr_utf8_count_of(), with the content of \a s.
+ */
+size_t sstr_utf8_count(sstr_t s);
+
+/**
+ * @brief The codepoint boundary of \a s at or before \a index.
+ * @details Steps back over at most three continuation bytes, so the bytes
+ * before the result never end with a cut sequence when \a s is valid
+ * UTF-8.
+ *
+ * @return size_t the boundary, sstr_length(s) if \a index is beyond it.
+ */
+size_t sstr_utf8_boundary(sstr_t s, size_t index);
+
+/**
+ * @brief Truncate \a s to at most \a length bytes without cutting a
+ * codepoint, see sstr_utf8_boundary().
+ *
+ * @param s sstr_t to truncate, not a SSTR_TYPE_REF one.
+ * @param length the most bytes to keep.
+ * @return size_t the new length of \a s.
+ */
+size_t sstr_utf8_truncate(sstr_t s, size_t length);
+
+/**
+ * @brief Append \a in to \a out with every invalid UTF-8 sequence replaced
+ * by U+FFFD.
+ * @details Valid input is found so with sstr_utf8_valid() and appended as
+ * it is. Otherwise each maximal invalid subpart, as defined by the Unicode
+ * standard, becomes one U+FFFD. Use it before
+ * sstr_json_escape_string_append() to keep untrusted bytes out of JSON.
+ *
+ * @param out sstr_t to append to, must not be \a in.
+ * @param in string to append.
+ * @return size_t number of replacements.
+ */
+size_t sstr_utf8_sanitize_append(sstr_t out, sstr_t in);
+
+/**
+ * @brief Transcode the UTF-8 content of \a s to UTF-16 in host byte order.
+ * @details Units are written to \a out as long as they fit in \a capacity,
+ * the return value is the length of the whole result: call with a
+ * \a capacity of 0 to size \a out first. Runs of 16 ASCII bytes are
+ * widened at once with SSE2.
+ *
+ * @param s sstr_t holding UTF-8.
+ * @param out buffer of \a capacity units, may be NULL if \a capacity is 0.
+ * @param capacity units \a out can hold.
+ * @return size_t number of UTF-16 units of the result, SSTR_NPOS if \a s is
+ * not valid UTF-8.
+ */
+size_t sstr_utf8_to_utf16(sstr_t s, uint16_t* out, size_t capacity);
+
+/**
+ * @brief Append the \a length UTF-16 units of \a data, in host byte order,
+ * to \a s as UTF-8.
+ * @details Surrogate pairs are combined. Runs of 8 units below 0x80 are
+ * narrowed at once with SSE2.
+ *
+ * @param s sstr_t to append to, not a SSTR_TYPE_REF one.
+ * @return int 0, or -1 if \a data has an unpaired surrogate, \a s is left
+ * unchanged then.
+ */
+int sstr_append_utf16(sstr_t s, const uint16_t* data, size_t length);
+
+/**
+ * @brief Do not yield empty fields, see sstr_split_init().
+ */
+#define SSTR_SPLIT_SKIP_EMPTY 1
+/**
+ * @brief Every byte of the delimiter is a delimiter of its own, see
+ * sstr_split_init().
+ */
+#define SSTR_SPLIT_ANY_OF 2
+
+/**
+ * @brief Iterator over the fields of a sstr_t, see sstr_split_init().
+ * @details Lives on the stack of the caller, the members are private.
+ */
+typedef struct sstr_split_s {
+    const char* data;
+    size_t length;
+    size_t pos;
+    const char* delim;
+    size_t delim_length;
+    int flags;
+    unsigned char delim_set[32];
+    struct sstr_s field;
+} sstr_split_t;
+
+/**
+ * @brief Start splitting \a s into fields separated by \a delim.
+ * @details Fields are returned by sstr_split_next() as reference views into
+ * \a s, nothing is copied or allocated. Like split() of python, "a,,b" split
+ * by "," gives "a", "" and "b", and an empty \a s gives one empty field.
+ * With SSTR_SPLIT_SKIP_EMPTY the empty fields are skipped, which makes
+ * SSTR_SPLIT_SKIP_EMPTY | SSTR_SPLIT_ANY_OF behave like strtok().
+ *
+ *     sstr_split_t it;
+ *     sstr_t field;
+ *     sstr_split_init(&it, line, ",", 1, 0);
+ *     while ((field = sstr_split_next(&it)) != NULL) {
+ *         printf("%.*s\n", (int)sstr_length(field), sstr_cstr(field));
+ *     }
+ *
+ * @param it iterator to initialize.
+ * @param s sstr_t to split, it must not be modified or freed while \a it or
+ * its fields are in use.
+ * @param delim delimiter, a sequence of bytes, or a set of single-byte
+ * delimiters with SSTR_SPLIT_ANY_OF. An empty delimiter yields \a s as a
+ * single field.
+ * @param length length of \a delim.
+ * @param flags 0, or SSTR_SPLIT_SKIP_EMPTY and SSTR_SPLIT_ANY_OF or-ed.
+ * \a delim is kept by pointer and must outlive \a it.
+ */
+void sstr_split_init(sstr_split_t* it, sstr_t s, const void* delim,
+                     size_t length, int flags);
+
+/**
+ * @brief Return the next field of \a it, NULL after the last one.
+ * @details The field is a SSTR_TYPE_REF sstr_t that lives inside \a it and
+ * is overwritten by the next call. It is not null-terminated, use
+ * sstr_length() with sstr_cstr(), and do not sstr_free() it. sstr_dup() it to
+ * keep a copy.
+ *
+ * @param it iterator initialized by sstr_split_init().
+ * @return sstr_t the next field, NULL when there are no more fields.
+ */
+sstr_t sstr_split_next(sstr_split_t* it);
+
 /**
  * @brief clear the sstr_t. After this call, the sstr_t is empty.
+ * @details The buffer of a long string is freed, see
+ * sstr_clear_keep_capacity() to reuse it.
  *
  * @param s sstr_t instance to clear.
  */
 void sstr_clear(sstr_t s);
 
+/**
+ * @brief Same as sstr_clear(), but keep the buffer for the next appends.
+ * @details A scratch string cleared this way between uses stops allocating
+ * once its buffer is large enough. A buffer still shared with sstr_dup()
+ * copies is let go, as sstr_clear() does.
+ *
+ * @param s sstr_t instance to clear.
+ */
+void sstr_clear_keep_capacity(sstr_t s);
+
+/**
+ * @brief Return the number of bytes \a s can hold without allocating.
+ * @details SHORT_STR_CAPACITY for strings that fit in the header, or
+ * SSTR_SHORT_ALLOC_CAPACITY if they have an allocator of their own. The
+ * length of a reference made by sstr_ref().
+ *
+ * @param s sstr_t instance.
+ * @return size_t the capacity of \a s.
+ */
+size_t sstr_capacity(sstr_t s);
+
+/**
+ * @brief Make room for at least \a capacity bytes in \a s, the content is
+ * kept.
+ * @details Reserve the final size before a build of known size, the appends
+ * then never reallocate. The buffer grows to exactly \a capacity, the growth
+ * policy does not apply; a buffer shared with sstr_dup() copies is copied
+ * first, with room for at least \a capacity. A reference made by sstr_ref()
+ * is left alone.
+ *
+ * @param s sstr_t instance.
+ * @param capacity bytes to make room for, not counting the null-terminal.
+ */
+void sstr_reserve(sstr_t s, size_t capacity);
+
+/**
+ * @brief Give back the unused part of the buffer of \a s.
+ * @details Content that fits in the header moves back into it and the buffer
+ * is freed, a longer one is reallocated to its length. A buffer shared with
+ * sstr_dup() copies is only let go of if the content fits in the header.
+ *
+ * @param s sstr_t instance.
+ */
+void sstr_shrink_to_fit(sstr_t s);
+
+/**
+ * @brief Set the process-wide default growth policy.
+ * @details Strings without a policy of their own (see sstr_set_growth()) use
+ * the default one. The default policy grows by a factor of 1.5, at least
+ * CAP_ADD_DELTA bytes and without an upper clamp.
+ *
+ * @param growth the new default policy, NULL to restore the builtin one. The
+ * policy is not copied, it must outlive every string that uses it.
+ */
+void sstr_set_default_growth(const sstr_growth_t* growth);
+
+/**
+ * @brief Return the process-wide default growth policy.
+ *
+ * @return const sstr_growth_t* current default policy.
+ */
+const sstr_growth_t* sstr_default_growth();
+
+/**
+ * @brief Set the growth policy of \a s.
+ * @details The policy takes the room of short content in the header, such
+ * content moves to a buffer.
+ *
+ * @param s sstr_t instance to set policy of.
+ * @param growth policy to use, NULL to use the process default. The policy is
+ * not copied, it must outlive \a s.
+ */
+void sstr_set_growth(sstr_t s, const sstr_growth_t* growth);
+
 /**
  * @brief Printf implement.
  *
@@ -249,7 +1407,10 @@ void sstr_clear(sstr_t s);
  *   - %[0][width][u][x|X]l      long
  *   - %[0][width][u][x|X]D      int32_t/uint32_t
  *   - %[0][width][u][x|X]L      int64_t/uint64_t
- *   - %[0][width][.width]f      double, max valid number fits to %18.15f
+ *   - %[0][width][.width]f      double, rounded exactly like glibc. The
+ *                               width pads the integer part, without
+ *                               .width 6 digits are printed and trailing
+ *                               zeros removed.
  *   - %p                        void *
  *   - %[x|X]S                   sstr_t, if x, print as hexadecimal
  *   - %s                        null-terminated string
@@ -297,6 +1458,46 @@ sstr_t sstr_printf(const char* fmt, ...);
  */
 sstr_t sstr_printf_append(sstr_t buf, const char* fmt, ...);
 
+/**
+ * @brief Append \a ui64 formatted like a number directive of sstr_printf().
+ * @details This is the formatting step of sstr_printf() without the format
+ * parsing, for callers that parse the format ahead of time.
+ *
+ * @param s sstr_t to append to.
+ * @param ui64 absolute value of the number.
+ * @param negative prepend '-' if not 0.
+ * @param zero padding character, '0' or ' '.
+ * @param hex 0 for decimal, 1 for lower case and 2 for upper case hexadecimal.
+ * @param width minimal width of the digits, padded by \a zero.
+ */
+void sstr_append_num(sstr_t s, uint64_t ui64, int negative, char zero,
+                     unsigned int hex, unsigned int width);
+
+/**
+ * @brief Append \a f formatted like the %f directive of sstr_printf().
+ *
+ * @param s sstr_t to append to.
+ * @param f number to format.
+ * @param zero padding character of the integer part, '0' or ' '.
+ * @param width minimal width of the integer part.
+ * @param frac_width number of fractional digits.
+ * @param trim remove trailing zeros of the fraction, and the dot if nothing
+ * is left of it, if not 0.
+ */
+void sstr_append_fixed(sstr_t s, double f, char zero, unsigned int width,
+                       unsigned int frac_width, int trim);
+
+/**
+ * @brief Append \a data as hexadecimal, like the %xS directive of
+ * sstr_printf().
+ *
+ * @param s sstr_t to append to.
+ * @param data bytes to print.
+ * @param length length of \a data.
+ * @param upper use upper case digits if not 0.
+ */
+void sstr_append_hex(sstr_t s, const void* data, size_t length, int upper);
+
 /// convert sstr <-> int,long,float,double
 
 /**
@@ -309,6 +1510,8 @@ void sstr_append_int_str(sstr_t s, int i);
 /**
  * @brief convert sstr_t string to long
  *
+ * Same as sstr_parse_i64(), out of range values are clamped.
+ *
  * @param s
  * @param v
  * @return int size of the string that parsed.
@@ -317,11 +1520,13 @@ int sstr_parse_long(sstr_t s, long* v);
 /**
  * @brief convert sstr_t string to int
  *
+ * Same as sstr_parse_i32(), out of range values are clamped.
+ *
  * @param s
  * @param v
  * @return int size of the string that parsed.
  */
-int sstr_parse_int(sstr_t* s, int* v);
+int sstr_parse_int(sstr_t s, int* v);
 /**
  * @brief convert long to sstr_t
  *
@@ -340,20 +1545,123 @@ void sstr_append_float_str(sstr_t s, float f, int precission);
 /**
  * @brief convert double to sstr_t
  *
+ * \a f is rounded to \a precision fractional digits, then trailing zeros and
+ * a bare dot are removed: 2.50 is "2.5", 3.00 is "3". NaN and infinity are
+ * "nan", "inf" and "-inf".
+ *
  * @param s
  * @param f
- * @param precision
+ * @param precision number of fractional digits, or -1 for the shortest form,
+ * see sstr_append_double_shortest().
  */
 void sstr_append_double_str(sstr_t s, double f, int precision);
+/**
+ * @brief Append the shortest decimal form of \a f that reads back to \a f.
+ *
+ * Plain decimals are used for 1e-6 <= |f| < 1e21, an exponent otherwise:
+ * 0.1 is "0.1", 100.0 is "100", 1e21 is "1e+21", 1.5e-7 is "1.5e-7".
+ *
+ * @param s sstr_t to append to.
+ * @param f number to format.
+ */
+void sstr_append_double_shortest(sstr_t s, double f);
 /**
  * @brief parse sstr_t string to double
  *
+ * Same as sstr_parse_f64().
+ *
  * @param s
  * @param v
  * @return int size of the string that parsed.
  */
 int sstr_parse_double(sstr_t s, double* v);
 
+/// the number was parsed.
+#define SSTR_PARSE_OK 0
+/// no number at the start of the input, nothing was consumed.
+#define SSTR_PARSE_INVALID 1
+/// the number does not fit the type. The result is clamped to the nearest
+/// limit, for doubles it is +-inf or +-0.
+#define SSTR_PARSE_RANGE 2
+
+/**
+ * @brief Parse a signed 64-bit integer at the start of \a data.
+ *
+ * The parsers accept ASCII only and ignore the locale: leading whitespace,
+ * an optional '+' or '-' sign, then decimal digits. Parsing stops at the first
+ * byte that does not fit, it is not an error.
+ *
+ * @param data bytes to parse, need not be null-terminated.
+ * @param length length of \a data.
+ * @param v the result, 0 if nothing was parsed.
+ * @param consumed if not NULL, set to the number of bytes used: whitespace,
+ * sign and digits.
+ * @return SSTR_PARSE_OK, SSTR_PARSE_INVALID or SSTR_PARSE_RANGE.
+ */
+int sstr_parse_i64_of(const void* data, size_t length, int64_t* v,
+                      size_t* consumed);
+/**
+ * @brief Parse an unsigned 64-bit integer at the start of \a data, see
+ * sstr_parse_i64_of(). A '-' sign is only valid with 0.
+ */
+int sstr_parse_u64_of(const void* data, size_t length, uint64_t* v,
+                      size_t* consumed);
+/**
+ * @brief Parse a signed 32-bit integer at the start of \a data, see
+ * sstr_parse_i64_of().
+ */
+int sstr_parse_i32_of(const void* data, size_t length, int32_t* v,
+                      size_t* consumed);
+/**
+ * @brief Parse an unsigned 32-bit integer at the start of \a data, see
+ * sstr_parse_u64_of().
+ */
+int sstr_parse_u32_of(const void* data, size_t length, uint32_t* v,
+                      size_t* consumed);
+/**
+ * @brief Parse a double at the start of \a data, correctly rounded.
+ *
+ * Accepts leading whitespace, an optional sign, digits with an optional '.'
+ * and fraction, and an optional exponent: "12", "-1.5", ".5e-3", "1E+10".
+ * "inf", "infinity" and "nan" are recognized in any case. The result is the
+ * double nearest to the decimal value, ties to even, whatever the number of
+ * digits.
+ *
+ * @param data bytes to parse, need not be null-terminated.
+ * @param length length of \a data.
+ * @param v the result, 0 if nothing was parsed.
+ * @param consumed if not NULL, set to the number of bytes used.
+ * @return SSTR_PARSE_OK, SSTR_PARSE_INVALID, or SSTR_PARSE_RANGE if the value
+ * overflows to infinity or underflows to zero.
+ */
+int sstr_parse_f64_of(const void* data, size_t length, double* v,
+                      size_t* consumed);
+
+/**
+ * @brief Parse a signed 64-bit integer at the start of \a s, see
+ * sstr_parse_i64_of().
+ */
+int sstr_parse_i64(sstr_t s, int64_t* v, size_t* consumed);
+/**
+ * @brief Parse an unsigned 64-bit integer at the start of \a s, see
+ * sstr_parse_u64_of().
+ */
+int sstr_parse_u64(sstr_t s, uint64_t* v, size_t* consumed);
+/**
+ * @brief Parse a signed 32-bit integer at the start of \a s, see
+ * sstr_parse_i64_of().
+ */
+int sstr_parse_i32(sstr_t s, int32_t* v, size_t* consumed);
+/**
+ * @brief Parse an unsigned 32-bit integer at the start of \a s, see
+ * sstr_parse_u64_of().
+ */
+int sstr_parse_u32(sstr_t s, uint32_t* v, size_t* consumed);
+/**
+ * @brief Parse a double at the start of \a s, see sstr_parse_f64_of().
+ */
+int sstr_parse_f64(sstr_t s, double* v, size_t* consumed);
+
 /**
  * @brief Append if cond is true, otherwise do nothing.
  *
@@ -372,9 +1680,35 @@ void sstr_append_of_if(sstr_t s, const void* data, size_t length, int cond);
 #define sstr_append_cstr_if(dst, src, cond) \
     sstr_append_of_if(dst, src, strlen(src), cond)
 
-// escape string to json string format
+/**
+ * @brief Append \a in escaped as the content of a JSON string, without the
+ * quotes.
+ *
+ * '"', '\\' and control characters are escaped, as \\n, \\t... or
+ * \\u00XX. Other bytes, UTF-8 included, are copied as they are: pass
+ * untrusted input through sstr_utf8_sanitize_append() first.
+ *
+ * @param out sstr_t to append to, must not be \a in.
+ * @param in string to escape.
+ * @return 0.
+ */
 int sstr_json_escape_string_append(sstr_t out, sstr_t in);
 
+/**
+ * @brief Append the content of a JSON string with its escape sequences
+ * decoded, the reverse of sstr_json_escape_string_append().
+ *
+ * \\uXXXX is written as UTF-8, surrogate pairs are combined and lone
+ * surrogates become U+FFFD. Bytes that are not part of an escape sequence are
+ * copied as they are.
+ *
+ * @param out sstr_t to append to, must not be \a in.
+ * @param in content of a JSON string, without the quotes.
+ * @return 0, or -1 if \a in has an invalid escape sequence, \a out is left
+ * unchanged then.
+ */
+int sstr_json_unescape_string_append(sstr_t out, sstr_t in);
+
 /**
  * @brief append spaces at the end of the sstr_t.
  *
@@ -0,0 +1,424 @@
+/**
+ * @file sstr_format.hpp
+ * @brief Compile-time parsed sstr_printf() for C++17.
+ * @details sstr_printf() parses its format on every call and reads the
+ * arguments through a va_list. This header parses the same format dialect at
+ * compile time into a list of directives, checks the argument types against
+ * them, and formats with no runtime parsing and no va_list:
+ *
+ *     sstr_t s = sstr_fmt::format(SSTR_FMT("id=%05d name=%S t=%.3f"), 42,
+ *                                 name, 1.5);
+ *     sstr_fmt::format_append(s, SSTR_FMT("%N"));
+ *
+ * The output is byte-identical to sstr_printf() with the same format. A wrong
+ * argument count, or an argument that does not fit its directive (a long for
+ * %d, a char* for %S, ...), is a compile error.
+ */
+
+#ifndef SSTR_FORMAT_HPP_
+#define SSTR_FORMAT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "sstr.h"
+
+/**
+ * @brief Wrap a string literal format for sstr_fmt::format().
+ * @details The result is an empty object whose type carries the literal, so
+ * the format is available at compile time.
+ */
+#define SSTR_FMT(lit)                                           \
+    ([] {                                                       \
+        struct sstr_fmt_literal {                               \
+            static constexpr const char* data() { return lit; } \
+            static constexpr std::size_t size() {               \
+                return sizeof(lit) - 1;                         \
+            }                                                   \
+        };                                                      \
+        return sstr_fmt_literal{};                              \
+    }())
+
+namespace sstr_fmt {
+namespace detail {
+
+enum class kind : unsigned char {
+    literal,   // bytes of the format itself
+    byte,      // a fixed byte, %Z and %N
+    skip,      // %* arguments of a directive that prints no argument
+    sstr,      // %S
+    sstr_hex,  // %xS, %XS
+    cstr,      // %s, %*s
+    num_time,  // %T
+    num_size,  // %z
+    num_int,   // %d, or %u/%x/%X without a type
+    num_long,  // %l
+    num_i32,   // %D
+    num_i64,   // %L
+    num_ptr,   // %p
+    fixed,     // %f
+    chr,       // %c
+};
+
+struct directive {
+    kind k = kind::literal;
+    bool sign = true;
+    unsigned char hex = 0;
+    char zero = ' ';
+    char ch = '\0';
+    unsigned char stars = 0;  // %* arguments before the value
+    unsigned int width = 0;
+    unsigned int frac_width = 6;
+    bool trim = true;
+    std::size_t pos = 0;  // literal offset in the format
+    std::size_t len = 0;  // literal length
+    std::size_t arg = 0;  // index of the first argument
+};
+
+constexpr std::size_t arg_count(const directive& d) {
+    switch (d.k) {
+        case kind::literal:
+        case kind::byte:
+        case kind::skip:
+            return d.stars;
+        default:
+            return d.stars + 1;
+    }
+}
+
+// append d to out, literals adjacent in the format are merged. With
+// out == nullptr only count, without merging, which gives an upper bound.
+constexpr void put(directive* out, std::size_t& count, const directive& d) {
+    if (out == nullptr) {
+        count++;
+        return;
+    }
+    if (d.k == kind::literal && count > 0 &&
+        out[count - 1].k == kind::literal &&
+        out[count - 1].pos + out[count - 1].len == d.pos) {
+        out[count - 1].len += d.len;
+        return;
+    }
+    out[count++] = d;
+}
+
+constexpr directive literal(std::size_t pos, std::size_t len,
+                            std::size_t arg) {
+    directive d;
+    d.k = kind::literal;
+    d.pos = pos;
+    d.len = len;
+    d.arg = arg;
+    return d;
+}
+
+constexpr bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+// parse fmt the same way sstr_vslprintf_append() does, return the number of
+// directives stored to out.
+constexpr std::size_t parse(const char* fmt, std::size_t n, directive* out) {
+    std::size_t i = 0, count = 0, arg = 0;
+
+    while (i < n) {
+        if (fmt[i] != '%') {
+            std::size_t j = i;
+            while (j < n && fmt[j] != '%') {
+                j++;
+            }
+            put(out, count, literal(i, j - i, arg));
+            i = j;
+            continue;
+        }
+
+        directive d;
+        bool df_d = false;
+        bool print_char = false;  // the directive character prints itself
+
+        i++;
+        d.zero = (i < n && fmt[i] == '0') ? '0' : ' ';
+        while (i < n && is_digit(fmt[i])) {
+            d.width = d.width * 10 + (fmt[i++] - '0');
+        }
+        while (i < n) {
+            char c = fmt[i];
+            if (c == 'u') {
+                d.sign = false;
+                df_d = true;
+                i++;
+                continue;
+            }
+            if (c == 'X' || c == 'x') {
+                d.hex = c == 'X' ? 2 : 1;
+                d.sign = false;
+                df_d = true;
+                i++;
+                continue;
+            }
+            if (c == '.') {
+                i++;
+                d.frac_width = 0;
+                while (i < n && is_digit(fmt[i])) {
+                    d.frac_width = d.frac_width * 10 + (fmt[i++] - '0');
+                    d.trim = false;
+                }
+                break;
+            }
+            if (c == '*') {
+                d.stars++;
+                i++;
+                continue;
+            }
+            break;
+        }
+        d.arg = arg;
+
+        char c = i < n ? fmt[i] : '\0';
+        switch (c) {
+            case 'S':
+                d.k = d.hex ? kind::sstr_hex : kind::sstr;
+                break;
+            case 's':
+                d.k = kind::cstr;
+                break;
+            case 'T':
+                d.k = kind::num_time;
+                d.sign = true;
+                break;
+            case 'z':
+                d.k = kind::num_size;
+                break;
+            case 'd':
+                d.k = kind::num_int;
+                break;
+            case 'l':
+                d.k = kind::num_long;
+                break;
+            case 'D':
+                d.k = kind::num_i32;
+                break;
+            case 'L':
+                d.k = kind::num_i64;
+                break;
+            case 'f':
+                d.k = kind::fixed;
+                break;
+            case 'p':
+                d.k = kind::num_ptr;
+                d.hex = 2;
+                d.sign = false;
+                d.zero = '0';
+                d.width = 2 * sizeof(void*);
+                break;
+            case 'c':
+                d.k = kind::chr;
+                break;
+            case 'Z':
+                d.k = kind::byte;
+                d.ch = '\0';
+                break;
+            case 'N':
+                d.k = kind::byte;
+                d.ch = '\n';
+                break;
+            case '%':
+                d.k = kind::skip;
+                print_char = true;
+                break;
+            default:
+                // an unknown directive prints its character, so does the
+                // character after a %u/%x/%X without a type.
+                d.k = df_d ? kind::num_int : kind::skip;
+                print_char = c != '\0';
+                break;
+        }
+
+        if (d.k != kind::skip || d.stars) {
+            put(out, count, d);
+        }
+        arg += arg_count(d);
+        if (print_char) {
+            put(out, count, literal(i, 1, arg));
+        }
+        if (c) {
+            i++;
+        }
+    }
+    return count;
+}
+
+template <std::size_t N>
+struct directive_list {
+    directive d[N > 0 ? N : 1];
+    std::size_t size;
+    std::size_t nargs;
+};
+
+template <class F>
+constexpr auto parse_format() {
+    constexpr std::size_t upper = parse(F::data(), F::size(), nullptr);
+    directive_list<upper> list{};
+    list.size = parse(F::data(), F::size(), list.d);
+    list.nargs = 0;
+    for (std::size_t i = 0; i < list.size; ++i) {
+        list.nargs += arg_count(list.d[i]);
+    }
+    return list;
+}
+
+template <class F>
+inline constexpr auto directives = parse_format<F>();
+
+template <class A>
+inline constexpr bool is_sstr_v =
+    std::is_same_v<A, sstr_t> || std::is_same_v<A, const void*> ||
+    std::is_same_v<A, struct sstr_s*> ||
+    std::is_same_v<A, const struct sstr_s*> ||
+    std::is_same_v<A, std::nullptr_t>;
+
+template <class A>
+inline constexpr bool is_cstr_v =
+    std::is_same_v<A, char*> || std::is_same_v<A, const char*> ||
+    std::is_same_v<A, unsigned char*> ||
+    std::is_same_v<A, const unsigned char*> ||
+    std::is_same_v<A, std::nullptr_t>;
+
+// an integral argument that fits the C type T the directive reads.
+template <class T, class A>
+inline constexpr bool fits_v = std::is_integral_v<A> && sizeof(A) <= sizeof(T);
+
+template <class S, class U, class A>
+inline void emit_int(sstr_t buf, const directive& d, const A& v) {
+    static_assert(fits_v<S, A>, "integer argument too wide for directive");
+    if (d.sign) {
+        std::int64_t i64 = static_cast<std::int64_t>(static_cast<S>(v));
+        if (i64 < 0) {
+            sstr_append_num(buf, 0 - static_cast<std::uint64_t>(i64), 1,
+                            d.zero, d.hex, d.width);
+        } else {
+            sstr_append_num(buf, static_cast<std::uint64_t>(i64), 0, d.zero,
+                            d.hex, d.width);
+        }
+    } else {
+        sstr_append_num(buf, static_cast<std::uint64_t>(static_cast<U>(v)), 0,
+                        d.zero, d.hex, d.width);
+    }
+}
+
+template <class Tuple, std::size_t First, std::size_t... S>
+constexpr bool stars_integral(std::index_sequence<S...>) {
+    return (std::is_integral_v<
+                std::decay_t<std::tuple_element_t<First + S, Tuple>>> &&
+            ...);
+}
+
+template <class F, std::size_t I, class Tuple>
+inline void emit(sstr_t buf, const Tuple& args) {
+    constexpr directive d = directives<F>.d[I];
+    static_assert(stars_integral<Tuple, d.arg>(
+                      std::make_index_sequence<d.stars>{}),
+                  "%* expects an integral length");
+
+    if constexpr (d.k == kind::literal) {
+        sstr_append_of(buf, F::data() + d.pos, d.len);
+    } else if constexpr (d.k == kind::byte) {
+        char c = d.ch;
+        sstr_append_of(buf, &c, 1);
+    } else if constexpr (d.k == kind::skip) {
+        // only %* arguments, nothing to print.
+    } else {
+        constexpr std::size_t a = d.arg + d.stars;
+        using A = std::decay_t<std::tuple_element_t<a, Tuple>>;
+        const auto& v = std::get<a>(args);
+
+        if constexpr (d.k == kind::sstr || d.k == kind::sstr_hex) {
+            static_assert(is_sstr_v<A>, "%S expects a sstr_t");
+            if (v == nullptr) {
+                sstr_append_of(buf, "NULL", 4);
+            } else if constexpr (d.k == kind::sstr) {
+                sstr_append(buf, (sstr_t)v);
+            } else {
+                sstr_t s = (sstr_t)v;
+                sstr_append_hex(buf, sstr_cstr(s), sstr_length(s), d.hex == 2);
+            }
+        } else if constexpr (d.k == kind::cstr) {
+            static_assert(is_cstr_v<A>, "%s expects a C string");
+            const char* p = v == nullptr ? "NULL" : (const char*)v;
+            if constexpr (d.stars) {
+                sstr_append_of(buf, p,
+                               static_cast<std::size_t>(std::get<a - 1>(args)));
+            } else {
+                sstr_append_cstr(buf, p);
+            }
+        } else if constexpr (d.k == kind::num_time) {
+            emit_int<std::time_t, std::time_t>(buf, d, v);
+        } else if constexpr (d.k == kind::num_size || d.k == kind::num_long) {
+            emit_int<long, unsigned long>(buf, d, v);
+        } else if constexpr (d.k == kind::num_int) {
+            emit_int<int, unsigned int>(buf, d, v);
+        } else if constexpr (d.k == kind::num_i32) {
+            emit_int<std::int32_t, std::uint32_t>(buf, d, v);
+        } else if constexpr (d.k == kind::num_i64) {
+            emit_int<std::int64_t, std::uint64_t>(buf, d, v);
+        } else if constexpr (d.k == kind::num_ptr) {
+            static_assert(std::is_pointer_v<A> ||
+                              std::is_same_v<A, std::nullptr_t>,
+                          "%p expects a pointer");
+            sstr_append_num(buf, (std::uintptr_t)(const void*)v, 0, d.zero,
+                            d.hex, d.width);
+        } else if constexpr (d.k == kind::fixed) {
+            static_assert(std::is_arithmetic_v<A>, "%f expects a number");
+            sstr_append_fixed(buf, static_cast<double>(v), d.zero, d.width,
+                              d.frac_width, d.trim);
+        } else if constexpr (d.k == kind::chr) {
+            static_assert(std::is_integral_v<A>, "%c expects a character");
+            char c = static_cast<char>(v);
+            sstr_append_of(buf, &c, 1);
+        }
+    }
+}
+
+template <class F, class Tuple, std::size_t... I>
+inline void run(sstr_t buf, const Tuple& args, std::index_sequence<I...>) {
+    (emit<F, I>(buf, args), ...);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Same as sstr_printf_append(), with the format parsed at compile time.
+ *
+ * @param buf buffer to print to.
+ * @param fmt format, wrapped by SSTR_FMT().
+ * @param args arguments, checked against the directives of \a fmt.
+ * @return sstr_t \a buf.
+ */
+template <class F, class... Args>
+inline sstr_t format_append(sstr_t buf, F fmt, const Args&... args) {
+    constexpr const auto& list = detail::directives<F>;
+    static_assert(list.nargs == sizeof...(Args),
+                  "number of arguments does not match the format");
+    (void)fmt;
+    detail::run<F>(buf, std::forward_as_tuple(args...),
+                   std::make_index_sequence<list.size>{});
+    return buf;
+}
+
+/**
+ * @brief Same as sstr_printf(), with the format parsed at compile time.
+ *
+ * @param fmt format, wrapped by SSTR_FMT().
+ * @param args arguments, checked against the directives of \a fmt.
+ * @return sstr_t result string.
+ */
+template <class F, class... Args>
+inline sstr_t format(F fmt, const Args&... args) {
+    return format_append(sstr_new(), fmt, args...);
+}
+
+}  // namespace sstr_fmt
+
+#endif /* SSTR_FORMAT_HPP_ */
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <stdlib.h> /* malloc, realloc, free */
+
+#include <string>
+
+#include "sstr.h"
+
+std::string gen_random(const int len);
+
+// shared with create.cc.
+struct counting_ctx {
+    long allocs;
+    long frees;
+    long bytes;
+};
+
+void* counting_alloc(void* ctx, size_t size) {
+    counting_ctx* c = (counting_ctx*)ctx;
+    c->allocs++;
+    c->bytes += size;
+    return malloc(size);
+}
+
+void* counting_realloc(void* ctx, void* ptr, size_t old_size,
+                       size_t new_size) {
+    counting_ctx* c = (counting_ctx*)ctx;
+    if (ptr == NULL) {
+        c->allocs++;
+    }
+    c->bytes += new_size - old_size;
+    return realloc(ptr, new_size);
+}
+
+void counting_free(void* ctx, void* ptr, size_t size) {
+    counting_ctx* c = (counting_ctx*)ctx;
+    c->frees++;
+    c->bytes -= size;
+    free(ptr);
+}
+
+TEST(allocator, per_string) {
+    counting_ctx ctx = {0, 0, 0};
+    sstr_allocator_t a = {counting_alloc, counting_realloc, counting_free,
+                          &ctx};
+    std::string cpp_str;
+
+    sstr_t s = sstr_new_alloc(&a);
+    for (int i = 0; i < 1000; ++i) {
+        auto rand_str = gen_random(i + 1);
+        sstr_append_of(s, rand_str.c_str(), rand_str.size());
+        cpp_str += rand_str;
+    }
+    ASSERT_EQ(cpp_str, sstr_cstr(s));
+    ASSERT_EQ(ctx.allocs, 2);
+
+    sstr_t d = sstr_dup(s);
+    sstr_t sub = sstr_substr(s, 10, 100);
+    sstr_t o = sstr_of_alloc(&a, "short", 5);
+    ASSERT_EQ(sstr_compare(d, s), 0);
+    ASSERT_EQ(sstr_compare_c(o, "short"), 0);
+    // the dup shares the buffer of s, only its header is allocated
+    ASSERT_EQ(ctx.allocs, 6);
+
+    sstr_clear(s);
+    sstr_append_cstr(s, cpp_str.c_str());
+    ASSERT_EQ(sstr_compare(d, s), 0);
+
+    sstr_free(s);
+    sstr_free(d);
+    sstr_free(sub);
+    sstr_free(o);
+    ASSERT_EQ(ctx.allocs, ctx.frees);
+    ASSERT_EQ(ctx.bytes, 0);
+}
+
+TEST(allocator, process_default) {
+    counting_ctx ctx = {0, 0, 0};
+    sstr_allocator_t a = {counting_alloc, counting_realloc, counting_free,
+                          &ctx};
+
+    sstr_set_default_allocator(&a);
+    ASSERT_EQ(sstr_default_allocator(), &a);
+    sstr_t s = sstr_printf("%s-%d-%S", "default allocator", 42, NULL);
+    sstr_t l = sstr(std::string(1000, 'x').c_str());
+    sstr_set_default_allocator(NULL);
+
+    ASSERT_EQ(sstr_compare_c(s, "default allocator-42-NULL"), 0);
+    ASSERT_GT(ctx.allocs, 2);
+    sstr_free(s);
+    sstr_free(l);
+    ASSERT_EQ(ctx.allocs, ctx.frees);
+    ASSERT_EQ(ctx.bytes, 0);
+}
+
+TEST(allocator, reuse) {
+    counting_ctx ctx = {0, 0, 0};
+    sstr_allocator_t a = {counting_alloc, counting_realloc, counting_free,
+                          &ctx};
+    std::string line = gen_random(300);
+
+    // a reserved build allocates once, however many appends
+    sstr_t s = sstr_new_alloc(&a);
+    sstr_reserve(s, 100 * line.size());
+    ASSERT_EQ(sstr_capacity(s), 100 * line.size());
+    long bytes = ctx.bytes;
+    for (int i = 0; i < 100; ++i) {
+        sstr_append_of(s, line.data(), line.size());
+    }
+    ASSERT_EQ(ctx.allocs, 2);
+    ASSERT_EQ(ctx.bytes, bytes);
+
+    // a cleared scratch string keeps its buffer
+    for (int round = 0; round < 10; ++round) {
+        sstr_clear_keep_capacity(s);
+        ASSERT_EQ(sstr_length(s), 0U);
+        ASSERT_STREQ(sstr_cstr(s), "");
+        for (int i = 0; i < 100; ++i) {
+            sstr_append_of(s, line.data(), line.size());
+        }
+    }
+    ASSERT_EQ(ctx.allocs, 2);
+    ASSERT_EQ(ctx.bytes, bytes);
+    ASSERT_EQ(sstr_hash(s), sstr_hash_of(sstr_cstr(s), sstr_length(s), 0));
+
+    // reserving less than the capacity does nothing, shrinking gives back
+    // the slack, down into the header when the content fits there
+    sstr_reserve(s, 10);
+    ASSERT_EQ(sstr_capacity(s), 100 * line.size());
+    sstr_clear_keep_capacity(s);
+    sstr_append_of(s, line.data(), line.size());
+    sstr_shrink_to_fit(s);
+    ASSERT_EQ(sstr_capacity(s), line.size());
+    ASSERT_EQ(std::string(sstr_cstr(s), sstr_length(s)), line);
+    sstr_clear_keep_capacity(s);
+    sstr_append_cstr(s, "short");
+    sstr_shrink_to_fit(s);
+    ASSERT_EQ(SSTR_TYPE_OF(s), SSTR_TYPE_SHORT);
+    ASSERT_EQ(sstr_capacity(s), SSTR_SHORT_ALLOC_CAPACITY);
+    ASSERT_STREQ(sstr_cstr(s), "short");
+    ASSERT_EQ(ctx.frees, 1);
+
+    // a reserve or shrink of a shared buffer leaves the copy alone
+    sstr_reserve(s, 1000);
+    sstr_append_of(s, line.data(), line.size());
+    sstr_t d = sstr_dup(s);
+    sstr_reserve(d, 2000);
+    ASSERT_GE(sstr_capacity(d), 2000U);
+    ASSERT_EQ(sstr_compare(d, s), 0);
+    sstr_clear_keep_capacity(s);
+    ASSERT_EQ(sstr_length(s), 0U);
+    ASSERT_EQ(sstr_length(d), 5 + line.size());
+    sstr_t e = sstr_dup(d);
+    sstr_shrink_to_fit(e);
+    ASSERT_EQ(sstr_compare(d, e), 0);
+
+    sstr_free(s);
+    sstr_free(d);
+    sstr_free(e);
+    ASSERT_EQ(ctx.allocs, ctx.frees);
+    ASSERT_EQ(ctx.bytes, 0);
+}
@@ -56,3 +56,39 @@ TEST(append, random) {
     sstr_free(s_apc);
     sstr_free(s_ap);
 }
+
+TEST(append, growth_policy) {
+    static const sstr_growth_t clamped = {4.0, 16, 1024};
+    sstr_t s = sstr_new();
+    std::string cpp_str;
+
+    ASSERT_EQ(sstr_default_growth()->factor, 1.5);
+    sstr_set_growth(s, &clamped);
+    for (int i = 0; i < 10000; ++i) {
+        size_t old_cap =
+            SSTR_TYPE_OF(s) == SSTR_TYPE_LONG ? sstr_capacity(s) : 0;
+        auto rand_str = gen_random(i % 100 + 1);
+        sstr_append_of(s, rand_str.c_str(), rand_str.size());
+        cpp_str += rand_str;
+        if (SSTR_TYPE_OF(s) != SSTR_TYPE_LONG) {
+            continue;
+        }
+        ASSERT_GE(sstr_capacity(s), sstr_length(s));
+        if (old_cap >= 16 && sstr_capacity(s) != old_cap) {
+            ASSERT_LE(sstr_capacity(s) - old_cap, 1024u);
+        }
+    }
+    ASSERT_EQ(cpp_str, sstr_cstr(s));
+    sstr_free(s);
+
+    static const sstr_growth_t doubling = {2.0, 0, 0};
+    sstr_set_default_growth(&doubling);
+    s = sstr_new();
+    sstr_append_zero(s, SHORT_STR_CAPACITY + 1);
+    size_t cap = sstr_capacity(s);
+    sstr_append_zero(s, cap - sstr_length(s) + 1);
+    ASSERT_EQ(sstr_capacity(s), cap * 2);
+    sstr_free(s);
+    sstr_set_default_growth(NULL);
+    ASSERT_EQ(sstr_default_growth()->min_step, (size_t)CAP_ADD_DELTA);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <stdio.h> /* snprintf */
+
+#include <string>
+#include <vector>
+
+#include "sstr.h"
+
+std::string gen_random(const int len);
+
+TEST(arena, request_scope) {
+    sstr_arena_t* arena = sstr_arena_create(1024);
+
+    for (int round = 0; round < 10; ++round) {
+        std::vector<sstr_t> strs;
+        std::vector<std::string> expect;
+        for (int i = 0; i < 200; ++i) {
+            sstr_t s = sstr_arena_printf(arena, "round %d, item %d", round, i);
+            char tmp[100];
+            snprintf(tmp, sizeof(tmp), "round %d, item %d", round, i);
+            strs.push_back(s);
+            expect.push_back(tmp);
+
+            sstr_t d = sstr_dup(s);
+            sstr_t sub = sstr_substr(s, 6, 3);
+            strs.push_back(d);
+            expect.push_back(tmp);
+            strs.push_back(sub);
+            expect.push_back(std::string(tmp).substr(6, 3));
+        }
+        auto big = gen_random(5000);
+        strs.push_back(sstr_arena_of(arena, big.c_str(), big.size()));
+        expect.push_back(big);
+
+        for (size_t i = 0; i < strs.size(); ++i) {
+            ASSERT_EQ(expect[i], sstr_cstr(strs[i]));
+        }
+        sstr_arena_reset(arena);
+    }
+    sstr_arena_destroy(arena);
+}
+
+TEST(arena, grow_in_place) {
+    sstr_arena_t* arena = sstr_arena_create(0);
+    sstr_t s = sstr_arena_new(arena);
+    std::string cpp_str;
+
+    sstr_append_zero(s, SHORT_STR_CAPACITY + 1);
+    cpp_str.append(SHORT_STR_CAPACITY + 1, '\0');
+    char* data = sstr_cstr(s);
+    while (sstr_length(s) < SSTR_ARENA_BLOCK_SIZE / 2) {
+        sstr_append_of(s, "0123456789", 10);
+        cpp_str += "0123456789";
+        ASSERT_EQ(data, sstr_cstr(s));
+    }
+    ASSERT_EQ(0, memcmp(cpp_str.data(), sstr_cstr(s), cpp_str.size()));
+
+    // a new allocation stops in place growth, content must move.
+    sstr_t other = sstr_arena_of(arena, "other", 5);
+    while (sstr_length(s) < SSTR_ARENA_BLOCK_SIZE * 4) {
+        sstr_append_of(s, "0123456789", 10);
+        cpp_str += "0123456789";
+    }
+    ASSERT_EQ(0, memcmp(cpp_str.data(), sstr_cstr(s), cpp_str.size()));
+    ASSERT_EQ(sstr_compare_c(other, "other"), 0);
+
+    // individual frees are allowed, but not needed.
+    sstr_free(other);
+    sstr_arena_destroy(arena);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sstr.h"
+
+std::string gen_random(const int len);
+
+static std::string builder_iovec_string(sstr_builder_t* b) {
+    size_t n;
+    const struct iovec* iov = sstr_builder_iovec(b, &n);
+    std::string r;
+    for (size_t i = 0; i < n; ++i) {
+        r.append((const char*)iov[i].iov_base, iov[i].iov_len);
+    }
+    return r;
+}
+
+TEST(builder, against_string) {
+    std::mt19937 rng(21);
+    sstr_builder_t* b = sstr_builder_create();
+    std::vector<std::string> refs;
+    std::string expect;
+
+    refs.reserve(1000);
+    for (int i = 0; i < 1000; ++i) {
+        int len = rng() % 4 == 0 ? (int)(rng() % 5000) : (int)(rng() % 40);
+        std::string in = gen_random(len);
+        switch (rng() % 4) {
+            case 0:
+                sstr_builder_append_of(b, in.data(), in.size());
+                break;
+            case 1: {
+                sstr_t s = sstr_of(in.data(), in.size());
+                sstr_builder_append(b, s);
+                sstr_free(s);
+                break;
+            }
+            case 2:
+                refs.push_back(in);
+                sstr_builder_append_ref(b, refs.back().data(),
+                                        refs.back().size());
+                break;
+            default:
+                sstr_builder_printf(b, "%d:%s", i, in.c_str());
+                in = std::to_string(i) + ":" + in;
+        }
+        expect += in;
+        ASSERT_EQ(sstr_builder_length(b), expect.size());
+    }
+    ASSERT_EQ(builder_iovec_string(b), expect);
+
+    sstr_t flat = sstr_builder_flatten(b);
+    ASSERT_EQ(std::string(sstr_cstr(flat), sstr_length(flat)), expect);
+    ASSERT_EQ(sstr_capacity(flat), expect.size());
+    ASSERT_EQ(sstr_cstr(flat)[expect.size()], '\0');
+
+    sstr_builder_flatten_append(b, flat);
+    ASSERT_EQ(std::string(sstr_cstr(flat), sstr_length(flat)),
+              expect + expect);
+    sstr_free(flat);
+
+    // a cleared builder is reused
+    sstr_builder_clear(b);
+    ASSERT_EQ(sstr_builder_length(b), 0U);
+    ASSERT_EQ(builder_iovec_string(b), "");
+    sstr_builder_append_of(b, "again", 5);
+    ASSERT_EQ(builder_iovec_string(b), "again");
+    sstr_builder_destroy(b);
+}
+
+TEST(builder, segments) {
+    sstr_builder_t* b = sstr_builder_create();
+    std::string body = gen_random(10000);
+    sstr_t s = sstr_of(body.data(), body.size());
+    size_t n;
+
+    // small copies join one segment, a long string is shared as is
+    sstr_builder_append_of(b, "HTTP/1.1 200 OK\r\n", 17);
+    sstr_builder_printf(b, "Content-Length: %z\r\n\r\n", body.size());
+    sstr_builder_append(b, s);
+    const struct iovec* iov = sstr_builder_iovec(b, &n);
+    ASSERT_EQ(n, 2U);
+    ASSERT_EQ(iov[1].iov_base, (void*)sstr_cstr(s));
+    ASSERT_EQ(SSTR_TYPE_OF(s), SSTR_TYPE_SHARED);
+
+    // the shared string is copied on write, the builder keeps the original
+    sstr_append_of(s, "!", 1);
+    sstr_free(s);
+    sstr_builder_append_ref(b, "\r\n", 2);
+    ASSERT_EQ(builder_iovec_string(b),
+              "HTTP/1.1 200 OK\r\nContent-Length: 10000\r\n\r\n" + body +
+                  "\r\n");
+    sstr_builder_destroy(b);
+}
+
+TEST(builder, writev) {
+    sstr_builder_t* b = sstr_builder_create();
+    std::string expect;
+    int fds[2];
+
+    for (int i = 0; i < 100; ++i) {
+        std::string chunk = gen_random(i * 7);
+        expect += chunk;
+        if (i % 2) {
+            sstr_t s = sstr_of(chunk.data(), chunk.size());
+            sstr_builder_append(b, s);
+            sstr_free(s);
+        } else {
+            sstr_builder_append_of(b, chunk.data(), chunk.size());
+        }
+    }
+
+    ASSERT_EQ(pipe(fds), 0);
+    size_t n;
+    const struct iovec* iov = sstr_builder_iovec(b, &n);
+    ASSERT_EQ(writev(fds[1], iov, n), (ssize_t)expect.size());
+    std::string got(expect.size(), '\0');
+    ASSERT_EQ(read(fds[0], &got[0], got.size()), (ssize_t)expect.size());
+    ASSERT_EQ(got, expect);
+    close(fds[0]);
+    close(fds[1]);
+
+    // short writes of up to 1000 bytes, resumed by sstr_builder_consume()
+    got.clear();
+    while (sstr_builder_length(b)) {
+        iov = sstr_builder_iovec(b, &n);
+        size_t w = 0;
+        for (size_t i = 0; i < n && w < 1000; ++i) {
+            size_t take = std::min(iov[i].iov_len, 1000 - w);
+            got.append((const char*)iov[i].iov_base, take);
+            w += take;
+        }
+        sstr_builder_consume(b, w);
+    }
+    ASSERT_EQ(got, expect);
+
+    sstr_builder_consume(b, 100);
+    ASSERT_EQ(sstr_builder_length(b), 0U);
+    sstr_builder_destroy(b);
+}
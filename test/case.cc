@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include "sstr.h"
+
+std::string str_of(sstr_t s);
+
+static std::string ascii_lower(std::string s) {
+    for (auto& c : s) {
+        if (c >= 'A' && c <= 'Z') {
+            c = (char)(c + 32);
+        }
+    }
+    return s;
+}
+
+static std::string ascii_upper(std::string s) {
+    for (auto& c : s) {
+        if (c >= 'a' && c <= 'z') {
+            c = (char)(c - 32);
+        }
+    }
+    return s;
+}
+
+// letters of both cases, their neighbours '@', '[', '`' and '{', and bytes
+// that are letters plus 0x80.
+static std::string case_text(std::mt19937& rng, size_t len) {
+    static const char bytes[] = "aAzZmM@[`{09 \xc1\xe1\xc3\xa9\xff";
+    std::string s;
+    for (size_t i = 0; i < len; ++i) {
+        s += bytes[rng() % (sizeof(bytes) - 1)];
+    }
+    return s;
+}
+
+static int sign(int v) { return (v > 0) - (v < 0); }
+
+TEST(sstr_case, convert) {
+    std::mt19937 rng(24);
+    for (size_t len = 0; len < 300; ++len) {
+        std::string text = case_text(rng, len);
+        sstr_t s = sstr_of(text.data(), text.size());
+
+        sstr_t lower = sstr_tolower_copy(s);
+        sstr_t upper = sstr_toupper_copy(s);
+        ASSERT_EQ(str_of(lower), ascii_lower(text)) << len;
+        ASSERT_EQ(str_of(upper), ascii_upper(text)) << len;
+        ASSERT_EQ(sstr_cstr(upper)[len], '\0');
+        ASSERT_EQ(str_of(s), text);
+
+        sstr_toupper(s);
+        ASSERT_EQ(str_of(s), ascii_upper(text));
+        sstr_tolower(s);
+        ASSERT_EQ(str_of(s), ascii_lower(text));
+        ASSERT_EQ(sstr_compare(s, lower), 0);
+
+        sstr_free(s);
+        sstr_free(lower);
+        sstr_free(upper);
+    }
+}
+
+TEST(sstr_case, convert_shared) {
+    std::string text = "Content-Type: " + std::string(100, 'X');
+    sstr_t s = sstr_of(text.data(), text.size());
+    sstr_t d = sstr_dup(s);
+    uint64_t h = sstr_hash(s);
+
+    // the copy converts into a buffer of its own
+    sstr_tolower(d);
+    ASSERT_EQ(str_of(d), ascii_lower(text));
+    ASSERT_EQ(str_of(s), text);
+    ASSERT_EQ(sstr_hash(s), h);
+    ASSERT_EQ(sstr_hash(d), sstr_hash_of(sstr_cstr(d), text.size(), 0));
+
+    // and the cached hash of the converted string is not stale
+    sstr_toupper(s);
+    ASSERT_EQ(sstr_hash(s), sstr_hash_of(ascii_upper(text).data(),
+                                         text.size(), 0));
+    sstr_free(d);
+
+    // views may be copied
+    struct sstr_s view;
+    sstr_t lower = sstr_tolower_copy(sstr_ref_init(&view, "GeT", 3));
+    ASSERT_STREQ(sstr_cstr(lower), "get");
+    sstr_free(lower);
+    sstr_free(s);
+}
+
+TEST(sstr_case, is_ascii) {
+    std::string text(1000, 'a');
+    ASSERT_TRUE(sstr_is_ascii_of(text.data(), 0));
+    ASSERT_TRUE(sstr_is_ascii_of(text.data(), text.size()));
+    for (size_t i = 0; i < text.size(); i += 7) {
+        text[i] = '\x80';
+        ASSERT_FALSE(sstr_is_ascii_of(text.data(), text.size())) << i;
+        ASSERT_TRUE(sstr_is_ascii_of(text.data(), i)) << i;
+        text[i] = '\x7f';
+    }
+    sstr_t s = sstr("h\xc3\xa9llo");
+    ASSERT_FALSE(sstr_is_ascii(s));
+    sstr_free(s);
+}
+
+TEST(sstr_case, compare_nocase) {
+    std::mt19937 rng(25);
+    for (int i = 0; i < 20000; ++i) {
+        size_t len = rng() % 80;
+        std::string a = case_text(rng, len), b;
+        switch (rng() % 3) {
+            case 0:
+                b = case_text(rng, rng() % 80);
+                break;
+            case 1:
+                b = rng() % 2 ? ascii_upper(a) : ascii_lower(a);
+                break;
+            default:
+                b = ascii_upper(a);
+                if (len) {
+                    b[rng() % len] = "aZ\xe1"[rng() % 3];
+                }
+                b.resize(rng() % (len + 2));
+        }
+        sstr_t sa = sstr_of(a.data(), a.size());
+        sstr_t sb = sstr_of(b.data(), b.size());
+        int expect = sign(ascii_lower(a).compare(ascii_lower(b)));
+        ASSERT_EQ(sign(sstr_compare_nocase(sa, sb)), expect) << a << "|" << b;
+        ASSERT_EQ(sign(sstr_compare_nocase(sb, sa)), -expect);
+        sstr_free(sa);
+        sstr_free(sb);
+    }
+
+    sstr_t s = sstr("Content-Length");
+    ASSERT_EQ(sstr_compare_nocase_c(s, "content-length"), 0);
+    ASSERT_LT(sstr_compare_nocase_c(s, "content-type"), 0);
+    ASSERT_GT(sstr_compare_nocase_c(s, "CONTENT"), 0);
+    ASSERT_LT(sstr_compare_nocase(NULL, s), 0);
+    ASSERT_EQ(sstr_compare_nocase(NULL, NULL), 0);
+    sstr_free(s);
+}
+
+TEST(sstr_case, find_nocase) {
+    std::mt19937 rng(26);
+    for (int i = 0; i < 5000; ++i) {
+        std::string text = case_text(rng, rng() % 200);
+        std::string needle = case_text(rng, 1 + rng() % 4);
+        size_t from = rng() % (text.size() + 2);
+        sstr_t s = sstr_of(text.data(), text.size());
+
+        std::string lt = ascii_lower(text), ln = ascii_lower(needle);
+        size_t expect = from > text.size() ? std::string::npos
+                                           : lt.find(ln, from);
+        ASSERT_EQ(sstr_find_nocase_of(s, needle.data(), needle.size(), from),
+                  expect == std::string::npos ? SSTR_NPOS : expect)
+            << text << "|" << needle << "|" << from;
+        sstr_free(s);
+    }
+
+    std::string text(1000, '-');
+    text += "X-Forwarded-For";
+    sstr_t s = sstr_of(text.data(), text.size());
+    sstr_t needle = sstr("x-forwarded-FOR");
+    ASSERT_EQ(sstr_find_nocase(s, needle, 0), 1000U);
+    ASSERT_EQ(sstr_find_nocase(s, needle, 1001), SSTR_NPOS);
+    ASSERT_EQ(sstr_find_nocase_of(s, "", 0, 3), 3U);
+    ASSERT_EQ(sstr_find_nocase_of(s, "\xd8", 1, 0), SSTR_NPOS);
+    sstr_free(needle);
+    sstr_free(s);
+}
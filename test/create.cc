@@ -26,3 +26,104 @@ TEST(create, compare) {
         sstr_free(ss);
     }
 }
+
+struct counting_ctx {
+    long allocs;
+    long frees;
+    long bytes;
+};
+void* counting_alloc(void* ctx, size_t size);
+void* counting_realloc(void* ctx, void* ptr, size_t old_size,
+                       size_t new_size);
+void counting_free(void* ctx, void* ptr, size_t size);
+
+TEST(create, stack) {
+    counting_ctx ctx = {0, 0, 0};
+    sstr_allocator_t a = {counting_alloc, counting_realloc, counting_free,
+                          &ctx};
+    struct sstr_s tmp;
+
+    // tmp keeps the allocator it was initialized with
+    sstr_set_default_allocator(&a);
+    sstr_init(&tmp);
+    sstr_set_default_allocator(NULL);
+    for (int i = 0; i < 1000; ++i) {
+        sstr_printf_append(&tmp, "%d:%l", i, (long)-i);
+        char buf[100];
+        snprintf(buf, sizeof(buf), "%d:%ld", i, (long)-i);
+        ASSERT_EQ(sstr_compare_c(&tmp, buf), 0);
+        sstr_clear(&tmp);
+    }
+    ASSERT_EQ(ctx.allocs, 0);
+
+    auto s = gen_random(1000);
+    sstr_append_cstr(&tmp, s.c_str());
+    ASSERT_EQ(s, sstr_cstr(&tmp));
+    ASSERT_EQ(ctx.allocs, 1);
+    sstr_deinit(&tmp);
+    ASSERT_EQ(sstr_length(&tmp), 0u);
+    ASSERT_STREQ(sstr_cstr(&tmp), "");
+    ASSERT_EQ(ctx.frees, 1);
+    ASSERT_EQ(ctx.bytes, 0);
+}
+
+// every length around both inline capacities, with and without an allocator.
+TEST(create, layout) {
+    counting_ctx ctx = {0, 0, 0};
+    sstr_allocator_t a = {counting_alloc, counting_realloc, counting_free,
+                          &ctx};
+    const sstr_allocator_t* allocators[] = {NULL, &a};
+
+    ASSERT_LE(sizeof(struct sstr_s), 32u);
+    for (const sstr_allocator_t* alloc : allocators) {
+        size_t inline_cap =
+            alloc ? SSTR_SHORT_ALLOC_CAPACITY : (size_t)SHORT_STR_CAPACITY;
+        for (size_t len = 0; len < 40; ++len) {
+            std::string in = gen_random(len + 1).substr(0, len);
+            sstr_t s = sstr_of_alloc(alloc, in.data(), len);
+            ASSERT_EQ(sstr_length(s), len);
+            ASSERT_EQ(std::string(sstr_cstr(s)), in);
+            ASSERT_EQ(SSTR_TYPE_OF(s),
+                      len <= inline_cap ? SSTR_TYPE_SHORT : SSTR_TYPE_LONG);
+
+            // grow one byte at a time across the boundary
+            sstr_t g = sstr_new_alloc(alloc);
+            for (size_t i = 0; i < len; ++i) {
+                sstr_append_of(g, &in[i], 1);
+                ASSERT_EQ(sstr_length(g), i + 1);
+                ASSERT_EQ(sstr_cstr(g)[i + 1], '\0');
+            }
+            ASSERT_EQ(sstr_compare(g, s), 0);
+            ASSERT_EQ(sstr_hash(g), sstr_hash(s));
+
+            sstr_shrink_to_fit(g);
+            ASSERT_EQ(SSTR_TYPE_OF(g), SSTR_TYPE_OF(s));
+            sstr_t d = sstr_dup(g);
+            ASSERT_EQ(sstr_compare(g, d), 0);
+            sstr_clear(g);
+            ASSERT_EQ(sstr_length(g), 0u);
+            ASSERT_STREQ(sstr_cstr(g), "");
+            ASSERT_EQ(SSTR_TYPE_OF(g), SSTR_TYPE_SHORT);
+            ASSERT_EQ(sstr_compare(d, s), 0);
+
+            sstr_free(s);
+            sstr_free(g);
+            sstr_free(d);
+        }
+    }
+    ASSERT_EQ(ctx.allocs, ctx.frees);
+    ASSERT_EQ(ctx.bytes, 0);
+
+    // a growth policy keeps the content out of the header
+    static const sstr_growth_t doubling = {2.0, 0, 0};
+    sstr_t s = sstr("short");
+    sstr_set_growth(s, &doubling);
+    ASSERT_EQ(SSTR_TYPE_OF(s), SSTR_TYPE_LONG);
+    ASSERT_STREQ(sstr_cstr(s), "short");
+    sstr_clear(s);
+    ASSERT_EQ(SSTR_TYPE_OF(s), SSTR_TYPE_LONG);
+    ASSERT_STREQ(sstr_cstr(s), "");
+    sstr_append_cstr(s, "x");
+    ASSERT_STREQ(sstr_cstr(s), "x");
+    sstr_free(s);
+}
@@ -7,6 +7,7 @@
 #include <ctime>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "sstr.h"
@@ -42,3 +43,132 @@ TEST(substr, simple) {
         sstr_free(ss);
     }
 }
+
+TEST(substr, huge_len) {
+    sstr_t ss = sstr("hello world");
+    sstr_t sub = sstr_substr(ss, 6, (size_t)-1);
+    ASSERT_STREQ(sstr_cstr(sub), "world");
+    sstr_free(sub);
+    sstr_free(ss);
+}
+
+TEST(substr_ref, same_as_substr) {
+    std::string data(1000, 'x');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (char)('a' + i % 26);
+    }
+    sstr_t ss = sstr_of(data.data(), data.size());
+    size_t cases[][2] = {{0, 0},    {0, 10},  {10, 990}, {500, 10000},
+                         {999, 1}, {1000, 5}, {1001, 5}, {3, (size_t)-1}};
+    for (auto& c : cases) {
+        sstr_t copy = sstr_substr(ss, c[0], c[1]);
+        sstr_t ref = sstr_substr_ref(ss, c[0], c[1]);
+        struct sstr_s view;
+        sstr_t v = sstr_substr_ref_init(&view, ss, c[0], c[1]);
+
+        ASSERT_EQ(SSTR_TYPE_OF(ref), SSTR_TYPE_REF);
+        ASSERT_EQ(SSTR_TYPE_OF(&view), SSTR_TYPE_REF);
+        ASSERT_EQ(v, (sstr_t)&view);
+        ASSERT_EQ(sstr_compare(copy, ref), 0);
+        ASSERT_EQ(sstr_compare(copy, v), 0);
+        if (sstr_length(ref) > 0) {
+            // a view, not a copy
+            ASSERT_EQ(sstr_cstr(ref), sstr_cstr(ss) + c[0]);
+        }
+        sstr_free(copy);
+        sstr_free(ref);
+    }
+    sstr_free(ss);
+}
+
+TEST(substr_ref, views) {
+    sstr_t msg = sstr("GET / HTTP/1.1\r\nHost: a\r\n\r\nbody");
+    size_t end = sstr_find_of(msg, "\r\n\r\n", 4, 0);
+    struct sstr_s head, body;
+    sstr_substr_ref_init(&head, msg, 0, end);
+    sstr_substr_ref_init(&body, msg, end + 4, SSTR_NPOS);
+    ASSERT_EQ(sstr_length(&head), 23U);
+    ASSERT_EQ(sstr_compare_c(&body, "body"), 0);
+    ASSERT_EQ(sstr_find_char(&head, '\n', 0), 15U);
+
+    // views can be sliced further, and copied out
+    struct sstr_s method;
+    sstr_substr_ref_init(&method, &head, 0, 3);
+    sstr_t copy = sstr_dup(&method);
+    ASSERT_STREQ(sstr_cstr(copy), "GET");
+    ASSERT_EQ(SSTR_TYPE_OF(copy), SSTR_TYPE_SHORT);
+
+    struct sstr_s lit;
+    ASSERT_EQ(sstr_compare(sstr_ref_init(&lit, "GET", 3), &method), 0);
+
+    sstr_free(copy);
+    sstr_free(msg);
+}
+
+TEST(dup, shared_copy_on_write) {
+    std::string data(1000, 'x');
+    sstr_t s = sstr_of(data.data(), data.size());
+    sstr_t d = sstr_dup(s);
+    sstr_t d2 = sstr_dup(d);
+
+    // one buffer for the three of them
+    ASSERT_EQ(SSTR_TYPE_OF(s), SSTR_TYPE_SHARED);
+    ASSERT_EQ(SSTR_TYPE_OF(d), SSTR_TYPE_SHARED);
+    ASSERT_EQ(sstr_cstr(s), sstr_cstr(d));
+    ASSERT_EQ(sstr_cstr(s), sstr_cstr(d2));
+
+    // a write copies first, the others keep the old content
+    sstr_append_cstr(d, "!");
+    ASSERT_NE(sstr_cstr(s), sstr_cstr(d));
+    ASSERT_EQ(SSTR_TYPE_OF(d), SSTR_TYPE_LONG);
+    ASSERT_EQ(sstr_length(d), 1001U);
+    ASSERT_EQ(sstr_length(s), 1000U);
+    ASSERT_EQ(data, std::string(sstr_cstr(s)));
+    ASSERT_EQ(data, std::string(sstr_cstr(d2)));
+    ASSERT_EQ(data + "!", std::string(sstr_cstr(d)));
+
+    // clear just lets go of the buffer
+    sstr_clear(d2);
+    ASSERT_EQ(sstr_length(d2), 0U);
+    ASSERT_STREQ(sstr_cstr(d2), "");
+    ASSERT_EQ(data, std::string(sstr_cstr(s)));
+
+    // the last owner takes the buffer over without a copy
+    char* p = sstr_cstr(s);
+    sstr_printf_append(s, "%d", 42);
+    ASSERT_EQ(SSTR_TYPE_OF(s), SSTR_TYPE_LONG);
+    ASSERT_EQ(data + "42", std::string(sstr_cstr(s)));
+    if (sstr_length(s) <= 1000) {
+        ASSERT_EQ(sstr_cstr(s), p);
+    }
+
+    sstr_free(s);
+    sstr_free(d);
+    sstr_free(d2);
+}
+
+TEST(dup, shared_across_threads) {
+    sstr_t s = sstr_of(std::string(4096, 'a').data(), 4096);
+    std::vector<std::thread> threads;
+    // every thread gets a copy of its own, they all share one buffer.
+    for (int t = 0; t < 8; ++t) {
+        sstr_t mine = sstr_dup(s);
+        threads.emplace_back([mine, t] {
+            for (int i = 0; i < 2000; ++i) {
+                sstr_t d = sstr_dup(mine);
+                if ((i + t) % 3 == 0) {
+                    sstr_append_of(d, "b", 1);
+                    EXPECT_EQ(sstr_length(d), 4097U);
+                    EXPECT_EQ(sstr_cstr(d)[4096], 'b');
+                }
+                EXPECT_EQ(sstr_cstr(d)[4095], 'a');
+                sstr_free(d);
+            }
+            sstr_free(mine);
+        });
+    }
+    sstr_free(s);
+    for (auto& th : threads) {
+        th.join();
+    }
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include "sstr.h"
+
+// a small alphabet with '\0' and a byte >= 0x80, so there are many partial
+// matches, and strstr() would stop early.
+static std::string random_text(std::mt19937& rng, size_t len) {
+    static const char alphabet[] = {'a', 'b', '\0', '\xe9'};
+    std::string s;
+    for (size_t i = 0; i < len; ++i) {
+        s += alphabet[rng() % 4 ? rng() % 2 : 2 + rng() % 2];
+    }
+    return s;
+}
+
+TEST(find, like_std_string) {
+    std::mt19937 rng(12);
+    for (size_t len = 0; len < 140; ++len) {
+        std::string h = random_text(rng, len);
+        sstr_t s = sstr_of(h.data(), h.size());
+        for (size_t nlen = 0; nlen < 6; ++nlen) {
+            std::string n = random_text(rng, nlen);
+            sstr_t needle = sstr_of(n.data(), n.size());
+            for (size_t from = 0; from <= len + 1; ++from) {
+                ASSERT_EQ(sstr_find(s, needle, from), h.find(n, from))
+                    << len << " " << nlen << " " << from;
+                ASSERT_EQ(sstr_rfind(s, needle, from), h.rfind(n, from))
+                    << len << " " << nlen << " " << from;
+            }
+            ASSERT_EQ(sstr_rfind_of(s, n.data(), n.size(), SSTR_NPOS),
+                      h.rfind(n));
+            sstr_free(needle);
+        }
+        for (size_t from = 0; from <= len + 1; ++from) {
+            ASSERT_EQ(sstr_find_char(s, 'b', from), h.find('b', from));
+            ASSERT_EQ(sstr_find_char(s, 0, from), h.find('\0', from));
+            ASSERT_EQ(sstr_rfind_char(s, 0xe9, from), h.rfind('\xe9', from));
+        }
+        ASSERT_EQ(sstr_rfind_char(s, 'a', SSTR_NPOS), h.rfind('a'));
+        sstr_free(s);
+    }
+}
+
+TEST(find, long_needle) {
+    std::string h(5000, 'a');
+    std::string n = std::string(300, 'a') + "b";
+    h.replace(4000, n.size(), n);
+    sstr_t s = sstr_of(h.data(), h.size());
+    ASSERT_EQ(sstr_find_of(s, n.data(), n.size(), 0), 4000U);
+    ASSERT_EQ(sstr_rfind_of(s, n.data(), n.size(), SSTR_NPOS), 4000U);
+    ASSERT_EQ(sstr_find_of(s, n.data(), n.size(), 4001), SSTR_NPOS);
+    ASSERT_EQ(sstr_rfind_of(s, n.data(), n.size(), 3999), SSTR_NPOS);
+    ASSERT_EQ(sstr_find_of(s, h.data(), h.size() + 1, 0), SSTR_NPOS);
+    sstr_free(s);
+}
+
+TEST(find, any_of) {
+    std::mt19937 rng(13);
+    for (size_t len = 0; len < 200; ++len) {
+        std::string h;
+        for (size_t i = 0; i < len; ++i) {
+            h += (char)(rng() % 256);
+        }
+        sstr_t s = sstr_of(h.data(), h.size());
+        // small sets take the compare path, large ones the table lookup.
+        for (size_t setlen : {0, 1, 2, 5, 8, 9, 40}) {
+            std::string set;
+            for (size_t i = 0; i < setlen; ++i) {
+                set += (char)(rng() % 256);
+            }
+            for (size_t from = 0; from <= len; from += 1 + len / 8) {
+                ASSERT_EQ(sstr_find_any_of(s, set.data(), set.size(), from),
+                          h.find_first_of(set, from))
+                    << len << " " << setlen << " " << from;
+            }
+        }
+        sstr_free(s);
+    }
+
+    sstr_t s = sstr("key=value; path=/a/b\r\n");
+    ASSERT_EQ(sstr_find_any_of(s, ";\r\n", 3, 0), 9U);
+    ASSERT_EQ(sstr_find_any_of(s, ";\r\n", 3, 10), 20U);
+    ASSERT_EQ(sstr_find_any_of(s, "#", 1, 0), SSTR_NPOS);
+    sstr_free(s);
+}
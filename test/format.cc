@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <string>
+
+#include "sstr.h"
+#include "sstr_format.hpp"
+
+std::string gen_random(const int len);
+
+#define EXPECT_SAME_AS_PRINTF(fmt, ...)                         \
+    do {                                                        \
+        sstr_t expect = sstr_printf(fmt, __VA_ARGS__);          \
+        sstr_t r = sstr_fmt::format(SSTR_FMT(fmt), __VA_ARGS__); \
+        ASSERT_EQ(sstr_compare(expect, r), 0)                   \
+            << fmt << ": " << sstr_cstr(expect) << " vs "       \
+            << sstr_cstr(r);                                    \
+        sstr_free(expect);                                      \
+        sstr_free(r);                                           \
+    } while (0)
+
+TEST(format, numbers) {
+    for (long i = -100000; i < 100000; i += 97) {
+        EXPECT_SAME_AS_PRINTF("a%db%5dc%05d%ud%xd%Xd%x %X|%ul", (int)i, (int)i,
+                              (int)i, (unsigned)i, (unsigned)i, (unsigned)i,
+                              (unsigned)i, (unsigned)i, (unsigned long)i);
+        EXPECT_SAME_AS_PRINTF("%l|%L|%D|%z|%T|%uz|%uL|%xL|%xabc", i,
+                              (int64_t)i * 1000000007LL, (int32_t)i, i,
+                              (time_t)i, (size_t)i, (uint64_t)i, (uint64_t)i,
+                              (unsigned)i);
+        EXPECT_SAME_AS_PRINTF("%f|%.3f|%10.2f|%.0f|%010.4f", i / 7.0, i / 3.0,
+                              i / 11.0, i / 13.0, i / 17.0);
+    }
+}
+
+TEST(format, strings) {
+    for (int i = 0; i < 1000; ++i) {
+        auto str = gen_random(i + 1);
+        sstr_t s = sstr(str.c_str());
+        EXPECT_SAME_AS_PRINTF("%S|%xS|%XS|%s|%*s|%c|%Z|%N|%%|%p|%q|%", s, s, s,
+                              str.c_str(), (size_t)(i / 2), str.c_str(), 'x',
+                              (void*)s);
+        sstr_free(s);
+    }
+    EXPECT_SAME_AS_PRINTF("%S %s %*%|%5", (sstr_t)NULL, (char*)NULL,
+                          (size_t)1);
+}
+
+TEST(format, append) {
+    sstr_t s = sstr("head:");
+    sstr_t r = sstr_fmt::format_append(s, SSTR_FMT("%d,%s%N"), 1, "two");
+    ASSERT_EQ(r, s);
+    ASSERT_EQ(sstr_compare_c(s, "head:1,two\n"), 0);
+    sstr_fmt::format_append(s, SSTR_FMT("no directives"));
+    ASSERT_EQ(sstr_compare_c(s, "head:1,two\nno directives"), 0);
+    sstr_free(s);
+}
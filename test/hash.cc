@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+
+#include "sstr.h"
+
+std::string gen_random(const int len);
+
+static std::string hash_input(size_t len) {
+    std::string in;
+    for (size_t i = 0; i < len; ++i) {
+        in += (char)(i * 31 + 7);
+    }
+    return in;
+}
+
+// the values are part of the interface: they must not change between
+// releases, nor between the scalar, SSE2 and AVX2 builds.
+TEST(hash, known_values) {
+    const struct {
+        size_t length;
+        uint64_t hash;
+    } cases[] = {
+        {0, 0x93228a4de0eec5a2ULL},    {3, 0xe9609c2e635eb614ULL},
+        {4, 0x856e7a5c5ce6b65eULL},    {8, 0xca9f70fc67bbea6dULL},
+        {16, 0xbdc55046c6d1ec4fULL},   {17, 0xb3889b861f2af496ULL},
+        {48, 0x09a8616e6549b4c8ULL},   {49, 0x0c4d8b68d0152146ULL},
+        {100, 0x7e291c157d363fabULL},  {1024, 0x5b23e3113b70a154ULL},
+        {1025, 0x2bc1d3b67f3e36fdULL}, {1600, 0x749d40faef5cf1cfULL},
+        {4096, 0xb513e98023b26f1cULL}, {5000, 0x89598935371d7170ULL},
+    };
+    std::string in = hash_input(5000);
+    for (const auto& c : cases) {
+        ASSERT_EQ(sstr_hash_of(in.data(), c.length, 0), c.hash) << c.length;
+    }
+    ASSERT_EQ(sstr_hash_of(in.data(), 100, 42), 0xe19dceea0d6207adULL);
+    ASSERT_EQ(sstr_hash_of(in.data(), 5000, 42), 0x8081a1df2ec9f37dULL);
+}
+
+TEST(hash, string) {
+    for (int len = 0; len < 2200; len += len < 100 ? 1 : 37) {
+        std::string in = gen_random(len);
+        sstr_t s = sstr_of(in.data(), in.size());
+        uint64_t h = sstr_hash_of(in.data(), in.size(), 0);
+        ASSERT_EQ(sstr_hash(s), h) << len;
+        ASSERT_EQ(sstr_hash(s), h) << len;  // cached
+        ASSERT_EQ(sstr_hash_seed(s, 0), h);
+        ASSERT_NE(sstr_hash_seed(s, 1), h);
+        sstr_free(s);
+    }
+}
+
+TEST(hash, cache_invalidation) {
+    std::string in = gen_random(300);
+    sstr_t s = sstr_of(in.data(), in.size());
+    ASSERT_EQ(sstr_hash(s), sstr_hash_of(in.data(), in.size(), 0));
+
+    // append within the capacity and past it
+    sstr_append_of(s, "x", 1);
+    in += "x";
+    ASSERT_EQ(sstr_hash(s), sstr_hash_of(in.data(), in.size(), 0));
+    std::string more = gen_random(1000);
+    sstr_append_of(s, more.data(), more.size());
+    in += more;
+    ASSERT_EQ(sstr_hash(s), sstr_hash_of(in.data(), in.size(), 0));
+    sstr_printf_append(s, "%d", 42);
+    in += "42";
+    ASSERT_EQ(sstr_hash(s), sstr_hash_of(in.data(), in.size(), 0));
+
+    // copies share the cached hash until one of them is written
+    sstr_t d = sstr_dup(s);
+    ASSERT_EQ(sstr_hash(d), sstr_hash(s));
+    sstr_append_of(d, "y", 1);
+    ASSERT_EQ(sstr_hash(d), sstr_hash_of((in + "y").data(), in.size() + 1, 0));
+    ASSERT_EQ(sstr_hash(s), sstr_hash_of(in.data(), in.size(), 0));
+    sstr_free(d);
+
+    sstr_clear(s);
+    ASSERT_EQ(sstr_hash(s), sstr_hash_of("", 0, 0));
+    sstr_append_of(s, in.data(), in.size());
+    ASSERT_EQ(sstr_hash(s), sstr_hash_of(in.data(), in.size(), 0));
+    sstr_free(s);
+}
+
+// every input bit flips about half of the output bits, on every path.
+TEST(hash, avalanche) {
+    for (size_t len : {3, 12, 40, 200, 1500}) {
+        std::string in = hash_input(len);
+        uint64_t h = sstr_hash_of(in.data(), len, 0);
+        double flipped = 0;
+        for (size_t bit = 0; bit < len * 8; ++bit) {
+            in[bit / 8] ^= (char)(1 << (bit % 8));
+            uint64_t h2 = sstr_hash_of(in.data(), len, 0);
+            flipped += __builtin_popcountll(h ^ h2);
+            in[bit / 8] ^= (char)(1 << (bit % 8));
+        }
+        flipped /= len * 8;
+        ASSERT_GT(flipped, 30) << len;
+        ASSERT_LT(flipped, 34) << len;
+    }
+
+    std::set<uint64_t> seen;
+    for (int i = 0; i < 100000; ++i) {
+        std::string k = "key-" + std::to_string(i);
+        seen.insert(sstr_hash_of(k.data(), k.size(), 0) & 0xffffffffffULL);
+    }
+    ASSERT_EQ(seen.size(), 100000U);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sstr.h"
+
+std::string gen_random(const int len);
+
+TEST(intern, canonical) {
+    sstr_intern_t* pool = sstr_intern_create(0);
+    std::vector<std::string> keys;
+    std::vector<sstr_t> interned;
+
+    // empty, short, the short/long boundary and long strings
+    keys.push_back("");
+    for (int len : {1, 7, SHORT_STR_CAPACITY, SHORT_STR_CAPACITY + 1, 100,
+                    5000}) {
+        for (int i = 0; i < 50; ++i) {
+            keys.push_back(gen_random(len));
+        }
+    }
+    keys.push_back(std::string("a\0b", 3));
+    keys.push_back(std::string("a\0c", 3));
+    for (const auto& k : keys) {
+        interned.push_back(sstr_intern_of(pool, k.data(), k.size()));
+    }
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        sstr_t s = interned[i];
+        ASSERT_EQ(sstr_length(s), keys[i].size());
+        ASSERT_EQ(memcmp(sstr_cstr(s), keys[i].data(), keys[i].size()), 0);
+        ASSERT_EQ(sstr_cstr(s)[keys[i].size()], '\0');
+
+        // equal bytes, same pointer, from every entry point
+        std::string copy = keys[i];
+        ASSERT_EQ(sstr_intern_of(pool, copy.data(), copy.size()), s);
+        ASSERT_EQ(sstr_intern_find(pool, copy.data(), copy.size()), s);
+        sstr_t other = sstr_of(copy.data(), copy.size());
+        ASSERT_EQ(sstr_intern(pool, other), s);
+        sstr_free(other);
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        for (size_t j = i + 1; j < keys.size(); ++j) {
+            ASSERT_EQ(keys[i] == keys[j], interned[i] == interned[j]);
+        }
+    }
+    ASSERT_EQ(sstr_intern_find(pool, "absent", 6), (sstr_t)NULL);
+
+    // a dup is a private, mutable copy
+    sstr_t d = sstr_dup(interned.back());
+    sstr_append_cstr(d, "!");
+    ASSERT_EQ(sstr_length(interned.back()), 3U);
+    ASSERT_EQ(sstr_length(d), 4U);
+    sstr_free(d);
+
+    sstr_intern_destroy(pool);
+}
+
+TEST(intern, stats) {
+    sstr_intern_t* pool = sstr_intern_create(4);
+    sstr_intern_stats_t st;
+    size_t bytes = 0;
+
+    sstr_intern_stats(pool, &st);
+    ASSERT_EQ(st.count, 0U);
+    ASSERT_EQ(st.bytes, 0U);
+    size_t empty_memory = st.memory;
+    ASSERT_GT(empty_memory, 0U);
+
+    for (int i = 0; i < 10000; ++i) {
+        std::string k = "metric." + std::to_string(i % 2500);
+        if (i < 2500) {
+            bytes += k.size();
+        }
+        sstr_intern_of(pool, k.data(), k.size());
+    }
+    sstr_intern_stats(pool, &st);
+    ASSERT_EQ(st.count, 2500U);
+    ASSERT_EQ(st.bytes, bytes);
+    ASSERT_GT(st.memory, empty_memory + bytes);
+
+    sstr_intern_destroy(pool);
+}
+
+TEST(intern, threads) {
+    sstr_intern_t* pool = sstr_intern_create(0);
+    const int nthreads = 8, nkeys = 5000;
+    std::vector<std::vector<sstr_t>> got(nthreads,
+                                         std::vector<sstr_t>(nkeys));
+    std::vector<std::thread> threads;
+
+    // every thread interns the same keys in a different order
+    for (int t = 0; t < nthreads; ++t) {
+        threads.emplace_back([pool, t, &got] {
+            for (int i = 0; i < nkeys; ++i) {
+                int k = (i * 7 + t * 613) % nkeys;
+                std::string key = "host-" + std::to_string(k) + ".example";
+                got[t][k] = sstr_intern_of(pool, key.data(), key.size());
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    for (int k = 0; k < nkeys; ++k) {
+        std::string key = "host-" + std::to_string(k) + ".example";
+        ASSERT_STREQ(sstr_cstr(got[0][k]), key.c_str());
+        for (int t = 1; t < nthreads; ++t) {
+            ASSERT_EQ(got[t][k], got[0][k]);
+        }
+    }
+    sstr_intern_stats_t st;
+    sstr_intern_stats(pool, &st);
+    ASSERT_EQ(st.count, (size_t)nkeys);
+
+    sstr_intern_destroy(pool);
+}
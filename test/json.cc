@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+#include <random>
+#include <string>
+
+#include "sstr.h"
+
+// the escaping rules spelled out one byte at a time.
+static std::string json_escape_ref(const std::string& in) {
+    std::string out;
+    char tmp[8];
+    for (unsigned char c : in) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (c <= 31) {
+                    snprintf(tmp, sizeof(tmp), "\\u%04x", c);
+                    out += tmp;
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    return out;
+}
+
+TEST(json, escape) {
+    std::mt19937 rng(3);
+    for (int len = 0; len < 300; ++len) {
+        // sparse and dense escapes, at every offset of the 16/32 byte blocks
+        for (int density : {0, 2, 50}) {
+            std::string in;
+            for (int i = 0; i < len; ++i) {
+                if (density && (int)(rng() % 100) < density) {
+                    in += (char)(rng() % 2 ? rng() % 32 : "\"\\"[rng() % 2]);
+                } else {
+                    in += (char)(32 + rng() % 224);
+                }
+            }
+            sstr_t s = sstr_of(in.data(), in.size());
+            sstr_t out = sstr("prefix");
+            sstr_json_escape_string_append(out, s);
+            std::string expect = "prefix" + json_escape_ref(in);
+            ASSERT_EQ(sstr_length(out), expect.size());
+            ASSERT_EQ(memcmp(sstr_cstr(out), expect.data(), expect.size()), 0);
+            ASSERT_EQ(sstr_cstr(out)[expect.size()], '\0');
+
+            sstr_t back = sstr_new();
+            ASSERT_EQ(sstr_json_unescape_string_append(back, out), 0);
+            ASSERT_EQ(sstr_length(back), in.size() + 6);
+            ASSERT_EQ(memcmp(sstr_cstr(back) + 6, in.data(), in.size()), 0);
+
+            sstr_free(s);
+            sstr_free(out);
+            sstr_free(back);
+        }
+    }
+
+    std::string all;
+    for (int c = 0; c < 256; ++c) {
+        all += (char)c;
+    }
+    sstr_t s = sstr_of(all.data(), all.size());
+    sstr_t out = sstr_new();
+    sstr_json_escape_string_append(out, s);
+    ASSERT_EQ(std::string(sstr_cstr(out), sstr_length(out)),
+              json_escape_ref(all));
+    sstr_free(s);
+    sstr_free(out);
+}
+
+TEST(json, unescape) {
+    const struct {
+        const char* in;
+        const char* expect;
+    } cases[] = {
+        {"plain", "plain"},
+        {"a\\\"b\\\\c\\/d", "a\"b\\c/d"},
+        {"\\b\\f\\n\\r\\t", "\b\f\n\r\t"},
+        {"\\u0041\\u00e9\\u20AC", "A\xc3\xa9\xe2\x82\xac"},
+        {"\\ud83d\\ude00!", "\xf0\x9f\x98\x80!"},
+        {"\\ud83d", "\xef\xbf\xbd"},
+        {"\\ude00x", "\xef\xbf\xbdx"},
+        {"\\ud83d\\u0041", "\xef\xbf\xbd" "A"},
+    };
+    for (const auto& c : cases) {
+        sstr_t in = sstr(c.in);
+        sstr_t out = sstr_new();
+        ASSERT_EQ(sstr_json_unescape_string_append(out, in), 0) << c.in;
+        ASSERT_STREQ(sstr_cstr(out), c.expect) << c.in;
+        sstr_free(in);
+        sstr_free(out);
+    }
+
+    const char* invalid[] = {"\\", "abc\\", "\\x", "\\u12", "\\u12g4"};
+    for (const char* bad : invalid) {
+        sstr_t in = sstr(bad);
+        sstr_t out = sstr("kept");
+        ASSERT_EQ(sstr_json_unescape_string_append(out, in), -1) << bad;
+        ASSERT_STREQ(sstr_cstr(out), "kept");
+        ASSERT_EQ(sstr_length(out), 4U);
+        sstr_free(in);
+        sstr_free(out);
+    }
+}
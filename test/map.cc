@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <unordered_map>
+
+#include "sstr.h"
+
+std::string gen_random(const int len);
+
+// keys around the short/long boundary, plus binary ones.
+static std::string map_key(std::mt19937& rng, int universe) {
+    int k = (int)(rng() % universe);
+    std::string s = "k" + std::to_string(k);
+    if (k % 3 == 0) {
+        s += std::string(SHORT_STR_CAPACITY, 'x');
+    } else if (k % 7 == 0) {
+        s += std::string("\0\1", 2);
+    }
+    return s;
+}
+
+TEST(map, against_unordered_map) {
+    std::mt19937 rng(5);
+    sstr_map_t* m = sstr_map_create(0);
+    std::unordered_map<std::string, void*> expect;
+
+    for (int i = 0; i < 200000; ++i) {
+        // the universe shrinks and grows again, so the table both fills up
+        // with tombstones and rehashes
+        int universe = i < 100000 ? 20000 : 200 + i % 5000;
+        std::string k = map_key(rng, universe);
+        switch (rng() % 4) {
+            case 0:
+            case 1: {
+                void* v = (void*)(uintptr_t)(i + 1);
+                *sstr_map_insert_of(m, k.data(), k.size()) = v;
+                expect[k] = v;
+                break;
+            }
+            case 2: {
+                int erased = sstr_map_erase_of(m, k.data(), k.size());
+                ASSERT_EQ(erased, (int)expect.erase(k));
+                break;
+            }
+            default: {
+                void** v = sstr_map_find_of(m, k.data(), k.size());
+                auto it = expect.find(k);
+                if (it == expect.end()) {
+                    ASSERT_EQ(v, (void**)NULL) << k;
+                } else {
+                    ASSERT_NE(v, (void**)NULL) << k;
+                    ASSERT_EQ(*v, it->second);
+                }
+            }
+        }
+        ASSERT_EQ(sstr_map_size(m), expect.size());
+    }
+
+    size_t it = 0, n = 0;
+    void* v;
+    sstr_t k;
+    while ((k = sstr_map_next(m, &it, &v)) != NULL) {
+        std::string key(sstr_cstr(k), sstr_length(k));
+        ASSERT_EQ(expect.at(key), v);
+        ++n;
+    }
+    ASSERT_EQ(n, expect.size());
+    sstr_map_destroy(m);
+}
+
+TEST(map, sstr_keys) {
+    sstr_map_t* m = sstr_map_create(1000);
+    sstr_t short_key = sstr("host");
+    sstr_t long_key = sstr_of(gen_random(100).data(), 100);
+
+    ASSERT_EQ(sstr_map_find(m, short_key), (void**)NULL);
+    void** v = sstr_map_insert(m, short_key);
+    ASSERT_EQ(*v, (void*)NULL);
+    *v = short_key;
+    *sstr_map_insert(m, long_key) = long_key;
+    ASSERT_EQ(*sstr_map_insert(m, short_key), (void*)short_key);
+
+    // the map keeps copies, the lookup key may be changed or freed
+    ASSERT_EQ(*sstr_map_find_of(m, sstr_cstr(long_key), 100),
+              (void*)long_key);
+    sstr_append_cstr(long_key, "!");
+    ASSERT_EQ(sstr_map_find(m, long_key), (void**)NULL);
+    ASSERT_EQ(sstr_map_erase(m, long_key), 0);
+    ASSERT_EQ(sstr_map_erase_of(m, sstr_cstr(long_key), 100), 1);
+    ASSERT_EQ(sstr_map_size(m), 1U);
+
+    sstr_t empty = sstr_new();
+    *sstr_map_insert(m, empty) = empty;
+    ASSERT_EQ(*sstr_map_find_of(m, "", 0), (void*)empty);
+    ASSERT_EQ(sstr_map_size(m), 2U);
+
+    sstr_free(short_key);
+    sstr_free(long_key);
+    sstr_free(empty);
+    sstr_map_destroy(m);
+}
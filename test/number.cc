@@ -0,0 +1,398 @@
+#include <gtest/gtest.h>
+#include <float.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "sstr.h"
+
+// every power of ten, its neighbours and the type limits, the values the
+// digit counting and pair table are most likely to get wrong.
+static std::vector<long> edge_values() {
+    std::vector<long> v = {0, 1, -1, 9, -9, LONG_MAX, LONG_MIN, INT_MAX,
+                           INT_MIN};
+    // 10^0 to 10^18, stopping before the next power overflows
+    for (long p = 1;; p *= 10) {
+        v.push_back(p - 1);
+        v.push_back(p);
+        v.push_back(p + 1);
+        v.push_back(-p);
+        if (p > LONG_MAX / 10) {
+            break;
+        }
+    }
+    return v;
+}
+
+TEST(number, append_long_str) {
+    char buf[64];
+    std::mt19937_64 rng(42);
+    std::vector<long> values = edge_values();
+    for (int i = 0; i < 10000; ++i) {
+        // log-uniform, so every digit count is covered
+        values.push_back((long)(rng() >> (rng() % 64)));
+    }
+
+    sstr_t s = sstr_new();
+    for (long v : values) {
+        sstr_clear(s);
+        sstr_append_long_str(s, v);
+        snprintf(buf, sizeof(buf), "%ld", v);
+        ASSERT_STREQ(sstr_cstr(s), buf);
+        ASSERT_EQ(sstr_length(s), strlen(buf));
+    }
+    sstr_free(s);
+}
+
+TEST(number, append_int_str) {
+    char buf[64];
+    std::vector<long> values = edge_values();
+    sstr_t s = sstr("prefix:");
+    std::string expect = "prefix:";
+    for (long v : values) {
+        int i = (int)v;
+        if ((long)i != v) {
+            continue;
+        }
+        sstr_append_int_str(s, i);
+        snprintf(buf, sizeof(buf), "%d,", i);
+        sstr_append_of(s, ",", 1);
+        expect += buf;
+    }
+    ASSERT_STREQ(sstr_cstr(s), expect.c_str());
+    ASSERT_EQ(sstr_length(s), expect.size());
+    sstr_free(s);
+}
+
+// the width pads the digits only, a minus sign is written in front of the
+// padding: %08l of -5 is "-00000005".
+TEST(number, printf_padding) {
+    char buf[256];
+    std::vector<long> values = edge_values();
+    for (long v : values) {
+        unsigned long u = v < 0 ? 0UL - (unsigned long)v : (unsigned long)v;
+        const char* sign = v < 0 ? "-" : "";
+        sstr_t s = sstr_printf("%l|%08l|%24l|%4l|%ul|%020ul", v, v, v, v,
+                               (unsigned long)v, (unsigned long)v);
+        snprintf(buf, sizeof(buf), "%ld|%s%08lu|%s%24lu|%s%4lu|%lu|%020lu", v,
+                 sign, u, sign, u, sign, u, (unsigned long)v,
+                 (unsigned long)v);
+        ASSERT_STREQ(sstr_cstr(s), buf) << v;
+        sstr_free(s);
+    }
+}
+
+static double random_double(std::mt19937_64& rng) {
+    double f;
+    do {
+        uint64_t bits = rng();
+        memcpy(&f, &bits, sizeof(f));
+    } while (std::isnan(f));
+    return f;
+}
+
+TEST(number, fixed_like_glibc) {
+    char fmt[16], buf[2048];
+    std::mt19937_64 rng(7);
+    std::vector<double> values = {0.0,   -0.0,    0.5,    1.5,     2.5,
+                                  0.125, 9.9995,  99.5,   0.05,    1e22,
+                                  5e-324, DBL_MAX, DBL_MIN, 0.1,   1e-7,
+                                  INFINITY, -INFINITY};
+    for (int i = 0; i < 20000; ++i) {
+        values.push_back(random_double(rng));
+        // short decimals, where ties and carries are common
+        values.push_back((double)(long)(rng() % 2000000 - 1000000) /
+                         (double)(1 << (rng() % 16)));
+    }
+
+    for (double f : values) {
+        int prec = (int)(rng() % 30);
+        snprintf(fmt, sizeof(fmt), "%%.%df", prec);
+        snprintf(buf, sizeof(buf), fmt, f);
+        sstr_t s = sstr_printf(fmt, f);
+        ASSERT_STREQ(sstr_cstr(s), buf) << fmt;
+        sstr_free(s);
+    }
+
+    // every digit of the smallest subnormal
+    snprintf(buf, sizeof(buf), "%.1100f", 5e-324);
+    sstr_t s = sstr_printf("%.1100f", 5e-324);
+    ASSERT_STREQ(sstr_cstr(s), buf);
+    sstr_free(s);
+}
+
+TEST(number, fixed_padding_and_trim) {
+    sstr_t s = sstr_printf("%f|%f|%.2f|%08.3f|%6.1f|%f|%f|%.0f|%03.1f", 1.0,
+                           2.5, 9.999, -3.14159, 99.96, NAN, -INFINITY, 0.5,
+                           -0.0);
+    ASSERT_STREQ(sstr_cstr(s),
+                 "1|2.5|10.00|-00000003.142|   100.0|nan|-inf|0|-000.0");
+    sstr_free(s);
+
+    s = sstr_new();
+    sstr_append_double_str(s, 1234.5678, 2);
+    sstr_append_of(s, " ", 1);
+    sstr_append_double_str(s, 3.0, 6);
+    sstr_append_of(s, " ", 1);
+    sstr_append_double_str(s, 1e30, 1);
+    ASSERT_STREQ(sstr_cstr(s), "1234.57 3 1000000000000000019884624838656");
+    sstr_free(s);
+}
+
+// the number of significant digits of a shortest form, from the first to the
+// last non-zero one.
+static int shortest_digits(const char* s) {
+    int n = 0, last = 0;
+    for (; *s && *s != 'e'; ++s) {
+        if (*s >= '0' && *s <= '9' && (n || *s != '0')) {
+            n++;
+            if (*s != '0') {
+                last = n;
+            }
+        }
+    }
+    return last;
+}
+
+TEST(number, shortest_round_trip) {
+    char buf[64];
+    std::mt19937_64 rng(11);
+    sstr_t s = sstr_new();
+    for (int i = 0; i < 200000; ++i) {
+        double f = random_double(rng);
+        if (i % 2) {
+            f = (double)(long)(rng() % 2000000) / std::pow(10, rng() % 12);
+        }
+        sstr_clear(s);
+        sstr_append_double_shortest(s, f);
+        double r = strtod(sstr_cstr(s), NULL);
+        ASSERT_EQ(memcmp(&r, &f, sizeof(f)), 0) << sstr_cstr(s);
+        ASSERT_LE(sstr_length(s), 25U);  // -0.00000 and 17 digits
+
+        // one digit less, correctly rounded, does not read back
+        int n = shortest_digits(sstr_cstr(s));
+        if (n > 1) {
+            snprintf(buf, sizeof(buf), "%.*e", n - 2, f);
+            ASSERT_NE(strtod(buf, NULL), f) << sstr_cstr(s);
+        }
+    }
+    sstr_free(s);
+}
+
+TEST(number, shortest_forms) {
+    const struct {
+        double f;
+        const char* expect;
+    } cases[] = {
+        {0.0, "0"},
+        {-0.0, "-0"},
+        {0.1, "0.1"},
+        {100.0, "100"},
+        {123.456, "123.456"},
+        {2.0 / 3, "0.6666666666666666"},
+        // Grisu2 prints more digits than needed for these
+        {0.22437, "0.22437"},
+        {0.0786759, "0.0786759"},
+        {1.6579e-05, "0.000016579"},
+        {1e-6, "0.000001"},
+        {1.5e-7, "1.5e-7"},
+        {1e20, "100000000000000000000"},
+        {1e21, "1e+21"},
+        {5e-324, "5e-324"},
+        {DBL_MAX, "1.7976931348623157e+308"},
+        {NAN, "nan"},
+        {-INFINITY, "-inf"},
+    };
+    for (const auto& c : cases) {
+        sstr_t s = sstr_new();
+        sstr_append_double_shortest(s, c.f);
+        ASSERT_STREQ(sstr_cstr(s), c.expect);
+        sstr_clear(s);
+        sstr_append_double_str(s, c.f, -1);
+        ASSERT_STREQ(sstr_cstr(s), c.expect);
+        sstr_free(s);
+    }
+}
+
+TEST(number, parse_integers) {
+    const struct {
+        const char* in;
+        int rc;
+        int64_t v;
+        size_t consumed;
+    } cases[] = {
+        {"0", SSTR_PARSE_OK, 0, 1},
+        {"  +42abc", SSTR_PARSE_OK, 42, 5},
+        {"\t-17 ", SSTR_PARSE_OK, -17, 4},
+        {"12345678901234567", SSTR_PARSE_OK, 12345678901234567LL, 17},
+        {"9223372036854775807", SSTR_PARSE_OK, INT64_MAX, 19},
+        {"-9223372036854775808", SSTR_PARSE_OK, INT64_MIN, 20},
+        {"9223372036854775808", SSTR_PARSE_RANGE, INT64_MAX, 19},
+        {"-99999999999999999999999", SSTR_PARSE_RANGE, INT64_MIN, 24},
+        {"000000000000000000000000123", SSTR_PARSE_OK, 123, 27},
+        {"", SSTR_PARSE_INVALID, 0, 0},
+        {"   ", SSTR_PARSE_INVALID, 0, 0},
+        {"-", SSTR_PARSE_INVALID, 0, 0},
+        {"x1", SSTR_PARSE_INVALID, 0, 0},
+    };
+    for (const auto& c : cases) {
+        int64_t v = -1;
+        size_t n = 99;
+        ASSERT_EQ(sstr_parse_i64_of(c.in, strlen(c.in), &v, &n), c.rc) << c.in;
+        ASSERT_EQ(v, c.v) << c.in;
+        ASSERT_EQ(n, c.consumed) << c.in;
+    }
+
+    uint64_t u64;
+    ASSERT_EQ(sstr_parse_u64_of("18446744073709551615", 20, &u64, NULL),
+              SSTR_PARSE_OK);
+    ASSERT_EQ(u64, UINT64_MAX);
+    ASSERT_EQ(sstr_parse_u64_of("18446744073709551616", 20, &u64, NULL),
+              SSTR_PARSE_RANGE);
+    ASSERT_EQ(u64, UINT64_MAX);
+    ASSERT_EQ(sstr_parse_u64_of("-1", 2, &u64, NULL), SSTR_PARSE_RANGE);
+    ASSERT_EQ(sstr_parse_u64_of("-0", 2, &u64, NULL), SSTR_PARSE_OK);
+
+    int32_t i32;
+    uint32_t u32;
+    ASSERT_EQ(sstr_parse_i32_of("-2147483648", 11, &i32, NULL), SSTR_PARSE_OK);
+    ASSERT_EQ(i32, INT32_MIN);
+    ASSERT_EQ(sstr_parse_i32_of("2147483648", 10, &i32, NULL),
+              SSTR_PARSE_RANGE);
+    ASSERT_EQ(i32, INT32_MAX);
+    ASSERT_EQ(sstr_parse_u32_of("4294967296", 10, &u32, NULL),
+              SSTR_PARSE_RANGE);
+    ASSERT_EQ(u32, UINT32_MAX);
+
+    // the length bounds the input, the bytes after it are not read
+    int64_t v;
+    size_t n;
+    ASSERT_EQ(sstr_parse_i64_of("123456789", 4, &v, &n), SSTR_PARSE_OK);
+    ASSERT_EQ(v, 1234);
+    ASSERT_EQ(n, 4U);
+
+    sstr_t s = sstr("  -2048 bytes");
+    ASSERT_EQ(sstr_parse_i64(s, &v, &n), SSTR_PARSE_OK);
+    ASSERT_EQ(v, -2048);
+    ASSERT_EQ(n, 7U);
+    long l;
+    int i;
+    ASSERT_EQ(sstr_parse_long(s, &l), 7);
+    ASSERT_EQ(l, -2048);
+    ASSERT_EQ(sstr_parse_int(s, &i), 7);
+    ASSERT_EQ(i, -2048);
+    sstr_free(s);
+}
+
+TEST(number, parse_integers_random) {
+    std::mt19937_64 rng(5);
+    char buf[64];
+    for (int i = 0; i < 100000; ++i) {
+        int64_t expect = (int64_t)(rng() >> (rng() % 64));
+        if (rng() & 1) {
+            expect = -expect;
+        }
+        int len = snprintf(buf, sizeof(buf), "%ld ", (long)expect);
+        int64_t v;
+        size_t n;
+        ASSERT_EQ(sstr_parse_i64_of(buf, len, &v, &n), SSTR_PARSE_OK);
+        ASSERT_EQ(v, expect);
+        ASSERT_EQ(n, (size_t)len - 1);
+    }
+}
+
+TEST(number, parse_double) {
+    const struct {
+        const char* in;
+        int rc;
+        double v;
+        size_t consumed;
+    } cases[] = {
+        {"0", SSTR_PARSE_OK, 0.0, 1},
+        {"  -12.5e3x", SSTR_PARSE_OK, -12500.0, 9},
+        {".5", SSTR_PARSE_OK, 0.5, 2},
+        {"1.", SSTR_PARSE_OK, 1.0, 2},
+        {"1e", SSTR_PARSE_OK, 1.0, 1},
+        {"1e+", SSTR_PARSE_OK, 1.0, 1},
+        {"0.1", SSTR_PARSE_OK, 0.1, 3},
+        {"9007199254740993", SSTR_PARSE_OK, 9007199254740992.0, 16},
+        {"1.7976931348623157e308", SSTR_PARSE_OK, DBL_MAX, 22},
+        {"4.9e-324", SSTR_PARSE_OK, 5e-324, 8},
+        {"2.2250738585072011e-308", SSTR_PARSE_OK, 2.2250738585072011e-308,
+         23},
+        {"1e400", SSTR_PARSE_RANGE, INFINITY, 5},
+        {"-1e-400", SSTR_PARSE_RANGE, -0.0, 7},
+        {"-Infinity", SSTR_PARSE_OK, -INFINITY, 9},
+        {"infx", SSTR_PARSE_OK, INFINITY, 3},
+        {"", SSTR_PARSE_INVALID, 0.0, 0},
+        {".e1", SSTR_PARSE_INVALID, 0.0, 0},
+        {"-", SSTR_PARSE_INVALID, 0.0, 0},
+    };
+    for (const auto& c : cases) {
+        double v = -1;
+        size_t n = 99;
+        ASSERT_EQ(sstr_parse_f64_of(c.in, strlen(c.in), &v, &n), c.rc) << c.in;
+        ASSERT_EQ(memcmp(&v, &c.v, sizeof(v)), 0) << c.in << " " << v;
+        ASSERT_EQ(n, c.consumed) << c.in;
+    }
+
+    double v;
+    ASSERT_EQ(sstr_parse_f64_of("nan", 3, &v, NULL), SSTR_PARSE_OK);
+    ASSERT_TRUE(std::isnan(v));
+
+    // halfway between two doubles only the 40th digit decides
+    const char* halfway = "9007199254740993.000000000000000000000001";
+    ASSERT_EQ(sstr_parse_f64_of(halfway, strlen(halfway), &v, NULL),
+              SSTR_PARSE_OK);
+    ASSERT_EQ(v, 9007199254740994.0);
+}
+
+// the shortest and the %.17g forms of random doubles read back exactly, and
+// every other input agrees with strtod.
+TEST(number, parse_double_like_strtod) {
+    std::mt19937_64 rng(13);
+    char buf[1024];
+    sstr_t s = sstr_new();
+    for (int i = 0; i < 100000; ++i) {
+        double f = random_double(rng);
+        sstr_clear(s);
+        sstr_append_double_shortest(s, f);
+        double v;
+        size_t n;
+        ASSERT_EQ(sstr_parse_f64(s, &v, &n), SSTR_PARSE_OK);
+        ASSERT_EQ(memcmp(&v, &f, sizeof(v)), 0) << sstr_cstr(s);
+        ASSERT_EQ(n, sstr_length(s));
+
+        // random digit strings, long ones included
+        int len = 0, digits = (int)(rng() % (i % 100 ? 30 : 800)) + 1;
+        int dot = (int)(rng() % (digits + 1));
+        for (int j = 0; j < digits; ++j) {
+            if (j == dot) {
+                buf[len++] = '.';
+            }
+            buf[len++] = (char)('0' + rng() % 10);
+        }
+        len += snprintf(buf + len, sizeof(buf) - len, "e%d",
+                        (int)(rng() % 700) - 350);
+        char* end;
+        double expect = strtod(buf, &end);
+        ASSERT_EQ(sstr_parse_f64_of(buf, len, &v, &n) == SSTR_PARSE_INVALID,
+                  end == buf);
+        ASSERT_EQ(memcmp(&v, &expect, sizeof(v)), 0) << buf;
+        ASSERT_EQ(n, (size_t)(end - buf)) << buf;
+    }
+    sstr_free(s);
+
+    // the locale decimal point is never looked at
+    s = sstr("3.25");
+    double v;
+    ASSERT_EQ(sstr_parse_double(s, &v), 4);
+    ASSERT_EQ(v, 3.25);
+    sstr_free(s);
+}
@@ -81,11 +81,8 @@ TEST(printf, float) {
         sstr_t r = sstr_printf("thisis%.10ffloat", f);
         char tmp[1000];
         snprintf(tmp, sizeof(tmp), "thisis%.10ffloat", f);
-        // printf("%.10f--%s\n", f, sstr_cstr(r));
-        /* TODO: compare round
         ASSERT_EQ(sstr_compare_c(r, tmp), 0)
             << "f:" << f << " tmp:" << tmp << " r:" << sstr_cstr(r) << endl;
-            */
         sstr_free(r);
     }
     for (long i = 0; i < 10000; ++i) {
@@ -93,11 +90,8 @@ TEST(printf, float) {
         sstr_t r = sstr_printf("thisis%.10ffloat", f);
         char tmp[1000];
         snprintf(tmp, sizeof(tmp), "thisis%.10ffloat", f);
-        // printf("%.10f--%s\n", f, sstr_cstr(r));
-        /* TODO: compare round
         ASSERT_EQ(sstr_compare_c(r, tmp), 0)
             << "f:" << f << " tmp:" << tmp << " r:" << sstr_cstr(r) << endl;
-            */
         sstr_free(r);
     }
 }
@@ -112,3 +106,23 @@ TEST(printf, sstr) {
         sstr_free(ss);
     }
 }
+
+TEST(printf, directives) {
+    sstr_t s = sstr("sstr");
+    sstr_t r = sstr_printf("[%5d|%05d|%ux|%Xd|%uL|%xabc|%*s|%S|%xS|%c%%]", -42,
+                           42, 255u, 255u, (uint64_t)1 << 40, 10u, (size_t)3,
+                           "abcdef", s, s, 'z');
+    ASSERT_EQ(sstr_compare_c(
+                  r, "[-   42|00042|ff|FF|1099511627776|aabc|abc|sstr|"
+                     "73737472|z%]"),
+              0)
+        << sstr_cstr(r);
+    sstr_free(r);
+
+    // appending keeps the existing content, %Z embeds a null character.
+    r = sstr_printf_append(s, "%Z%N%s", "tail");
+    ASSERT_EQ(r, s);
+    ASSERT_EQ(sstr_length(s), 10u);
+    ASSERT_EQ(memcmp(sstr_cstr(s), "sstr\0\ntail", 11), 0);
+    sstr_free(s);
+}
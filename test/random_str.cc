@@ -1,5 +1,7 @@
 #include <string>
 
+#include "sstr.h"
+
 std::string gen_random(const int len) {
     static const char alphanum[] =
         "0123456789"
@@ -15,3 +17,8 @@ std::string gen_random(const int len) {
 
     return tmp_s;
 }
+
+// the bytes of s, embedded zeros included.
+std::string str_of(sstr_t s) {
+    return std::string(sstr_cstr(s), sstr_length(s));
+}
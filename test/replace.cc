@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include "sstr.h"
+
+std::string gen_random(const int len);
+std::string str_of(sstr_t s);
+
+static std::string replace_all(std::string s, const std::string& needle,
+                               const std::string& replacement) {
+    size_t pos = 0;
+    while ((pos = s.find(needle, pos)) != std::string::npos) {
+        s.replace(pos, needle.size(), replacement);
+        pos += replacement.size();
+    }
+    return s;
+}
+
+TEST(replace, insert_erase) {
+    std::mt19937 rng(23);
+    sstr_t s = sstr_new();
+    std::string expect;
+
+    for (int i = 0; i < 5000; ++i) {
+        size_t pos = rng() % (expect.size() + 5);
+        size_t at = std::min(pos, expect.size());
+        size_t len = rng() % 4 == 0 ? rng() % 500 : rng() % 10;
+        if (rng() % 3 == 0) {
+            sstr_erase(s, pos, len);
+            expect.erase(at, len);
+        } else {
+            std::string in = gen_random(len);
+            sstr_insert_of(s, pos, in.data(), in.size());
+            expect.insert(at, in);
+        }
+        ASSERT_EQ(str_of(s), expect);
+        ASSERT_EQ(sstr_cstr(s)[expect.size()], '\0');
+        // shrink back once in a while, through the short layout too
+        if (expect.size() > 20000) {
+            sstr_erase(s, 10, expect.size());
+            expect.erase(10);
+        }
+    }
+    sstr_free(s);
+}
+
+TEST(replace, insert_shared_and_self) {
+    std::string text = gen_random(300);
+    sstr_t s = sstr_of(text.data(), text.size());
+    sstr_t d = sstr_dup(s);
+
+    // a shared buffer is copied once, with the gap already in place
+    sstr_insert_of(d, 100, "abc", 3);
+    ASSERT_EQ(str_of(d), text.substr(0, 100) + "abc" + text.substr(100));
+    ASSERT_EQ(str_of(s), text);
+    sstr_erase(s, 0, 50);
+    ASSERT_EQ(str_of(s), text.substr(50));
+    sstr_free(d);
+
+    // a part of the string itself, before and across the insert position
+    text = text.substr(50);
+    sstr_insert_of(s, 10, sstr_cstr(s) + 5, 20);
+    text.insert(10, text.substr(5, 20));
+    ASSERT_EQ(str_of(s), text);
+    sstr_insert(s, 0, s);
+    ASSERT_EQ(str_of(s), text + text);
+    sstr_free(s);
+
+    sstr_t h = sstr("hello");
+    sstr_insert(h, 2, h);
+    ASSERT_STREQ(sstr_cstr(h), "hehellollo");
+    sstr_erase(h, 3, 100);
+    ASSERT_STREQ(sstr_cstr(h), "heh");
+    sstr_erase(h, 3, 1);
+    sstr_insert_of(h, 100, "!", 1);
+    ASSERT_STREQ(sstr_cstr(h), "heh!");
+    sstr_free(h);
+}
+
+TEST(replace, replace_all) {
+    std::mt19937 rng(24);
+    const char* needles[] = {"a", "ab", "aba", "{{x}}", "zz"};
+    const char* replacements[] = {"", "b", "XY", "{{x}}", "a much longer one"};
+
+    for (int i = 0; i < 3000; ++i) {
+        std::string text;
+        int len = i % 10 == 0 ? rng() % 3000 : rng() % 40;
+        for (int j = 0; j < len; ++j) {
+            text += "ab{x}z"[rng() % 6];
+        }
+        std::string n = needles[rng() % 5], r = replacements[rng() % 5];
+        std::string expect = replace_all(text, n, r);
+        size_t count = 0;
+        for (size_t p = text.find(n); p != std::string::npos;
+             p = text.find(n, p + n.size())) {
+            ++count;
+        }
+
+        sstr_t s = sstr_of(text.data(), text.size());
+        sstr_t dup = i % 3 == 0 ? sstr_dup(s) : NULL;
+        ASSERT_EQ(sstr_replace_all_of(s, n.data(), n.size(), r.data(),
+                                      r.size()),
+                  count);
+        ASSERT_EQ(str_of(s), expect) << text << " " << n << " " << r;
+        ASSERT_EQ(sstr_cstr(s)[expect.size()], '\0');
+        if (dup) {
+            ASSERT_EQ(str_of(dup), text);
+            sstr_free(dup);
+        }
+        sstr_free(s);
+    }
+}
+
+TEST(replace, replace_all_sizes) {
+    std::string text;
+    for (int i = 0; i < 1000; ++i) {
+        text += "Dear {{name}}, ";
+    }
+    sstr_t s = sstr_of(text.data(), text.size());
+    sstr_t needle = sstr("{{name}}");
+    sstr_t longer = sstr("Alexander Hamilton");
+
+    // a longer result gets a buffer of the exact length
+    ASSERT_EQ(sstr_replace_all(s, needle, longer), 1000U);
+    ASSERT_EQ(sstr_length(s), 1000U * 25);
+    ASSERT_EQ(sstr_capacity(s), sstr_length(s));
+    ASSERT_EQ(str_of(s).substr(0, 35), "Dear Alexander Hamilton, Dear Alexa");
+
+    // a shorter one is written in place
+    const char* before = sstr_cstr(s);
+    ASSERT_EQ(sstr_replace_all_of(s, "Alexander Hamilton", 18, "Al", 2),
+              1000U);
+    ASSERT_EQ(sstr_cstr(s), before);
+    ASSERT_EQ(str_of(s).substr(0, 18), "Dear Al, Dear Al, ");
+
+    // nothing to do for an empty or absent needle
+    ASSERT_EQ(sstr_replace_all_of(s, "", 0, "x", 1), 0U);
+    ASSERT_EQ(sstr_replace_all_of(s, "nope", 4, "x", 1), 0U);
+    ASSERT_EQ(sstr_length(s), 1000U * 9);
+
+    // the needle and the replacement may be parts of s
+    sstr_t t = sstr("abcabc");
+    ASSERT_EQ(sstr_replace_all_of(t, sstr_cstr(t), 3, sstr_cstr(t) + 4, 1),
+              2U);
+    ASSERT_STREQ(sstr_cstr(t), "bb");
+    sstr_free(t);
+
+    sstr_free(s);
+    sstr_free(needle);
+    sstr_free(longer);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include "sstr.h"
+
+std::string gen_random(const int len);
+
+static std::string rope_string(sstr_rope_t* r) {
+    std::string out;
+    size_t n;
+    for (size_t i = 0; i < sstr_rope_length(r); i += n) {
+        const char* p = sstr_rope_chunk(r, i, &n);
+        EXPECT_GT(n, 0U);
+        out.append(p, n);
+    }
+    return out;
+}
+
+TEST(rope, against_string) {
+    std::mt19937 rng(22);
+    std::string base = gen_random(100000);
+    sstr_t s = sstr_of(base.data(), base.size());
+    sstr_rope_t* r = sstr_rope_from(s);
+    std::string expect = base;
+    size_t n;
+
+    // the long buffer is shared, not copied
+    ASSERT_EQ(sstr_rope_chunk(r, 10, &n), sstr_cstr(s) + 10);
+    ASSERT_EQ(n, base.size() - 10);
+    sstr_free(s);
+
+    for (int i = 0; i < 20000; ++i) {
+        size_t pos = rng() % (expect.size() + 10);
+        size_t len = rng() % 8 == 0 ? rng() % 3000 : rng() % 20;
+        size_t at = std::min(pos, expect.size());
+        switch (rng() % 5) {
+            case 0:
+            case 1: {
+                std::string in = gen_random(len);
+                sstr_rope_insert_of(r, pos, in.data(), in.size());
+                expect.insert(at, in);
+                break;
+            }
+            case 2: {
+                std::string in = gen_random(len + 40);
+                sstr_t t = sstr_of(in.data(), in.size());
+                sstr_rope_insert(r, pos, t);
+                sstr_free(t);
+                expect.insert(at, in);
+                break;
+            }
+            case 3:
+                sstr_rope_erase(r, pos, len);
+                expect.erase(at, len);
+                break;
+            default: {
+                ASSERT_EQ(sstr_rope_at(r, pos),
+                          pos < expect.size() ? (unsigned char)expect[pos]
+                                              : -1);
+                sstr_rope_t* sub = sstr_rope_substr(r, pos, len);
+                ASSERT_EQ(rope_string(sub), expect.substr(at, len));
+                sstr_rope_free(sub);
+            }
+        }
+        ASSERT_EQ(sstr_rope_length(r), expect.size());
+    }
+    ASSERT_EQ(rope_string(r), expect);
+
+    sstr_t flat = sstr_rope_flatten(r);
+    ASSERT_EQ(std::string(sstr_cstr(flat), sstr_length(flat)), expect);
+    ASSERT_EQ(sstr_capacity(flat), expect.size());
+    ASSERT_EQ(sstr_cstr(flat)[expect.size()], '\0');
+    sstr_free(flat);
+    sstr_rope_free(r);
+}
+
+TEST(rope, persistent) {
+    std::string text = gen_random(5000);
+    sstr_rope_t* r = sstr_rope_of(text.data(), text.size());
+    sstr_rope_t* copy = sstr_rope_dup(r);
+    sstr_rope_t* sub = sstr_rope_substr(r, 1000, 2000);
+
+    // edits of one rope leave the ropes sharing its nodes alone
+    sstr_rope_erase(r, 500, 3000);
+    sstr_rope_insert_rope(r, 500, sub);
+    sstr_rope_append_of(r, "end", 3);
+    ASSERT_EQ(rope_string(copy), text);
+    ASSERT_EQ(rope_string(sub), text.substr(1000, 2000));
+    ASSERT_EQ(rope_string(r), text.substr(0, 500) + text.substr(1000, 2000) +
+                                  text.substr(3500) + "end");
+
+    sstr_rope_free(r);
+    sstr_rope_free(sub);
+    sstr_rope_erase(copy, 0, 1000000);
+    ASSERT_EQ(sstr_rope_length(copy), 0U);
+    ASSERT_EQ(sstr_rope_at(copy, 0), -1);
+    sstr_rope_free(copy);
+}
+
+TEST(rope, flatten) {
+    sstr_rope_t* r = sstr_rope_new();
+    sstr_t flat = sstr_rope_flatten(r);
+    ASSERT_EQ(sstr_length(flat), 0U);
+    sstr_free(flat);
+
+    // typing one byte at a time is merged into a few chunks
+    std::string expect;
+    for (int i = 0; i < 1000; ++i) {
+        char c = (char)('a' + i % 26);
+        sstr_rope_insert_of(r, i / 2, &c, 1);
+        expect.insert(expect.begin() + i / 2, c);
+    }
+    size_t chunks = 0, n;
+    for (size_t i = 0; i < sstr_rope_length(r); i += n) {
+        sstr_rope_chunk(r, i, &n);
+        ++chunks;
+    }
+    ASSERT_LT(chunks, 20U);
+    flat = sstr_rope_flatten(r);
+    ASSERT_STREQ(sstr_cstr(flat), expect.c_str());
+    sstr_free(flat);
+    sstr_rope_free(r);
+
+    // a single long chunk is shared by the flat string
+    std::string text = gen_random(1000);
+    sstr_t s = sstr_of(text.data(), text.size());
+    r = sstr_rope_from(s);
+    flat = sstr_rope_flatten(r);
+    ASSERT_EQ(sstr_cstr(flat), sstr_cstr(s));
+    sstr_append_of(flat, "!", 1);
+    ASSERT_NE(sstr_cstr(flat), sstr_cstr(s));
+    ASSERT_EQ(rope_string(r), text);
+    sstr_free(flat);
+    sstr_free(s);
+    sstr_rope_free(r);
+}
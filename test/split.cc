@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sstr.h"
+
+static std::vector<std::string> split_all(sstr_t s, const std::string& delim,
+                                          int flags) {
+    std::vector<std::string> out;
+    sstr_split_t it;
+    sstr_t field;
+    sstr_split_init(&it, s, delim.data(), delim.size(), flags);
+    while ((field = sstr_split_next(&it)) != NULL) {
+        EXPECT_EQ(SSTR_TYPE_OF(field), SSTR_TYPE_REF);
+        out.push_back(std::string(sstr_cstr(field), sstr_length(field)));
+    }
+    // stays at the end
+    EXPECT_EQ(sstr_split_next(&it), (sstr_t)NULL);
+    return out;
+}
+
+// the fields as python's str.split(delim) finds them.
+static std::vector<std::string> split_ref(const std::string& s,
+                                          const std::string& delim,
+                                          int flags) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    for (;;) {
+        size_t end;
+        size_t step = 1;
+        if (delim.empty()) {
+            end = std::string::npos;
+        } else if (flags & SSTR_SPLIT_ANY_OF) {
+            end = s.find_first_of(delim, start);
+        } else {
+            end = s.find(delim, start);
+            step = delim.size();
+        }
+        std::string field = s.substr(start, end == std::string::npos
+                                                ? std::string::npos
+                                                : end - start);
+        if (!field.empty() || !(flags & SSTR_SPLIT_SKIP_EMPTY)) {
+            out.push_back(field);
+        }
+        if (end == std::string::npos) {
+            return out;
+        }
+        start = end + step;
+    }
+}
+
+TEST(split, simple) {
+    sstr_t s = sstr("a,,b,");
+    EXPECT_EQ(split_all(s, ",", 0),
+              (std::vector<std::string>{"a", "", "b", ""}));
+    EXPECT_EQ(split_all(s, ",", SSTR_SPLIT_SKIP_EMPTY),
+              (std::vector<std::string>{"a", "b"}));
+    EXPECT_EQ(split_all(s, "", 0), (std::vector<std::string>{"a,,b,"}));
+    sstr_free(s);
+
+    s = sstr("");
+    EXPECT_EQ(split_all(s, ",", 0), (std::vector<std::string>{""}));
+    EXPECT_EQ(split_all(s, ",", SSTR_SPLIT_SKIP_EMPTY),
+              (std::vector<std::string>{}));
+    sstr_free(s);
+
+    s = sstr("key: value\r\nhost: example.com\r\n\r\n");
+    EXPECT_EQ(split_all(s, "\r\n", SSTR_SPLIT_SKIP_EMPTY),
+              (std::vector<std::string>{"key: value", "host: example.com"}));
+    sstr_free(s);
+
+    // like strtok(): runs of any delimiter
+    s = sstr("  GET /index.html\tHTTP/1.1 ");
+    EXPECT_EQ(split_all(s, " \t", SSTR_SPLIT_ANY_OF | SSTR_SPLIT_SKIP_EMPTY),
+              (std::vector<std::string>{"GET", "/index.html", "HTTP/1.1"}));
+    sstr_free(s);
+
+    // embedded '\0' is a byte like others
+    s = sstr_of("a\0b\0\0c", 6);
+    EXPECT_EQ(split_all(s, std::string("\0", 1), 0),
+              (std::vector<std::string>{"a", "b", "", "c"}));
+    sstr_free(s);
+}
+
+TEST(split, like_reference) {
+    std::mt19937 rng(14);
+    const std::string delims[] = {",", ";,", "ab", "aba", ",\t;\n"};
+    for (int round = 0; round < 2000; ++round) {
+        std::string s;
+        size_t len = rng() % 120;
+        for (size_t i = 0; i < len; ++i) {
+            s += "ab,;\t\nxyz"[rng() % 9];
+        }
+        sstr_t ss = sstr_of(s.data(), s.size());
+        for (const std::string& d : delims) {
+            for (int flags = 0; flags < 4; ++flags) {
+                ASSERT_EQ(split_all(ss, d, flags), split_ref(s, d, flags))
+                    << s << " / " << d << " / " << flags;
+            }
+        }
+        sstr_free(ss);
+    }
+}
@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sstr.h"
+
+std::string str_of(sstr_t s);
+
+static void put_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += (char)cp;
+    } else if (cp < 0x800) {
+        out += (char)(0xC0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += (char)(0xE0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else {
+        out += (char)(0xF0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3F));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+static void put_utf16(std::vector<uint16_t>& out, uint32_t cp) {
+    if (cp < 0x10000) {
+        out.push_back((uint16_t)cp);
+    } else {
+        out.push_back((uint16_t)(0xD800 | ((cp - 0x10000) >> 10)));
+        out.push_back((uint16_t)(0xDC00 | ((cp - 0x10000) & 0x3FF)));
+    }
+}
+
+// mostly ASCII, or mostly 2, 3 and 4 byte codepoints, never surrogates.
+static uint32_t random_codepoint(std::mt19937& rng, bool ascii) {
+    if (ascii && rng() % 10) {
+        return rng() % 0x80;
+    }
+    switch (rng() % 4) {
+        case 0:
+            return rng() % 0x80;
+        case 1:
+            return 0x80 + rng() % (0x800 - 0x80);
+        case 2: {
+            uint32_t cp = 0x800 + rng() % (0x10000 - 0x800);
+            return cp >= 0xD800 && cp <= 0xDFFF ? cp - 0x800 : cp;
+        }
+        default:
+            return 0x10000 + rng() % (0x110000 - 0x10000);
+    }
+}
+
+// the well-formed byte sequences of the Unicode standard, table 3-7, one
+// codepoint at a time.
+static bool utf8_valid_ref(const std::string& s) {
+    size_t i = 0;
+    while (i < s.size()) {
+        unsigned char c = s[i];
+        size_t n;
+        unsigned char lo = 0x80, hi = 0xBF;
+        if (c < 0x80) {
+            i++;
+            continue;
+        } else if (c >= 0xC2 && c <= 0xDF) {
+            n = 1;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            n = 2;
+            lo = c == 0xE0 ? 0xA0 : 0x80;
+            hi = c == 0xED ? 0x9F : 0xBF;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            n = 3;
+            lo = c == 0xF0 ? 0x90 : 0x80;
+            hi = c == 0xF4 ? 0x8F : 0xBF;
+        } else {
+            return false;
+        }
+        for (size_t k = 1; k <= n; ++k) {
+            if (i + k >= s.size()) {
+                return false;
+            }
+            unsigned char b = s[i + k];
+            if (b < (k == 1 ? lo : 0x80) || b > (k == 1 ? hi : 0xBF)) {
+                return false;
+            }
+        }
+        i += n + 1;
+    }
+    return true;
+}
+
+TEST(utf8, valid) {
+    std::mt19937 rng(25);
+    for (int i = 0; i < 20000; ++i) {
+        // every offset of the 16 and 32 byte blocks, short and long runs
+        std::string s;
+        size_t target = i % 10 == 0 ? rng() % 2000 : rng() % 100;
+        bool ascii = rng() % 2;
+        size_t codepoints = 0;
+        while (s.size() < target) {
+            put_utf8(s, random_codepoint(rng, ascii));
+            codepoints++;
+        }
+        ASSERT_TRUE(sstr_utf8_valid_of(s.data(), s.size())) << i;
+        ASSERT_EQ(sstr_utf8_count_of(s.data(), s.size()), codepoints);
+
+        // one to three bytes replaced or dropped, anywhere
+        std::string bad = s;
+        for (int k = 1 + rng() % 3; k > 0 && !bad.empty(); --k) {
+            size_t at = rng() % bad.size();
+            if (rng() % 4 == 0) {
+                bad.erase(at, 1);
+            } else {
+                bad[at] = (char)(rng() % 2 ? rng() % 256 : 0x80 + rng() % 64);
+            }
+        }
+        ASSERT_EQ(sstr_utf8_valid_of(bad.data(), bad.size()),
+                  (int)utf8_valid_ref(bad))
+            << i;
+    }
+}
+
+TEST(utf8, invalid_forms) {
+    const char* bad[] = {
+        "\x80",              // continuation without lead
+        "a\xbf",             //
+        "\xc0\x80",          // overlong
+        "\xc1\xbf",          //
+        "\xe0\x80\x80",      //
+        "\xe0\x9f\xbf",      //
+        "\xf0\x80\x80\x80",  //
+        "\xf0\x8f\xbf\xbf",  //
+        "\xed\xa0\x80",      // surrogates
+        "\xed\xbf\xbf",      //
+        "\xf4\x90\x80\x80",  // above U+10FFFF
+        "\xf5\x80\x80\x80",  //
+        "\xff",              //
+        "\xc3",              // cut
+        "\xe2\x82",          //
+        "\xf0\x9f\x98",      //
+        "\xc3\xa9\xa9",      // extra continuation
+    };
+    const char* good[] = {"", "\x7f", "\xc2\x80", "\xdf\xbf", "\xe0\xa0\x80",
+                          "\xed\x9f\xbf", "\xee\x80\x80", "\xef\xbf\xbf",
+                          "\xf0\x90\x80\x80", "\xf4\x8f\xbf\xbf"};
+    for (const char* b : bad) {
+        std::string s = b;
+        // alone, and cut by or at the end of a block
+        for (size_t pad : {0, 14, 15, 29, 31, 40}) {
+            std::string t = std::string(pad, 'x') + s;
+            ASSERT_FALSE(sstr_utf8_valid_of(t.data(), t.size()))
+                << pad << " " << t;
+            t += std::string(40, 'y');
+            ASSERT_FALSE(sstr_utf8_valid_of(t.data(), t.size()))
+                << pad << " " << t;
+        }
+    }
+    for (const char* g : good) {
+        for (size_t pad : {0, 14, 15, 29, 31, 40}) {
+            std::string t = std::string(pad, 'x') + g;
+            ASSERT_TRUE(sstr_utf8_valid_of(t.data(), t.size())) << pad;
+        }
+    }
+
+    sstr_t s = sstr("h\xc3\xa9llo \xe2\x82\xac");
+    ASSERT_TRUE(sstr_utf8_valid(s));
+    ASSERT_EQ(sstr_utf8_count(s), 7U);
+    sstr_free(s);
+}
+
+TEST(utf8, truncate) {
+    // 1, 2, 3 and 4 byte codepoints
+    std::string text = "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80z";
+    const size_t keep[] = {0, 1, 1, 3, 3, 3, 6, 6, 6, 6, 10, 11, 11};
+    for (size_t n = 0; n <= text.size() + 1; ++n) {
+        sstr_t s = sstr_of(text.data(), text.size());
+        ASSERT_EQ(sstr_utf8_boundary(s, n), keep[n]) << n;
+        ASSERT_EQ(sstr_utf8_truncate(s, n), keep[n]) << n;
+        ASSERT_EQ(str_of(s), text.substr(0, keep[n]));
+        ASSERT_EQ(sstr_cstr(s)[keep[n]], '\0');
+        ASSERT_TRUE(sstr_utf8_valid(s));
+        sstr_free(s);
+    }
+}
+
+TEST(utf8, sanitize) {
+    const struct {
+        const char* in;
+        const char* out;
+        size_t replaced;
+    } cases[] = {
+        {"plain", "plain", 0},
+        {"\xc3\xa9t\xc3\xa9", "\xc3\xa9t\xc3\xa9", 0},
+        {"a\x80z", "a\xef\xbf\xbdz", 1},
+        // a cut sequence is one replacement, its valid prefix included
+        {"\xf0\x9f\x98!", "\xef\xbf\xbd!", 1},
+        {"\xe2\x82", "\xef\xbf\xbd", 1},
+        // every byte of a form that can not start well is its own
+        {"\xc0\x80", "\xef\xbf\xbd\xef\xbf\xbd", 2},
+        {"\xed\xa0\x80", "\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd", 3},
+        {"\xf4\x90\x80\x80x",
+         "\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd" "x", 4},
+    };
+    for (const auto& c : cases) {
+        sstr_t in = sstr(c.in);
+        sstr_t out = sstr("<");
+        ASSERT_EQ(sstr_utf8_sanitize_append(out, in), c.replaced) << c.in;
+        ASSERT_EQ(str_of(out), std::string("<") + c.out) << c.in;
+        ASSERT_TRUE(sstr_utf8_valid(out));
+        sstr_free(in);
+        sstr_free(out);
+    }
+
+    std::mt19937 rng(26);
+    for (int i = 0; i < 2000; ++i) {
+        std::string bytes;
+        for (int k = rng() % 300; k > 0; --k) {
+            bytes += (char)(rng() % 4 ? rng() % 128 : rng() % 256);
+        }
+        sstr_t in = sstr_of(bytes.data(), bytes.size());
+        sstr_t out = sstr_new();
+        size_t replaced = sstr_utf8_sanitize_append(out, in);
+        ASSERT_TRUE(sstr_utf8_valid(out));
+        ASSERT_EQ(replaced == 0, utf8_valid_ref(bytes));
+        sstr_free(in);
+        sstr_free(out);
+    }
+}
+
+TEST(utf8, utf16) {
+    std::mt19937 rng(27);
+    for (int i = 0; i < 3000; ++i) {
+        std::string utf8;
+        std::vector<uint16_t> utf16;
+        bool ascii = rng() % 2;
+        for (int k = rng() % 200; k > 0; --k) {
+            uint32_t cp = random_codepoint(rng, ascii);
+            put_utf8(utf8, cp);
+            put_utf16(utf16, cp);
+        }
+        sstr_t s = sstr_of(utf8.data(), utf8.size());
+        ASSERT_EQ(sstr_utf8_to_utf16(s, NULL, 0), utf16.size());
+        std::vector<uint16_t> out(utf16.size() + 1, 0xFFFF);
+        ASSERT_EQ(sstr_utf8_to_utf16(s, out.data(), utf16.size()),
+                  utf16.size());
+        out.pop_back();
+        ASSERT_EQ(out, utf16);
+
+        sstr_t back = sstr("<");
+        ASSERT_EQ(sstr_append_utf16(back, utf16.data(), utf16.size()), 0);
+        ASSERT_EQ(str_of(back), "<" + utf8);
+        ASSERT_EQ(sstr_cstr(back)[utf8.size() + 1], '\0');
+        sstr_free(back);
+        sstr_free(s);
+    }
+
+    // a short buffer holds a prefix that does not split a pair
+    sstr_t s = sstr("ab\xf0\x9f\x98\x80" "c");
+    uint16_t out[4] = {0, 0, 0, 0};
+    ASSERT_EQ(sstr_utf8_to_utf16(s, out, 3), 5U);
+    ASSERT_EQ(out[0], 'a');
+    ASSERT_EQ(out[1], 'b');
+    ASSERT_EQ(out[2], 0);
+    sstr_free(s);
+    s = sstr("a\xed\xa0\x80");
+    ASSERT_EQ(sstr_utf8_to_utf16(s, out, 4), SSTR_NPOS);
+    sstr_free(s);
+
+    const uint16_t lone[][3] = {{'a', 0xD83D, 'b'}, {'a', 0xDE00, 'b'},
+                                {'a', 'b', 0xD83D}};
+    s = sstr("keep");
+    for (const auto& l : lone) {
+        ASSERT_EQ(sstr_append_utf16(s, l, 3), -1);
+        ASSERT_STREQ(sstr_cstr(s), "keep");
+    }
+    sstr_free(s);
+}